@@ -0,0 +1,1520 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_bench.c
+ * @brief  ROHC throughput benchmark program
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The program loads one or several captures of IP packets (in the PCAP
+ * format) in memory, then measures the time spent by the library to
+ * compress, to decompress, and to compress then decompress every packet
+ * of the captures for a fixed number of iterations.
+ *
+ * Results are given per ROHC profile: median and 99th percentile of the
+ * time spent per packet, bytes saved by the compression, and number of
+ * calls to the memory allocator.
+ */
+
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h> /* for PRIu32 */
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for ntohs() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for ntohs() on Linux */
+#endif
+#include <assert.h>
+#include <stdarg.h>
+#include <time.h> /* for clock_gettime(2) */
+#include <limits.h> /* for INT_MAX */
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/ipv6.h>
+
+/* include for the PCAP library */
+#if HAVE_PCAP_PCAP_H == 1
+#  include <pcap/pcap.h>
+#elif HAVE_PCAP_H == 1
+#  include <pcap.h>
+#else
+#  error "pcap.h header not found, did you specified --enable-app-bench \
+for ./configure ? If yes, check configure output and config.log"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_packets.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The device MTU */
+#define DEV_MTU  0xffffU
+
+/** The maximal size for the ROHC packets */
+#define MAX_ROHC_SIZE  (DEV_MTU + 100U)
+
+/** The length of the Linux Cooked Sockets header */
+#define LINUX_COOKED_HDR_LEN  16U
+
+/** The length (in bytes) of the Ethernet address */
+#define ETH_ALEN  6U
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** The minimum Ethernet length (in bytes) */
+#define ETHER_FRAME_MIN_LEN  60U
+
+/** The 10Mb/s ethernet header */
+struct ether_header
+{
+	uint8_t ether_dhost[ETH_ALEN];  /**< destination eth addr */
+	uint8_t ether_shost[ETH_ALEN];  /**< source ether addr */
+	uint16_t ether_type;            /**< packet type ID field */
+} __attribute__((__packed__));
+
+/** The Ethertype for the 802.1q protocol (VLAN) */
+#define ETHERTYPE_8021Q   0x8100U
+/** The Ethertype for the 802.1ad protocol */
+#define ETHERTYPE_8021AD  0x88a8U
+
+/** The VLAN header */
+struct vlan_hdr
+{
+	uint16_t vid;  /**< The PCP, DEI and VID fields */
+	uint16_t type; /**< The Ethertype of the next header */
+} __attribute__((packed));
+
+
+/** The default number of times every capture is processed */
+#define BENCH_ITERATIONS_DEFAULT  100U
+
+/** The maximum number of different profiles the benchmark keeps track of */
+#define BENCH_PROFILES_MAX  16U
+
+
+/** The benchmarks run on every capture */
+typedef enum
+{
+	BENCH_MODE_COMP      = 0, /**< Compression only */
+	BENCH_MODE_DECOMP    = 1, /**< Decompression only */
+	BENCH_MODE_ROUNDTRIP = 2, /**< Compression then decompression */
+	BENCH_MODE_MAX       = 3, /**< The number of benchmarks */
+} bench_mode_t;
+
+/** The names of the benchmarks, as printed in results */
+static const char *const bench_mode_names[BENCH_MODE_MAX] =
+{
+	[BENCH_MODE_COMP]      = "comp",
+	[BENCH_MODE_DECOMP]    = "decomp",
+	[BENCH_MODE_ROUNDTRIP] = "roundtrip",
+};
+
+/** One packet of a capture loaded in memory */
+struct bench_pkt
+{
+	struct rohc_ts arrival_time; /**< The arrival time of the IP packet */
+	uint8_t *ip_data;            /**< The IP packet, without link layer */
+	size_t ip_len;               /**< The length of the IP packet */
+	uint8_t *rohc_data;          /**< The ROHC packet, compressed beforehand */
+	size_t rohc_len;             /**< The length of the ROHC packet */
+	size_t profile_idx;          /**< The profile used to compress the packet */
+};
+
+/** A capture loaded in memory */
+struct bench_capture
+{
+	struct bench_pkt *pkts;  /**< The packets of the capture */
+	size_t pkts_nr;          /**< The number of packets in the capture */
+	size_t pkts_max;         /**< The number of packets that fit in pkts */
+};
+
+/** The durations measured for one profile with one benchmark */
+struct bench_samples
+{
+	uint32_t *ns;              /**< The time spent for every packet (in ns) */
+	size_t nr;                 /**< The number of measures in ns */
+	size_t max;                /**< The number of measures that fit in ns */
+	unsigned long allocs_nr;   /**< The calls to the allocator while measuring */
+};
+
+/** The results of the benchmarks for one profile */
+struct bench_profile
+{
+	rohc_profile_t id;                  /**< The ID of the profile */
+	size_t pkts_nr;                     /**< The number of packets */
+	unsigned long long uncomp_bytes;    /**< The bytes before compression */
+	unsigned long long comp_bytes;      /**< The bytes after compression */
+	struct bench_samples samples[BENCH_MODE_MAX]; /**< The measures */
+};
+
+/** The position of the results for one profile before one capture */
+struct bench_mark
+{
+	size_t pkts_nr;                     /**< The number of packets */
+	unsigned long long uncomp_bytes;    /**< The bytes before compression */
+	unsigned long long comp_bytes;      /**< The bytes after compression */
+	size_t samples_nr[BENCH_MODE_MAX];  /**< The number of measures */
+	unsigned long allocs_nr[BENCH_MODE_MAX]; /**< The calls to the allocator */
+};
+
+
+/** The results of the benchmarks for every profile seen so far */
+static struct bench_profile bench_profiles[BENCH_PROFILES_MAX];
+/** The number of profiles in \ref bench_profiles */
+static size_t bench_profiles_nr = 0;
+
+/** The IP packets decompressed by the benchmarks */
+static uint8_t bench_ip_buf[MAX_ROHC_SIZE];
+/** The ROHC packets compressed by the benchmarks */
+static uint8_t bench_rohc_buf[MAX_ROHC_SIZE];
+
+
+#if defined(__GLIBC__)
+
+/* the glibc allocator, used by the counting wrappers below */
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t nmemb, size_t size);
+extern void * __libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+/** The number of calls to the memory allocator */
+static unsigned long allocs_nr = 0;
+
+void * malloc(size_t size)
+{
+	allocs_nr++;
+	return __libc_malloc(size);
+}
+
+void * calloc(size_t nmemb, size_t size)
+{
+	allocs_nr++;
+	return __libc_calloc(nmemb, size);
+}
+
+void * realloc(void *ptr, size_t size)
+{
+	allocs_nr++;
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+	__libc_free(ptr);
+}
+
+/** Whether the calls to the memory allocator are counted */
+static const bool allocs_counted = true;
+
+#else
+
+/** The calls to the memory allocator cannot be counted on the platform */
+static const unsigned long allocs_nr = 0;
+
+/** Whether the calls to the memory allocator are counted */
+static const bool allocs_counted = false;
+
+#endif /* __GLIBC__ */
+
+
+/* prototypes of private functions */
+static void usage(void);
+
+static int bench_capture_load(struct bench_capture *const capture,
+                              const char *const source)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static int bench_capture_load_one(struct bench_capture *const capture,
+                                  const struct pcap_pkthdr *const header,
+                                  const unsigned char *const packet,
+                                  size_t link_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void bench_capture_free(struct bench_capture *const capture)
+	__attribute__((nonnull(1)));
+
+static int bench_capture_prepare(struct bench_capture *const capture,
+                                 const rohc_cid_type_t cid_type,
+                                 const unsigned int max_contexts,
+                                 const bool use_rohcv2,
+                                 const size_t iterations)
+	__attribute__((warn_unused_result, nonnull(1)));
+static int bench_capture_run(const struct bench_capture *const capture,
+                             const bench_mode_t mode,
+                             const rohc_cid_type_t cid_type,
+                             const unsigned int max_contexts,
+                             const bool use_rohcv2,
+                             const size_t iterations)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static struct rohc_comp * bench_create_comp(const rohc_cid_type_t cid_type,
+                                            const unsigned int max_contexts,
+                                            const bool use_rohcv2)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * bench_create_decomp(const rohc_cid_type_t cid_type,
+                                                const unsigned int max_contexts,
+                                                const bool use_rohcv2)
+	__attribute__((warn_unused_result));
+
+static bool bench_profile_get(const rohc_profile_t id, size_t *const idx)
+	__attribute__((warn_unused_result, nonnull(2)));
+static bool bench_samples_reserve(struct bench_samples *const samples,
+                                  const size_t nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void bench_marks_get(struct bench_mark marks[BENCH_PROFILES_MAX]);
+static void bench_print_header(void);
+static void bench_print_results(const char *const source,
+                                const bool modes[BENCH_MODE_MAX],
+                                const size_t iterations,
+                                const struct bench_mark marks[BENCH_PROFILES_MAX])
+	__attribute__((nonnull(1, 2, 4)));
+static int cmp_uint32(const void *const a, const void *const b)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint64_t gettime_ns(void)
+	__attribute__((warn_unused_result));
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+static bool detect_vlan_hdrs(const unsigned char *const frame,
+                             const size_t frame_len,
+                             size_t *const link_len)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+
+/**
+ * @brief Main function for the ROHC benchmark program
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	char *cid_type_name = NULL;
+	char **sources = NULL;
+	size_t sources_nr = 0;
+	int status = 1;
+	int max_contexts = ROHC_SMALL_CID_MAX + 1;
+	int iterations = BENCH_ITERATIONS_DEFAULT;
+	size_t max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
+	rohc_cid_type_t cid_type = ROHC_SMALL_CID;
+	bool modes[BENCH_MODE_MAX] = { true, true, true };
+	bool use_rohcv2 = false;
+	bool print_header = true;
+	struct bench_mark start_marks[BENCH_PROFILES_MAX];
+	size_t i;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_bench version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "--no-header"))
+		{
+			/* do not print the names of the columns */
+			print_header = false;
+		}
+		else if(!strcmp(*argv, "--rohcv2"))
+		{
+			/* use the ROHCv2 profiles instead of the ROHCv1 ones */
+			use_rohcv2 = true;
+		}
+		else if(!strcmp(*argv, "--max-contexts"))
+		{
+			/* get the maximum number of contexts the test should use */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --max-contexts parameter\n");
+				usage();
+				goto error;
+			}
+			max_contexts = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--iterations"))
+		{
+			/* get the number of times every capture shall be processed */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --iterations parameter\n");
+				usage();
+				goto error;
+			}
+			iterations = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--mode"))
+		{
+			/* get the benchmark to run */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --mode parameter\n");
+				usage();
+				goto error;
+			}
+			if(!strcmp(argv[1], "all"))
+			{
+				modes[BENCH_MODE_COMP] = true;
+				modes[BENCH_MODE_DECOMP] = true;
+				modes[BENCH_MODE_ROUNDTRIP] = true;
+			}
+			else
+			{
+				bench_mode_t mode;
+
+				for(mode = 0; mode < BENCH_MODE_MAX &&
+				    strcmp(argv[1], bench_mode_names[mode]) != 0; mode++)
+				{
+				}
+				if(mode == BENCH_MODE_MAX)
+				{
+					fprintf(stderr, "invalid mode '%s', only 'comp', 'decomp', "
+					        "'roundtrip' and 'all' expected\n", argv[1]);
+					usage();
+					goto error;
+				}
+				modes[BENCH_MODE_COMP] = false;
+				modes[BENCH_MODE_DECOMP] = false;
+				modes[BENCH_MODE_ROUNDTRIP] = false;
+				modes[mode] = true;
+			}
+			args_used++;
+		}
+		else if(cid_type_name == NULL)
+		{
+			/* get the type of CID to use within the ROHC library */
+			cid_type_name = argv[0];
+
+			if(!strcmp(cid_type_name, "smallcid"))
+			{
+				cid_type = ROHC_SMALL_CID;
+				max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
+			}
+			else if(!strcmp(cid_type_name, "largecid"))
+			{
+				cid_type = ROHC_LARGE_CID;
+				max_possible_contexts = ROHC_LARGE_CID_MAX + 1;
+			}
+			else
+			{
+				fprintf(stderr, "invalid CID type '%s', only 'smallcid' and "
+				        "'largecid' expected\n", cid_type_name);
+				usage();
+				goto error;
+			}
+		}
+		else
+		{
+			/* all remaining arguments are captures */
+			sources = argv;
+			sources_nr = argc;
+			args_used = argc;
+		}
+	}
+
+	/* check CID type */
+	if(cid_type_name == NULL)
+	{
+		fprintf(stderr, "parameter CID_TYPE is mandatory\n");
+		usage();
+		goto error;
+	}
+
+	/* the maximum number of ROHC contexts should be valid wrt CID type */
+	if(max_contexts < 1 || max_contexts > max_possible_contexts)
+	{
+		fprintf(stderr, "the maximum number of ROHC contexts should be "
+		        "between 1 and %zu\n\n", max_possible_contexts);
+		usage();
+		goto error;
+	}
+
+	/* at least one iteration is required to measure something */
+	if(iterations < 1)
+	{
+		fprintf(stderr, "the number of iterations should be between 1 and "
+		        "%d\n\n", INT_MAX);
+		usage();
+		goto error;
+	}
+
+	/* at least one capture is mandatory */
+	if(sources_nr == 0)
+	{
+		fprintf(stderr, "at least one source is mandatory\n");
+		usage();
+		goto error;
+	}
+
+	if(print_header)
+	{
+		bench_print_header();
+	}
+
+	/* run the benchmarks on every capture, one after the other */
+	bench_marks_get(start_marks);
+	status = 0;
+	for(i = 0; i < sources_nr; i++)
+	{
+		struct bench_capture capture;
+		struct bench_mark marks[BENCH_PROFILES_MAX];
+		bench_mode_t mode;
+
+		bench_marks_get(marks);
+
+		/* load the whole capture in memory, then compress it once to get the
+		 * ROHC packets for the decompression benchmark */
+		if(bench_capture_load(&capture, sources[i]) != 0)
+		{
+			fprintf(stderr, "%s: failed to load capture\n", sources[i]);
+			status = 1;
+			continue;
+		}
+		if(bench_capture_prepare(&capture, cid_type, max_contexts, use_rohcv2,
+		                         iterations) != 0)
+		{
+			fprintf(stderr, "%s: failed to compress capture\n", sources[i]);
+			bench_capture_free(&capture);
+			status = 1;
+			continue;
+		}
+
+		for(mode = 0; mode < BENCH_MODE_MAX; mode++)
+		{
+			if(modes[mode] &&
+			   bench_capture_run(&capture, mode, cid_type, max_contexts,
+			                     use_rohcv2, iterations) != 0)
+			{
+				fprintf(stderr, "%s: %s benchmark failed\n", sources[i],
+				        bench_mode_names[mode]);
+				status = 1;
+			}
+		}
+		bench_capture_free(&capture);
+
+		bench_print_results(sources[i], modes, iterations, marks);
+	}
+
+	/* summarize all the captures if there are several ones */
+	if(sources_nr > 1)
+	{
+		bench_print_results("all", modes, iterations, start_marks);
+	}
+
+	for(i = 0; i < bench_profiles_nr; i++)
+	{
+		bench_mode_t mode;
+
+		for(mode = 0; mode < BENCH_MODE_MAX; mode++)
+		{
+			free(bench_profiles[i].samples[mode].ns);
+		}
+	}
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the benchmark application
+ */
+static void usage(void)
+{
+	printf("The ROHC benchmark tool measures the throughput of the ROHC library\n"
+	       "\n"
+	       "Every capture is loaded in memory, then compressed, decompressed,\n"
+	       "or compressed and decompressed several times with new compressors\n"
+	       "and decompressors. The rohc_bench tool outputs the results in CSV\n"
+	       "format with the following tab-separated fields:\n\n"
+	       "  * keyword 'BENCH'\n\n"
+	       "  * capture ('all' for the summary of all captures)\n\n"
+	       "  * benchmark ('comp', 'decomp' or 'roundtrip')\n\n"
+	       "  * profile (numeric ID)\n\n"
+	       "  * profile (string)\n\n"
+	       "  * packets per iteration\n\n"
+	       "  * iterations\n\n"
+	       "  * median time per packet (ns)\n\n"
+	       "  * 99th percentile of time per packet (ns)\n\n"
+	       "  * mean time per packet (ns)\n\n"
+	       "  * uncompressed bytes per iteration\n\n"
+	       "  * compressed bytes per iteration\n\n"
+	       "  * bytes saved per iteration\n\n"
+	       "  * calls to the memory allocator per packet (-1 if not available)\n\n"
+	       "\n"
+	       "Usage: rohc_bench [OPTIONS] CID_TYPE SOURCE...\n"
+	       "\n"
+	       "Options:\n"
+	       "  -v, --version           Print version information and exit\n"
+	       "  -h, --help              Print this usage and exit\n"
+	       "      --max-contexts NUM  The maximum number of ROHC contexts to\n"
+	       "                          simultaneously use during the test\n"
+	       "      --iterations NUM    The number of times every capture is\n"
+	       "                          processed (default: %u)\n"
+	       "      --mode MODE         Run the 'comp', 'decomp' or 'roundtrip'\n"
+	       "                          benchmark only, or 'all' of them (default)\n"
+	       "      --rohcv2            Use the ROHCv2 profiles instead of the\n"
+	       "                          ROHCv1 ones\n"
+	       "      --no-header         Do not print the names of the fields\n"
+	       "\n"
+	       "With:\n"
+	       "  CID_TYPE  The type of CID to use among 'smallcid'\n"
+	       "            and 'largecid'\n"
+	       "  SOURCE    The name of a file in PCAP format that contains the\n"
+	       "            Ethernet frames to compress\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_bench smallcid /tmp/rtp.pcap                 Benchmark one capture\n"
+	       "  rohc_bench --mode comp largecid ~/a.pcap ~/b.pcap  Benchmark compression\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       BENCH_ITERATIONS_DEFAULT);
+}
+
+
+/**
+ * @brief Load all the IP packets of one PCAP capture in memory
+ *
+ * @param capture  OUT: The capture loaded in memory
+ * @param source   The name of the PCAP file
+ * @return         0 in case of success,
+ *                 1 in case of failure
+ */
+static int bench_capture_load(struct bench_capture *const capture,
+                              const char *const source)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	pcap_t *handle;
+	int link_layer_type;
+	size_t link_len;
+
+	struct pcap_pkthdr header;
+	unsigned char *packet;
+
+	capture->pkts = NULL;
+	capture->pkts_nr = 0;
+	capture->pkts_max = 0;
+
+	/* open the source PCAP file */
+	handle = pcap_open_offline(source, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source PCAP file must be Ethernet */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type != DLT_EN10MB &&
+	   link_layer_type != DLT_LINUX_SLL &&
+	   link_layer_type != DLT_RAW)
+	{
+		fprintf(stderr, "link layer type %d not supported in source PCAP file "
+		        "(supported = %d, %d, %d)\n", link_layer_type, DLT_EN10MB,
+		        DLT_LINUX_SLL, DLT_RAW);
+		goto close_input;
+	}
+
+	/* determine the size of the link layer header */
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else /* DLT_RAW */
+	{
+		link_len = 0;
+	}
+
+	/* copy every IP packet of the capture */
+	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	{
+		if(bench_capture_load_one(capture, &header, packet, link_len) != 0)
+		{
+			fprintf(stderr, "packet #%zu: failed to load packet\n",
+			        capture->pkts_nr + 1);
+			goto free_capture;
+		}
+	}
+	if(capture->pkts_nr == 0)
+	{
+		fprintf(stderr, "no packet in capture\n");
+		goto free_capture;
+	}
+
+	pcap_close(handle);
+	return 0;
+
+free_capture:
+	bench_capture_free(capture);
+close_input:
+	pcap_close(handle);
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Copy one IP packet of one PCAP capture in memory
+ *
+ * @param capture   The capture to add the IP packet to
+ * @param header    The PCAP header for the packet
+ * @param packet    The packet to copy (link layer included)
+ * @param link_len  The length of the link layer header before IP data
+ * @return          0 in case of success,
+ *                  1 in case of failure
+ */
+static int bench_capture_load_one(struct bench_capture *const capture,
+                                  const struct pcap_pkthdr *const header,
+                                  const unsigned char *const packet,
+                                  size_t link_len)
+{
+	struct bench_pkt *pkt;
+	size_t ip_len;
+
+	/* check frame length */
+	if(header->len <= link_len || header->len != header->caplen)
+	{
+		fprintf(stderr, "bad PCAP packet (len = %u, caplen = %u)\n",
+		        header->len, header->caplen);
+		goto error;
+	}
+
+	/* skip the link layer header (including VLAN headers) */
+	if(!detect_vlan_hdrs(packet, header->caplen, &link_len))
+	{
+		fprintf(stderr, "malformed VLAN header\n");
+		goto error;
+	}
+	if(header->caplen <= link_len)
+	{
+		fprintf(stderr, "truncated %u-byte frame\n", header->caplen);
+		goto error;
+	}
+	ip_len = header->caplen - link_len;
+
+	/* check for padding after the IP packet in the Ethernet payload */
+	if(link_len == ETHER_HDR_LEN && header->len == ETHER_FRAME_MIN_LEN)
+	{
+		const uint8_t version = (packet[link_len] >> 4) & 0x0f;
+		uint16_t tot_len;
+
+		if(version == 4)
+		{
+			const struct ipv4_hdr *const ip =
+				(struct ipv4_hdr *) (packet + link_len);
+			tot_len = ntohs(ip->tot_len);
+		}
+		else
+		{
+			const struct ipv6_hdr *const ip =
+				(struct ipv6_hdr *) (packet + link_len);
+			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+		}
+
+		if(tot_len < ip_len)
+		{
+			/* the Ethernet frame has some bytes of padding after the IP packet */
+			ip_len = tot_len;
+		}
+	}
+
+	/* make room for the new packet */
+	if(capture->pkts_nr == capture->pkts_max)
+	{
+		const size_t new_max =
+			(capture->pkts_max == 0 ? 1024 : capture->pkts_max * 2);
+		struct bench_pkt *const new_pkts =
+			realloc(capture->pkts, new_max * sizeof(struct bench_pkt));
+		if(new_pkts == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for %zu packets\n",
+			        new_max);
+			goto error;
+		}
+		capture->pkts = new_pkts;
+		capture->pkts_max = new_max;
+	}
+
+	/* copy the IP packet */
+	pkt = &(capture->pkts[capture->pkts_nr]);
+	pkt->ip_data = malloc(ip_len);
+	if(pkt->ip_data == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu-byte packet\n",
+		        ip_len);
+		goto error;
+	}
+	memcpy(pkt->ip_data, packet + link_len, ip_len);
+	pkt->ip_len = ip_len;
+	pkt->arrival_time.sec = header->ts.tv_sec;
+	pkt->arrival_time.nsec = header->ts.tv_usec * 1000;
+	pkt->rohc_data = NULL;
+	pkt->rohc_len = 0;
+	pkt->profile_idx = 0;
+	capture->pkts_nr++;
+
+	return 0;
+
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Free all the packets of one capture loaded in memory
+ *
+ * @param capture  The capture to free
+ */
+static void bench_capture_free(struct bench_capture *const capture)
+{
+	size_t i;
+
+	for(i = 0; i < capture->pkts_nr; i++)
+	{
+		free(capture->pkts[i].ip_data);
+		free(capture->pkts[i].rohc_data);
+	}
+	free(capture->pkts);
+	capture->pkts = NULL;
+	capture->pkts_nr = 0;
+	capture->pkts_max = 0;
+}
+
+
+/**
+ * @brief Compress one capture once before running the benchmarks
+ *
+ * Record the ROHC packets for the decompression benchmark, the profile used
+ * for every packet, and the number of bytes saved by compression. Also
+ * reserve the memory for the measures of the benchmarks, so that the memory
+ * allocator is not called by the program itself while measuring.
+ *
+ * @param capture       The capture to compress
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param use_rohcv2    Whether to use the ROHCv2 profiles or the ROHCv1 ones
+ * @param iterations    The number of times the capture will be processed
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int bench_capture_prepare(struct bench_capture *const capture,
+                                 const rohc_cid_type_t cid_type,
+                                 const unsigned int max_contexts,
+                                 const bool use_rohcv2,
+                                 const size_t iterations)
+{
+	size_t pkts_per_profile[BENCH_PROFILES_MAX] = { 0 };
+	struct rohc_comp *comp;
+	size_t i;
+	int is_failure = 1;
+
+	comp = bench_create_comp(cid_type, max_contexts, use_rohcv2);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	for(i = 0; i < capture->pkts_nr; i++)
+	{
+		struct bench_pkt *const pkt = &(capture->pkts[i]);
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(pkt->ip_data, pkt->ip_len, pkt->arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(bench_rohc_buf, MAX_ROHC_SIZE);
+		rohc_comp_last_packet_info2_t last_packet_info;
+		struct bench_profile *profile;
+		rohc_status_t status;
+
+		/* compress the IP packet */
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: compression failed\n", i + 1);
+			goto destroy_comp;
+		}
+
+		/* keep the ROHC packet for the decompression benchmark */
+		pkt->rohc_data = malloc(rohc_packet.len);
+		if(pkt->rohc_data == NULL)
+		{
+			fprintf(stderr, "packet #%zu: failed to allocate memory for %zu-byte "
+			        "ROHC packet\n", i + 1, rohc_packet.len);
+			goto destroy_comp;
+		}
+		memcpy(pkt->rohc_data, rohc_buf_data(rohc_packet), rohc_packet.len);
+		pkt->rohc_len = rohc_packet.len;
+
+		/* retrieve the profile used to compress the packet */
+		last_packet_info.version_major = 0;
+		last_packet_info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
+		{
+			fprintf(stderr, "packet #%zu: cannot get stats about the last "
+			        "compressed packet\n", i + 1);
+			goto destroy_comp;
+		}
+		if(!bench_profile_get(last_packet_info.profile_id, &pkt->profile_idx))
+		{
+			fprintf(stderr, "packet #%zu: too many different profiles\n", i + 1);
+			goto destroy_comp;
+		}
+
+		profile = &(bench_profiles[pkt->profile_idx]);
+		profile->pkts_nr++;
+		profile->uncomp_bytes += pkt->ip_len;
+		profile->comp_bytes += pkt->rohc_len;
+		pkts_per_profile[pkt->profile_idx]++;
+	}
+
+	/* reserve memory for the measures */
+	for(i = 0; i < bench_profiles_nr; i++)
+	{
+		bench_mode_t mode;
+
+		for(mode = 0; mode < BENCH_MODE_MAX; mode++)
+		{
+			if(!bench_samples_reserve(&(bench_profiles[i].samples[mode]),
+			                          pkts_per_profile[i] * iterations))
+			{
+				fprintf(stderr, "failed to allocate memory for %zu measures\n",
+				        pkts_per_profile[i] * iterations);
+				goto destroy_comp;
+			}
+		}
+	}
+
+	is_failure = 0;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run one benchmark on one capture loaded in memory
+ *
+ * New compressor and decompressor are created for every iteration, so that
+ * every iteration processes the very same packets. Only the calls to
+ * \ref rohc_compress4 and \ref rohc_decompress3 are measured.
+ *
+ * @param capture       The capture to process
+ * @param mode          The benchmark to run
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param use_rohcv2    Whether to use the ROHCv2 profiles or the ROHCv1 ones
+ * @param iterations    The number of times the capture shall be processed
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int bench_capture_run(const struct bench_capture *const capture,
+                             const bench_mode_t mode,
+                             const rohc_cid_type_t cid_type,
+                             const unsigned int max_contexts,
+                             const bool use_rohcv2,
+                             const size_t iterations)
+{
+	struct rohc_comp *comp = NULL;
+	struct rohc_decomp *decomp = NULL;
+	size_t iter;
+	size_t i;
+
+	for(iter = 0; iter < iterations; iter++)
+	{
+		if(mode != BENCH_MODE_DECOMP)
+		{
+			comp = bench_create_comp(cid_type, max_contexts, use_rohcv2);
+			if(comp == NULL)
+			{
+				goto error;
+			}
+		}
+		if(mode != BENCH_MODE_COMP)
+		{
+			decomp = bench_create_decomp(cid_type, max_contexts, use_rohcv2);
+			if(decomp == NULL)
+			{
+				goto free_comp;
+			}
+		}
+
+		for(i = 0; i < capture->pkts_nr; i++)
+		{
+			const struct bench_pkt *const pkt = &(capture->pkts[i]);
+			struct bench_samples *const samples =
+				&(bench_profiles[pkt->profile_idx].samples[mode]);
+			const struct rohc_buf ip_packet =
+				rohc_buf_init_full(pkt->ip_data, pkt->ip_len, pkt->arrival_time);
+			const struct rohc_buf prepared_packet =
+				rohc_buf_init_full(pkt->rohc_data, pkt->rohc_len, pkt->arrival_time);
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(bench_rohc_buf, MAX_ROHC_SIZE);
+			struct rohc_buf decomp_packet =
+				rohc_buf_init_empty(bench_ip_buf, MAX_ROHC_SIZE);
+			rohc_status_t comp_status = ROHC_STATUS_OK;
+			rohc_status_t decomp_status = ROHC_STATUS_OK;
+			unsigned long allocs_before;
+			uint64_t start;
+			uint64_t end;
+
+			if(mode == BENCH_MODE_DECOMP)
+			{
+				rohc_packet = prepared_packet;
+			}
+
+			/* measure the library only */
+			allocs_before = allocs_nr;
+			start = gettime_ns();
+			if(mode != BENCH_MODE_DECOMP)
+			{
+				comp_status = rohc_compress4(comp, ip_packet, &rohc_packet);
+			}
+			if(mode != BENCH_MODE_COMP && comp_status == ROHC_STATUS_OK)
+			{
+				decomp_status = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
+				                                 NULL, NULL);
+			}
+			end = gettime_ns();
+			samples->allocs_nr += allocs_nr - allocs_before;
+
+			if(comp_status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "packet #%zu: compression failed\n", i + 1);
+				goto free_decomp;
+			}
+			if(decomp_status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "packet #%zu: decompression failed\n", i + 1);
+				goto free_decomp;
+			}
+			if(mode != BENCH_MODE_COMP &&
+			   (decomp_packet.len != pkt->ip_len ||
+			    memcmp(rohc_buf_data(decomp_packet), pkt->ip_data, pkt->ip_len) != 0))
+			{
+				fprintf(stderr, "packet #%zu: decompressed packet does not match "
+				        "the original one\n", i + 1);
+				goto free_decomp;
+			}
+
+			/* room for the measure was reserved beforehand */
+			assert(samples->nr < samples->max);
+			samples->ns[samples->nr] =
+				((end - start) > UINT32_MAX ? UINT32_MAX : (end - start));
+			samples->nr++;
+		}
+
+		rohc_decomp_free(decomp);
+		decomp = NULL;
+		rohc_comp_free(comp);
+		comp = NULL;
+	}
+
+	return 0;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Create one ROHC compressor for the benchmarks
+ *
+ * The random generator is reset, so that all compressors behave the same.
+ *
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param use_rohcv2    Whether to use the ROHCv2 profiles or the ROHCv1 ones
+ * @return              The new compressor in case of success,
+ *                      NULL in case of failure
+ */
+static struct rohc_comp * bench_create_comp(const rohc_cid_type_t cid_type,
+                                            const unsigned int max_contexts,
+                                            const bool use_rohcv2)
+{
+	struct rohc_comp *comp;
+	bool profiles_enabled;
+
+	srand(1);
+
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+
+	/* enable periodic refreshes based on inter-packet delay */
+	if(!rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES))
+	{
+		fprintf(stderr, "failed to enable periodic refreshes of contexts based "
+		        "on inter-packet delay\n");
+		goto destroy_comp;
+	}
+
+	/* enable profiles */
+	if(use_rohcv2)
+	{
+		profiles_enabled =
+			rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_UNCOMPRESSED,
+			                          ROHCv2_PROFILE_IP_UDP, ROHCv2_PROFILE_IP,
+			                          ROHCv2_PROFILE_IP_UDP_RTP,
+			                          ROHCv2_PROFILE_IP_ESP,
+			                          ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	else
+	{
+		profiles_enabled =
+			rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_UNCOMPRESSED,
+			                          ROHCv1_PROFILE_IP_UDP, ROHCv1_PROFILE_IP,
+			                          ROHCv1_PROFILE_IP_UDP_RTP,
+			                          ROHCv1_PROFILE_IP_ESP,
+			                          ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	if(!profiles_enabled)
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for RTP detection\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create one ROHC decompressor for the benchmarks
+ *
+ * The decompressor works in unidirectional mode, so that no feedback is
+ * required by the compressor.
+ *
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param use_rohcv2    Whether to use the ROHCv2 profiles or the ROHCv1 ones
+ * @return              The new decompressor in case of success,
+ *                      NULL in case of failure
+ */
+static struct rohc_decomp * bench_create_decomp(const rohc_cid_type_t cid_type,
+                                                const unsigned int max_contexts,
+                                                const bool use_rohcv2)
+{
+	struct rohc_decomp *decomp;
+	bool profiles_enabled;
+
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto error;
+	}
+
+	/* enable profiles */
+	if(use_rohcv2)
+	{
+		profiles_enabled =
+			rohc_decomp_enable_profiles(decomp, ROHCv1_PROFILE_UNCOMPRESSED,
+			                            ROHCv2_PROFILE_IP_UDP, ROHCv2_PROFILE_IP,
+			                            ROHCv2_PROFILE_IP_UDP_RTP,
+			                            ROHCv2_PROFILE_IP_ESP,
+			                            ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	else
+	{
+		profiles_enabled =
+			rohc_decomp_enable_profiles(decomp, ROHCv1_PROFILE_UNCOMPRESSED,
+			                            ROHCv1_PROFILE_IP_UDP, ROHCv1_PROFILE_IP,
+			                            ROHCv1_PROFILE_IP_UDP_RTP,
+			                            ROHCv1_PROFILE_IP_ESP,
+			                            ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	if(!profiles_enabled)
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the results of the benchmarks for one profile
+ *
+ * @param id   The ID of the profile
+ * @param idx  OUT: The index of the profile in \ref bench_profiles
+ * @return     true if the profile was found or added,
+ *             false if too many profiles were already seen
+ */
+static bool bench_profile_get(const rohc_profile_t id, size_t *const idx)
+{
+	size_t i;
+
+	for(i = 0; i < bench_profiles_nr && bench_profiles[i].id != id; i++)
+	{
+	}
+	if(i == bench_profiles_nr)
+	{
+		if(bench_profiles_nr >= BENCH_PROFILES_MAX)
+		{
+			return false;
+		}
+		memset(&(bench_profiles[i]), 0, sizeof(struct bench_profile));
+		bench_profiles[i].id = id;
+		bench_profiles_nr++;
+	}
+	*idx = i;
+
+	return true;
+}
+
+
+/**
+ * @brief Make room for new measures
+ *
+ * @param samples  The measures
+ * @param nr       The number of new measures to make room for
+ * @return         true if enough room is available,
+ *                 false if memory cannot be allocated
+ */
+static bool bench_samples_reserve(struct bench_samples *const samples,
+                                  const size_t nr)
+{
+	if((samples->max - samples->nr) < nr)
+	{
+		const size_t new_max = samples->nr + nr;
+		uint32_t *const new_ns = realloc(samples->ns, new_max * sizeof(uint32_t));
+		if(new_ns == NULL)
+		{
+			return false;
+		}
+		samples->ns = new_ns;
+		samples->max = new_max;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Record the position of the results for every profile
+ *
+ * @param marks  OUT: The position of the results for every profile
+ */
+static void bench_marks_get(struct bench_mark marks[BENCH_PROFILES_MAX])
+{
+	size_t i;
+
+	memset(marks, 0, BENCH_PROFILES_MAX * sizeof(struct bench_mark));
+	for(i = 0; i < bench_profiles_nr; i++)
+	{
+		bench_mode_t mode;
+
+		marks[i].pkts_nr = bench_profiles[i].pkts_nr;
+		marks[i].uncomp_bytes = bench_profiles[i].uncomp_bytes;
+		marks[i].comp_bytes = bench_profiles[i].comp_bytes;
+		for(mode = 0; mode < BENCH_MODE_MAX; mode++)
+		{
+			marks[i].samples_nr[mode] = bench_profiles[i].samples[mode].nr;
+			marks[i].allocs_nr[mode] = bench_profiles[i].samples[mode].allocs_nr;
+		}
+	}
+}
+
+
+/**
+ * @brief Print the names of the fields of the results
+ */
+static void bench_print_header(void)
+{
+	printf("BENCH\t"
+	       "\"capture\"\t"
+	       "\"benchmark\"\t"
+	       "\"profile\"\t"
+	       "\"profile (string)\"\t"
+	       "\"packets per iteration\"\t"
+	       "\"iterations\"\t"
+	       "\"median time per packet (ns)\"\t"
+	       "\"p99 time per packet (ns)\"\t"
+	       "\"mean time per packet (ns)\"\t"
+	       "\"uncompressed bytes per iteration\"\t"
+	       "\"compressed bytes per iteration\"\t"
+	       "\"bytes saved per iteration\"\t"
+	       "\"allocator calls per packet\"\n");
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Print the results of the benchmarks since the given position
+ *
+ * The measures since the given position are sorted in place to compute
+ * their median and 99th percentile.
+ *
+ * @param source      The name of the results
+ * @param modes       The benchmarks that were run
+ * @param iterations  The number of times the captures were processed
+ * @param marks       The position of the results to print
+ */
+static void bench_print_results(const char *const source,
+                                const bool modes[BENCH_MODE_MAX],
+                                const size_t iterations,
+                                const struct bench_mark marks[BENCH_PROFILES_MAX])
+{
+	size_t i;
+
+	for(i = 0; i < bench_profiles_nr; i++)
+	{
+		const struct bench_profile *const profile = &(bench_profiles[i]);
+		const size_t pkts_nr = profile->pkts_nr - marks[i].pkts_nr;
+		const unsigned long long uncomp_bytes =
+			profile->uncomp_bytes - marks[i].uncomp_bytes;
+		const unsigned long long comp_bytes =
+			profile->comp_bytes - marks[i].comp_bytes;
+		bench_mode_t mode;
+
+		for(mode = 0; mode < BENCH_MODE_MAX; mode++)
+		{
+			const struct bench_samples *const samples = &(profile->samples[mode]);
+			uint32_t *const ns = samples->ns + marks[i].samples_nr[mode];
+			const size_t nr = samples->nr - marks[i].samples_nr[mode];
+			const unsigned long allocs =
+				samples->allocs_nr - marks[i].allocs_nr[mode];
+			unsigned long long total_ns = 0;
+			size_t j;
+
+			if(!modes[mode] || nr == 0)
+			{
+				continue;
+			}
+
+			qsort(ns, nr, sizeof(uint32_t), cmp_uint32);
+			for(j = 0; j < nr; j++)
+			{
+				total_ns += ns[j];
+			}
+
+			printf("BENCH\t%s\t%s\t%d\t%s\t%zu\t%zu\t%" PRIu32 "\t%" PRIu32
+			       "\t%llu\t%llu\t%llu\t%lld\t%.3f\n",
+			       source, bench_mode_names[mode], profile->id,
+			       rohc_get_profile_descr(profile->id), pkts_nr, iterations,
+			       ns[(nr - 1) / 2], ns[(nr * 99 + 99) / 100 - 1],
+			       total_ns / nr, uncomp_bytes, comp_bytes,
+			       (long long) (uncomp_bytes - comp_bytes),
+			       (allocs_counted ? ((double) allocs) / nr : -1.0));
+		}
+	}
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Compare two measures for qsort(3)
+ *
+ * @param a  The first measure
+ * @param b  The second measure
+ * @return   -1, 0 or 1 if a is less than, equal to, or greater than b
+ */
+static int cmp_uint32(const void *const a, const void *const b)
+{
+	const uint32_t val_a = *((const uint32_t *) a);
+	const uint32_t val_b = *((const uint32_t *) b);
+
+	return (val_a > val_b) - (val_a < val_b);
+}
+
+
+/**
+ * @brief Get the current time of a monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t gettime_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t) ts.tv_sec) * 1000000000U + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context, may be NULL
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	const size_t default_rtp_ports_nr = 5;
+	unsigned int default_rtp_ports[] = { 1234, 36780, 33238, 5020, 5002 };
+	uint16_t udp_dport;
+	bool is_rtp = false;
+	size_t i;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* get the UDP destination port */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	/* is the UDP destination port in the list of ports reserved for RTP
+	 * traffic by default (for compatibility reasons) */
+	for(i = 0; i < default_rtp_ports_nr; i++)
+	{
+		if(ntohs(udp_dport) == default_rtp_ports[i])
+		{
+			is_rtp = true;
+			break;
+		}
+	}
+
+	return is_rtp;
+}
+
+
+/**
+ * @brief Detect the 802.1q/802.1ad VLAN headers after the Ethernet header
+ *
+ * @param frame          The Ethernet frame
+ * @param frame_len      The length of the Ethernet frame
+ * @param[in,out] link_len  in: the length of the link layer header
+ *                          out: the length of the link layer + VLAN headers
+ * @return               true if the VLAN headers are valid,
+ *                       false if they are malformed
+ */
+static bool detect_vlan_hdrs(const unsigned char *const frame,
+                             const size_t frame_len,
+                             size_t *const link_len)
+{
+	if((*link_len) == ETHER_HDR_LEN)
+	{
+		const struct ether_header *const eth_header =
+			(struct ether_header *) frame;
+		uint16_t proto_type = ntohs(eth_header->ether_type);
+
+		/* skip all 802.1q or 802.1ad headers */
+		while(proto_type == ETHERTYPE_8021Q || proto_type == ETHERTYPE_8021AD)
+		{
+			/* check min length */
+			if(frame_len < (*link_len) + sizeof(struct vlan_hdr))
+			{
+				fprintf(stderr, "truncated %zu-byte 802.1q or 802.1ad frame\n",
+				        frame_len);
+				goto error;
+			}
+
+			/* detect next header */
+			const struct vlan_hdr *const vlan_hdr =
+				(struct vlan_hdr *) (frame + (*link_len));
+			proto_type = ntohs(vlan_hdr->type);
+
+			/* skip VLAN header */
+			(*link_len) += sizeof(struct vlan_hdr);
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
@@ -25,6 +25,11 @@
  *
  * The program takes a flow of IP packets as input (in the PCAP format) and
  * generate some ROHC compression statistics with them.
+ *
+ * The 'summary' action is dedicated to the offline analysis of large
+ * captures: several PCAP files are compressed in parallel, one compressor
+ * per file, and only a compact CSV summary per profile and per packet type
+ * is output instead of one line per packet.
  */
 
 #include "config.h" /* for HAVE_*_H */
@@ -33,6 +38,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h> /* for PRIu64 */
 #if HAVE_WINSOCK2_H == 1
 #  include <winsock2.h> /* for ntohs() on Windows */
 #endif
@@ -47,6 +53,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <limits.h> /* for INT_MAX */
+#include <pthread.h>
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -108,6 +115,100 @@ struct vlan_hdr
 } __attribute__((packed));
 
 
+/** The magic number of PCAP files with timestamps in microseconds */
+#define PCAP_MAGIC_USEC  0xa1b2c3d4U
+/** The magic number of PCAP files with timestamps in nanoseconds */
+#define PCAP_MAGIC_NSEC  0xa1b23c4dU
+
+/** The link types of PCAP files (they may differ from the DLT_* values) */
+#define PCAP_LINKTYPE_ETHERNET   1U
+#define PCAP_LINKTYPE_RAW      101U
+#define PCAP_LINKTYPE_LINUX_SLL  113U
+
+/** The size of the stdio buffer used to read PCAP files */
+#define PCAP_READER_BUF_LEN  (1U << 20)
+
+/** The maximum length of the packets in PCAP files */
+#define PCAP_READER_PKT_MAX_LEN  262144U
+
+/** The global header of PCAP files */
+struct pcap_file_hdr
+{
+	uint32_t magic;          /**< The magic number */
+	uint16_t version_major;  /**< The major version of the file format */
+	uint16_t version_minor;  /**< The minor version of the file format */
+	int32_t thiszone;        /**< The GMT to local correction */
+	uint32_t sigfigs;        /**< The accuracy of timestamps */
+	uint32_t snaplen;        /**< The max length of captured packets */
+	uint32_t linktype;       /**< The type of the link layer */
+} __attribute__((packed));
+
+/** The header of every record in PCAP files */
+struct pcap_record_hdr
+{
+	uint32_t ts_sec;    /**< The timestamp seconds */
+	uint32_t ts_frac;   /**< The timestamp microseconds or nanoseconds */
+	uint32_t caplen;    /**< The number of bytes saved in file */
+	uint32_t len;       /**< The actual length of the packet */
+} __attribute__((packed));
+
+/** A buffered reader for PCAP files that does not rely on libpcap */
+struct pcap_file_reader
+{
+	const char *source;     /**< The name of the PCAP file */
+	FILE *file;             /**< The PCAP file */
+	char *file_buf;         /**< The large stdio buffer for the PCAP file */
+	unsigned char *packet;  /**< The buffer for the current packet */
+	size_t link_len;        /**< The length of the link layer header */
+	bool is_swapped;        /**< Whether the file uses the other byte order */
+	bool is_nsec;           /**< Whether timestamps are in nanoseconds */
+};
+
+
+/** The counters of the summary for one kind of packets */
+struct summary_counters
+{
+	uint64_t packets_nr;          /**< The number of packets */
+	uint64_t uncomp_bytes_nr;     /**< The number of uncompressed bytes */
+	uint64_t uncomp_hdr_bytes_nr; /**< The number of uncompressed header bytes */
+	uint64_t comp_bytes_nr;       /**< The number of compressed bytes */
+	uint64_t comp_hdr_bytes_nr;   /**< The number of compressed header bytes */
+};
+
+/** The summary of the compression of one or several PCAP files */
+struct summary
+{
+	/** The counters for all the compressed packets */
+	struct summary_counters all;
+	/** The counters for the packets that failed to be compressed */
+	struct summary_counters failures;
+	/** The counters per compression profile */
+	struct summary_counters
+		profiles[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The counters per type of ROHC packet */
+	struct summary_counters pkt_types[ROHC_PACKET_MAX];
+};
+
+/** One PCAP file to summarize */
+struct summary_job
+{
+	const char *source;      /**< The name of the PCAP file */
+	struct summary summary;  /**< The summary for the PCAP file */
+	int status;              /**< 0 in case of success, 1 in case of failure */
+};
+
+/** The work shared by all the threads that generate summaries */
+struct summary_workers
+{
+	struct summary_job *jobs;    /**< The PCAP files to summarize */
+	size_t jobs_nr;              /**< The number of PCAP files to summarize */
+	size_t next_job;             /**< The next PCAP file to summarize */
+	rohc_cid_type_t cid_type;    /**< The type of CIDs for compressors */
+	unsigned int max_contexts;   /**< The maximum number of ROHC contexts */
+	size_t max_pkts_nr;          /**< The maximum number of packets per file */
+};
+
+
 /** Whether the application runs in verbose mode or not */
 static enum
 {
@@ -174,6 +275,54 @@ static bool rohc_comp_rtp_cb(const unsigned char *const ip,
 static bool detect_vlan_hdrs(const struct rohc_buf *const frame,
                              size_t *const link_len)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool extract_ip_packet(const unsigned long num_packet,
+                              const struct pcap_pkthdr header,
+                              size_t link_len,
+                              struct rohc_buf *const ip_packet)
+	__attribute__((warn_unused_result, nonnull(4)));
+
+static int generate_summary_all(const rohc_cid_type_t cid_type,
+                                const unsigned int max_contexts,
+                                const char *const sources[],
+                                const size_t sources_nr,
+                                const size_t threads_nr,
+                                const size_t max_pkts_nr)
+	__attribute__((warn_unused_result, nonnull(3)));
+static void * generate_summary_worker(void *const arg)
+	__attribute__((nonnull(1)));
+static int generate_summary_one(const struct summary_workers *const workers,
+                                struct summary_job *const job)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void summary_count_packet(struct summary_counters *const counters,
+                                 const rohc_comp_last_packet_info2_t *const info)
+	__attribute__((nonnull(1, 2)));
+static void summary_counters_add(struct summary_counters *const counters,
+                                 const struct summary_counters *const other)
+	__attribute__((nonnull(1, 2)));
+static void summary_add(struct summary *const summary,
+                        const struct summary *const other)
+	__attribute__((nonnull(1, 2)));
+static void summary_print(const char *const source,
+                          const struct summary *const summary)
+	__attribute__((nonnull(1, 2)));
+static void summary_print_counters(const char *const source,
+                                   const char *const kind,
+                                   const unsigned int id,
+                                   const char *const name,
+                                   const struct summary_counters *const counters)
+	__attribute__((nonnull(1, 2, 4, 5)));
+
+static bool pcap_reader_open(struct pcap_file_reader *const reader,
+                             const char *const source)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static int pcap_reader_next(struct pcap_file_reader *const reader,
+                            struct pcap_pkthdr *const header)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void pcap_reader_close(struct pcap_file_reader *const reader)
+	__attribute__((nonnull(1)));
+static uint32_t pcap_reader_get32(const struct pcap_file_reader *const reader,
+                                  const uint32_t value)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 
 /**
@@ -189,10 +338,12 @@ int main(int argc, char *argv[])
 {
 	char *test_type = NULL; /* the name of the test to perform */
 	char *cid_type_name = NULL;
-	char *source_descr = NULL;
+	const char **sources = NULL;
+	size_t sources_nr = 0;
 	int status = 1;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int max_pkts_nr = 0; /* 0 means all PCAP file or infinite for live capture */
+	int threads_nr = 0; /* 0 means one thread per online CPU */
 	size_t max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
 	rohc_cid_type_t cid_type = ROHC_SMALL_CID;
 	int args_used;
@@ -207,6 +358,14 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* the summary action accepts several sources */
+	sources = calloc(argc, sizeof(char *));
+	if(sources == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the list of sources\n");
+		goto error;
+	}
+
 	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
 	{
 		args_used = 1;
@@ -215,13 +374,13 @@ int main(int argc, char *argv[])
 		{
 			/* print help */
 			usage();
-			goto error;
+			goto free_sources;
 		}
 		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
 		{
 			/* print version */
 			printf("rohc_stats version %s\n", rohc_version());
-			goto error;
+			goto free_sources;
 		}
 		else if(!strcmp(*argv, "--verbose"))
 		{
@@ -240,7 +399,7 @@ int main(int argc, char *argv[])
 			{
 				fprintf(stderr, "missing mandatory --max-contexts parameter\n");
 				usage();
-				goto error;
+				goto free_sources;
 			}
 			max_contexts = atoi(argv[1]);
 			args_used++;
@@ -252,11 +411,23 @@ int main(int argc, char *argv[])
 			{
 				fprintf(stderr, "missing mandatory --max-pkts-nr parameter\n");
 				usage();
-				goto error;
+				goto free_sources;
 			}
 			max_pkts_nr = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--threads"))
+		{
+			/* get the number of threads the summary action should use */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --threads parameter\n");
+				usage();
+				goto free_sources;
+			}
+			threads_nr = atoi(argv[1]);
+			args_used++;
+		}
 		else if(test_type == NULL)
 		{
 			/* get the name of the test */
@@ -282,21 +453,16 @@ int main(int argc, char *argv[])
 				fprintf(stderr, "invalid CID type '%s', only 'smallcid' and "
 				        "'largecid' expected\n", cid_type_name);
 				usage();
-				goto error;
+				goto free_sources;
 			}
 		}
-		else if(source_descr == NULL)
+		else
 		{
 			/* get the source of packets: either the name of the file that contains
 			 * the packets to compress, or the name of the network device to
 			 * live capture packets from */
-			source_descr = argv[0];
-		}
-		else
-		{
-			/* do not accept more than one filename without option name */
-			usage();
-			goto error;
+			sources[sources_nr] = argv[0];
+			sources_nr++;
 		}
 	}
 
@@ -305,7 +471,7 @@ int main(int argc, char *argv[])
 	{
 		fprintf(stderr, "parameter TEST_TYPE is mandatory\n");
 		usage();
-		goto error;
+		goto free_sources;
 	}
 
 	/* check CID type */
@@ -313,7 +479,7 @@ int main(int argc, char *argv[])
 	{
 		fprintf(stderr, "parameter CID_TYPE is mandatory\n");
 		usage();
-		goto error;
+		goto free_sources;
 	}
 
 	/* the maximum number of ROHC contexts should be valid wrt CID type */
@@ -322,7 +488,7 @@ int main(int argc, char *argv[])
 		fprintf(stderr, "the maximum number of ROHC contexts should be "
 		        "between 1 and %zu\n\n", max_possible_contexts);
 		usage();
-		goto error;
+		goto free_sources;
 	}
 
 	/* handling a negative number of packets is not possible (0 is a value
@@ -333,41 +499,72 @@ int main(int argc, char *argv[])
 		fprintf(stderr, "the maximum number of packets should be "
 		        "between 0 and %d\n\n", INT_MAX);
 		usage();
-		goto error;
+		goto free_sources;
+	}
+
+	/* handling a negative number of threads is not possible (0 is a value
+	 * meaning one thread per online CPU) */
+	if(threads_nr < 0)
+	{
+		fprintf(stderr, "the number of threads should be between 0 and %d\n\n",
+		        INT_MAX);
+		usage();
+		goto free_sources;
+	}
+	else if(threads_nr == 0)
+	{
+		const long cpus_nr = sysconf(_SC_NPROCESSORS_ONLN);
+		threads_nr = (cpus_nr > 0 && cpus_nr <= INT_MAX) ? cpus_nr : 1;
 	}
 
 	/* the source is mandatory */
-	if(source_descr == NULL)
+	if(sources_nr == 0)
 	{
 		fprintf(stderr, "source is mandatory\n");
 		usage();
-		goto error;
+		goto free_sources;
+	}
+
+	/* only the summary action accepts several sources */
+	if(sources_nr > 1 && strcmp(test_type, "summary") != 0)
+	{
+		fprintf(stderr, "only the 'summary' action accepts several sources\n");
+		usage();
+		goto free_sources;
 	}
 
 	/* generate ROHC (de)compression statistics with the packets from the source */
 	if(strcmp(test_type, "dummy") == 0)
 	{
 		/* do nothing with the packets from the capture to estimate program overhead */
-		status = generate_dummy_stats_all(source_descr, max_pkts_nr);
+		status = generate_dummy_stats_all(sources[0], max_pkts_nr);
 	}
 	else if(strcmp(test_type, "comp") == 0)
 	{
 		/* test ROHC compression with the packets from the capture */
-		status = generate_comp_stats_all(cid_type, max_contexts, source_descr,
+		status = generate_comp_stats_all(cid_type, max_contexts, sources[0],
 		                                 max_pkts_nr);
 	}
 	else if(strcmp(test_type, "decomp") == 0)
 	{
 		/* test ROHC decompression with the packets from the capture */
-		status = generate_decomp_stats_all(cid_type, max_contexts, source_descr,
+		status = generate_decomp_stats_all(cid_type, max_contexts, sources[0],
 		                                   max_pkts_nr);
 	}
+	else if(strcmp(test_type, "summary") == 0)
+	{
+		/* summarize ROHC compression with the packets from the PCAP files */
+		status = generate_summary_all(cid_type, max_contexts, sources, sources_nr,
+		                              threads_nr, max_pkts_nr);
+	}
 	else
 	{
 		fprintf(stderr, "unexpected test type '%s'\n", test_type);
-		goto error;
+		goto free_sources;
 	}
 
+free_sources:
+	free(sources);
 error:
 	return status;
 }
@@ -398,7 +595,21 @@ static void usage(void)
 	       "The shell script rohc_stats.sh could be used to generate a HTML\n"
 	       "report.\n"
 	       "\n"
-	       "Usage: rohc_stats [OPTIONS] ACTION CID_TYPE SOURCE\n"
+	       "The 'summary' action compresses several PCAP files in parallel and\n"
+	       "outputs one compact summary in CSV format with the following\n"
+	       "comma-separated fields:\n\n"
+	       "  * name of the PCAP file ('*' for all the files)\n\n"
+	       "  * kind of counters among 'all', 'failures', 'profile' and\n"
+	       "    'packet_type'\n\n"
+	       "  * profile or packet type (numeric ID)\n\n"
+	       "  * profile or packet type (string)\n\n"
+	       "  * number of packets\n\n"
+	       "  * uncompressed packet sizes (bytes)\n\n"
+	       "  * uncompressed header sizes (bytes)\n\n"
+	       "  * compressed packet sizes (bytes)\n\n"
+	       "  * compressed header sizes (bytes)\n\n"
+	       "\n"
+	       "Usage: rohc_stats [OPTIONS] ACTION CID_TYPE SOURCE [SOURCE...]\n"
 	       "\n"
 	       "Options:\n"
 	       "  -v, --version           Print version information and exit\n"
@@ -410,21 +621,26 @@ static void usage(void)
 	       "      --max-pkts-nr NUM   The maximum number of packets to (de)compress\n"
 	       "                          (0 means all packets from file or infinite for\n"
 	       "                           network device)\n"
+	       "      --threads NUM       The number of threads for the 'summary'\n"
+	       "                          action (0 means one thread per CPU)\n"
 	       "\n"
 	       "With:\n"
 	       "  ACTION    Run a dummy test with 'dummy',\n"
-	       "            a compression test with 'comp', or\n"
-	       "            a decompression test with 'decomp'\n"
+	       "            a compression test with 'comp',\n"
+	       "            a decompression test with 'decomp', or\n"
+	       "            a compression summary with 'summary'\n"
 	       "  CID_TYPE  The type of CID to use among 'smallcid'\n"
 	       "            and 'largecid'\n"
 	       "  SOURCE    The source of of Ethernet frames to compress, ie:\n"
 	       "              - the name of a file in PCAP format\n"
 	       "              - the name of a network device\n"
+	       "            Several PCAP files may be given for the 'summary' action\n"
 	       "\n"
 	       "Examples:\n"
 	       "  rohc_stats comp smallcid /tmp/rtp.pcap  Generate statistics from a file\n"
 	       "  rohc_stats decomp largecid ~/lan.pcap   Generate statistics from a file\n"
 	       "  rohc_stats comp largecid eth0           Generate statistics from Ethernet device 'eth0'\n"
+	       "  rohc_stats summary largecid *.pcap      Summarize statistics from several files\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
@@ -845,49 +1061,12 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
 	rohc_comp_last_packet_info2_t last_packet_info;
 	rohc_status_t status;
 
-	/* check frame length */
-	if(header.len <= link_len || header.len != header.caplen)
+	/* skip the link layer header and the Ethernet padding */
+	if(!extract_ip_packet(num_packet, header, link_len, &ip_packet))
 	{
-		fprintf(stderr, "packet #%lu: bad PCAP packet (len = %u, caplen = %u)\n",
-		        num_packet, header.len, header.caplen);
 		goto error;
 	}
 
-	/* skip the link layer header (including VLAN headers) */
-	if(!detect_vlan_hdrs(&ip_packet, &link_len))
-	{
-		fprintf(stderr, "packet #%lu: malformed VLAN header\n", num_packet);
-		goto error;
-	}
-	rohc_buf_pull(&ip_packet, link_len);
-
-	/* check for padding after the IP packet in the Ethernet payload */
-	if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
-	{
-		uint8_t version;
-		uint16_t tot_len;
-
-		version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
-		if(version == 4)
-		{
-			const struct ipv4_hdr *const ip =
-				(struct ipv4_hdr *) rohc_buf_data(ip_packet);
-			tot_len = ntohs(ip->tot_len);
-		}
-		else
-		{
-			const struct ipv6_hdr *const ip =
-				(struct ipv6_hdr *) rohc_buf_data(ip_packet);
-			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
-		}
-
-		if(tot_len < ip_packet.len)
-		{
-			/* the Ethernet frame has some bytes of padding after the IP packet */
-			ip_packet.len = tot_len;
-		}
-	}
-
 	/* compress the IP packet */
 	status = rohc_compress4(comp, ip_packet, &rohc_packet);
 	if(status != ROHC_STATUS_OK)
@@ -1191,6 +1370,657 @@ error:
 }
 
 
+/**
+ * @brief Summarize ROHC compression with the packets from several PCAP files
+ *
+ * The PCAP files are shared among several threads. Every PCAP file is
+ * compressed with its own ROHC compressor, so the summaries do not depend
+ * on the number of threads. The statistics are aggregated in memory and
+ * only output once all the PCAP files are compressed.
+ *
+ * @param cid_type       The type of CIDs the compressors shall use
+ * @param max_contexts   The maximum number of ROHC contexts to use
+ * @param sources        The names of the PCAP files
+ * @param sources_nr     The number of PCAP files
+ * @param threads_nr     The maximum number of threads to use
+ * @param max_pkts_nr    The maximum number of packets to compress per file
+ * @return               0 in case of success,
+ *                       1 in case of failure
+ */
+static int generate_summary_all(const rohc_cid_type_t cid_type,
+                                const unsigned int max_contexts,
+                                const char *const sources[],
+                                const size_t sources_nr,
+                                const size_t threads_nr,
+                                const size_t max_pkts_nr)
+{
+	struct summary_workers workers;
+	struct summary *total;
+	pthread_t *threads;
+	size_t threads_started_nr;
+	size_t i;
+	int ret;
+
+	int is_failure = 1;
+
+	/* one job per PCAP file */
+	workers.jobs = calloc(sources_nr, sizeof(struct summary_job));
+	if(workers.jobs == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu PCAP files\n",
+		        sources_nr);
+		goto error;
+	}
+	for(i = 0; i < sources_nr; i++)
+	{
+		workers.jobs[i].source = sources[i];
+		workers.jobs[i].status = 1;
+	}
+	workers.jobs_nr = sources_nr;
+	workers.next_job = 0;
+	workers.cid_type = cid_type;
+	workers.max_contexts = max_contexts;
+	workers.max_pkts_nr = max_pkts_nr;
+
+	total = calloc(1, sizeof(struct summary));
+	if(total == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the summary\n");
+		goto free_jobs;
+	}
+
+	threads = calloc(threads_nr, sizeof(pthread_t));
+	if(threads == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu threads\n", threads_nr);
+		goto free_total;
+	}
+
+	/* initialize the random generator */
+	srand(time(NULL));
+
+	/* compress the PCAP files in parallel, no need for more threads than
+	 * PCAP files */
+	for(threads_started_nr = 0;
+	    threads_started_nr < threads_nr && threads_started_nr < sources_nr;
+	    threads_started_nr++)
+	{
+		ret = pthread_create(&threads[threads_started_nr], NULL,
+		                     generate_summary_worker, &workers);
+		if(ret != 0)
+		{
+			fprintf(stderr, "failed to create thread #%zu: %s (%d)\n",
+			        threads_started_nr + 1, strerror(ret), ret);
+			break;
+		}
+	}
+	if(threads_started_nr == 0)
+	{
+		goto free_threads;
+	}
+	for(i = 0; i < threads_started_nr; i++)
+	{
+		ret = pthread_join(threads[i], NULL);
+		assert(ret == 0);
+	}
+
+	/* output the summaries in the order of the PCAP files, then the summary
+	 * for all the PCAP files */
+	is_failure = 0;
+	printf("file,kind,id,name,packets,uncomp_bytes,uncomp_hdr_bytes,"
+	       "comp_bytes,comp_hdr_bytes\n");
+	for(i = 0; i < sources_nr; i++)
+	{
+		if(workers.jobs[i].status != 0)
+		{
+			fprintf(stderr, "failed to summarize PCAP file '%s'\n",
+			        workers.jobs[i].source);
+			is_failure = 1;
+			continue;
+		}
+		summary_print(workers.jobs[i].source, &workers.jobs[i].summary);
+		summary_add(total, &workers.jobs[i].summary);
+	}
+	summary_print("*", total);
+	fflush(stdout);
+
+free_threads:
+	free(threads);
+free_total:
+	free(total);
+free_jobs:
+	free(workers.jobs);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Summarize the PCAP files one after the other until all are done
+ *
+ * @param arg  The work shared by all the threads
+ * @return     Always NULL
+ */
+static void * generate_summary_worker(void *const arg)
+{
+	struct summary_workers *const workers = arg;
+	size_t job_id;
+
+	while((job_id = __atomic_fetch_add(&workers->next_job, 1,
+	                                   __ATOMIC_RELAXED)) < workers->jobs_nr)
+	{
+		struct summary_job *const job = &workers->jobs[job_id];
+		job->status = generate_summary_one(workers, job);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Summarize ROHC compression with the packets from one PCAP file
+ *
+ * Packets that cannot be parsed or compressed are counted as failures, they
+ * do not stop the compression of the PCAP file.
+ *
+ * @param workers  The work shared by all the threads
+ * @param job      The PCAP file to summarize
+ * @return         0 in case of success,
+ *                 1 in case of failure
+ */
+static int generate_summary_one(const struct summary_workers *const workers,
+                                struct summary_job *const job)
+{
+	struct summary *const summary = &job->summary;
+	struct pcap_file_reader reader;
+	struct rohc_comp *comp;
+	uint8_t *rohc_buffer;
+
+	unsigned long num_packet;
+	struct pcap_pkthdr header;
+	int ret = 0;
+
+	int is_failure = 1;
+
+	/* open the source PCAP file */
+	if(!pcap_reader_open(&reader, job->source))
+	{
+		goto error;
+	}
+
+	/* create the ROHC compressor */
+	comp = rohc_comp_new2(workers->cid_type, workers->max_contexts - 1,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "%s: cannot create the ROHC compressor\n", job->source);
+		goto close_input;
+	}
+
+	/* enable traces in verbose mode */
+	if(verbosity == VERBOSITY_FULL)
+	{
+		/* set the callback for traces on compressor */
+		if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+		{
+			fprintf(stderr, "%s: failed to set the callback for traces on "
+			        "compressor\n", job->source);
+			goto destroy_comp;
+		}
+	}
+
+	/* enable periodic refreshes based on inter-packet delay */
+	if(!rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES))
+	{
+		fprintf(stderr, "%s: failed to enable periodic refreshes of contexts "
+		        "based on inter-packet delay\n", job->source);
+		goto destroy_comp;
+	}
+
+	/* enable profiles */
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_ESP,
+	                              ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "%s: failed to enable the compression profiles\n",
+		        job->source);
+		goto destroy_comp;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		goto destroy_comp;
+	}
+
+	rohc_buffer = malloc(MAX_ROHC_SIZE);
+	if(rohc_buffer == NULL)
+	{
+		fprintf(stderr, "%s: failed to allocate memory for ROHC packets\n",
+		        job->source);
+		goto destroy_comp;
+	}
+
+	/* for each packet extracted from the PCAP file, up to max_pkts_nr
+	 * packets */
+	num_packet = 0;
+	while((workers->max_pkts_nr == 0 || num_packet < workers->max_pkts_nr) &&
+	      (ret = pcap_reader_next(&reader, &header)) > 0)
+	{
+		const struct rohc_ts arrival_time = {
+			.sec = header.ts.tv_sec,
+			.nsec = header.ts.tv_usec * 1000
+		};
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full(reader.packet, header.caplen, arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		rohc_comp_last_packet_info2_t last_packet_info;
+		unsigned int profile_major;
+		unsigned int profile_minor;
+		rohc_status_t status;
+
+		num_packet++;
+
+		/* skip the link layer header and the Ethernet padding */
+		if(!extract_ip_packet(num_packet, header, reader.link_len, &ip_packet))
+		{
+			summary->failures.packets_nr++;
+			summary->failures.uncomp_bytes_nr += header.caplen;
+			continue;
+		}
+
+		/* compress the IP packet */
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			if(verbosity == VERBOSITY_FULL)
+			{
+				fprintf(stderr, "%s: packet #%lu: compression failed\n",
+				        job->source, num_packet);
+			}
+			summary->failures.packets_nr++;
+			summary->failures.uncomp_bytes_nr += ip_packet.len;
+			continue;
+		}
+
+		/* get some statistics about the last compressed packet */
+		last_packet_info.version_major = 0;
+		last_packet_info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
+		{
+			fprintf(stderr, "%s: packet #%lu: cannot get stats about the last "
+			        "compressed packet\n", job->source, num_packet);
+			goto free_rohc_buffer;
+		}
+
+		/* aggregate them per profile and per packet type */
+		summary_count_packet(&summary->all, &last_packet_info);
+		profile_major = (last_packet_info.profile_id >> 8) & 0xff;
+		profile_minor = last_packet_info.profile_id & 0xff;
+		if(profile_major <= ROHC_PROFILE_ID_MAJOR_MAX &&
+		   profile_minor <= ROHC_PROFILE_ID_MINOR_MAX)
+		{
+			summary_count_packet(&summary->profiles[profile_major][profile_minor],
+			                     &last_packet_info);
+		}
+		if(last_packet_info.packet_type < ROHC_PACKET_MAX)
+		{
+			summary_count_packet(&summary->pkt_types[last_packet_info.packet_type],
+			                     &last_packet_info);
+		}
+	}
+	if(ret < 0)
+	{
+		goto free_rohc_buffer;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_rohc_buffer:
+	free(rohc_buffer);
+destroy_comp:
+	rohc_comp_free(comp);
+close_input:
+	pcap_reader_close(&reader);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Count one compressed packet in the given summary counters
+ *
+ * @param counters  The summary counters to update
+ * @param info      The information about the compressed packet
+ */
+static void summary_count_packet(struct summary_counters *const counters,
+                                 const rohc_comp_last_packet_info2_t *const info)
+{
+	counters->packets_nr++;
+	counters->uncomp_bytes_nr += info->total_last_uncomp_size;
+	counters->uncomp_hdr_bytes_nr += info->header_last_uncomp_size;
+	counters->comp_bytes_nr += info->total_last_comp_size;
+	counters->comp_hdr_bytes_nr += info->header_last_comp_size;
+}
+
+
+/**
+ * @brief Add the summary counters of one group of packets to another one
+ *
+ * @param counters  The summary counters to update
+ * @param other     The summary counters to add
+ */
+static void summary_counters_add(struct summary_counters *const counters,
+                                 const struct summary_counters *const other)
+{
+	counters->packets_nr += other->packets_nr;
+	counters->uncomp_bytes_nr += other->uncomp_bytes_nr;
+	counters->uncomp_hdr_bytes_nr += other->uncomp_hdr_bytes_nr;
+	counters->comp_bytes_nr += other->comp_bytes_nr;
+	counters->comp_hdr_bytes_nr += other->comp_hdr_bytes_nr;
+}
+
+
+/**
+ * @brief Add the summary of one PCAP file to another summary
+ *
+ * @param summary  The summary to update
+ * @param other    The summary to add
+ */
+static void summary_add(struct summary *const summary,
+                        const struct summary *const other)
+{
+	size_t i;
+	size_t j;
+
+	summary_counters_add(&summary->all, &other->all);
+	summary_counters_add(&summary->failures, &other->failures);
+	for(i = 0; i <= ROHC_PROFILE_ID_MAJOR_MAX; i++)
+	{
+		for(j = 0; j <= ROHC_PROFILE_ID_MINOR_MAX; j++)
+		{
+			summary_counters_add(&summary->profiles[i][j], &other->profiles[i][j]);
+		}
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		summary_counters_add(&summary->pkt_types[i], &other->pkt_types[i]);
+	}
+}
+
+
+/**
+ * @brief Output the summary of one or several PCAP files in CSV format
+ *
+ * Only the profiles and packet types that were used are output.
+ *
+ * @param source   The name of the PCAP file, '*' for all the PCAP files
+ * @param summary  The summary to output
+ */
+static void summary_print(const char *const source,
+                          const struct summary *const summary)
+{
+	size_t i;
+	size_t j;
+
+	summary_print_counters(source, "all", 0, "", &summary->all);
+	summary_print_counters(source, "failures", 0, "", &summary->failures);
+	for(i = 0; i <= ROHC_PROFILE_ID_MAJOR_MAX; i++)
+	{
+		for(j = 0; j <= ROHC_PROFILE_ID_MINOR_MAX; j++)
+		{
+			const rohc_profile_t profile = (i << 8) | j;
+
+			if(summary->profiles[i][j].packets_nr > 0)
+			{
+				summary_print_counters(source, "profile", profile,
+				                       rohc_get_profile_descr(profile),
+				                       &summary->profiles[i][j]);
+			}
+		}
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(summary->pkt_types[i].packets_nr > 0)
+		{
+			summary_print_counters(source, "packet_type", i,
+			                       rohc_get_packet_descr(i),
+			                       &summary->pkt_types[i]);
+		}
+	}
+}
+
+
+/**
+ * @brief Output one line of summary in CSV format
+ *
+ * @param source    The name of the PCAP file, '*' for all the PCAP files
+ * @param kind      The kind of counters
+ * @param id        The ID of the profile or packet type, 0 if none
+ * @param name      The name of the profile or packet type, empty if none
+ * @param counters  The summary counters to output
+ */
+static void summary_print_counters(const char *const source,
+                                   const char *const kind,
+                                   const unsigned int id,
+                                   const char *const name,
+                                   const struct summary_counters *const counters)
+{
+	printf("\"%s\",%s,%u,\"%s\",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+	       ",%" PRIu64 "\n", source, kind, id, name, counters->packets_nr,
+	       counters->uncomp_bytes_nr, counters->uncomp_hdr_bytes_nr,
+	       counters->comp_bytes_nr, counters->comp_hdr_bytes_nr);
+}
+
+
+/**
+ * @brief Open one PCAP file for buffered reads
+ *
+ * Both byte orders and both timestamp precisions of the PCAP file format are
+ * supported. The pcapng file format is not.
+ *
+ * @param reader  The PCAP reader to initialize
+ * @param source  The name of the PCAP file
+ * @return        true if the PCAP file is ready to be read, false otherwise
+ */
+static bool pcap_reader_open(struct pcap_file_reader *const reader,
+                             const char *const source)
+{
+	struct pcap_file_hdr file_hdr;
+	uint32_t linktype;
+
+	reader->source = source;
+	reader->packet = malloc(PCAP_READER_PKT_MAX_LEN);
+	if(reader->packet == NULL)
+	{
+		fprintf(stderr, "%s: failed to allocate memory for packets\n", source);
+		goto error;
+	}
+	reader->file_buf = malloc(PCAP_READER_BUF_LEN);
+	if(reader->file_buf == NULL)
+	{
+		fprintf(stderr, "%s: failed to allocate memory for reading\n", source);
+		goto free_packet;
+	}
+
+	/* read the file through the large buffer */
+	reader->file = fopen(source, "rb");
+	if(reader->file == NULL)
+	{
+		fprintf(stderr, "failed to open the source pcap file '%s': %s (%d)\n",
+		        source, strerror(errno), errno);
+		goto free_file_buf;
+	}
+	if(setvbuf(reader->file, reader->file_buf, _IOFBF, PCAP_READER_BUF_LEN) != 0)
+	{
+		fprintf(stderr, "%s: failed to set the buffer for reading\n", source);
+		goto close_file;
+	}
+
+	/* the magic number gives the byte order and the timestamp precision */
+	if(fread(&file_hdr, sizeof(struct pcap_file_hdr), 1, reader->file) != 1)
+	{
+		fprintf(stderr, "%s: truncated PCAP header\n", source);
+		goto close_file;
+	}
+	reader->is_swapped = false;
+	reader->is_nsec = false;
+	if(file_hdr.magic == PCAP_MAGIC_NSEC)
+	{
+		reader->is_nsec = true;
+	}
+	else if(file_hdr.magic != PCAP_MAGIC_USEC)
+	{
+		reader->is_swapped = true;
+		file_hdr.magic = pcap_reader_get32(reader, file_hdr.magic);
+		if(file_hdr.magic == PCAP_MAGIC_NSEC)
+		{
+			reader->is_nsec = true;
+		}
+		else if(file_hdr.magic != PCAP_MAGIC_USEC)
+		{
+			fprintf(stderr, "%s: not a file in PCAP format (pcapng is not "
+			        "supported)\n", source);
+			goto close_file;
+		}
+	}
+
+	/* determine the size of the link layer header */
+	linktype = pcap_reader_get32(reader, file_hdr.linktype);
+	if(linktype == PCAP_LINKTYPE_ETHERNET)
+	{
+		reader->link_len = ETHER_HDR_LEN;
+	}
+	else if(linktype == PCAP_LINKTYPE_LINUX_SLL)
+	{
+		reader->link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(linktype == PCAP_LINKTYPE_RAW || linktype == DLT_RAW)
+	{
+		reader->link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "%s: link layer type %u not supported in source PCAP "
+		        "file (supported = %u, %u, %u)\n", source, linktype,
+		        PCAP_LINKTYPE_ETHERNET, PCAP_LINKTYPE_LINUX_SLL,
+		        PCAP_LINKTYPE_RAW);
+		goto close_file;
+	}
+
+	return true;
+
+close_file:
+	fclose(reader->file);
+free_file_buf:
+	free(reader->file_buf);
+free_packet:
+	free(reader->packet);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Read the next packet from one PCAP file
+ *
+ * @param reader       The PCAP reader
+ * @param[out] header  The PCAP header for the packet, the packet itself is
+ *                     available in the buffer of the PCAP reader
+ * @return             1 if one packet was read,
+ *                     0 if the end of the PCAP file was reached (a truncated
+ *                       last packet is ignored as libpcap does),
+ *                     -1 in case of failure
+ */
+static int pcap_reader_next(struct pcap_file_reader *const reader,
+                            struct pcap_pkthdr *const header)
+{
+	struct pcap_record_hdr record_hdr;
+	size_t read_len;
+
+	read_len = fread(&record_hdr, 1, sizeof(struct pcap_record_hdr),
+	                 reader->file);
+	if(read_len == 0 && feof(reader->file))
+	{
+		return 0;
+	}
+	else if(read_len != sizeof(struct pcap_record_hdr))
+	{
+		goto truncated;
+	}
+
+	header->ts.tv_sec = pcap_reader_get32(reader, record_hdr.ts_sec);
+	header->ts.tv_usec = pcap_reader_get32(reader, record_hdr.ts_frac);
+	if(reader->is_nsec)
+	{
+		header->ts.tv_usec /= 1000;
+	}
+	header->caplen = pcap_reader_get32(reader, record_hdr.caplen);
+	header->len = pcap_reader_get32(reader, record_hdr.len);
+
+	if(header->caplen > PCAP_READER_PKT_MAX_LEN)
+	{
+		fprintf(stderr, "%s: PCAP record too large (caplen = %u)\n",
+		        reader->source, header->caplen);
+		return -1;
+	}
+	if(fread(reader->packet, 1, header->caplen, reader->file) != header->caplen)
+	{
+		goto truncated;
+	}
+
+	return 1;
+
+truncated:
+	if(ferror(reader->file))
+	{
+		fprintf(stderr, "%s: failed to read PCAP record\n", reader->source);
+		return -1;
+	}
+	fprintf(stderr, "%s: truncated PCAP record at the end of file, "
+	        "ignore it\n", reader->source);
+	return 0;
+}
+
+
+/**
+ * @brief Close one PCAP file and release the resources of its reader
+ *
+ * @param reader  The PCAP reader
+ */
+static void pcap_reader_close(struct pcap_file_reader *const reader)
+{
+	fclose(reader->file);
+	free(reader->file_buf);
+	free(reader->packet);
+}
+
+
+/**
+ * @brief Get one 32-bit field of one PCAP file in host byte order
+ *
+ * @param reader  The PCAP reader
+ * @param value   The 32-bit field as stored in the PCAP file
+ * @return        The 32-bit field in host byte order
+ */
+static uint32_t pcap_reader_get32(const struct pcap_file_reader *const reader,
+                                  const uint32_t value)
+{
+	if(!reader->is_swapped)
+	{
+		return value;
+	}
+
+	return (((value & 0x000000ffU) << 24) |
+	        ((value & 0x0000ff00U) <<  8) |
+	        ((value & 0x00ff0000U) >>  8) |
+	        ((value & 0xff000000U) >> 24));
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
@@ -1326,3 +2156,70 @@ error:
 	return false;
 }
 
+
+
+/**
+ * @brief Locate the IP packet within one captured frame
+ *
+ * Check the frame length, skip the link layer header (VLAN headers included)
+ * and remove the Ethernet padding that may follow the IP packet.
+ *
+ * @param num_packet      A number affected to the frame
+ * @param header          The PCAP header for the frame
+ * @param link_len        The length of the link layer header before IP data
+ * @param[in,out] ip_packet  in: the whole frame, out: the IP packet only
+ * @return                true if the IP packet was found, false otherwise
+ */
+static bool extract_ip_packet(const unsigned long num_packet,
+                              const struct pcap_pkthdr header,
+                              size_t link_len,
+                              struct rohc_buf *const ip_packet)
+{
+	/* check frame length */
+	if(header.len <= link_len || header.len != header.caplen)
+	{
+		fprintf(stderr, "packet #%lu: bad PCAP packet (len = %u, caplen = %u)\n",
+		        num_packet, header.len, header.caplen);
+		goto error;
+	}
+
+	/* skip the link layer header (including VLAN headers) */
+	if(!detect_vlan_hdrs(ip_packet, &link_len))
+	{
+		fprintf(stderr, "packet #%lu: malformed VLAN header\n", num_packet);
+		goto error;
+	}
+	rohc_buf_pull(ip_packet, link_len);
+
+	/* check for padding after the IP packet in the Ethernet payload */
+	if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+	{
+		uint8_t version;
+		uint16_t tot_len;
+
+		version = (rohc_buf_byte(*ip_packet) >> 4) & 0x0f;
+		if(version == 4)
+		{
+			const struct ipv4_hdr *const ip =
+				(struct ipv4_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = ntohs(ip->tot_len);
+		}
+		else
+		{
+			const struct ipv6_hdr *const ip =
+				(struct ipv6_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+		}
+
+		if(tot_len < ip_packet->len)
+		{
+			/* the Ethernet frame has some bytes of padding after the IP packet */
+			ip_packet->len = tot_len;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
@@ -83,7 +83,8 @@ if [ -e "/lib/modules/`uname -r`/build" ] ; then
 fi
 
 # run configure with failure on compiler warnings enabled since autogen.sh
-# is for developpers not users, also enable tests, stats, doc and examples.
+# is for developpers not users, also enable tests, stats, benchmark, doc and
+# examples.
 chmod +x ${NEW_PWD}/configure
 ${NEW_PWD}/configure \
 	--enable-rohc-debug \
@@ -91,6 +92,7 @@ ${NEW_PWD}/configure \
 	--enable-fortify-sources \
 	--enable-app-sniffer \
 	--enable-app-stats \
+	--enable-app-bench \
 	--enable-rohc-tests \
 	--enable-examples \
 	${add_opts} \
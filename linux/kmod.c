@@ -48,6 +48,7 @@ MODULE_DESCRIPTION(PACKAGE_NAME
 
 EXPORT_SYMBOL_GPL(rohc_version);
 EXPORT_SYMBOL_GPL(rohc_get_mode_descr);
+EXPORT_SYMBOL_GPL(rohc_stats_get_bucket_min);
 EXPORT_SYMBOL_GPL(rohc_get_profile_descr);
 EXPORT_SYMBOL_GPL(rohc_profile_is_rohcv1);
 EXPORT_SYMBOL_GPL(rohc_profile_is_rohcv2);
@@ -80,6 +81,8 @@ EXPORT_SYMBOL_GPL(rohc_buf_reset);
 EXPORT_SYMBOL_GPL(rohc_comp_new2);
 EXPORT_SYMBOL_GPL(rohc_comp_free);
 EXPORT_SYMBOL_GPL(rohc_compress4);
+EXPORT_SYMBOL_GPL(rohc_compress_burst);
+EXPORT_SYMBOL_GPL(rohc_compress_zero_copy);
 EXPORT_SYMBOL_GPL(rohc_comp_pad);
 EXPORT_SYMBOL_GPL(rohc_comp_force_contexts_reinit);
 
@@ -88,12 +91,23 @@ EXPORT_SYMBOL_GPL(rohc_comp_get_segment2);
 
 /* feedback */
 EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback2);
+EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedbacks);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_comp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_comp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_comp_get_stats);
 EXPORT_SYMBOL_GPL(rohc_comp_get_last_packet_info2);
 
+/* multi-core compression */
+EXPORT_SYMBOL_GPL(rohc_comp_shards_new);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_free);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_get_comp);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_enqueue);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_run);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_dequeue);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_deliver_feedback);
+
 /* configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_profile_enabled);
 EXPORT_SYMBOL_GPL(rohc_comp_enable_profile);
@@ -102,6 +116,7 @@ EXPORT_SYMBOL_GPL(rohc_comp_enable_profiles);
 EXPORT_SYMBOL_GPL(rohc_comp_disable_profiles);
 EXPORT_SYMBOL_GPL(rohc_comp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_comp_get_mrru);
+EXPORT_SYMBOL_GPL(rohc_comp_set_arena);
 EXPORT_SYMBOL_GPL(rohc_comp_get_max_cid);
 EXPORT_SYMBOL_GPL(rohc_comp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_comp_set_optimistic_approach);
@@ -109,10 +124,12 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_reorder_ratio);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_time);
 EXPORT_SYMBOL_GPL(rohc_comp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_traces_min_level);
 EXPORT_SYMBOL_GPL(rohc_comp_set_features);
 
 /* RTP-specific configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_heuristic);
 
 
 /*
@@ -123,10 +140,22 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
 EXPORT_SYMBOL_GPL(rohc_decomp_new2);
 EXPORT_SYMBOL_GPL(rohc_decomp_free);
 EXPORT_SYMBOL_GPL(rohc_decompress3);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst);
+EXPORT_SYMBOL_GPL(rohc_decompress_in_place);
+
+/* multi-core decompression */
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_new);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_free);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_get_decomp);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_set_feedback_pacing);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_enqueue);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_run);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_dequeue);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_decomp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_stats);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_context_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_last_packet_info);
 
@@ -140,10 +169,14 @@ EXPORT_SYMBOL_GPL(rohc_decomp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_max_cid);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_mrru);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_arena);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_rate_limits);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_feedback_pacing);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_feedback_pacing);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_min_level);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_features);
 
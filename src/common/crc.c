@@ -40,86 +40,65 @@
 #include "protocols/tcp.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 
+#if ROHC_CRC_PCLMUL
+#  include <wmmintrin.h>
+#  include <emmintrin.h>
+#endif
+
+
+#if ROHC_CRC_PCLMUL
+
 /**
- * @brief The pre-computed table for 32-bit Frame Check Sequence (FCS)
+ * @brief The constants for one CRC computed with the PCLMULQDQ instruction
  *
- *   x**0 + x**1 + x**2 + x**4 + x**5 +
- *   x**7 + x**8 + x**10 + x**11 + x**12 + x**16 +
- *   x**22 + x**23 + x**26 + x**32
- *
- * Copied from RFC 1662, appendix C.3
+ * Every constant is the remainder of the division of one power of x by the
+ * CRC polynomial, bit-reflected on 64 bits.
  */
-static const uint32_t crc_table_fcs32[256] =
+struct crc_pclmul_keys
+{
+	uint64_t x191;  /**< x^191 mod P, to fold the 1st half of one 128-bit block */
+	uint64_t x127;  /**< x^127 mod P, to fold the 2nd half of one 128-bit block */
+	uint64_t x63;   /**< x^63 mod P, to reduce the last 128-bit block to 96 bits */
+};
+
+/** The PCLMULQDQ constants for CRC-3: x^3 + x + 1 */
+static const struct crc_pclmul_keys crc_pclmul_keys_3 =
+{
+	.x191 = 0x2000000000000000ULL,
+	.x127 = 0x4000000000000000ULL,
+	.x63  = 0x8000000000000000ULL,
+};
+
+/** The PCLMULQDQ constants for CRC-7: x^7 + x^6 + x^3 + x^2 + x + 1 */
+static const struct crc_pclmul_keys crc_pclmul_keys_7 =
 {
-	0x00000000, 0x77073096, 0xee0e612c, 0x990951ba,
-	0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
-	0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
-	0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
-	0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de,
-	0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-	0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec,
-	0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
-	0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
-	0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
-	0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940,
-	0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-	0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116,
-	0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
-	0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
-	0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
-	0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a,
-	0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-	0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818,
-	0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
-	0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
-	0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
-	0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c,
-	0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-	0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2,
-	0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
-	0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
-	0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
-	0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086,
-	0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-	0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4,
-	0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
-	0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
-	0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
-	0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8,
-	0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-	0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe,
-	0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
-	0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
-	0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
-	0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252,
-	0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-	0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60,
-	0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
-	0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
-	0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
-	0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04,
-	0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-	0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a,
-	0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
-	0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
-	0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
-	0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e,
-	0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-	0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c,
-	0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
-	0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
-	0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
-	0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0,
-	0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-	0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6,
-	0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
-	0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
-	0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
+	.x191 = 0xb600000000000000ULL,
+	.x127 = 0x4000000000000000ULL,
+	.x63  = 0xf200000000000000ULL,
 };
 
+/** The PCLMULQDQ constants for CRC-8: x^8 + x^2 + x + 1 */
+static const struct crc_pclmul_keys crc_pclmul_keys_8 =
+{
+	.x191 = 0xc800000000000000ULL,
+	.x127 = 0x8000000000000000ULL,
+	.x63  = 0x5100000000000000ULL,
+};
+
+/** The PCLMULQDQ constants for the 32-bit Frame Check Sequence (FCS) */
+static const struct crc_pclmul_keys crc_pclmul_keys_fcs32 =
+{
+	.x191 = 0x65673b4600000000ULL,
+	.x127 = 0x9ba54c6f00000000ULL,
+	.x63  = 0xb8bc676500000000ULL,
+};
+
+#endif /* ROHC_CRC_PCLMUL */
+
 
 /**
  * Prototypes of private functions
@@ -134,6 +113,19 @@ static uint8_t ipv6_ext_calc_crc_dyn(const struct rohc_pkt_ip_hdr *const ip_hdr,
                                      const uint8_t init_val)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+#if ROHC_CRC_PCLMUL
+static bool crc_pclmul_is_supported(void)
+	__attribute__((warn_unused_result));
+static uint32_t crc_calc_pclmul(const struct crc_pclmul_keys *const keys,
+                                unsigned (*const crc_word)(unsigned crc,
+                                                           const void *mem,
+                                                           size_t len),
+                                const uint8_t *const buf,
+                                const size_t size,
+                                const uint32_t init_val)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+#endif
+
 
 
 /**
@@ -142,7 +134,11 @@ static uint8_t ipv6_ext_calc_crc_dyn(const struct rohc_pkt_ip_hdr *const ip_hdr,
 
 
 /**
- * @brief Optimized CRC FCS-32 calculation using a table
+ * @brief Optimized CRC FCS-32 calculation
+ *
+ * The CRC is computed 128 bits at a time with the PCLMULQDQ instruction if
+ * the data is long enough and the CPU supports it, 8 bytes at a time with
+ * tables otherwise.
  *
  * @param data      The data to compute the CRC for
  * @param length    The size of the data
@@ -153,15 +149,143 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
                         const size_t length,
                         const uint32_t init_val)
 {
-	uint32_t crc = init_val;
-	size_t i;
+#if ROHC_CRC_PCLMUL
+	if(length >= CRC_PCLMUL_MIN_LEN && crc_pclmul_is_supported())
+	{
+		return crc_calc_pclmul(&crc_pclmul_keys_fcs32, crc32fcs_word,
+		                       data, length, init_val);
+	}
+#endif
+	return crc32fcs_word(init_val, data, length);
+}
+
 
-	for(i = 0; i < length; i++)
+/**
+ * @brief Optimized CRC-8 calculation
+ *
+ * The CRC is computed 128 bits at a time with the PCLMULQDQ instruction if
+ * the data is long enough and the CPU supports it, 8 bytes at a time with
+ * tables otherwise.
+ *
+ * @param buf        The data to compute the CRC for
+ * @param size       The size of the data
+ * @param init_val   The initial CRC value
+ * @return           The CRC byte
+ */
+uint8_t crc_calc_8(const uint8_t *const buf,
+                   const size_t size,
+                   const uint8_t init_val)
+{
+#if ROHC_CRC_PCLMUL
+	if(size >= CRC_PCLMUL_MIN_LEN && crc_pclmul_is_supported())
 	{
-		crc = (crc >> 8) ^ crc_table_fcs32[(crc ^ data[i]) & 0xff];
+		return crc_calc_pclmul(&crc_pclmul_keys_8, crc8rohc_word,
+		                       buf, size, init_val);
 	}
+#endif
+	return crc8rohc_word(init_val, buf, size);
+}
 
-	return crc;
+
+/**
+ * @brief Optimized CRC-7 calculation
+ *
+ * The CRC is computed 128 bits at a time with the PCLMULQDQ instruction if
+ * the data is long enough and the CPU supports it, 8 bytes at a time with
+ * tables otherwise.
+ *
+ * @param buf        The data to compute the CRC for
+ * @param size       The size of the data
+ * @param init_val   The initial CRC value
+ * @return           The CRC byte
+ */
+uint8_t crc_calc_7(const uint8_t *const buf,
+                   const size_t size,
+                   const uint8_t init_val)
+{
+#if ROHC_CRC_PCLMUL
+	if(size >= CRC_PCLMUL_MIN_LEN && crc_pclmul_is_supported())
+	{
+		return crc_calc_pclmul(&crc_pclmul_keys_7, crc7rohc_word,
+		                       buf, size, init_val);
+	}
+#endif
+	return crc7rohc_word(init_val, buf, size);
+}
+
+
+/**
+ * @brief Optimized CRC-3 calculation
+ *
+ * The CRC is computed 128 bits at a time with the PCLMULQDQ instruction if
+ * the data is long enough and the CPU supports it, 8 bytes at a time with
+ * tables otherwise.
+ *
+ * @param buf        The data to compute the CRC for
+ * @param size       The size of the data
+ * @param init_val   The initial CRC value
+ * @return           The CRC byte
+ */
+uint8_t crc_calc_3(const uint8_t *const buf,
+                   const size_t size,
+                   const uint8_t init_val)
+{
+#if ROHC_CRC_PCLMUL
+	if(size >= CRC_PCLMUL_MIN_LEN && crc_pclmul_is_supported())
+	{
+		return crc_calc_pclmul(&crc_pclmul_keys_3, crc3rohc_word,
+		                       buf, size, init_val);
+	}
+#endif
+	return crc3rohc_word(init_val, buf, size);
+}
+
+
+/**
+ * @brief Compute the CRC-3 or CRC-7 of uncompressed headers with a cache
+ *
+ * If the cache holds headers of the same length with the same CRC type, only
+ * the 4-byte words that changed since are processed. Otherwise, the CRC is
+ * fully computed and the cache is filled with the new headers. Headers too
+ * large for the cache are not cached.
+ *
+ * @param cache     The CRC cache of the context
+ * @param crc_type  The CRC type, either ROHC_CRC_TYPE_3 or ROHC_CRC_TYPE_7
+ * @param data      The uncompressed headers
+ * @param length    The length of the uncompressed headers
+ * @return          The CRC of the uncompressed headers
+ */
+uint8_t crc_calc_cached(struct rohc_crc_cache *const cache,
+                        const rohc_crc_type_t crc_type,
+                        const uint8_t *const data,
+                        const size_t length)
+{
+	const uint8_t init_val = (crc_type == ROHC_CRC_TYPE_3 ? CRC_INIT_3 : CRC_INIT_7);
+
+	assert(crc_type == ROHC_CRC_TYPE_3 || crc_type == ROHC_CRC_TYPE_7);
+
+	if(length > ROHC_CRC_CACHE_MAX_LEN)
+	{
+		return crc_calculate(crc_type, data, length, init_val);
+	}
+
+	if(cache->crc_type != crc_type || cache->hdrs_len != length)
+	{
+		memcpy(cache->hdrs, data, length);
+		cache->hdrs_len = length;
+		cache->crc_type = crc_type;
+		cache->crc = crc_calculate(crc_type, data, length, init_val);
+	}
+	else if(crc_type == ROHC_CRC_TYPE_3)
+	{
+		cache->crc = crc3rohc_word_update(cache->crc, cache->hdrs, data, length);
+	}
+	else
+	{
+		cache->crc = crc7rohc_word_update(cache->crc, cache->hdrs, data, length);
+	}
+
+	return cache->crc;
 }
 
 
@@ -365,3 +489,79 @@ static uint8_t ipv6_ext_calc_crc_dyn(const struct rohc_pkt_ip_hdr *const ip_hdr
 	return init_val;
 }
 
+
+#if ROHC_CRC_PCLMUL
+
+/**
+ * @brief Whether the CPU supports the PCLMULQDQ instruction or not
+ *
+ * @return  true if the CPU supports PCLMULQDQ, false otherwise
+ */
+static bool crc_pclmul_is_supported(void)
+{
+	return !!__builtin_cpu_supports("pclmul");
+}
+
+
+/**
+ * @brief Compute a reflected CRC with the PCLMULQDQ instruction
+ *
+ * The data is folded 128 bits at a time with carry-less multiplications,
+ * then the last 128-bit block is reduced to 96 bits whose CRC is computed
+ * with tables, as well as the CRC of the remaining bytes. All the ROHC CRCs
+ * and the FCS-32 are reflected CRCs of 32 bits or less, so they share the
+ * same algorithm with different constants.
+ *
+ * @param keys      The constants of the CRC polynomial
+ * @param crc_word  The function that computes the CRC with tables
+ * @param buf       The data to compute the CRC for, at least 16 bytes
+ * @param size      The size of the data
+ * @param init_val  The initial CRC value
+ * @return          The CRC
+ */
+__attribute__((target("pclmul,sse2")))
+static uint32_t crc_calc_pclmul(const struct crc_pclmul_keys *const keys,
+                                unsigned (*const crc_word)(unsigned crc,
+                                                           const void *mem,
+                                                           size_t len),
+                                const uint8_t *const buf,
+                                const size_t size,
+                                const uint32_t init_val)
+{
+	const __m128i fold_keys = _mm_set_epi64x(keys->x127, keys->x191);
+	const __m128i reduce_key = _mm_set_epi64x(0, keys->x63);
+	uint8_t remainder[16];
+	__m128i block;
+	size_t pos;
+	unsigned crc;
+
+	assert(size >= 16);
+
+	/* the initial CRC value is XOR'ed with the first bytes of the data */
+	block = _mm_loadu_si128((const __m128i *) buf);
+	block = _mm_xor_si128(block, _mm_cvtsi32_si128(init_val));
+
+	/* fold every 128-bit block into the next one:
+	 *   block = block.lo * x^192 + block.hi * x^128 + next_block  (mod P) */
+	for(pos = 16; (size - pos) >= 16; pos += 16)
+	{
+		const __m128i next_block = _mm_loadu_si128((const __m128i *) (buf + pos));
+		const __m128i fold_lo = _mm_clmulepi64_si128(block, fold_keys, 0x00);
+		const __m128i fold_hi = _mm_clmulepi64_si128(block, fold_keys, 0x11);
+		block = _mm_xor_si128(_mm_xor_si128(fold_lo, fold_hi), next_block);
+	}
+
+	/* reduce the last block to 96 bits:
+	 *   remainder = block.lo * x^64 + block.hi  (mod P) */
+	block = _mm_xor_si128(_mm_clmulepi64_si128(block, reduce_key, 0x00),
+	                      _mm_unpackhi_epi64(_mm_setzero_si128(), block));
+	_mm_storeu_si128((__m128i *) remainder, block);
+
+	/* the first 32 bits of the remainder are always zero */
+	crc = crc_word(0, remainder + 4, 12);
+	crc = crc_word(crc, buf + pos, size - pos);
+
+	return crc;
+}
+
+#endif /* ROHC_CRC_PCLMUL */
@@ -52,6 +52,8 @@
  *
  * This is a modified version of the CRC-3/ROHC algorithm initially
  * generated by crcany from Mark Adler (https://github.com/madler/crcany).
+ * The CRC-7/ROHC, CRC-8/ROHC and FCS-32 algorithms use the same tables of
+ * 8 bytes at a time (slicing-by-8).
  */
 
 #ifndef ROHC_COMMON_CRCANY_H
@@ -63,6 +65,20 @@
 // Compute the CRC a word at a time.
 unsigned crc3rohc_word(unsigned crc, void const *mem, size_t len)
 	__attribute__((warn_unused_result, nonnull(2)));
+unsigned crc7rohc_word(unsigned crc, void const *mem, size_t len)
+	__attribute__((warn_unused_result, nonnull(2)));
+unsigned crc8rohc_word(unsigned crc, void const *mem, size_t len)
+	__attribute__((warn_unused_result, nonnull(2)));
+unsigned crc32fcs_word(unsigned crc, void const *mem, size_t len)
+	__attribute__((warn_unused_result, nonnull(2)));
+
+// Update the CRC of cached data with the words that changed in new data.
+unsigned crc3rohc_word_update(unsigned crc, void *cache, void const *mem,
+                              size_t len)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
+unsigned crc7rohc_word_update(unsigned crc, void *cache, void const *mem,
+                              size_t len)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
 
 #endif
 
@@ -30,6 +30,7 @@
 */
 
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 
 #if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
@@ -75,52 +76,43 @@
 	HALF_ROUND(v2,v1,v0,v3,17,21);
 
 
+/* words are read with memcpy() since neither the data to hash nor the key
+ * are aligned on 8 bytes, eg. the fingerprint keys of compression contexts */
 uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16]) {
-	const uint64_t *_key = (uint64_t *)key;
-	uint64_t k0 = _le64toh(_key[0]);
-	uint64_t k1 = _le64toh(_key[1]);
+	uint64_t k0;
+	uint64_t k1;
 	uint64_t b = (uint64_t)src_sz << 56;
-	const uint64_t *in = (uint64_t*)src;
-
-	uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
-	uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
-	uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
-	uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+	const uint8_t *in = (const uint8_t *)src;
+
+	uint64_t v0;
+	uint64_t v1;
+	uint64_t v2;
+	uint64_t v3;
+
+	memcpy(&k0, key, sizeof(uint64_t));
+	memcpy(&k1, key + sizeof(uint64_t), sizeof(uint64_t));
+	k0 = _le64toh(k0);
+	k1 = _le64toh(k1);
+	v0 = k0 ^ 0x736f6d6570736575ULL;
+	v1 = k1 ^ 0x646f72616e646f6dULL;
+	v2 = k0 ^ 0x6c7967656e657261ULL;
+	v3 = k1 ^ 0x7465646279746573ULL;
 
 	while (src_sz >= 8) {
-		uint64_t mi = _le64toh(*in);
-		in += 1; src_sz -= 8;
+		uint64_t mi;
+		memcpy(&mi, in, sizeof(uint64_t));
+		mi = _le64toh(mi);
+		in += 8; src_sz -= 8;
 		v3 ^= mi;
 		DOUBLE_ROUND(v0,v1,v2,v3);
 		v0 ^= mi;
 	}
 
 	{
-		uint64_t t = 0; uint8_t *pt = (uint8_t *)&t; uint8_t *m = (uint8_t *)in;
-		if (src_sz == 7) {
-			pt[6] = m[6];
-			pt[5] = m[5];
-			pt[4] = m[4];
-			*((uint32_t*)&pt[0]) = *((uint32_t*)&m[0]);
-		} else if (src_sz == 6) {
-			pt[5] = m[5];
-			pt[4] = m[4];
-			*((uint32_t*)&pt[0]) = *((uint32_t*)&m[0]);
-		} else if (src_sz == 5) {
-			pt[4] = m[4];
-			*((uint32_t*)&pt[0]) = *((uint32_t*)&m[0]);
-		} else if (src_sz == 4) {
-			*((uint32_t*)&pt[0]) = *((uint32_t*)&m[0]);
-		} else if (src_sz == 3) {
-			pt[2] = m[2];
-			pt[1] = m[1];
-			pt[0] = m[0];
-		} else if (src_sz == 2) {
-			pt[1] = m[1];
-			pt[0] = m[0];
-		} else if (src_sz == 1) {
-			pt[0] = m[0];
-		}
+		/* the remaining bytes are the least significant ones of the last
+		 * little-endian word */
+		uint64_t t = 0;
+		memcpy(&t, in, src_sz);
 		b |= _le64toh(t);
 	}
 
@@ -31,104 +31,597 @@
 #include <assert.h>
 
 
+/** The index of the slots of the old table that were moved or removed */
+#define HASHTABLE_DELETED_IDX  (UINT32_MAX - 1)
+
+/** The number of slots of the table when it is created */
+#define HASHTABLE_MIN_SLOTS  64U
+
+/** The number of slots of the old table moved at every add or removal */
+#define HASHTABLE_RESIZE_STEP  8U
+
+
+static inline uint32_t hashtable_hash(const struct hashtable *const hashtable,
+                                      const void *const key)
+	__attribute__((warn_unused_result, nonnull(1, 2), always_inline));
+
+static uint64_t hashtable_fast_hash(const void *const key,
+                                    const size_t key_len,
+                                    const char seed[16])
+	__attribute__((warn_unused_result, nonnull(1, 3), pure));
+
+static inline size_t hashtable_key_len(const struct hashtable *const hashtable,
+                                       const uint8_t *const key)
+	__attribute__((warn_unused_result, nonnull(1, 2), always_inline));
+
+static inline const uint8_t * hashtable_key(const struct hashtable *const hashtable,
+                                            const uint32_t idx)
+	__attribute__((warn_unused_result, nonnull(1), always_inline));
+
+static void hashtable_insert(struct hashtable_slot *const slots,
+                             const uint32_t mask,
+                             const struct hashtable_slot slot)
+	__attribute__((nonnull(1)));
+
+static void hashtable_resize_step(struct hashtable *const hashtable,
+                                  const uint32_t slots_nr)
+	__attribute__((nonnull(1)));
+
+static uint32_t hashtable_search(const struct hashtable *const hashtable,
+                                 const void *const key,
+                                 struct hashtable_iter *const iter,
+                                 uint32_t pos)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+
+/**
+ * @brief Create a new hash table
+ *
+ * The hash table does not store the keys: the key of the element with index
+ * i is read at \e keys + i * \e key_stride, so the elements shall not move
+ * and their keys shall not change while they are in the hash table.
+ *
+ * The random key of the hash function shall be set in \e hashtable->key
+ * before the hash table is created.
+ *
+ * @param hashtable       The hash table to create
+ * @param key_len         The length of the keys, the maximum length of the
+ *                        keys if they are of variable length
+ * @param is_key_len_var  Whether the keys are of variable length, with their
+ *                        length in their first byte
+ * @param keys            The key of the element with index 0
+ * @param key_stride      The distance between the keys of 2 consecutive
+ *                        elements
+ * @param max_elems       The maximum number of elements in the hash table
+ * @return                true if the hash table was created, false otherwise
+ */
 bool hashtable_new(struct hashtable *const hashtable,
                    const size_t key_len,
-                   const size_t size)
+                   const bool is_key_len_var,
+                   const void *const keys,
+                   const size_t key_stride,
+                   const size_t max_elems)
 {
+	uint32_t max_slots_nr = HASHTABLE_MIN_SLOTS;
+	uint32_t slots_nr;
+	uint32_t i;
+
+	assert(max_elems > 0);
+	assert(max_elems < (HASHTABLE_DELETED_IDX / 2));
+
 	hashtable->key_len = key_len;
-	hashtable->full_key_len = key_len;
-	hashtable->mask = size - 1;
+	hashtable->is_key_len_var = is_key_len_var;
+	hashtable->keys = keys;
+	hashtable->key_stride = key_stride;
+	hashtable->hash = HASHTABLE_HASH_SIPHASH;
+
+	/* at most half of the slots of the largest table are in use */
+	while(max_slots_nr < (max_elems * 2))
+	{
+		max_slots_nr <<= 1;
+	}
+	slots_nr = HASHTABLE_MIN_SLOTS;
+	hashtable->max_mask = max_slots_nr - 1;
 
-	hashtable->table = calloc(size, sizeof(struct hashlist *));
-	if(hashtable->table == NULL)
+	hashtable->slots = malloc(slots_nr * sizeof(struct hashtable_slot));
+	if(hashtable->slots == NULL)
 	{
 		return false;
 	}
+	for(i = 0; i < slots_nr; i++)
+	{
+		hashtable->slots[i].idx = HASHTABLE_NO_IDX;
+	}
+	hashtable->mask = slots_nr - 1;
+	hashtable->elems_nr = 0;
+	hashtable->old_slots = NULL;
+	hashtable->old_mask = 0;
+	hashtable->old_pos = 0;
 
 	return true;
 }
 
 
+/**
+ * @brief Destroy the given hash table
+ *
+ * @param hashtable  The hash table to destroy
+ */
 void hashtable_free(struct hashtable *const hashtable)
 {
-	free(hashtable->table);
+	free(hashtable->old_slots);
+	free(hashtable->slots);
 }
 
 
-void hashtable_add(struct hashtable *const hashtable,
-                   const void *const key,
-                   void *const elem)
+/**
+ * @brief Change the keyed hash function of the hash table
+ *
+ * The elements already in the hash table are moved to the slots given by the
+ * new hash function.
+ *
+ * @param hashtable  The hash table
+ * @param hash       The new keyed hash function
+ * @return           true if the hash function was changed,
+ *                   false in case of memory shortage
+ */
+bool hashtable_set_hash(struct hashtable *const hashtable,
+                        const hashtable_hash_t hash)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	struct hashtable_slot *slots;
+	uint32_t i;
+
+	if(hashtable->hash == hash)
+	{
+		return true;
+	}
 
-	entry = hashtable->table[hash & hashtable->mask];
-	if(entry == NULL)
+	slots = malloc((hashtable->mask + 1) * sizeof(struct hashtable_slot));
+	if(slots == NULL)
 	{
-		hashtable->table[hash & hashtable->mask] = elem;
-		((struct hashlist *) elem)->prev = NULL;
+		return false;
 	}
-	else
+	for(i = 0; i <= hashtable->mask; i++)
 	{
-		while(entry->next != NULL)
+		slots[i].idx = HASHTABLE_NO_IDX;
+	}
+
+	/* end the resize in progress if any, then hash all the elements again */
+	hashtable_resize_step(hashtable, hashtable->old_mask + 1);
+	hashtable->hash = hash;
+	for(i = 0; i <= hashtable->mask; i++)
+	{
+		if(hashtable->slots[i].idx != HASHTABLE_NO_IDX)
 		{
-			entry = entry->next;
+			const uint32_t idx = hashtable->slots[i].idx;
+			const struct hashtable_slot slot = {
+				.hash = hashtable_hash(hashtable, hashtable_key(hashtable, idx)),
+				.idx = idx,
+			};
+			hashtable_insert(slots, hashtable->mask, slot);
 		}
-		entry->next = elem;
-		((struct hashlist *) elem)->prev = entry;
 	}
-	((struct hashlist *) elem)->next = NULL;
+	free(hashtable->slots);
+	hashtable->slots = slots;
+
+	return true;
 }
 
 
-void * hashtable_get(const struct hashtable *const hashtable,
-                     const void *const key)
+/**
+ * @brief Add one element in the hash table
+ *
+ * Adding an element that is already in the hash table does nothing.
+ *
+ * @param hashtable  The hash table
+ * @param idx        The index of the element to add
+ * @return           true if the element was added,
+ *                   false in case of memory shortage
+ */
+bool hashtable_add(struct hashtable *const hashtable,
+                   const uint32_t idx)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	const uint8_t *const key = hashtable_key(hashtable, idx);
+	struct hashtable_iter iter;
+	uint32_t found_idx;
+	struct hashtable_slot slot;
+
+	assert(idx < HASHTABLE_DELETED_IDX);
 
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next)
+	hashtable_resize_step(hashtable, HASHTABLE_RESIZE_STEP);
+
+	/* nothing to do if the element is already in the table */
+	for(found_idx = hashtable_get_first(hashtable, key, &iter);
+	    found_idx != HASHTABLE_NO_IDX;
+	    found_idx = hashtable_get_next(hashtable, key, &iter))
 	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
+		if(found_idx == idx)
 		{
-			break;
+			return true;
 		}
 	}
 
-	return entry;
+	/* start a larger table once half of the slots are in use ; keep going
+	 * with the current table if no memory is available for the new one */
+	if(((hashtable->elems_nr + 1) * 2) > (hashtable->mask + 1) &&
+	   hashtable->old_slots == NULL &&
+	   hashtable->mask < hashtable->max_mask)
+	{
+		const uint32_t slots_nr = (hashtable->mask + 1) * 2;
+		struct hashtable_slot *const slots =
+			malloc(slots_nr * sizeof(struct hashtable_slot));
+
+		if(slots != NULL)
+		{
+			uint32_t i;
+
+			for(i = 0; i < slots_nr; i++)
+			{
+				slots[i].idx = HASHTABLE_NO_IDX;
+			}
+			hashtable->old_slots = hashtable->slots;
+			hashtable->old_mask = hashtable->mask;
+			hashtable->old_pos = 0;
+			hashtable->slots = slots;
+			hashtable->mask = slots_nr - 1;
+		}
+	}
+
+	/* always keep one unused slot to stop the probing */
+	if((hashtable->elems_nr + 1) > hashtable->mask)
+	{
+		return false;
+	}
+
+	slot.hash = iter.hash;
+	slot.idx = idx;
+	hashtable_insert(hashtable->slots, hashtable->mask, slot);
+	hashtable->elems_nr++;
+
+	return true;
+}
+
+
+/**
+ * @brief Get the element that matches the given key
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @return           The index of the element, HASHTABLE_NO_IDX if not found
+ */
+uint32_t hashtable_get(const struct hashtable *const hashtable,
+                       const void *const key)
+{
+	struct hashtable_iter iter;
+	return hashtable_get_first(hashtable, key, &iter);
+}
+
+
+/**
+ * @brief Get the first element that matches the given key
+ *
+ * The search may be continued with \ref hashtable_get_next as long as no
+ * element is added to or removed from the hash table.
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @param[out] iter  The position of the search
+ * @return           The index of the element, HASHTABLE_NO_IDX if not found
+ */
+uint32_t hashtable_get_first(const struct hashtable *const hashtable,
+                             const void *const key,
+                             struct hashtable_iter *const iter)
+{
+	iter->hash = hashtable_hash(hashtable, key);
+	iter->in_old = false;
+	return hashtable_search(hashtable, key, iter, iter->hash & hashtable->mask);
 }
 
 
+/**
+ * @brief Get the next element that matches the given key
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @param iter       The position of the search
+ * @return           The index of the element, HASHTABLE_NO_IDX if no more
+ *                   element matches the key
+ */
+uint32_t hashtable_get_next(const struct hashtable *const hashtable,
+                            const void *const key,
+                            struct hashtable_iter *const iter)
+{
+	const uint32_t mask = (iter->in_old ? hashtable->old_mask : hashtable->mask);
+	return hashtable_search(hashtable, key, iter, (iter->pos + 1) & mask);
+}
+
+
+/**
+ * @brief Remove one element from the hash table
+ *
+ * Removing an element that is not in the hash table does nothing.
+ *
+ * @param hashtable  The hash table
+ * @param idx        The index of the element to remove
+ */
 void hashtable_del(struct hashtable *const hashtable,
-                   const void *const key)
+                   const uint32_t idx)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	const uint32_t hash = hashtable_hash(hashtable, hashtable_key(hashtable, idx));
+	struct hashtable_slot *const slots = hashtable->slots;
+	const uint32_t mask = hashtable->mask;
+	uint32_t pos;
+
+	hashtable_resize_step(hashtable, HASHTABLE_RESIZE_STEP);
 
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next)
+	/* search the element in the current table, then remove it and move back
+	 * the next elements of the same run that may fill the unused slot */
+	for(pos = hash & mask; slots[pos].idx != HASHTABLE_NO_IDX; pos = (pos + 1) & mask)
 	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
+		if(slots[pos].idx == idx)
 		{
-			if(entry->prev == NULL)
+			uint32_t next_pos = pos;
+
+			slots[pos].idx = HASHTABLE_NO_IDX;
+			while(slots[(next_pos = (next_pos + 1) & mask)].idx != HASHTABLE_NO_IDX)
 			{
-				hashtable->table[hash & hashtable->mask] = entry->next;
+				const uint32_t home = slots[next_pos].hash & mask;
+				const bool is_home_between = (pos <= next_pos) ?
+					(pos < home && home <= next_pos) :
+					(pos < home || home <= next_pos);
+
+				if(!is_home_between)
+				{
+					slots[pos] = slots[next_pos];
+					slots[next_pos].idx = HASHTABLE_NO_IDX;
+					pos = next_pos;
+				}
 			}
-			else
+			hashtable->elems_nr--;
+			return;
+		}
+	}
+
+	/* search the element in the old table, where it is only marked as deleted
+	 * not to break the runs that are not moved to the new table yet */
+	if(hashtable->old_slots != NULL)
+	{
+		struct hashtable_slot *const old_slots = hashtable->old_slots;
+		const uint32_t old_mask = hashtable->old_mask;
+
+		for(pos = hash & old_mask;
+		    old_slots[pos].idx != HASHTABLE_NO_IDX;
+		    pos = (pos + 1) & old_mask)
+		{
+			if(old_slots[pos].idx == idx)
 			{
-				entry->prev->next = entry->next;
+				old_slots[pos].idx = HASHTABLE_DELETED_IDX;
+				hashtable->elems_nr--;
+				return;
 			}
+		}
+	}
+}
+
+
+/**
+ * @brief Search the next element that matches the given key
+ *
+ * The current table is searched first, then the old table if a resize is in
+ * progress.
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @param iter       The position of the search
+ * @param pos        The first slot to check
+ * @return           The index of the element, HASHTABLE_NO_IDX if not found
+ */
+static uint32_t hashtable_search(const struct hashtable *const hashtable,
+                                 const void *const key,
+                                 struct hashtable_iter *const iter,
+                                 uint32_t pos)
+{
+	if(!iter->in_old)
+	{
+		const struct hashtable_slot *const slots = hashtable->slots;
+
+		for( ; slots[pos].idx != HASHTABLE_NO_IDX; pos = (pos + 1) & hashtable->mask)
+		{
+			if(slots[pos].hash == iter->hash &&
+			   memcmp(key, hashtable_key(hashtable, slots[pos].idx),
+			          hashtable_key_len(hashtable, key)) == 0)
+			{
+				iter->pos = pos;
+				return slots[pos].idx;
+			}
+		}
+		if(hashtable->old_slots == NULL)
+		{
+			return HASHTABLE_NO_IDX;
+		}
+		iter->in_old = true;
+		pos = iter->hash & hashtable->old_mask;
+	}
+
+	{
+		const struct hashtable_slot *const old_slots = hashtable->old_slots;
 
-			if(entry->next != NULL)
+		for( ; old_slots[pos].idx != HASHTABLE_NO_IDX;
+		    pos = (pos + 1) & hashtable->old_mask)
+		{
+			if(old_slots[pos].idx != HASHTABLE_DELETED_IDX &&
+			   old_slots[pos].hash == iter->hash &&
+			   memcmp(key, hashtable_key(hashtable, old_slots[pos].idx),
+			          hashtable_key_len(hashtable, key)) == 0)
 			{
-				entry->next->prev = entry->prev;
+				iter->pos = pos;
+				return old_slots[pos].idx;
 			}
+		}
+	}
+
+	return HASHTABLE_NO_IDX;
+}
 
-			break;
+
+/**
+ * @brief Move some slots of the old table to the new table
+ *
+ * The old table is released once all its slots are moved.
+ *
+ * @param hashtable  The hash table
+ * @param slots_nr   The maximum number of slots to move
+ */
+static void hashtable_resize_step(struct hashtable *const hashtable,
+                                  const uint32_t slots_nr)
+{
+	uint32_t i;
+
+	for(i = 0; hashtable->old_slots != NULL && i < slots_nr; i++)
+	{
+		struct hashtable_slot *const slot =
+			&(hashtable->old_slots[hashtable->old_pos]);
+
+		if(slot->idx < HASHTABLE_DELETED_IDX)
+		{
+			hashtable_insert(hashtable->slots, hashtable->mask, *slot);
+			slot->idx = HASHTABLE_DELETED_IDX;
+		}
+		hashtable->old_pos++;
+		if(hashtable->old_pos > hashtable->old_mask)
+		{
+			free(hashtable->old_slots);
+			hashtable->old_slots = NULL;
 		}
 	}
 }
 
+
+/**
+ * @brief Store one element in the first unused slot of its run
+ *
+ * @param slots  The slots of the table
+ * @param mask   The number of slots minus one
+ * @param slot   The hash and index of the element
+ */
+static void hashtable_insert(struct hashtable_slot *const slots,
+                             const uint32_t mask,
+                             const struct hashtable_slot slot)
+{
+	uint32_t pos;
+
+	for(pos = slot.hash & mask; slots[pos].idx != HASHTABLE_NO_IDX; pos = (pos + 1) & mask)
+	{
+	}
+	slots[pos] = slot;
+}
+
+
+/**
+ * @brief Get the key of the element with the given index
+ *
+ * @param hashtable  The hash table
+ * @param idx        The index of the element
+ * @return           The key of the element
+ */
+static inline const uint8_t * hashtable_key(const struct hashtable *const hashtable,
+                                            const uint32_t idx)
+{
+	return hashtable->keys + ((size_t) idx) * hashtable->key_stride;
+}
+
+
+/**
+ * @brief Compute the keyed hash of the given key
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to hash
+ * @return           The hash of the key
+ */
+static inline uint32_t hashtable_hash(const struct hashtable *const hashtable,
+                                      const void *const key)
+{
+	const size_t key_len = hashtable_key_len(hashtable, key);
+
+	if(hashtable->hash == HASHTABLE_HASH_FAST)
+	{
+		return hashtable_fast_hash(key, key_len, hashtable->key);
+	}
+	return siphash24(key, key_len, hashtable->key);
+}
+
+
+/**
+ * @brief Get the length of the given key
+ *
+ * @param hashtable  The hash table
+ * @param key        The key
+ * @return           The length of the key
+ */
+static inline size_t hashtable_key_len(const struct hashtable *const hashtable,
+                                       const uint8_t *const key)
+{
+	if(hashtable->is_key_len_var)
+	{
+		assert(key[0] > 0 && key[0] <= hashtable->key_len);
+		return key[0];
+	}
+	return hashtable->key_len;
+}
+
+
+/**
+ * @brief Compute a fast keyed hash of the given key
+ *
+ * The key is mixed 8 bytes at a time with one multiplication and one
+ * xorshift, then the result goes through the MurmurHash3 finalizer. The seed
+ * makes the hash differ from one hash table to another, but the hash is not
+ * strong enough to resist hash flooding by hostile traffic: SipHash shall be
+ * used in that case.
+ *
+ * @param key      The key to hash
+ * @param key_len  The length of the key
+ * @param seed     The random seed of the hash table
+ * @return         The hash of the key
+ */
+static uint64_t hashtable_fast_hash(const void *const key,
+                                    const size_t key_len,
+                                    const char seed[16])
+{
+	const uint64_t mul = 0x9e3779b97f4a7c15ULL;
+	const uint8_t *data = key;
+	size_t remain_len = key_len;
+	uint64_t seed0;
+	uint64_t seed1;
+	uint64_t hash;
+	uint64_t word;
+
+	memcpy(&seed0, seed, sizeof(uint64_t));
+	memcpy(&seed1, seed + sizeof(uint64_t), sizeof(uint64_t));
+	hash = seed0 ^ (key_len * mul);
+
+	while(remain_len >= sizeof(uint64_t))
+	{
+		memcpy(&word, data, sizeof(uint64_t));
+		hash = (hash ^ word) * mul;
+		hash ^= hash >> 29;
+		data += sizeof(uint64_t);
+		remain_len -= sizeof(uint64_t);
+	}
+	if(remain_len > 0)
+	{
+		word = 0;
+		memcpy(&word, data, remain_len);
+		hash = (hash ^ word) * mul;
+		hash ^= hash >> 29;
+	}
+
+	hash ^= seed1;
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
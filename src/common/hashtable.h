@@ -20,6 +20,23 @@
  * @file   hashtable.h
  * @brief  Efficient, secure hash table
  * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The hash table finds the elements of one array by their key. It uses open
+ * addressing with linear probing: every slot stores the 32-bit hash of the
+ * key and the index of the element in the array, so that probing does not
+ * read the elements themselves until the hashes match. Several elements may
+ * share the same key: they are then found one after the other with
+ * \ref hashtable_get_first and \ref hashtable_get_next.
+ *
+ * Keys are either all of the same length, or of variable length: the first
+ * byte of every key is then the length of the key, that byte included. Only
+ * the bytes of the key are then hashed and compared.
+ *
+ * The table starts small and doubles in size when half of its slots are in
+ * use, up to twice the maximum number of elements. The elements of the old
+ * table are moved to the new table a few slots at a time every time an
+ * element is added or removed, so that no single operation pays for the
+ * whole resize.
  */
 
 #ifndef ROHC_HASHTABLE_H
@@ -30,48 +47,96 @@
 #include <stdint.h>
 
 
-/** A linked list */
-struct hashlist
+/** The index returned when no element matches the key */
+#define HASHTABLE_NO_IDX  UINT32_MAX
+
+
+/** The keyed hash functions available for one hash table */
+typedef enum
+{
+	/** SipHash-2-4, resistant to hash flooding by hostile traffic */
+	HASHTABLE_HASH_SIPHASH = 0,
+	/** Faster multiply/xorshift hash, not resistant to hash flooding */
+	HASHTABLE_HASH_FAST    = 1,
+} hashtable_hash_t;
+
+
+/** One slot of the hash table */
+struct hashtable_slot
 {
-	struct hashlist *prev;
-	struct hashlist *next;
-	struct hashlist *prev_cr;
-	struct hashlist *next_cr;
-	uint8_t key[];
-} __attribute__((packed));
+	uint32_t hash; /**< The hash of the key of the element */
+	uint32_t idx;  /**< The index of the element, HASHTABLE_NO_IDX if unused */
+};
 
 
 /** One hash table */
 struct hashtable
 {
-	size_t key_len;
-	size_t full_key_len;
-	uint64_t mask;
-	struct hashlist **table;
-	char key[16];
+	size_t key_len;            /**< The length of the keys */
+	bool is_key_len_var;       /**< Whether the first byte of keys is their length */
+	const uint8_t *keys;       /**< The key of the first element */
+	size_t key_stride;         /**< The distance between 2 consecutive keys */
+
+	struct hashtable_slot *slots; /**< The slots of the table */
+	uint32_t mask;                /**< The number of slots minus one */
+	uint32_t max_mask;            /**< The mask of the largest table */
+	uint32_t elems_nr;            /**< The number of elements in the table */
+
+	/** The slots of the previous table during a resize, NULL otherwise */
+	struct hashtable_slot *old_slots;
+	uint32_t old_mask;         /**< The number of slots minus one */
+	uint32_t old_pos;          /**< The next slot to move to the new table */
+
+	char key[16];              /**< The random key of the hash function */
+	hashtable_hash_t hash;     /**< The keyed hash function of the table */
+};
+
+
+/** The position of one search for the elements that match one key */
+struct hashtable_iter
+{
+	uint32_t hash;  /**< The hash of the searched key */
+	uint32_t pos;   /**< The slot of the last element found */
+	bool in_old;    /**< Whether the search is in the old table */
 };
 
 
 bool hashtable_new(struct hashtable *const hashtable,
                    const size_t key_len,
-                   const size_t size)
-	__attribute((warn_unused_result, nonnull(1)));
+                   const bool is_key_len_var,
+                   const void *const keys,
+                   const size_t key_stride,
+                   const size_t max_elems)
+	__attribute((warn_unused_result, nonnull(1, 4)));
 
 void hashtable_free(struct hashtable *const hashtable)
 	__attribute((nonnull(1)));
 
-void hashtable_add(struct hashtable *const hashtable,
-                   const void *const key,
-                   void *const elem)
-	__attribute((nonnull(1, 2, 3)));
+bool hashtable_set_hash(struct hashtable *const hashtable,
+                        const hashtable_hash_t hash)
+	__attribute((warn_unused_result, nonnull(1)));
 
-void * hashtable_get(const struct hashtable *const hashtable,
-                     const void *const key)
+bool hashtable_add(struct hashtable *const hashtable,
+                   const uint32_t idx)
+	__attribute((warn_unused_result, nonnull(1)));
+
+uint32_t hashtable_get(const struct hashtable *const hashtable,
+                       const void *const key)
 	__attribute((warn_unused_result, nonnull(1, 2)));
 
+uint32_t hashtable_get_first(const struct hashtable *const hashtable,
+                             const void *const key,
+                             struct hashtable_iter *const iter)
+	__attribute((warn_unused_result, nonnull(1, 2, 3)));
+
+uint32_t hashtable_get_next(const struct hashtable *const hashtable,
+                            const void *const key,
+                            struct hashtable_iter *const iter)
+	__attribute((warn_unused_result, nonnull(1, 2, 3)));
+
 void hashtable_del(struct hashtable *const hashtable,
-                   const void *const key)
-	__attribute((nonnull(1, 2)));
+                   const uint32_t idx)
+	__attribute((nonnull(1)));
 
 #endif
 
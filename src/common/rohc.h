@@ -196,6 +196,22 @@ typedef enum
 typedef uint16_t rohc_cid_t;
 
 
+/**
+ * @brief The number of buckets in the latency histograms of the statistics
+ *
+ * The latency histograms of the compressor and decompressor statistics are
+ * log-linear: durations smaller than 4 ticks get one bucket each, then every
+ * power of 2 is split into 4 buckets of equal width. Use the function
+ * \ref rohc_stats_get_bucket_min to get the range of durations counted by
+ * one bucket.
+ *
+ * @see rohc_stats_get_bucket_min
+ *
+ * @ingroup rohc
+ */
+#define ROHC_STATS_LATENCY_BUCKETS_NR  252U
+
+
 /**
  * @brief The different values of reordering offset
  *
@@ -223,6 +239,9 @@ const char * ROHC_EXPORT rohc_strerror(const rohc_status_t status)
 const char * ROHC_EXPORT rohc_get_mode_descr(const rohc_mode_t mode)
 	__attribute__((warn_unused_result, const));
 
+uint64_t ROHC_EXPORT rohc_stats_get_bucket_min(const size_t bucket)
+	__attribute__((warn_unused_result, const));
+
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_arena.c
+ * @brief  Slab allocator for the objects of the compression and
+ *         decompression contexts
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_arena.h"
+
+#include <string.h>
+#include <assert.h>
+
+
+static struct rohc_arena_slab * rohc_arena_get_slab(struct rohc_arena *const arena,
+                                                    const size_t size,
+                                                    bool *const is_shortage)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+
+/**
+ * @brief Initialize an arena
+ *
+ * No memory is allocated: the objects of one slab are all allocated at once
+ * when the first object of that size is requested.
+ *
+ * @param arena          The arena to initialize
+ * @param objs_per_slab  The number of objects per slab,
+ *                       0 to disable the arena and use malloc()/free()
+ */
+void rohc_arena_init(struct rohc_arena *const arena,
+                     const size_t objs_per_slab)
+{
+	arena->objs_per_slab = objs_per_slab;
+	arena->slabs_nr = 0;
+}
+
+
+/**
+ * @brief Release all the memory of an arena
+ *
+ * All the objects allocated from the slabs of the arena shall have been
+ * released before.
+ *
+ * @param arena  The arena to release
+ */
+void rohc_arena_free_all(struct rohc_arena *const arena)
+{
+	size_t i;
+
+	for(i = 0; i < arena->slabs_nr; i++)
+	{
+		struct rohc_arena_slab *const slab = &(arena->slabs[i]);
+
+		assert(slab->used_objs_nr == 0);
+		free(slab->objs);
+		slab->objs = NULL;
+		slab->free_objs = NULL;
+	}
+	arena->slabs_nr = 0;
+}
+
+
+/**
+ * @brief Allocate one object from an arena
+ *
+ * @param arena  The arena to allocate the object from,
+ *               NULL to allocate it with malloc()
+ * @param size   The size of the object
+ * @return       The new object,
+ *               NULL in case of memory shortage or if all the objects of
+ *               the slab for that size are in use
+ */
+void * rohc_arena_malloc(struct rohc_arena *const arena, const size_t size)
+{
+	struct rohc_arena_slab *slab = NULL;
+	union rohc_arena_obj *obj;
+
+	if(arena != NULL && arena->objs_per_slab > 0)
+	{
+		bool is_shortage;
+
+		slab = rohc_arena_get_slab(arena, size, &is_shortage);
+		if(is_shortage)
+		{
+			goto error;
+		}
+	}
+
+	if(slab == NULL)
+	{
+		/* no slab for that object, fallback on the system allocator */
+		obj = malloc(sizeof(union rohc_arena_obj) + size);
+		if(obj == NULL)
+		{
+			goto error;
+		}
+	}
+	else
+	{
+		if(slab->free_objs == NULL)
+		{
+			/* all the objects of the slab are in use */
+			goto error;
+		}
+		obj = slab->free_objs;
+		slab->free_objs = obj->next_free;
+		slab->used_objs_nr++;
+	}
+	obj->slab = slab;
+
+	return (obj + 1);
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Allocate one zeroed object from an arena
+ *
+ * @param arena  The arena to allocate the object from,
+ *               NULL to allocate it with malloc()
+ * @param size   The size of the object
+ * @return       The new object,
+ *               NULL in case of memory shortage or if all the objects of
+ *               the slab for that size are in use
+ */
+void * rohc_arena_calloc(struct rohc_arena *const arena, const size_t size)
+{
+	void *const obj = rohc_arena_malloc(arena, size);
+
+	if(obj != NULL)
+	{
+		memset(obj, 0, size);
+	}
+
+	return obj;
+}
+
+
+/**
+ * @brief Release one object allocated from an arena
+ *
+ * The object returns in the free list of its slab, or is released with free()
+ * if it was not allocated from a slab.
+ *
+ * @param obj  The object to release, may be NULL
+ */
+void rohc_arena_free(void *const obj)
+{
+	if(obj != NULL)
+	{
+		union rohc_arena_obj *const hdr = ((union rohc_arena_obj *) obj) - 1;
+		struct rohc_arena_slab *const slab = hdr->slab;
+
+		if(slab == NULL)
+		{
+			free(hdr);
+		}
+		else
+		{
+			assert(slab->used_objs_nr > 0);
+			slab->used_objs_nr--;
+			hdr->next_free = slab->free_objs;
+			slab->free_objs = hdr;
+		}
+	}
+}
+
+
+/**
+ * @brief Get the slab for the objects of the given size
+ *
+ * Create the slab and preallocate all its objects if no object of the given
+ * size was requested before.
+ *
+ * @param arena        The arena
+ * @param size         The size of the objects
+ * @param is_shortage  OUT: true if the objects of the new slab cannot be
+ *                     allocated, false otherwise
+ * @return             The slab for the objects of the given size,
+ *                     NULL if the arena has no more room for one new slab
+ *                     or in case of memory shortage
+ */
+static struct rohc_arena_slab * rohc_arena_get_slab(struct rohc_arena *const arena,
+                                                    const size_t size,
+                                                    bool *const is_shortage)
+{
+	struct rohc_arena_slab *slab;
+	uint8_t *objs;
+	size_t i;
+
+	*is_shortage = false;
+
+	for(i = 0; i < arena->slabs_nr; i++)
+	{
+		if(arena->slabs[i].obj_size == size)
+		{
+			return &(arena->slabs[i]);
+		}
+	}
+
+	if(arena->slabs_nr >= ROHC_ARENA_SLABS_MAX)
+	{
+		return NULL;
+	}
+
+	slab = &(arena->slabs[arena->slabs_nr]);
+	slab->obj_size = size;
+	slab->obj_stride = sizeof(union rohc_arena_obj) +
+		((size + sizeof(union rohc_arena_obj) - 1) &
+		 ~(sizeof(union rohc_arena_obj) - 1));
+	slab->objs = malloc(arena->objs_per_slab * slab->obj_stride);
+	if(slab->objs == NULL)
+	{
+		*is_shortage = true;
+		return NULL;
+	}
+	slab->used_objs_nr = 0;
+
+	/* link the objects in the free list, the first one at the head */
+	slab->free_objs = NULL;
+	objs = (uint8_t *) slab->objs;
+	for(i = arena->objs_per_slab; i > 0; i--)
+	{
+		union rohc_arena_obj *const obj =
+			(union rohc_arena_obj *) (objs + (i - 1) * slab->obj_stride);
+		obj->next_free = slab->free_objs;
+		slab->free_objs = obj;
+	}
+	arena->slabs_nr++;
+
+	return slab;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_arena.h
+ * @brief  Slab allocator for the objects of the compression and
+ *         decompression contexts
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * One arena holds one slab per object size. Every slab preallocates a fixed
+ * number of objects with one single allocation the first time an object of
+ * its size is requested, and keeps the unused objects in a free list. A slab
+ * never grows: once all its objects are in use, no more object of its size
+ * may be allocated until one is released. Creating and destroying contexts
+ * thus does not hit the system allocator once the slabs are allocated, and
+ * the memory of the slabs is bounded by the number of objects per slab.
+ *
+ * Every object starts with a small header that records the slab it belongs
+ * to, so objects may be released without knowing the arena. Objects that do
+ * not fit in one of the slabs of the arena (arena disabled, no arena, or too
+ * many object sizes) are allocated with malloc() and released with free().
+ */
+
+#ifndef ROHC_COMMON_ARENA_H
+#define ROHC_COMMON_ARENA_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/** The maximum number of object sizes (slabs) per arena */
+#define ROHC_ARENA_SLABS_MAX  16U
+
+/** The maximum number of objects per slab */
+#define ROHC_ARENA_SLAB_OBJS_MAX  65536U
+
+
+/** The header in front of every object allocated by an arena */
+union rohc_arena_obj
+{
+	/** The slab the allocated object belongs to, NULL if allocated by malloc() */
+	struct rohc_arena_slab *slab;
+	/** The next unused object in the free list of the slab */
+	union rohc_arena_obj *next_free;
+	uint64_t align; /**< Keep objects aligned on 8 bytes */
+};
+
+
+/** The objects of one given size */
+struct rohc_arena_slab
+{
+	size_t obj_size;                  /**< The size of the objects */
+	size_t obj_stride;                /**< The size of one object with header */
+	union rohc_arena_obj *free_objs;  /**< The unused objects */
+	union rohc_arena_obj *objs;       /**< The preallocated objects */
+	size_t used_objs_nr;              /**< The number of objects in use */
+};
+
+
+/** The arena of one compressor or decompressor */
+struct rohc_arena
+{
+	/** The number of objects per slab, 0 if the arena is disabled */
+	size_t objs_per_slab;
+	/** The slabs of the arena, one per object size */
+	struct rohc_arena_slab slabs[ROHC_ARENA_SLABS_MAX];
+	size_t slabs_nr; /**< The number of slabs in use */
+};
+
+
+void rohc_arena_init(struct rohc_arena *const arena,
+                     const size_t objs_per_slab)
+	__attribute__((nonnull(1)));
+
+void rohc_arena_free_all(struct rohc_arena *const arena)
+	__attribute__((nonnull(1)));
+
+void * rohc_arena_malloc(struct rohc_arena *const arena, const size_t size)
+	__attribute__((warn_unused_result));
+
+void * rohc_arena_calloc(struct rohc_arena *const arena, const size_t size)
+	__attribute__((warn_unused_result));
+
+void rohc_arena_free(void *const obj);
+
+/** Release one object allocated from an arena and reset its pointer */
+#define rohc_arena_zfree(pointer) \
+	do { \
+		rohc_arena_free(pointer); \
+		pointer = NULL; \
+	} while(0)
+
+#endif
+
@@ -127,3 +127,34 @@ const char * rohc_get_mode_descr(const rohc_mode_t mode)
 	}
 }
 
+
+/**
+ * @brief Get the smallest duration counted by one bucket of a latency histogram
+ *
+ * The bucket counts all the durations between the value returned for it and
+ * the value returned for the next bucket (excluded). The durations are given
+ * in ticks of the counter used by the library to measure time, see
+ * \ref rohc_comp_stats_t and \ref rohc_decomp_stats_t for details.
+ *
+ * @param bucket  The index of the bucket in the latency histogram
+ * @return        The smallest duration (in ticks) counted by the bucket,
+ *                UINT64_MAX if the index is not a valid one
+ *
+ * @ingroup rohc
+ *
+ * @see ROHC_STATS_LATENCY_BUCKETS_NR
+ */
+uint64_t rohc_stats_get_bucket_min(const size_t bucket)
+{
+	if(bucket >= ROHC_STATS_LATENCY_BUCKETS_NR)
+	{
+		return UINT64_MAX;
+	}
+	else if(bucket < 4)
+	{
+		return bucket;
+	}
+
+	return ((uint64_t) (4 + (bucket & 0x3))) << ((bucket / 4) - 1);
+}
+
@@ -84,5 +84,26 @@ struct rohc_fingerprint
 
 } __attribute__((packed));
 
+
+/** The maximum length of the compact key of one fingerprint */
+#define ROHC_FINGERPRINT_KEY_MAX_LEN \
+	(4U + ROHC_MAX_IP_HDRS * (4U + 2U * sizeof(struct ipv6_addr)) + 8U)
+
+
+/**
+ * @brief The compact key of one fingerprint
+ *
+ * The key holds the fields of the fingerprint one after the other, but only
+ * for the IP headers that are present and with IPv4 addresses stored on 4
+ * bytes instead of 16. The key of one IPv4/UDP flow is thus 24-byte long
+ * instead of the 85 bytes of the fingerprint, and so is the data to hash and
+ * compare when searching for its context. The first byte of the key is the
+ * length of the key, that byte included.
+ */
+struct rohc_fingerprint_key
+{
+	uint8_t data[ROHC_FINGERPRINT_KEY_MAX_LEN]; /**< The length, then the fields */
+};
+
 #endif
 
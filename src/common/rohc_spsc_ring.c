@@ -0,0 +1,187 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_spsc_ring.c
+ * @brief  Lock-free ring of indexes with one producer and one consumer
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_spsc_ring.h"
+
+#include <assert.h>
+
+
+/**
+ * @brief Create a new ring
+ *
+ * @param ring      The ring to create
+ * @param min_size  The minimum number of indexes the ring shall hold, the
+ *                  actual size is rounded up to the next power of 2
+ * @return          true if the ring was created,
+ *                  false if memory cannot be allocated
+ */
+bool rohc_spsc_ring_new(struct rohc_spsc_ring *const ring,
+                        const size_t min_size)
+{
+	size_t size = 1;
+
+	while(size < min_size)
+	{
+		size <<= 1;
+	}
+
+	ring->items = calloc(size, sizeof(uint32_t));
+	if(ring->items == NULL)
+	{
+		goto error;
+	}
+	ring->mask = size - 1;
+	ring->head = 0;
+	ring->tail_cache = 0;
+	ring->tail = 0;
+	ring->head_cache = 0;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Free the memory of a ring
+ *
+ * @param ring  The ring to free
+ */
+void rohc_spsc_ring_free(struct rohc_spsc_ring *const ring)
+{
+	free(ring->items);
+	ring->items = NULL;
+}
+
+
+/**
+ * @brief Get the number of indexes the ring may hold
+ *
+ * @param ring  The ring
+ * @return      The number of indexes the ring may hold
+ */
+size_t rohc_spsc_ring_get_size(const struct rohc_spsc_ring *const ring)
+{
+	return ring->mask + 1;
+}
+
+
+/**
+ * @brief Whether the ring is full or not
+ *
+ * Shall be called by the producer thread only. The place at the end of the
+ * ring is free for the producer to reuse as long as the ring is not full.
+ *
+ * @param ring  The ring
+ * @return      true if the ring is full,
+ *              false if at least one index may be pushed
+ */
+bool rohc_spsc_ring_is_full(struct rohc_spsc_ring *const ring)
+{
+	const size_t tail = ring->tail;
+
+	/* read the position of the consumer again only if the ring looks full */
+	if((tail - ring->head_cache) > ring->mask)
+	{
+		ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	}
+
+	return ((tail - ring->head_cache) > ring->mask);
+}
+
+
+/**
+ * @brief Add one index at the end of the ring
+ *
+ * Shall be called by the producer thread only.
+ *
+ * @param ring  The ring
+ * @param item  The index to add
+ * @return      true if the index was added,
+ *              false if the ring is full
+ */
+bool rohc_spsc_ring_push(struct rohc_spsc_ring *const ring,
+                         const uint32_t item)
+{
+	const size_t tail = ring->tail;
+
+	if(rohc_spsc_ring_is_full(ring))
+	{
+		return false;
+	}
+
+	ring->items[tail & ring->mask] = item;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+
+/**
+ * @brief Get the index at the beginning of the ring without removing it
+ *
+ * Shall be called by the consumer thread only.
+ *
+ * @param ring       The ring
+ * @param[out] item  The index at the beginning of the ring
+ * @return           true if one index is available,
+ *                   false if the ring is empty
+ */
+bool rohc_spsc_ring_peek(struct rohc_spsc_ring *const ring,
+                         uint32_t *const item)
+{
+	const size_t head = ring->head;
+
+	/* read the position of the producer again only if the ring looks empty */
+	if(head == ring->tail_cache)
+	{
+		ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		if(head == ring->tail_cache)
+		{
+			return false;
+		}
+	}
+
+	*item = ring->items[head & ring->mask];
+
+	return true;
+}
+
+
+/**
+ * @brief Remove the index at the beginning of the ring
+ *
+ * Shall be called by the consumer thread only, once the index returned by
+ * \ref rohc_spsc_ring_peek is not needed anymore.
+ *
+ * @param ring  The ring
+ */
+void rohc_spsc_ring_pop(struct rohc_spsc_ring *const ring)
+{
+	const size_t head = ring->head;
+
+	assert(head != ring->tail_cache);
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
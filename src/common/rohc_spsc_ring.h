@@ -0,0 +1,97 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_spsc_ring.h
+ * @brief  Lock-free ring of indexes with one producer and one consumer
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The ring hands indexes from one thread (the producer) to another one (the
+ * consumer) without any lock. The positions of the producer and the consumer
+ * are kept on separate cache lines, and each side caches the last known
+ * position of the other side to avoid reading the shared one on every call.
+ * Everything written by the producer before pushing an index is visible to
+ * the consumer once it peeked that index, and everything done by the
+ * consumer before popping the index is done before the producer may reuse
+ * its place in the ring.
+ */
+
+#ifndef ROHC_COMMON_SPSC_RING_H
+#define ROHC_COMMON_SPSC_RING_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/** The size of a cache line, to keep producer and consumer data apart */
+#define ROHC_SPSC_RING_CACHE_LINE  64U
+
+
+/** A lock-free ring with one producer and one consumer */
+struct rohc_spsc_ring
+{
+	/** The indexes in the ring */
+	uint32_t *items;
+	/** The number of items in the ring minus one (size is a power of 2) */
+	size_t mask;
+
+	/** The position of the consumer, written by the consumer only */
+	size_t head;
+	/** The last position of the producer seen by the consumer */
+	size_t tail_cache;
+
+	/** Keep the data of the producer on another cache line */
+	uint8_t pad1[ROHC_SPSC_RING_CACHE_LINE];
+
+	/** The position of the producer, written by the producer only */
+	size_t tail;
+	/** The last position of the consumer seen by the producer */
+	size_t head_cache;
+
+	/** Keep the data of the producer away from the data next to the ring */
+	uint8_t pad2[ROHC_SPSC_RING_CACHE_LINE];
+};
+
+
+bool rohc_spsc_ring_new(struct rohc_spsc_ring *const ring,
+                        const size_t min_size)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_spsc_ring_free(struct rohc_spsc_ring *const ring)
+	__attribute__((nonnull(1)));
+
+size_t rohc_spsc_ring_get_size(const struct rohc_spsc_ring *const ring)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+bool rohc_spsc_ring_is_full(struct rohc_spsc_ring *const ring)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool rohc_spsc_ring_push(struct rohc_spsc_ring *const ring,
+                         const uint32_t item)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool rohc_spsc_ring_peek(struct rohc_spsc_ring *const ring,
+                         uint32_t *const item)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+void rohc_spsc_ring_pop(struct rohc_spsc_ring *const ring)
+	__attribute__((nonnull(1)));
+
+#endif
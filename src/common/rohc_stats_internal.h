@@ -0,0 +1,197 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_stats_internal.h
+ * @brief  ROHC internal helpers for the statistics of compressors and
+ *         decompressors
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The statistics are written by the thread that runs the compressor or the
+ * decompressor, and they may be read at the same time by any other thread.
+ * The writer protects its updates with a sequence counter: the counter is
+ * odd while an update is in progress, and readers copy the statistics again
+ * until they get a copy taken between two identical even values of the
+ * counter. The writer never waits for the readers.
+ */
+
+#ifndef ROHC_STATS_INTERNAL_H
+#define ROHC_STATS_INTERNAL_H
+
+#include "rohc.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#if defined(__KERNEL__)
+#  include <linux/timex.h>
+#elif !defined(__x86_64__) && !defined(__i386__) && !defined(__aarch64__)
+#  include <time.h>
+#endif
+
+
+static inline uint64_t rohc_stats_get_ticks(void)
+	__attribute__((warn_unused_result));
+
+static inline size_t rohc_stats_get_latency_bucket(const uint64_t ticks)
+	__attribute__((warn_unused_result, const));
+
+static inline void rohc_stats_write_begin(uint32_t *const seq)
+	__attribute__((nonnull(1)));
+static inline void rohc_stats_write_end(uint32_t *const seq)
+	__attribute__((nonnull(1)));
+static inline void rohc_stats_add(uint64_t *const counter, const uint64_t value)
+	__attribute__((nonnull(1)));
+
+static inline void rohc_stats_read(const uint32_t *const seq,
+                                   uint8_t *const snapshot,
+                                   const uint64_t *const counters,
+                                   const size_t counters_nr)
+	__attribute__((nonnull(1, 2, 3)));
+
+
+/**
+ * @brief Get the current value of a cheap monotonic counter of ticks
+ *
+ * The counter is the CPU Time Stamp Counter on x86, the virtual counter of
+ * the generic timer on ARM64, the cycle counter of the kernel in kernel
+ * space, and the monotonic clock in nanoseconds everywhere else.
+ *
+ * @return  The current number of ticks
+ */
+static inline uint64_t rohc_stats_get_ticks(void)
+{
+#if defined(__KERNEL__)
+	return get_cycles();
+#elif defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+	uint64_t ticks;
+	__asm__ __volatile__("mrs %0, cntvct_el0" : "=r" (ticks));
+	return ticks;
+#else
+	struct timespec now;
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+
+/**
+ * @brief Get the bucket of the latency histogram for the given duration
+ *
+ * The histogram is log-linear: durations smaller than 4 ticks get one bucket
+ * each, then every power of 2 is split into 4 buckets of equal width. The
+ * relative error of the histogram is thus lower than 25% whatever the
+ * duration, and no division is required.
+ *
+ * @param ticks  The duration in ticks
+ * @return       The index of the bucket in the histogram
+ */
+static inline size_t rohc_stats_get_latency_bucket(const uint64_t ticks)
+{
+	size_t msb;
+
+	if(ticks < 4)
+	{
+		return ticks;
+	}
+	msb = 63 - __builtin_clzll(ticks);
+
+	return (4 * (msb - 1)) + ((ticks >> (msb - 2)) & 0x3);
+}
+
+
+/**
+ * @brief Start an update of the statistics
+ *
+ * @param seq  The sequence counter that protects the statistics
+ */
+static inline void rohc_stats_write_begin(uint32_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief End an update of the statistics
+ *
+ * @param seq  The sequence counter that protects the statistics
+ */
+static inline void rohc_stats_write_end(uint32_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Add the given value to one counter of the statistics
+ *
+ * Shall be called between \ref rohc_stats_write_begin and
+ * \ref rohc_stats_write_end.
+ *
+ * @param counter  The counter to update
+ * @param value    The value to add to the counter
+ */
+static inline void rohc_stats_add(uint64_t *const counter, const uint64_t value)
+{
+	__atomic_store_n(counter, (*counter) + value, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * @brief Take a consistent snapshot of the statistics
+ *
+ * The copy of the counters does not need to be aligned on 64 bits, so that
+ * the counters may be copied directly in the packed structures of the API.
+ *
+ * @param seq            The sequence counter that protects the statistics
+ * @param[out] snapshot  The copy of the counters
+ * @param counters       The counters to copy
+ * @param counters_nr    The number of counters to copy
+ */
+static inline void rohc_stats_read(const uint32_t *const seq,
+                                   uint8_t *const snapshot,
+                                   const uint64_t *const counters,
+                                   const size_t counters_nr)
+{
+	uint32_t seq_begin;
+	uint32_t seq_end;
+
+	do
+	{
+		size_t i;
+
+		seq_begin = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+		for(i = 0; i < counters_nr; i++)
+		{
+			const uint64_t counter = __atomic_load_n(&counters[i], __ATOMIC_RELAXED);
+			memcpy(snapshot + i * sizeof(uint64_t), &counter, sizeof(uint64_t));
+		}
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		seq_end = __atomic_load_n(seq, __ATOMIC_RELAXED);
+	}
+	while((seq_begin & 1) != 0 || seq_begin != seq_end);
+}
+
+#endif /* ROHC_STATS_INTERNAL_H */
+
@@ -38,54 +38,61 @@
 /**
  * @brief Dump the content of the given packet
  *
- * @param trace_cb      The function to log traces
- * @param trace_cb_priv An optional private context, may be NULL
- * @param trace_entity  The entity that emits the traces
- * @param trace_level   The priority level for the trace
- * @param descr         The description of the packet to dump
- * @param packet        The packet to dump
+ * @param trace_cb         The function to log traces
+ * @param trace_cb_priv    An optional private context, may be NULL
+ * @param trace_min_level  The minimal level of the traces to emit
+ * @param trace_entity     The entity that emits the traces
+ * @param trace_level      The priority level for the trace
+ * @param descr            The description of the packet to dump
+ * @param packet           The packet to dump
  */
 void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
                       void *const trace_cb_priv,
+                      const rohc_trace_level_t trace_min_level,
                       const rohc_trace_entity_t trace_entity,
                       const rohc_trace_level_t trace_level,
                       const char *const descr,
                       const struct rohc_buf packet)
 {
-	/* leave early if no trace callback was defined */
-	if(trace_cb == NULL)
+	/* leave early if no trace callback was defined or if the trace level is
+	 * filtered out */
+	if(trace_cb == NULL || trace_level < trace_min_level)
 	{
 		return;
 	}
 
 	assert(!rohc_buf_is_malformed(packet));
 
-	rohc_dump_buf(trace_cb, trace_cb_priv, trace_entity, trace_level, descr,
-	              rohc_buf_data(packet), rohc_min(packet.len, 100U));
+	rohc_dump_buf(trace_cb, trace_cb_priv, trace_min_level, trace_entity,
+	              trace_level, descr, rohc_buf_data(packet),
+	              rohc_min(packet.len, 100U));
 }
 
 
 /**
  * @brief Dump the content of the given buffer
  *
- * @param trace_cb      The function to log traces
- * @param trace_cb_priv An optional private context, may be NULL
- * @param trace_entity  The entity that emits the traces
- * @param trace_level   The priority level for the trace
- * @param descr         The description of the packet to dump
- * @param packet        The packet to dump
- * @param length        The length (in bytes) of the packet to dump
+ * @param trace_cb         The function to log traces
+ * @param trace_cb_priv    An optional private context, may be NULL
+ * @param trace_min_level  The minimal level of the traces to emit
+ * @param trace_entity     The entity that emits the traces
+ * @param trace_level      The priority level for the trace
+ * @param descr            The description of the packet to dump
+ * @param packet           The packet to dump
+ * @param length           The length (in bytes) of the packet to dump
  */
 void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
+                   const rohc_trace_level_t trace_min_level,
                    const rohc_trace_entity_t trace_entity,
                    const rohc_trace_level_t trace_level,
                    const char *const descr,
                    const uint8_t *const packet,
                    const size_t length)
 {
-	/* leave early if no trace callback was defined */
-	if(trace_cb == NULL)
+	/* leave early if no trace callback was defined or if the trace level is
+	 * filtered out */
+	if(trace_cb == NULL || trace_level < trace_min_level)
 	{
 		return;
 	}
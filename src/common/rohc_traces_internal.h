@@ -50,13 +50,21 @@
 		} \
 	} while(0)
 
-/** Print information depending on the debug level */
+/**
+ * @brief Print information depending on the debug level
+ *
+ * Traces below the minimal level configured for the entity are discarded
+ * before the trace callback is called, so their arguments are never
+ * formatted.
+ */
 #define rohc_print(entity_struct, level, entity, profile, format, ...) \
 	do { \
-		__rohc_print((entity_struct)->trace_callback, \
-		             (entity_struct)->trace_callback_priv, \
-		             level, entity, profile, \
-		             format, ##__VA_ARGS__); \
+		if((level) >= (entity_struct)->trace_min_level) { \
+			__rohc_print((entity_struct)->trace_callback, \
+			             (entity_struct)->trace_callback_priv, \
+			             level, entity, profile, \
+			             format, ##__VA_ARGS__); \
+		} \
 	} while(0)
 
 /** Print debug messages prefixed with the function name */
@@ -121,27 +129,29 @@
 
 void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
                       void *const trace_cb_priv,
+                      const rohc_trace_level_t trace_min_level,
                       const rohc_trace_entity_t trace_entity,
                       const rohc_trace_level_t trace_level,
                       const char *const descr,
                       const struct rohc_buf packet)
-	__attribute__((nonnull(5)));
+	__attribute__((nonnull(6)));
 
 void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
+                   const rohc_trace_level_t trace_min_level,
                    const rohc_trace_entity_t trace_entity,
                    const rohc_trace_level_t trace_level,
                    const char *const descr,
                    const uint8_t *const packet,
                    const size_t length)
-	__attribute__((nonnull(5, 6)));
+	__attribute__((nonnull(6, 7)));
 
 #else
-#define rohc_dump_packet(trace_cb, trace_cb_priv, trace_entity, trace_level, \
-                         descr, packet) \
+#define rohc_dump_packet(trace_cb, trace_cb_priv, trace_min_level, \
+                         trace_entity, trace_level, descr, packet) \
 	do { } while(0)
-#define rohc_dump_buf(trace_cb, trace_cb_priv, trace_entity, trace_level, \
-                      descr, packet, length) \
+#define rohc_dump_buf(trace_cb, trace_cb_priv, trace_min_level, \
+                      trace_entity, trace_level, descr, packet, length) \
 	do { } while(0)
 #endif
 
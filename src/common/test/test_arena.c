@@ -0,0 +1,193 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_arena.c
+ * @brief   Test the slab allocator of the compression/decompression contexts
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_arena.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Test the slab allocator
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the slab allocator\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* no arena: objects are allocated with malloc() */
+	{
+		uint8_t *obj = rohc_arena_malloc(NULL, 100);
+		CHECK(obj != NULL);
+		memset(obj, 0xaa, 100);
+		rohc_arena_zfree(obj);
+		CHECK(obj == NULL);
+		rohc_arena_free(NULL);
+	}
+
+	/* disabled arena: objects are allocated with malloc() */
+	{
+		struct rohc_arena arena;
+		void *obj;
+
+		rohc_arena_init(&arena, 0);
+		obj = rohc_arena_malloc(&arena, 100);
+		CHECK(obj != NULL);
+		CHECK(arena.slabs_nr == 0);
+		rohc_arena_free(obj);
+		rohc_arena_free_all(&arena);
+	}
+
+	/* enabled arena: objects are allocated from slabs and reused */
+	{
+		struct rohc_arena arena;
+		void *objs[10];
+		uint8_t *zeroed;
+		size_t i;
+
+		rohc_arena_init(&arena, 10);
+
+		/* the slab holds 10 objects of the same size, no more */
+		for(i = 0; i < 10; i++)
+		{
+			objs[i] = rohc_arena_malloc(&arena, 37);
+			CHECK(objs[i] != NULL);
+			CHECK((((uintptr_t) objs[i]) % sizeof(uint64_t)) == 0);
+			memset(objs[i], i, 37);
+		}
+		CHECK(arena.slabs_nr == 1);
+		CHECK(arena.slabs[0].used_objs_nr == 10);
+		CHECK(rohc_arena_malloc(&arena, 37) == NULL);
+		CHECK(rohc_arena_calloc(&arena, 37) == NULL);
+		CHECK(arena.slabs[0].used_objs_nr == 10);
+		for(i = 0; i < 10; i++)
+		{
+			size_t j;
+			for(j = 0; j < 37; j++)
+			{
+				CHECK(((uint8_t *) objs[i])[j] == i);
+			}
+		}
+
+		/* the last released object is the next one allocated */
+		rohc_arena_free(objs[3]);
+		CHECK(arena.slabs[0].used_objs_nr == 9);
+		zeroed = rohc_arena_calloc(&arena, 37);
+		CHECK(zeroed == objs[3]);
+		for(i = 0; i < 37; i++)
+		{
+			CHECK(zeroed[i] == 0);
+		}
+		CHECK(arena.slabs[0].used_objs_nr == 10);
+
+		/* objects of another size get their own slab */
+		objs[3] = rohc_arena_malloc(&arena, 200);
+		CHECK(objs[3] != NULL);
+		CHECK(arena.slabs_nr == 2);
+		CHECK(arena.slabs[1].used_objs_nr == 1);
+		rohc_arena_free(objs[3]);
+		rohc_arena_free(zeroed);
+
+		for(i = 0; i < 10; i++)
+		{
+			if(i != 3)
+			{
+				rohc_arena_free(objs[i]);
+			}
+		}
+		CHECK(arena.slabs[0].used_objs_nr == 0);
+		CHECK(arena.slabs[1].used_objs_nr == 0);
+		rohc_arena_free_all(&arena);
+		CHECK(arena.slabs_nr == 0);
+	}
+
+	/* too many object sizes: the extra sizes are allocated with malloc() */
+	{
+		struct rohc_arena arena;
+		void *objs[ROHC_ARENA_SLABS_MAX + 2];
+		size_t i;
+
+		rohc_arena_init(&arena, 2);
+		for(i = 0; i < (ROHC_ARENA_SLABS_MAX + 2); i++)
+		{
+			objs[i] = rohc_arena_calloc(&arena, 8 * (i + 1));
+			CHECK(objs[i] != NULL);
+		}
+		CHECK(arena.slabs_nr == ROHC_ARENA_SLABS_MAX);
+		for(i = 0; i < (ROHC_ARENA_SLABS_MAX + 2); i++)
+		{
+			rohc_arena_free(objs[i]);
+		}
+		rohc_arena_free_all(&arena);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -0,0 +1,362 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_crc.c
+ * @brief   Test and benchmark the CRC algorithms
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The CRCs computed 8 bytes at a time with tables and the CRCs computed with
+ * the PCLMULQDQ instruction (if the CPU supports it) are compared with CRCs
+ * computed one bit at a time, and so are the CRCs computed from the cached
+ * CRC of the previous headers. In bench mode, the time spent to compute the
+ * CRCs of data of different lengths is printed.
+ */
+
+#include "crc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/time.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The maximum length of the test data */
+#define TEST_DATA_MAX_LEN  300U
+
+/** The number of CRCs computed for every length in bench mode */
+#define BENCH_ROUNDS  2000000U
+
+
+static uint32_t crc_calc_bitwise(const uint32_t reflected_poly,
+                                 const uint8_t *const data,
+                                 const size_t len,
+                                 const uint32_t init_val)
+	__attribute__((warn_unused_result, nonnull(2)));
+
+static void bench_crc(void);
+
+static uint64_t gettime_ns(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test and benchmark the CRC algorithms
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	uint8_t data[TEST_DATA_MAX_LEN];
+	bool verbose; /* whether to run in verbose mode or not */
+	bool bench; /* whether to run the benchmark or not */
+	int is_failure = 1; /* test fails by default */
+	size_t len;
+	size_t i;
+
+	/* do we run in verbose or bench mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+		bench = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+		bench = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "bench") == 0)
+	{
+		/* run the benchmark */
+		verbose = false;
+		bench = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test and benchmark the CRC algorithms\n");
+		printf("usage: %s [verbose|bench]\n", argv[0]);
+		goto error;
+	}
+
+	srand(42);
+	for(i = 0; i < TEST_DATA_MAX_LEN; i++)
+	{
+		data[i] = rand() & 0xff;
+	}
+
+	/* well-known check values of the CRCs over the "123456789" string */
+	{
+		const uint8_t check[] = "123456789";
+		CHECK(crc_calc_3(check, 9, CRC_INIT_3) == 0x6);
+		CHECK(crc_calc_7(check, 9, CRC_INIT_7) == 0x53);
+		CHECK(crc_calc_8(check, 9, CRC_INIT_8) == 0xd0);
+		CHECK((crc_calc_fcs32(check, 9, CRC_INIT_FCS32) ^ 0xffffffff) == 0xcbf43926);
+	}
+
+	/* all the implementations shall compute the same CRCs for all the lengths
+	 * and all the alignments of data */
+	for(len = 0; len < TEST_DATA_MAX_LEN; len++)
+	{
+		const size_t offset = len % 16;
+		const size_t data_len = (offset + len <= TEST_DATA_MAX_LEN ?
+		                         len : TEST_DATA_MAX_LEN - offset);
+		const uint8_t *const buf = data + offset;
+		const uint8_t init_val = rand() & 0xff;
+		const uint32_t init_val_32 = rand();
+		uint32_t crc;
+
+		trace(verbose, "compute CRCs over %zu bytes at offset %zu\n",
+		      data_len, offset);
+
+		crc = crc_calc_bitwise(0x6, buf, data_len, init_val & 0x7);
+		CHECK(crc_calc_3(buf, data_len, init_val & 0x7) == crc);
+		CHECK(crc3rohc_word(init_val & 0x7, buf, data_len) == crc);
+		CHECK(crc_calculate(ROHC_CRC_TYPE_3, buf, data_len, init_val & 0x7) == crc);
+
+		crc = crc_calc_bitwise(0x79, buf, data_len, init_val & 0x7f);
+		CHECK(crc_calc_7(buf, data_len, init_val & 0x7f) == crc);
+		CHECK(crc7rohc_word(init_val & 0x7f, buf, data_len) == crc);
+		CHECK(crc_calculate(ROHC_CRC_TYPE_7, buf, data_len, init_val & 0x7f) == crc);
+
+		crc = crc_calc_bitwise(0xe0, buf, data_len, init_val);
+		CHECK(crc_calc_8(buf, data_len, init_val) == crc);
+		CHECK(crc8rohc_word(init_val, buf, data_len) == crc);
+		CHECK(crc_calculate(ROHC_CRC_TYPE_8, buf, data_len, init_val) == crc);
+
+		crc = crc_calc_bitwise(0xedb88320, buf, data_len, init_val_32);
+		CHECK(crc_calc_fcs32(buf, data_len, init_val_32) == crc);
+		CHECK(crc32fcs_word(init_val_32, buf, data_len) == crc);
+	}
+
+	/* the CRCs computed with the cache of the last headers shall match the
+	 * CRCs computed from scratch, whatever the bytes that change */
+	{
+		struct rohc_crc_cache cache;
+		uint8_t hdrs[ROHC_CRC_CACHE_MAX_LEN + 1];
+		size_t hdrs_len = 60;
+		size_t round;
+
+		memset(&cache, 0, sizeof(struct rohc_crc_cache));
+		memcpy(hdrs, data, ROHC_CRC_CACHE_MAX_LEN + 1);
+
+		for(round = 0; round < 10000; round++)
+		{
+			const rohc_crc_type_t crc_type =
+				((round % 100) < 90 ? ROHC_CRC_TYPE_3 : ROHC_CRC_TYPE_7);
+			const uint8_t init_val =
+				(crc_type == ROHC_CRC_TYPE_3 ? CRC_INIT_3 : CRC_INIT_7);
+			const size_t changes_nr = rand() % 5;
+			size_t change;
+
+			/* change the length of the headers from time to time */
+			if((round % 500) == 0)
+			{
+				hdrs_len = rand() % (ROHC_CRC_CACHE_MAX_LEN + 2);
+			}
+			for(change = 0; change < changes_nr && hdrs_len > 0; change++)
+			{
+				hdrs[rand() % hdrs_len] = rand() & 0xff;
+			}
+
+			CHECK(crc_calc_cached(&cache, crc_type, hdrs, hdrs_len) ==
+			      crc_calculate(crc_type, hdrs, hdrs_len, init_val));
+		}
+	}
+
+	/* run the benchmark if asked to */
+	if(bench)
+	{
+		bench_crc();
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compute a reflected CRC one bit at a time
+ *
+ * @param reflected_poly  The bit-reflected CRC polynomial
+ * @param data            The data to compute the CRC for
+ * @param len             The length of the data
+ * @param init_val        The initial CRC value
+ * @return                The CRC
+ */
+static uint32_t crc_calc_bitwise(const uint32_t reflected_poly,
+                                 const uint8_t *const data,
+                                 const size_t len,
+                                 const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+	size_t i;
+
+	for(i = 0; i < len; i++)
+	{
+		size_t bit;
+
+		crc ^= data[i];
+		for(bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ reflected_poly) : (crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Print the time spent to compute CRCs of data of different lengths
+ *
+ * The lengths range from one IPv4 header to one full Ethernet frame. The
+ * CRCs are computed with tables 8 bytes at a time, then with the best
+ * implementation available on the CPU.
+ */
+static void bench_crc(void)
+{
+	const size_t lengths[] = { 20, 40, 60, 64, 80, 100, 128, 1500 };
+	const size_t lengths_nr = sizeof(lengths) / sizeof(size_t);
+	uint8_t data[1500];
+	size_t i;
+
+	for(i = 0; i < 1500; i++)
+	{
+		data[i] = rand() & 0xff;
+	}
+
+	printf("%6s  %16s  %16s  %16s  %16s\n", "length",
+	       "CRC-7 tables", "CRC-7 best", "FCS-32 tables", "FCS-32 best");
+	for(i = 0; i < lengths_nr; i++)
+	{
+		const size_t len = lengths[i];
+		volatile uint32_t crc = 0;
+		double ns[4];
+		uint64_t start;
+		size_t round;
+
+		start = gettime_ns();
+		for(round = 0; round < BENCH_ROUNDS; round++)
+		{
+			crc = crc7rohc_word(crc, data, len);
+		}
+		ns[0] = (gettime_ns() - start) / (double) BENCH_ROUNDS;
+
+		start = gettime_ns();
+		for(round = 0; round < BENCH_ROUNDS; round++)
+		{
+			crc = crc_calc_7(data, len, crc);
+		}
+		ns[1] = (gettime_ns() - start) / (double) BENCH_ROUNDS;
+
+		start = gettime_ns();
+		for(round = 0; round < BENCH_ROUNDS; round++)
+		{
+			crc = crc32fcs_word(crc, data, len);
+		}
+		ns[2] = (gettime_ns() - start) / (double) BENCH_ROUNDS;
+
+		start = gettime_ns();
+		for(round = 0; round < BENCH_ROUNDS; round++)
+		{
+			crc = crc_calc_fcs32(data, len, crc);
+		}
+		ns[3] = (gettime_ns() - start) / (double) BENCH_ROUNDS;
+
+		printf("%6zu  %13.1f ns  %13.1f ns  %13.1f ns  %13.1f ns\n",
+		       len, ns[0], ns[1], ns[2], ns[3]);
+	}
+
+	/* IPv6/TCP headers of a bulk transfer: the Payload Length, the TCP
+	 * sequence number and the TCP checksum change */
+	{
+		struct rohc_crc_cache cache;
+		volatile uint8_t crc = 0;
+		uint8_t hdrs[60];
+		double ns[2];
+		uint64_t start;
+		size_t round;
+
+		memcpy(hdrs, data, 60);
+		memset(&cache, 0, sizeof(struct rohc_crc_cache));
+
+		start = gettime_ns();
+		for(round = 0; round < BENCH_ROUNDS; round++)
+		{
+			hdrs[5] = round & 0xff;
+			hdrs[47] = round & 0xff;
+			hdrs[57] = round & 0xff;
+			crc ^= crc_calc_3(hdrs, 60, CRC_INIT_3);
+		}
+		ns[0] = (gettime_ns() - start) / (double) BENCH_ROUNDS;
+
+		start = gettime_ns();
+		for(round = 0; round < BENCH_ROUNDS; round++)
+		{
+			hdrs[5] = round & 0xff;
+			hdrs[47] = round & 0xff;
+			hdrs[57] = round & 0xff;
+			crc ^= crc_calc_cached(&cache, ROHC_CRC_TYPE_3, hdrs, 60);
+		}
+		ns[1] = (gettime_ns() - start) / (double) BENCH_ROUNDS;
+
+		printf("\nCRC-3 of 60-byte IPv6/TCP headers: %.1f ns without cache, "
+		       "%.1f ns with cache\n", ns[0], ns[1]);
+	}
+}
+
+
+/**
+ * @brief Get the current time in nanoseconds
+ *
+ * @return  The current time in nanoseconds
+ */
+static uint64_t gettime_ns(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return ((uint64_t) tv.tv_sec) * 1000000000ULL + tv.tv_usec * 1000ULL;
+}
@@ -83,6 +83,18 @@ int main(void)
 	}
 	t1 = gettime_ns();
 
+	/* neither the data nor the key need to be aligned */
+	{
+		uint64_t unaligned_buf[(1 + 64 + 16 + 7) / 8];
+		char *const unaligned_plaintext = ((char *) unaligned_buf) + 1;
+		char *const unaligned_key = unaligned_plaintext + 64;
+		for (i=0; i<64; i++) unaligned_plaintext[i] = i;
+		for (i=0; i<16; i++) unaligned_key[i] = key[i];
+		for (i=0; i<64; i++) {
+			assert(siphash24(unaligned_plaintext, i, unaligned_key) == vectors[i]);
+		}
+	}
+
 	printf("%i tests passed in %.3fms, %.0fns per test\n", REPEATS*64, (t1-t0)/1000000., (t1-t0)/(REPEATS*64.));
 	return 0;
 }
@@ -0,0 +1,465 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_hashtable.c
+ * @brief   Test and benchmark the hash table of compression contexts
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Elements are added to and removed from the hash table while it grows, and
+ * all of them shall always be found by their key, with both hash functions.
+ * Elements that share their key shall all be found once, and keys of
+ * variable length shall only match keys of the same length. In bench mode,
+ * the time spent to find random elements among 16K elements as large as
+ * compression contexts is printed, for keys as long as full fingerprints
+ * and for keys as long as the compact keys of IPv4/UDP flows.
+ */
+
+#include "hashtable.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/time.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The number of elements of the test */
+#define ELEMS_NR  1000U
+
+/** The number of elements that share the same base key */
+#define ELEMS_PER_BASE  10U
+
+/** The number of elements in bench mode */
+#define BENCH_ELEMS_NR  16384U
+
+/** The length of the keys in bench mode, as long as context fingerprints */
+#define BENCH_KEY_LEN  85U
+
+/** The length of the variable-length keys in bench mode, as long as the
+ *  compact keys of IPv4/UDP flows */
+#define BENCH_COMPACT_KEY_LEN  24U
+
+/** The offset of the variable-length keys in the elements in bench mode */
+#define BENCH_COMPACT_KEY_OFFSET  128U
+
+/** The size of the elements in bench mode, as large as compression contexts */
+#define BENCH_ELEM_SIZE  1024U
+
+/** The number of lookups in bench mode */
+#define BENCH_ROUNDS  4000000U
+
+
+/** One element of the hash table */
+struct elem
+{
+	uint8_t key[40];   /**< The key of the element, starts with its base key */
+	bool is_in_table;  /**< Whether the element is in the hash table */
+};
+
+
+static void check_all_elems(const struct hashtable *const hashtable,
+                            const struct elem *const elems,
+                            const bool verbose)
+	__attribute__((nonnull(1, 2)));
+
+static void bench_hashtable(void);
+
+static uint64_t gettime_ns(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test and benchmark the hash table
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static struct elem elems[ELEMS_NR];
+	struct hashtable hashtable;
+	struct hashtable base_hashtable;
+	bool verbose; /* whether to run in verbose mode or not */
+	bool bench; /* whether to run the benchmark or not */
+	int is_failure = 1; /* test fails by default */
+	size_t round;
+	uint32_t i;
+
+	/* do we run in verbose or bench mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+		bench = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+		bench = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "bench") == 0)
+	{
+		/* run the benchmark */
+		verbose = false;
+		bench = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test and benchmark the hash table of compression contexts\n");
+		printf("usage: %s [verbose|bench]\n", argv[0]);
+		goto error;
+	}
+
+	srand(42);
+
+	/* keys share most of their bytes, as the fingerprints of flows do ; the
+	 * base key is made of the first 8 bytes */
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		memset(elems[i].key, 0x42, sizeof(elems[i].key));
+		elems[i].key[2] = (i / ELEMS_PER_BASE) & 0xff;
+		elems[i].key[3] = ((i / ELEMS_PER_BASE) >> 8) & 0xff;
+		elems[i].key[sizeof(elems[i].key) - 1] = i & 0xff;
+		elems[i].key[sizeof(elems[i].key) - 2] = (i >> 8) & 0xff;
+		elems[i].is_in_table = false;
+	}
+
+	for(i = 0; i < sizeof(hashtable.key); i++)
+	{
+		hashtable.key[i] = rand() & 0xff;
+		base_hashtable.key[i] = rand() & 0xff;
+	}
+	CHECK(hashtable_new(&hashtable, sizeof(elems[0].key), false, elems[0].key,
+	                    sizeof(struct elem), ELEMS_NR));
+	CHECK(hashtable.hash == HASHTABLE_HASH_SIPHASH);
+	CHECK(hashtable_new(&base_hashtable, 8, false, elems[0].key,
+	                    sizeof(struct elem), ELEMS_NR));
+
+	/* elements are found while the table grows */
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		CHECK(hashtable_get(&hashtable, elems[i].key) == HASHTABLE_NO_IDX);
+		CHECK(hashtable_add(&hashtable, i));
+		elems[i].is_in_table = true;
+		CHECK(hashtable_get(&hashtable, elems[i].key) == i);
+		if((i % 50) == 0)
+		{
+			check_all_elems(&hashtable, elems, verbose);
+		}
+	}
+	CHECK(hashtable.elems_nr == ELEMS_NR);
+	check_all_elems(&hashtable, elems, verbose);
+
+	/* adding an element twice does nothing */
+	CHECK(hashtable_add(&hashtable, 5));
+	CHECK(hashtable.elems_nr == ELEMS_NR);
+
+	/* random removals and additions */
+	for(round = 0; round < 20000; round++)
+	{
+		const uint32_t idx = rand() % ELEMS_NR;
+
+		if(elems[idx].is_in_table)
+		{
+			hashtable_del(&hashtable, idx);
+			elems[idx].is_in_table = false;
+			CHECK(hashtable_get(&hashtable, elems[idx].key) == HASHTABLE_NO_IDX);
+		}
+		else
+		{
+			CHECK(hashtable_add(&hashtable, idx));
+			elems[idx].is_in_table = true;
+			CHECK(hashtable_get(&hashtable, elems[idx].key) == idx);
+		}
+		if((round % 1000) == 0)
+		{
+			check_all_elems(&hashtable, elems, verbose);
+		}
+	}
+	check_all_elems(&hashtable, elems, verbose);
+
+	/* change the hash function back and forth */
+	CHECK(hashtable_set_hash(&hashtable, HASHTABLE_HASH_FAST));
+	CHECK(hashtable.hash == HASHTABLE_HASH_FAST);
+	check_all_elems(&hashtable, elems, verbose);
+	for(round = 0; round < 5000; round++)
+	{
+		const uint32_t idx = rand() % ELEMS_NR;
+
+		if(elems[idx].is_in_table)
+		{
+			hashtable_del(&hashtable, idx);
+			elems[idx].is_in_table = false;
+		}
+		else
+		{
+			CHECK(hashtable_add(&hashtable, idx));
+			elems[idx].is_in_table = true;
+		}
+	}
+	check_all_elems(&hashtable, elems, verbose);
+	CHECK(hashtable_set_hash(&hashtable, HASHTABLE_HASH_SIPHASH));
+	check_all_elems(&hashtable, elems, verbose);
+
+	/* removing an element that is not in the table does nothing */
+	for(i = 0; i < ELEMS_NR && elems[i].is_in_table; i++)
+	{
+	}
+	if(i < ELEMS_NR)
+	{
+		const uint32_t elems_nr = hashtable.elems_nr;
+		hashtable_del(&hashtable, i);
+		CHECK(hashtable.elems_nr == elems_nr);
+	}
+	check_all_elems(&hashtable, elems, verbose);
+
+	/* all the elements that share one base key are found once */
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		CHECK(hashtable_add(&base_hashtable, i));
+	}
+	for(i = 0; i < ELEMS_NR; i += ELEMS_PER_BASE)
+	{
+		bool is_found[ELEMS_PER_BASE] = { false };
+		struct hashtable_iter iter;
+		uint32_t found_nr = 0;
+		uint32_t idx;
+
+		for(idx = hashtable_get_first(&base_hashtable, elems[i].key, &iter);
+		    idx != HASHTABLE_NO_IDX;
+		    idx = hashtable_get_next(&base_hashtable, elems[i].key, &iter))
+		{
+			CHECK(idx >= i && idx < (i + ELEMS_PER_BASE));
+			CHECK(!is_found[idx - i]);
+			is_found[idx - i] = true;
+			found_nr++;
+		}
+		CHECK(found_nr == ELEMS_PER_BASE);
+	}
+
+	hashtable_free(&base_hashtable);
+	hashtable_free(&hashtable);
+
+	/* keys of variable length: the keys that share their first bytes but
+	 * differ in length are different keys */
+	{
+		static uint8_t var_keys[ELEMS_NR][40];
+
+		for(i = 0; i < ELEMS_NR; i++)
+		{
+			memset(var_keys[i], 0x42, sizeof(var_keys[i]));
+			var_keys[i][0] = 4 + (i % 30);
+			var_keys[i][1] = (i / 30) & 0xff;
+			var_keys[i][2] = ((i / 30) >> 8) & 0xff;
+			/* bytes after the length shall be ignored */
+			var_keys[i][var_keys[i][0]] = rand() & 0xff;
+		}
+		CHECK(hashtable_new(&hashtable, sizeof(var_keys[0]), true, var_keys[0],
+		                    sizeof(var_keys[0]), ELEMS_NR));
+		for(i = 0; i < ELEMS_NR; i++)
+		{
+			CHECK(hashtable_add(&hashtable, i));
+		}
+		CHECK(hashtable_set_hash(&hashtable, HASHTABLE_HASH_FAST));
+		for(i = 0; i < ELEMS_NR; i++)
+		{
+			uint8_t key[sizeof(var_keys[0])];
+
+			memcpy(key, var_keys[i], var_keys[i][0]);
+			memset(key + var_keys[i][0], 0xff, sizeof(key) - var_keys[i][0]);
+			CHECK(hashtable_get(&hashtable, key) == i);
+		}
+		for(i = 0; i < ELEMS_NR; i += 2)
+		{
+			hashtable_del(&hashtable, i);
+		}
+		for(i = 0; i < ELEMS_NR; i++)
+		{
+			CHECK(hashtable_get(&hashtable, var_keys[i]) ==
+			      ((i % 2) == 0 ? HASHTABLE_NO_IDX : i));
+		}
+		hashtable_free(&hashtable);
+	}
+
+	/* run the benchmark if asked to */
+	if(bench)
+	{
+		bench_hashtable();
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Check that the elements are found in the hash table if and only if
+ *        they were added to it
+ *
+ * @param hashtable  The hash table
+ * @param elems      The elements
+ * @param verbose    Whether to run in verbose mode or not
+ */
+static void check_all_elems(const struct hashtable *const hashtable,
+                            const struct elem *const elems,
+                            const bool verbose)
+{
+	uint32_t elems_nr = 0;
+	uint32_t i;
+
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		const uint32_t idx = hashtable_get(hashtable, elems[i].key);
+
+		if(elems[i].is_in_table)
+		{
+			CHECK(idx == i);
+			elems_nr++;
+		}
+		else
+		{
+			CHECK(idx == HASHTABLE_NO_IDX);
+		}
+	}
+	CHECK(hashtable->elems_nr == elems_nr);
+}
+
+
+/**
+ * @brief Print the time spent to find random elements in the hash table
+ *
+ * The hash table holds 16K elements as large as compression contexts, with
+ * keys as long as the fingerprints of the contexts.
+ */
+static void bench_hashtable(void)
+{
+	const hashtable_hash_t hashes[] = {
+		HASHTABLE_HASH_SIPHASH,
+		HASHTABLE_HASH_FAST,
+	};
+	const char *const hashes_descr[] = { "SipHash", "fast hash" };
+	const bool keys_compact[] = { false, true };
+	const bool verbose = false;
+	uint8_t *const elems = malloc(BENCH_ELEMS_NR * BENCH_ELEM_SIZE);
+	uint32_t *const lookups = malloc(BENCH_ROUNDS * sizeof(uint32_t));
+	struct hashtable hashtable;
+	size_t i;
+
+	CHECK(elems != NULL);
+	CHECK(lookups != NULL);
+
+	for(i = 0; i < BENCH_ELEMS_NR; i++)
+	{
+		uint8_t *const key = elems + i * BENCH_ELEM_SIZE;
+		size_t j;
+
+		for(j = 0; j < BENCH_KEY_LEN; j++)
+		{
+			key[j] = (j < 40 ? 0x42 : (rand() & 0xff));
+		}
+		key[BENCH_COMPACT_KEY_OFFSET] = BENCH_COMPACT_KEY_LEN;
+		for(j = 1; j < BENCH_COMPACT_KEY_LEN; j++)
+		{
+			key[BENCH_COMPACT_KEY_OFFSET + j] = (j < 10 ? 0x42 : (rand() & 0xff));
+		}
+	}
+	for(i = 0; i < BENCH_ROUNDS; i++)
+	{
+		lookups[i] = rand() % BENCH_ELEMS_NR;
+	}
+	for(i = 0; i < sizeof(hashtable.key); i++)
+	{
+		hashtable.key[i] = rand() & 0xff;
+	}
+
+	for(i = 0; i < (sizeof(hashes) / sizeof(hashtable_hash_t) * 2); i++)
+	{
+		const hashtable_hash_t hash = hashes[i / 2];
+		const bool is_compact = keys_compact[i % 2];
+		const size_t key_offset = (is_compact ? BENCH_COMPACT_KEY_OFFSET : 0);
+		volatile uint32_t found = 0;
+		uint64_t start;
+		size_t round;
+		uint32_t idx;
+
+		CHECK(hashtable_new(&hashtable,
+		                    (is_compact ? BENCH_COMPACT_KEY_LEN : BENCH_KEY_LEN),
+		                    is_compact, elems + key_offset,
+		                    BENCH_ELEM_SIZE, BENCH_ELEMS_NR));
+		CHECK(hashtable_set_hash(&hashtable, hash));
+		for(idx = 0; idx < BENCH_ELEMS_NR; idx++)
+		{
+			CHECK(hashtable_add(&hashtable, idx));
+		}
+
+		start = gettime_ns();
+		for(round = 0; round < BENCH_ROUNDS; round++)
+		{
+			found ^= hashtable_get(&hashtable, elems + key_offset +
+			                       lookups[round] * BENCH_ELEM_SIZE);
+		}
+		printf("%u elements, %s, %u-byte keys: %.1f ns per random lookup\n",
+		       BENCH_ELEMS_NR, hashes_descr[i / 2],
+		       (is_compact ? BENCH_COMPACT_KEY_LEN : BENCH_KEY_LEN),
+		       (gettime_ns() - start) / (double) BENCH_ROUNDS);
+
+		hashtable_free(&hashtable);
+	}
+
+	free(lookups);
+	free(elems);
+}
+
+
+/**
+ * @brief Get the current time in nanoseconds
+ *
+ * @return  The current time in nanoseconds
+ */
+static uint64_t gettime_ns(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return ((uint64_t) tv.tv_sec) * 1000000000ULL + tv.tv_usec * 1000ULL;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_spsc_ring.c
+ * @brief   Test the lock-free single-producer, single-consumer ring
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_spsc_ring.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Test the lock-free single-producer, single-consumer ring
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the single-producer, single-consumer ring\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* the size of the ring is rounded up to the next power of 2 */
+	{
+		struct rohc_spsc_ring ring;
+		uint32_t item;
+
+		CHECK(rohc_spsc_ring_new(&ring, 5));
+		CHECK(rohc_spsc_ring_get_size(&ring) == 8);
+		CHECK(!rohc_spsc_ring_is_full(&ring));
+		CHECK(!rohc_spsc_ring_peek(&ring, &item));
+		rohc_spsc_ring_free(&ring);
+
+		CHECK(rohc_spsc_ring_new(&ring, 1));
+		CHECK(rohc_spsc_ring_get_size(&ring) == 1);
+		rohc_spsc_ring_free(&ring);
+	}
+
+	/* items are given back in order, the ring may wrap around */
+	{
+		struct rohc_spsc_ring ring;
+		uint32_t next_in = 0;
+		uint32_t next_out = 0;
+		uint32_t item;
+		size_t round;
+
+		CHECK(rohc_spsc_ring_new(&ring, 4));
+		for(round = 0; round < 10; round++)
+		{
+			/* fill the ring */
+			while(!rohc_spsc_ring_is_full(&ring))
+			{
+				CHECK(rohc_spsc_ring_push(&ring, next_in));
+				next_in++;
+			}
+			CHECK(!rohc_spsc_ring_push(&ring, next_in));
+			CHECK((next_in - next_out) == 4);
+
+			/* empty some of the ring, peek does not consume the item */
+			while((next_in - next_out) > (round % 4))
+			{
+				CHECK(rohc_spsc_ring_peek(&ring, &item));
+				CHECK(item == next_out);
+				CHECK(rohc_spsc_ring_peek(&ring, &item));
+				CHECK(item == next_out);
+				rohc_spsc_ring_pop(&ring);
+				next_out++;
+			}
+		}
+		while(rohc_spsc_ring_peek(&ring, &item))
+		{
+			CHECK(item == next_out);
+			rohc_spsc_ring_pop(&ring);
+			next_out++;
+		}
+		CHECK(next_out == next_in);
+		rohc_spsc_ring_free(&ring);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -141,7 +141,8 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->last_sn);
 
 	/* create the RTP part of the profile context */
-	rtp_context = malloc(sizeof(struct sc_rtp_context));
+	rtp_context = rohc_arena_malloc(&context->compressor->arena,
+	                                sizeof(struct sc_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -163,8 +164,10 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rtp_context->old_rtp_pt = uncomp_pkt_hdrs->rtp->pt;
 	if(!c_create_sc(&rtp_context->ts_sc,
 	                context->compressor->oa_repetitions_nr,
+	                &context->compressor->arena,
 	                context->compressor->trace_callback,
-	                context->compressor->trace_callback_priv))
+	                context->compressor->trace_callback_priv,
+	                context->compressor->trace_min_level))
 	{
 		rohc_comp_warn(context, "cannot create scaled RTP Timestamp encoding");
 		goto clean;
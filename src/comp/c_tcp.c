@@ -64,6 +64,12 @@
 #define TRACE_GOTO_CHOICE \
 	rohc_comp_debug(context, "Compressed format choice LINE %d", __LINE__ )
 
+/** The number of W-LSB objects in the W-LSB store of one TCP context */
+#define C_TCP_WLSB_FIELDS_NR         10U
+/** The number of W-LSB objects updated with every packet (see
+ *  \ref c_tcp_get_wlsb_fields for their order) */
+#define C_TCP_WLSB_SHARED_FIELDS_NR  5U
+
 
 /*
  * Private function prototypes.
@@ -80,6 +86,10 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+static void c_tcp_get_wlsb_fields(struct sc_tcp_context *const tcp_context,
+                                  struct c_wlsb *fields[C_TCP_WLSB_FIELDS_NR])
+	__attribute__((nonnull(1, 2)));
+
 static bool c_tcp_is_cr_possible(const struct rohc_comp_ctxt *const ctxt,
 	                              const struct rohc_pkt_hdrs *const pkt_hdrs)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -119,38 +129,32 @@ static void tcp_detect_changes_tcp_hdr(const struct rohc_comp_ctxt *const contex
 	__attribute__((nonnull(1, 2, 3, 4)));
 
 static rohc_packet_t tcp_decide_packet(const struct rohc_comp_ctxt *const context,
-                                       const struct rohc_comp_ctxt *const ref_ctxt,
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                        const struct tcp_tmp_variables *const tmp)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 static rohc_packet_t tcp_decide_FO_packet(const struct rohc_comp_ctxt *const context,
-                                          const struct rohc_comp_ctxt *const ref_ctxt,
                                           const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                           const struct tcp_tmp_variables *const tmp)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 static rohc_packet_t tcp_decide_SO_packet(const struct rohc_comp_ctxt *const context,
-                                          const struct rohc_comp_ctxt *const ref_ctxt,
                                           const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                           const struct tcp_tmp_variables *const tmp)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const context,
-                                             const struct rohc_comp_ctxt *const ref_ctxt,
                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                              const struct tcp_tmp_variables *const tmp,
                                              const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
                                                  const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
                                                  const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 /* IR and CO packets */
 static int code_IR_packet(const struct rohc_comp_ctxt *const context,
@@ -427,11 +431,13 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 {
 	const struct rohc_comp *const comp = ctxt->compressor;
 	const struct sc_tcp_context *const base_tcp_ctxt = base_ctxt->specific;
+	struct rohc_arena *const arena = &ctxt->compressor->arena;
+	struct c_wlsb *wlsb_fields[C_TCP_WLSB_FIELDS_NR];
 	struct sc_tcp_context *tcp_ctxt;
 	bool is_ok;
 
 	/* create the TCP part of the profile context */
-	tcp_ctxt = malloc(sizeof(struct sc_tcp_context));
+	tcp_ctxt = rohc_arena_malloc(arena, sizeof(struct sc_tcp_context));
 	if(tcp_ctxt == NULL)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -446,121 +452,25 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	 * don't want the initialization to restart */
 	ctxt->num_sent_packets = base_ctxt->num_sent_packets;
 
-	/* MSN */
-	is_ok = wlsb_copy(&tcp_ctxt->msn_wlsb, &base_tcp_ctxt->msn_wlsb);
+	/* windows of all the W-LSB objects */
+	c_tcp_get_wlsb_fields(tcp_ctxt, wlsb_fields);
+	is_ok = wlsb_store_copy(&tcp_ctxt->wlsb_store, wlsb_fields,
+	                        &base_tcp_ctxt->wlsb_store, arena);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for MSN");
+		           "failed to create W-LSB contexts");
 		goto free_context;
 	}
 
-	/* IP-ID offset */
-	is_ok = wlsb_copy(&tcp_ctxt->ip_id_wlsb, &base_tcp_ctxt->ip_id_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for IP-ID offset");
-		goto free_wlsb_msn;
-	}
-
-	/* innermost IPv4 TTL or IPv6 Hop Limit */
-	is_ok = wlsb_copy(&tcp_ctxt->ttl_hopl_wlsb, &base_tcp_ctxt->ttl_hopl_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for innermost IPv4 TTL or "
-		           "IPv6 Hop Limit");
-		goto free_wlsb_ip_id;
-	}
-
-	/* TCP window */
-	is_ok = wlsb_copy(&tcp_ctxt->window_wlsb, &base_tcp_ctxt->window_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for TCP window");
-		goto free_wlsb_ttl_hopl;
-	}
-
-	/* TCP sequence number */
-	is_ok = wlsb_copy(&tcp_ctxt->seq_wlsb, &base_tcp_ctxt->seq_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for TCP sequence number");
-		goto free_wlsb_window;
-	}
-	is_ok = wlsb_copy(&tcp_ctxt->seq_scaled_wlsb, &base_tcp_ctxt->seq_scaled_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for TCP scaled sequence "
-		           "number");
-		goto free_wlsb_seq;
-	}
-
-	/* TCP acknowledgment (ACK) number */
-	is_ok = wlsb_copy(&tcp_ctxt->ack_wlsb, &base_tcp_ctxt->ack_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for TCP ACK number");
-		goto free_wlsb_seq_scaled;
-	}
-	is_ok = wlsb_copy(&tcp_ctxt->ack_scaled_wlsb, &base_tcp_ctxt->ack_scaled_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for TCP scaled ACK number");
-		goto free_wlsb_ack;
-	}
-
 	/* init the Master Sequence Number to a random value */
 	tcp_ctxt->last_msn = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
 	rohc_comp_debug(ctxt, "MSN = 0x%04x / %u", tcp_ctxt->last_msn, tcp_ctxt->last_msn);
 
-	/* TCP option Timestamp (request) */
-	is_ok = wlsb_copy(&tcp_ctxt->tcp_opts.ts_req_wlsb, &base_tcp_ctxt->tcp_opts.ts_req_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for TCP option Timestamp "
-		           "request");
-		goto free_wlsb_ack_scaled;
-	}
-	/* TCP option Timestamp (reply) */
-	is_ok = wlsb_copy(&tcp_ctxt->tcp_opts.ts_reply_wlsb, &base_tcp_ctxt->tcp_opts.ts_reply_wlsb);
-	if(!is_ok)
-	{
-		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
-		           "failed to create W-LSB context for TCP option Timestamp "
-		           "reply");
-		goto free_wlsb_opt_ts_req;
-	}
-
 	return true;
 
-free_wlsb_opt_ts_req:
-	wlsb_free(&tcp_ctxt->tcp_opts.ts_req_wlsb);
-free_wlsb_ack_scaled:
-	wlsb_free(&tcp_ctxt->ack_scaled_wlsb);
-free_wlsb_ack:
-	wlsb_free(&tcp_ctxt->ack_wlsb);
-free_wlsb_seq_scaled:
-	wlsb_free(&tcp_ctxt->seq_scaled_wlsb);
-free_wlsb_seq:
-	wlsb_free(&tcp_ctxt->seq_wlsb);
-free_wlsb_window:
-	wlsb_free(&tcp_ctxt->window_wlsb);
-free_wlsb_ttl_hopl:
-	wlsb_free(&tcp_ctxt->ttl_hopl_wlsb);
-free_wlsb_ip_id:
-	wlsb_free(&tcp_ctxt->ip_id_wlsb);
-free_wlsb_msn:
-	wlsb_free(&tcp_ctxt->msn_wlsb);
 free_context:
-	free(tcp_ctxt);
+	rohc_arena_free(tcp_ctxt);
 error:
 	return false;
 }
@@ -582,6 +492,8 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 {
 	const struct rohc_comp *const comp = context->compressor;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
+	struct rohc_arena *const arena = &context->compressor->arena;
+	struct c_wlsb *wlsb_fields[C_TCP_WLSB_FIELDS_NR];
 	struct sc_tcp_context *tcp_context;
 	size_t ipv4_hdrs_nr;
 	size_t ip_hdr_pos;
@@ -592,7 +504,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	assert(uncomp_pkt_hdrs->tcp != NULL);
 
 	/* create the TCP part of the profile context */
-	tcp_context = calloc(1, sizeof(struct sc_tcp_context));
+	tcp_context = rohc_arena_calloc(arena, sizeof(struct sc_tcp_context));
 	if(tcp_context == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -669,76 +581,18 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 		tcp_context->outer_ip_id_behavior_trans_nr = 0;
 	}
 
-	/* MSN */
-	is_ok = wlsb_new(&tcp_context->msn_wlsb, comp->oa_repetitions_nr);
+	/* windows of all the W-LSB objects */
+	c_tcp_get_wlsb_fields(tcp_context, wlsb_fields);
+	is_ok = wlsb_store_new(&tcp_context->wlsb_store, wlsb_fields,
+	                       C_TCP_WLSB_FIELDS_NR, C_TCP_WLSB_SHARED_FIELDS_NR,
+	                       comp->oa_repetitions_nr, arena);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for MSN");
+		           "failed to create W-LSB contexts");
 		goto free_context;
 	}
 
-	/* IP-ID offset */
-	is_ok = wlsb_new(&tcp_context->ip_id_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for IP-ID offset");
-		goto free_wlsb_msn;
-	}
-
-	/* innermost IPv4 TTL or IPv6 Hop Limit */
-	is_ok = wlsb_new(&tcp_context->ttl_hopl_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for innermost IPv4 TTL or "
-		           "IPv6 Hop Limit");
-		goto free_wlsb_ip_id;
-	}
-
-	/* TCP window */
-	is_ok = wlsb_new(&tcp_context->window_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP window");
-		goto free_wlsb_ttl_hopl;
-	}
-
-	/* TCP sequence number */
-	is_ok = wlsb_new(&tcp_context->seq_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP sequence number");
-		goto free_wlsb_window;
-	}
-	is_ok = wlsb_new(&tcp_context->seq_scaled_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP scaled sequence "
-		           "number");
-		goto free_wlsb_seq;
-	}
-
-	/* TCP acknowledgment (ACK) number */
-	is_ok = wlsb_new(&tcp_context->ack_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP ACK number");
-		goto free_wlsb_seq_scaled;
-	}
-	is_ok = wlsb_new(&tcp_context->ack_scaled_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP scaled ACK number");
-		goto free_wlsb_ack;
-	}
-
 	/* init the Master Sequence Number to a random value */
 	tcp_context->last_msn = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
 	rohc_comp_debug(context, "MSN = 0x%04x / %u", tcp_context->last_msn, tcp_context->last_msn);
@@ -752,47 +606,10 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 		tcp_context->tcp_opts.list[i].used = false;
 	}
 
-	/* TCP option Timestamp (request) */
-	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_req_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP option Timestamp "
-		           "request");
-		goto free_wlsb_ack_scaled;
-	}
-	/* TCP option Timestamp (reply) */
-	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_reply_wlsb, comp->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP option Timestamp "
-		           "reply");
-		goto free_wlsb_opt_ts_req;
-	}
-
 	return true;
 
-free_wlsb_opt_ts_req:
-	wlsb_free(&tcp_context->tcp_opts.ts_req_wlsb);
-free_wlsb_ack_scaled:
-	wlsb_free(&tcp_context->ack_scaled_wlsb);
-free_wlsb_ack:
-	wlsb_free(&tcp_context->ack_wlsb);
-free_wlsb_seq_scaled:
-	wlsb_free(&tcp_context->seq_scaled_wlsb);
-free_wlsb_seq:
-	wlsb_free(&tcp_context->seq_wlsb);
-free_wlsb_window:
-	wlsb_free(&tcp_context->window_wlsb);
-free_wlsb_ttl_hopl:
-	wlsb_free(&tcp_context->ttl_hopl_wlsb);
-free_wlsb_ip_id:
-	wlsb_free(&tcp_context->ip_id_wlsb);
-free_wlsb_msn:
-	wlsb_free(&tcp_context->msn_wlsb);
 free_context:
-	free(tcp_context);
+	rohc_arena_free(tcp_context);
 error:
 	return false;
 }
@@ -807,17 +624,38 @@ static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
 
-	wlsb_free(&tcp_context->tcp_opts.ts_reply_wlsb);
-	wlsb_free(&tcp_context->tcp_opts.ts_req_wlsb);
-	wlsb_free(&tcp_context->ack_scaled_wlsb);
-	wlsb_free(&tcp_context->ack_wlsb);
-	wlsb_free(&tcp_context->seq_scaled_wlsb);
-	wlsb_free(&tcp_context->seq_wlsb);
-	wlsb_free(&tcp_context->window_wlsb);
-	wlsb_free(&tcp_context->ip_id_wlsb);
-	wlsb_free(&tcp_context->ttl_hopl_wlsb);
-	wlsb_free(&tcp_context->msn_wlsb);
-	free(tcp_context);
+	wlsb_store_free(&tcp_context->wlsb_store);
+	rohc_arena_free(tcp_context);
+}
+
+
+/**
+ * @brief Get the W-LSB objects of the W-LSB store of one TCP context
+ *
+ * The W-LSB objects that are updated with every packet come first, so that
+ * they share the SN ring of the W-LSB store: MSN, innermost TTL/Hop Limit,
+ * TCP sequence number, TCP ACK number and TCP window. The W-LSB objects that
+ * are updated with some packets only follow: innermost IP-ID, scaled TCP
+ * sequence number, scaled TCP ACK number and TCP Timestamp option.
+ *
+ * @param tcp_context  The TCP compression context
+ * @param[out] fields  The W-LSB objects of the TCP compression context
+ */
+static void c_tcp_get_wlsb_fields(struct sc_tcp_context *const tcp_context,
+                                  struct c_wlsb *fields[C_TCP_WLSB_FIELDS_NR])
+{
+	/* W-LSB objects updated with every packet */
+	fields[0] = &tcp_context->msn_wlsb;
+	fields[1] = &tcp_context->ttl_hopl_wlsb;
+	fields[2] = &tcp_context->seq_wlsb;
+	fields[3] = &tcp_context->ack_wlsb;
+	fields[4] = &tcp_context->window_wlsb;
+	/* W-LSB objects updated with some packets only */
+	fields[5] = &tcp_context->ip_id_wlsb;
+	fields[6] = &tcp_context->seq_scaled_wlsb;
+	fields[7] = &tcp_context->ack_scaled_wlsb;
+	fields[8] = &tcp_context->tcp_opts.ts_req_wlsb;
+	fields[9] = &tcp_context->tcp_opts.ts_reply_wlsb;
 }
 
 
@@ -925,7 +763,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		tcp_detect_changes(context, ref_ctxt, inner_ip_ref_ctxt, uncomp_pkt_hdrs, &tmp);
 
 		/* decide which packet to send */
-		*packet_type = tcp_decide_packet(context, ref_ctxt, uncomp_pkt_hdrs, &tmp);
+		*packet_type = tcp_decide_packet(context, uncomp_pkt_hdrs, &tmp);
 		if((*packet_type) == ROHC_PACKET_UNKNOWN)
 		{
 			rohc_comp_warn(context, "failed to find the packet type to encode");
@@ -1619,6 +1457,7 @@ static int code_CO_packet(const struct rohc_comp_ctxt *const context,
                           const rohc_packet_t packet_type)
 {
 	const rohc_cid_type_t cid_type = context->compressor->medium.cid_type;
+	struct sc_tcp_context *const tcp_context = context->specific;
 
 	const uint8_t *const uncomp_data = (uint8_t *) uncomp_pkt_hdrs->ip_hdrs[0].ip;
 
@@ -1639,16 +1478,16 @@ static int code_CO_packet(const struct rohc_comp_ctxt *const context,
 	   packet_type == ROHC_PACKET_TCP_CO_COMMON)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
-			              CRC_INIT_7);
+			crc_calc_cached(&tcp_context->crc_cache, ROHC_CRC_TYPE_7,
+			                uncomp_data, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
-			              CRC_INIT_3);
+			crc_calc_cached(&tcp_context->crc_cache, ROHC_CRC_TYPE_3,
+			                uncomp_data, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-3 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -3507,6 +3346,24 @@ static void tcp_detect_changes(const struct rohc_comp_ctxt *const context,
 	/* parse TCP options for changes */
 	tcp_detect_options_changes(context, uncomp_pkt_hdrs, &tcp_context->tcp_opts,
 	                           &tmp->tcp_opts, !tmp->tcp_ack_num_unchanged);
+
+	/* walk every W-LSB window once, so that the packet decision only checks
+	 * the offsets for every candidate number of bits */
+	wlsb_get_range_16bits(&tcp_context->msn_wlsb, tmp->new_msn, &tmp->msn_range);
+	wlsb_get_range_16bits(&tcp_context->ip_id_wlsb, tmp->ip_id_delta,
+	                      &tmp->ip_id_range);
+	wlsb_get_range_8bits(&tcp_context->ttl_hopl_wlsb,
+	                     uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
+	                     &tmp->ttl_hopl_range);
+	wlsb_get_range_16bits(&tcp_context->window_wlsb,
+	                      rohc_ntoh16(uncomp_pkt_hdrs->tcp->window),
+	                      &tmp->window_range);
+	wlsb_get_range_32bits(&tcp_context->seq_wlsb, tmp->seq_num, &tmp->seq_range);
+	wlsb_get_range_32bits(&tcp_context->seq_scaled_wlsb, tmp->seq_num_scaled,
+	                      &tmp->seq_scaled_range);
+	wlsb_get_range_32bits(&tcp_context->ack_wlsb, tmp->ack_num, &tmp->ack_range);
+	wlsb_get_range_32bits(&tcp_context->ack_scaled_wlsb, tmp->ack_num_scaled,
+	                      &tmp->ack_scaled_range);
 }
 
 
@@ -3954,7 +3811,6 @@ static void tcp_detect_changes_tcp_hdr(const struct rohc_comp_ctxt *const contex
  * @brief Decide which packet to send when in the different states.
  *
  * @param context           The real compression context for traces and update
- * @param ref_ctxt          The reference compression context to detect changes
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
  * @return                  \li The packet type among ROHC_PACKET_IR,
@@ -3964,7 +3820,6 @@ static void tcp_detect_changes_tcp_hdr(const struct rohc_comp_ctxt *const contex
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t tcp_decide_packet(const struct rohc_comp_ctxt *const context,
-                                       const struct rohc_comp_ctxt *const ref_ctxt,
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                        const struct tcp_tmp_variables *const tmp)
 {
@@ -3989,10 +3844,10 @@ static rohc_packet_t tcp_decide_packet(const struct rohc_comp_ctxt *const contex
 			}
 			break;
 		case ROHC_COMP_STATE_FO: /* The First Order (FO) state */
-			packet_type = tcp_decide_FO_packet(context, ref_ctxt, uncomp_pkt_hdrs, tmp);
+			packet_type = tcp_decide_FO_packet(context, uncomp_pkt_hdrs, tmp);
 			break;
 		case ROHC_COMP_STATE_SO: /* The Second Order (SO) state */
-			packet_type = tcp_decide_SO_packet(context, ref_ctxt, uncomp_pkt_hdrs, tmp);
+			packet_type = tcp_decide_SO_packet(context, uncomp_pkt_hdrs, tmp);
 			break;
 		case ROHC_COMP_STATE_UNKNOWN:
 		default:
@@ -4011,7 +3866,6 @@ static rohc_packet_t tcp_decide_packet(const struct rohc_comp_ctxt *const contex
  * @brief Decide which packet to send when in FO state.
  *
  * @param context           The real compression context for traces and update
- * @param ref_ctxt          The reference compression context to detect changes
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
  * @return                  \li The packet type among ROHC_PACKET_IR,
@@ -4021,12 +3875,11 @@ static rohc_packet_t tcp_decide_packet(const struct rohc_comp_ctxt *const contex
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t tcp_decide_FO_packet(const struct rohc_comp_ctxt *const context,
-                                          const struct rohc_comp_ctxt *const ref_ctxt,
                                           const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                           const struct tcp_tmp_variables *const tmp)
 {
 	const bool crc7_at_least = true;
-	return tcp_decide_FO_SO_packet(context, ref_ctxt, uncomp_pkt_hdrs, tmp, crc7_at_least);
+	return tcp_decide_FO_SO_packet(context, uncomp_pkt_hdrs, tmp, crc7_at_least);
 }
 
 
@@ -4034,7 +3887,6 @@ static rohc_packet_t tcp_decide_FO_packet(const struct rohc_comp_ctxt *const con
  * @brief Decide which packet to send when in SO state.
  *
  * @param context           The real compression context for traces and update
- * @param ref_ctxt          The reference compression context to detect changes
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
  * @return                  \li The packet type among ROHC_PACKET_IR,
@@ -4045,12 +3897,11 @@ static rohc_packet_t tcp_decide_FO_packet(const struct rohc_comp_ctxt *const con
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t tcp_decide_SO_packet(const struct rohc_comp_ctxt *const context,
-                                          const struct rohc_comp_ctxt *const ref_ctxt,
                                           const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                           const struct tcp_tmp_variables *const tmp)
 {
 	const bool crc7_at_least = false;
-	return tcp_decide_FO_SO_packet(context, ref_ctxt, uncomp_pkt_hdrs, tmp, crc7_at_least);
+	return tcp_decide_FO_SO_packet(context, uncomp_pkt_hdrs, tmp, crc7_at_least);
 }
 
 
@@ -4058,7 +3909,6 @@ static rohc_packet_t tcp_decide_SO_packet(const struct rohc_comp_ctxt *const con
  * @brief Decide which packet to send when in FO or SO state.
  *
  * @param context           The real compression context for traces and update
- * @param ref_ctxt          The reference compression context to detect changes
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
  * @param crc7_at_least     Whether packet types with CRC strictly smaller
@@ -4070,12 +3920,10 @@ static rohc_packet_t tcp_decide_SO_packet(const struct rohc_comp_ctxt *const con
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const context,
-                                             const struct rohc_comp_ctxt *const ref_ctxt,
                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                              const struct tcp_tmp_variables *const tmp,
                                              const bool crc7_at_least)
 {
-	const struct sc_tcp_context *const tcp_ref_ctxt = ref_ctxt->specific;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 	rohc_packet_t packet_type;
 
@@ -4097,8 +3945,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		                "IP-ID changed its behavior");
 		packet_type = ROHC_PACKET_IR_DYN;
 	}
-	else if(!wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->msn_wlsb, tmp->new_msn, 4,
-	                                    ROHC_LSB_SHIFT_TCP_SN))
+	else if(!wlsb_range_is_kp_possible(&tmp->msn_range, 4, ROHC_LSB_SHIFT_TCP_SN))
 	{
 		rohc_comp_debug(context, "force packet IR-DYN because the MSN changed "
 		                "too much");
@@ -4132,12 +3979,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		 *  - use common if too many LSB of innermost TTL/Hop Limit are required
 		 *  - use common if window changed */
 		if(tmp->innermost_ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb, tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		   wlsb_range_is_kp_possible(&tmp->ip_id_range, 4, 3) &&
+		   wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191) &&
+		   wlsb_range_is_kp_possible(&tmp->ttl_hopl_range, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		   !tmp->tcp_window_changed)
 		{
 			/* ROHC_IP_ID_BEHAVIOR_SEQ or ROHC_IP_ID_BEHAVIOR_SEQ_SWAP */
@@ -4145,11 +3990,9 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
 		}
 		else if(tmp->innermost_ip_id_behavior > ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 65535) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383) &&
+		        wlsb_range_is_kp_possible(&tmp->ttl_hopl_range, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		        !tmp->tcp_window_changed)
 		{
 			TRACE_GOTO_CHOICE;
@@ -4165,7 +4008,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 	{
 		/* ROHC_IP_ID_BEHAVIOR_SEQ or ROHC_IP_ID_BEHAVIOR_SEQ_SWAP:
 		 * co_common or seq_X packet types */
-		packet_type = tcp_decide_FO_SO_packet_seq(context, ref_ctxt, uncomp_pkt_hdrs,
+		packet_type = tcp_decide_FO_SO_packet_seq(context, uncomp_pkt_hdrs,
 		                                          tmp, crc7_at_least);
 	}
 	else if(tmp->innermost_ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND ||
@@ -4173,7 +4016,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 	{
 		/* ROHC_IP_ID_BEHAVIOR_RAND or ROHC_IP_ID_BEHAVIOR_ZERO:
 		 * co_common or rnd_X packet types */
-		packet_type = tcp_decide_FO_SO_packet_rnd(context, ref_ctxt, uncomp_pkt_hdrs,
+		packet_type = tcp_decide_FO_SO_packet_rnd(context, uncomp_pkt_hdrs,
 		                                          tmp, crc7_at_least);
 	}
 	else
@@ -4198,7 +4041,6 @@ error:
  * @brief Decide which seq packet to send when in FO or SO state.
  *
  * @param context           The real compression context for traces and update
- * @param ref_ctxt          The reference compression context to detect changes
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
  * @param crc7_at_least     Whether packet types with CRC strictly smaller
@@ -4208,12 +4050,10 @@ error:
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
                                                  const bool crc7_at_least)
 {
-	const struct sc_tcp_context *const tcp_ref_ctxt = ref_ctxt->specific;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 	rohc_packet_t packet_type;
 
@@ -4222,12 +4062,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	   !tmp->tcp_window_changed &&
 	   (tcp->ack_flag == 0 || tmp->tcp_ack_num_unchanged) &&
 	   !crc7_at_least &&
-	   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-	                              tmp->ip_id_delta, 7, 3) &&
+	   wlsb_range_is_kp_possible(&tmp->ip_id_range, 7, 3) &&
 	   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
 	                             tmp->seq_num_scaling_changed) &&
-	   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-	                              tmp->seq_num_scaled, 4, 7))
+	   wlsb_range_is_kp_possible(&tmp->seq_scaled_range, 4, 7))
 	{
 		/* seq_2 is possible */
 		TRACE_GOTO_CHOICE;
@@ -4245,13 +4083,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 		 *  - at most 15 LSB of the TCP ACK number are required,
 		 *  - at most 4 LSBs of IP-ID must be transmitted
 		 * otherwise use co_common packet */
-		if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		if(wlsb_range_is_kp_possible(&tmp->ip_id_range, 4, 3) &&
+		   wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191) &&
+		   wlsb_range_is_kp_possible(&tmp->ttl_hopl_range, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		   !tmp->tcp_window_changed)
 		{
 			/* seq_8 is possible */
@@ -4268,11 +4103,9 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	{
 		/* seq_7 or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->window_wlsb,
-		                              rohc_ntoh16(tcp->window), 15, 16383) &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 5, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 32767) &&
+		   wlsb_range_is_kp_possible(&tmp->window_range, 15, 16383) &&
+		   wlsb_range_is_kp_possible(&tmp->ip_id_range, 5, 3) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 16, 32767) &&
 		   tmp->tcp_seq_num_unchanged)
 		{
 			/* seq_7 is possible */
@@ -4290,12 +4123,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	{
 		/* seq_2, seq_1 or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 7, 3) &&
+		   wlsb_range_is_kp_possible(&tmp->ip_id_range, 7, 3) &&
 		   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
 		                             tmp->seq_num_scaling_changed) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                              tmp->seq_num_scaled, 4, 7))
+		   wlsb_range_is_kp_possible(&tmp->seq_scaled_range, 4, 7))
 		{
 			/* seq_2 is possible */
 			TRACE_GOTO_CHOICE;
@@ -4303,19 +4134,17 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_SEQ_2;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 32767))
+		        wlsb_range_is_kp_possible(&tmp->ip_id_range, 4, 3) &&
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 32767))
 		{
 			/* seq_1 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_1;
 		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
+		else if(wlsb_range_is_kp_possible(&tmp->ip_id_range, 4, 3) &&
 		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
@@ -4330,29 +4159,25 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	{
 		/* seq_4, seq_3, or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 3, 1) &&
+		   wlsb_range_is_kp_possible(&tmp->ip_id_range, 3, 1) &&
 		   is_field_scaling_possible(tmp->ack_stride,
 		                             tmp->ack_num_scaling_changed) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_scaled_wlsb,
-		                              tmp->ack_num_scaled, 4, 3))
+		   wlsb_range_is_kp_possible(&tmp->ack_scaled_range, 4, 3))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_4;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+		        wlsb_range_is_kp_possible(&tmp->ip_id_range, 4, 3) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_3;
 		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
+		else if(wlsb_range_is_kp_possible(&tmp->ip_id_range, 4, 3) &&
 		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
@@ -4363,34 +4188,30 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_CO_COMMON;
 		}
 	}
-	else if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-	                                   tmp->ip_id_delta, 4, 3))
+	else if(wlsb_range_is_kp_possible(&tmp->ip_id_range, 4, 3))
 	{
 		/* sequence and acknowledgment numbers changed:
 		 * seq_6, seq_5, seq_8 or co_common */
 		if(!crc7_at_least &&
 		   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
 		                             tmp->seq_num_scaling_changed) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                              tmp->seq_num_scaled, 4, 7) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+		   wlsb_range_is_kp_possible(&tmp->seq_scaled_range, 4, 7) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			assert(uncomp_pkt_hdrs->payload_len > 0);
 			packet_type = ROHC_PACKET_TCP_SEQ_6;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 32767))
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383) &&
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 32767))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_5;
 		}
-		else if(wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		        wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		else if(wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ttl_hopl_range, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		        !tmp->tcp_window_changed)
 		{
 			TRACE_GOTO_CHOICE;
@@ -4421,7 +4242,6 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
  * @brief Decide which rnd packet to send when in FO or SO state.
  *
  * @param context           The real compression context for traces and update
- * @param ref_ctxt          The reference compression context to detect changes
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
  * @param crc7_at_least     Whether packet types with CRC strictly smaller
@@ -4431,12 +4251,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
                                                  const bool crc7_at_least)
 {
-	const struct sc_tcp_context *const tcp_ref_ctxt = ref_ctxt->specific;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 	rohc_packet_t packet_type;
 
@@ -4447,8 +4265,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 	   tmp->tcp_ack_num_unchanged &&
 	   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
 	                             tmp->seq_num_scaling_changed) &&
-	   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-	                              tmp->seq_num_scaled, 4, 7))
+	   wlsb_range_is_kp_possible(&tmp->seq_scaled_range, 4, 7))
 	{
 		/* rnd_2 is possible */
 		assert(uncomp_pkt_hdrs->payload_len > 0);
@@ -4459,8 +4276,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 	        tmp->tcp_opts.is_list_needed)
 	{
 		if(!tmp->tcp_window_changed &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+		   wlsb_range_is_kp_possible(&tmp->seq_range, 16, 65535) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_8;
@@ -4477,7 +4294,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		{
 			if(!crc7_at_least &&
 			   tmp->tcp_seq_num_unchanged &&
-			   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 18, 65535))
+			   wlsb_range_is_kp_possible(&tmp->ack_range, 18, 65535))
 			{
 				/* rnd_7 is possible */
 				TRACE_GOTO_CHOICE;
@@ -4494,8 +4311,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		        tmp->tcp_ack_num_unchanged &&
 		        is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
 		                                  tmp->seq_num_scaling_changed) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                                   tmp->seq_num_scaled, 4, 7))
+		        wlsb_range_is_kp_possible(&tmp->seq_scaled_range, 4, 7))
 		{
 			/* rnd_2 is possible */
 			assert(uncomp_pkt_hdrs->payload_len > 0);
@@ -4506,8 +4322,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		        tcp->ack_flag != 0 &&
 		        is_field_scaling_possible(tmp->ack_stride,
 		                                  tmp->ack_num_scaling_changed) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_scaled_wlsb,
-		                                   tmp->ack_num_scaled, 4, 3) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_scaled_range, 4, 3) &&
 		        tmp->tcp_seq_num_unchanged)
 		{
 			/* rnd_4 is possible */
@@ -4517,14 +4332,14 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		else if(!crc7_at_least &&
 		        tcp->ack_flag != 0 &&
 		        tmp->tcp_seq_num_unchanged &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			/* rnd_3 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_3;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 18, 65535) &&
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 18, 65535) &&
 		        tmp->tcp_ack_num_unchanged)
 		{
 			/* rnd_1 is possible */
@@ -4535,9 +4350,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		        tcp->ack_flag != 0 &&
 		        is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
 		                                  tmp->seq_num_scaling_changed) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                                   tmp->seq_num_scaled, 4, 7) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+		        wlsb_range_is_kp_possible(&tmp->seq_scaled_range, 4, 7) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			/* ACK number present */
 			/* rnd_6 is possible */
@@ -4547,8 +4361,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		}
 		else if(!crc7_at_least &&
 		        tcp->ack_flag != 0 &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			/* ACK number present */
 			/* rnd_5 is possible */
@@ -4556,8 +4370,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_RND_5;
 		}
 		else if(/* !tmp->tcp_window_changed && */
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 65535) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			/* fallback on rnd_8 */
 			TRACE_GOTO_CHOICE;
@@ -4922,48 +4736,18 @@ static void c_tcp_feedback_ack(struct rohc_comp_ctxt *const context,
 	 * is established, positive ACKs may remove older values from the windows */
 	if(!sn_not_valid)
 	{
+		struct c_wlsb *wlsb_fields[C_TCP_WLSB_FIELDS_NR];
 		size_t acked_nr;
 
 		assert(sn_bits_nr <= 16);
 		assert(sn_bits <= 0xffffU);
 
-		/* ack TTL or Hop Limit */
-		acked_nr = wlsb_ack(&tcp_context->ttl_hopl_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TTL or Hop Limit W-LSB", acked_nr);
-		/* ack innermost IP-ID */
-		acked_nr = wlsb_ack(&tcp_context->ip_id_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from innermost IP-ID W-LSB", acked_nr);
-		/* ack TCP window */
-		acked_nr = wlsb_ack(&tcp_context->window_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP window W-LSB", acked_nr);
-		/* ack TCP (scaled) sequence number */
-		acked_nr = wlsb_ack(&tcp_context->seq_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP sequence number W-LSB", acked_nr);
-		acked_nr = wlsb_ack(&tcp_context->seq_scaled_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP scaled sequence number W-LSB", acked_nr);
-		/* ack TCP (scaled) acknowledgment number */
-		acked_nr = wlsb_ack(&tcp_context->ack_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP acknowledgment number W-LSB", acked_nr);
-		acked_nr = wlsb_ack(&tcp_context->ack_scaled_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP scaled acknowledgment number W-LSB", acked_nr);
-		/* ack TCP TS option */
-		acked_nr = wlsb_ack(&tcp_context->tcp_opts.ts_req_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP TS request W-LSB", acked_nr);
-		acked_nr = wlsb_ack(&tcp_context->tcp_opts.ts_reply_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP TS reply W-LSB", acked_nr);
-		/* ack SN */
-		acked_nr = wlsb_ack(&tcp_context->msn_wlsb, sn_bits, sn_bits_nr);
+		/* ack all the W-LSB objects at once */
+		c_tcp_get_wlsb_fields(tcp_context, wlsb_fields);
+		acked_nr = wlsb_store_ack(&tcp_context->wlsb_store, wlsb_fields,
+		                          sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from SN W-LSB", acked_nr);
+		                "from the W-LSB objects", acked_nr);
 	}
 
 	/* RFC 6846, §5.2.2.1:
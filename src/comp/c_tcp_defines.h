@@ -33,6 +33,7 @@
 #include "protocols/tcp.h"
 #include "schemes/ip_ctxt.h"
 #include "c_tcp_opts_list.h"
+#include "crc.h"
 
 
 /**
@@ -125,6 +126,23 @@ struct tcp_tmp_variables
 	uint32_t ack_num_scaling_just_changed:1;
 	uint32_t ack_num_scaling_changed:1;
 
+	/** The offsets between the new MSN and its W-LSB window */
+	struct c_wlsb_range msn_range;
+	/** The offsets between the new innermost IP-ID delta and its W-LSB window */
+	struct c_wlsb_range ip_id_range;
+	/** The offsets between the new innermost TTL/HL and its W-LSB window */
+	struct c_wlsb_range ttl_hopl_range;
+	/** The offsets between the new TCP window and its W-LSB window */
+	struct c_wlsb_range window_range;
+	/** The offsets between the new sequence number and its W-LSB window */
+	struct c_wlsb_range seq_range;
+	/** The offsets between the new scaled sequence number and its W-LSB window */
+	struct c_wlsb_range seq_scaled_range;
+	/** The offsets between the new ACK number and its W-LSB window */
+	struct c_wlsb_range ack_range;
+	/** The offsets between the new scaled ACK number and its W-LSB window */
+	struct c_wlsb_range ack_scaled_range;
+
 	/** The temporary part of the context for TCP options */
 	struct c_tcp_opts_ctxt_tmp tcp_opts;
 };
@@ -193,12 +211,17 @@ struct sc_tcp_context
 	struct c_wlsb seq_scaled_wlsb;
 	struct c_wlsb ack_wlsb;
 	struct c_wlsb ack_scaled_wlsb;
+	/** The memory block for the windows of all the W-LSB objects */
+	struct c_wlsb_store wlsb_store;
 
 	/** The compression context for TCP options */
 	struct c_tcp_opts_ctxt tcp_opts;
 
 	uint16_t urg_ptr_nbo;
 	uint16_t window_nbo;
+
+	/** The CRC of the last uncompressed headers */
+	struct rohc_crc_cache crc_cache;
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -126,7 +126,8 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 	                rfc3095_ctxt->last_sn);
 
 	/* create the UDP part of the profile context */
-	udp_context = malloc(sizeof(struct sc_udp_context));
+	udp_context = rohc_arena_malloc(&context->compressor->arena,
+	                                sizeof(struct sc_udp_context));
 	if(udp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -61,6 +61,10 @@ struct comp_rfc5225_tmp_variables
 	uint16_t innermost_ip_id;
 	/** The new innermost IP-ID / SN delta (with bits swapped if necessary) */
 	uint16_t innermost_ip_id_offset;
+	/** The W-LSB range of the new innermost IP-ID / SN delta */
+	struct c_wlsb_range innermost_ip_id_offset_range;
+	/** The W-LSB range of the new MSN */
+	struct c_wlsb_range msn_range;
 
 	/** The new innermost DF value */
 	uint8_t innermost_df;
@@ -166,6 +170,9 @@ struct rohc_comp_rfc5225_ip_esp_ctxt
 
 	/** The ESP Security Parameters Index (SPI) */
 	uint32_t esp_spi;
+
+	/** The CRC of the last uncompressed headers */
+	struct rohc_crc_cache crc_cache;
 };
 
 
@@ -372,8 +379,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_FO_SO_pkt(const struct rohc
                                                                const bool crc7_at_least)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint32_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_range *const msn_range,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -391,7 +397,7 @@ static bool rohc_comp_rfc5225_is_seq_ipid_inferred(const ip_context_t *const ip_
 static bool sdvl_sn_lsb_encode(uint8_t *const sdvl_bytes,
                                const size_t sdvl_bytes_max_nr,
                                size_t *const sdvl_bytes_nr,
-                               const struct c_wlsb *const sn_wlsb,
+                               const struct c_wlsb_range *const sn_range,
                                const rohc_reordering_offset_t reorder_ratio,
                                const uint32_t sn)
 	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
@@ -417,6 +423,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_arena *const arena = &context->compressor->arena;
 	struct rohc_comp_rfc5225_ip_esp_ctxt *rfc5225_ctxt;
 	size_t ip_hdr_pos;
 	bool is_ok;
@@ -425,7 +432,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 	assert(uncomp_pkt_hdrs->esp != NULL);
 
 	/* create the ROHCv2 IP/ESP part of the profile context */
-	rfc5225_ctxt = calloc(1, sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt));
+	rfc5225_ctxt = rohc_arena_calloc(arena, sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt));
 	if(rfc5225_ctxt == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -475,7 +482,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 	rfc5225_ctxt->ip_contexts_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
 	/* MSN */
-	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr, arena);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -485,7 +492,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 
 	/* innermost IP-ID offset */
 	is_ok = wlsb_new(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                 comp->oa_repetitions_nr);
+	                 comp->oa_repetitions_nr, arena);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -507,7 +514,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 free_wlsb_msn:
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
 free_context:
-	free(rfc5225_ctxt);
+	rohc_arena_free(rfc5225_ctxt);
 error:
 	return false;
 }
@@ -527,7 +534,7 @@ static void rohc_comp_rfc5225_ip_esp_destroy(struct rohc_comp_ctxt *const contex
 
 	wlsb_free(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
-	free(rfc5225_ctxt);
+	rohc_arena_free(rfc5225_ctxt);
 }
 
 
@@ -924,6 +931,9 @@ static void rohc_comp_rfc5225_ip_esp_detect_changes(const struct rohc_comp_ctxt
 		}
 		rohc_comp_debug(context, "new IP-ID offset = 0x%x / %u",
 		                tmp->innermost_ip_id_offset, tmp->innermost_ip_id_offset);
+		wlsb_get_range_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+		                      tmp->innermost_ip_id_offset,
+		                      &tmp->innermost_ip_id_offset_range);
 
 		tmp->innermost_ip_id_offset_just_changed =
 			!!(rfc5225_ctxt->innermost_ip_id_offset != tmp->innermost_ip_id_offset);
@@ -1095,6 +1105,9 @@ static void rohc_comp_rfc5225_ip_esp_detect_changes(const struct rohc_comp_ctxt
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_ttl_hopl_trans_nr);
 		tmp->innermost_ttl_hopl_changed = true;
 	}
+
+	/* walk the MSN window once for all the packet types */
+	wlsb_get_range_32bits(&rfc5225_ctxt->msn_wlsb, tmp->new_msn, &tmp->msn_range);
 }
 
 
@@ -1590,8 +1603,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_FO_SO_pkt(const struct rohc
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	if(!crc7_at_least &&
-	   rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                         tmp->new_msn, reorder_ratio, 4) &&
+	   rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 4) &&
 	   (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	    rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                           !tmp->innermost_ip_id_offset_changed,
@@ -1614,8 +1626,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_FO_SO_pkt(const struct rohc
 	 *  - the TOS/TC fields of all IP headers shall not be changing
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn, reorder_ratio, 6) &&
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 6) &&
 	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                                !tmp->innermost_ip_id_offset_changed,
@@ -1638,12 +1649,10 @@ static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_FO_SO_pkt(const struct rohc
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn, reorder_ratio, 6) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 6) &&
 	        rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   tmp->innermost_ip_id_offset, 4,
-	                                   rohc_interval_get_rfc5225_id_id_p(4)) &&
+	        wlsb_range_is_kp_possible(&tmp->innermost_ip_id_offset_range, 4,
+	                                  rohc_interval_get_rfc5225_id_id_p(4)) &&
 	        !tmp->outer_ip_flag &&
 	        !tmp->innermost_ip_flag &&
 	        !tmp->at_least_one_df_changed &&
@@ -1661,11 +1670,9 @@ static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_FO_SO_pkt(const struct rohc
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   tmp->innermost_ip_id_offset, 6,
-	                                   rohc_interval_get_rfc5225_id_id_p(6)) &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn, reorder_ratio, 8) &&
+	        wlsb_range_is_kp_possible(&tmp->innermost_ip_id_offset_range, 6,
+	                                  rohc_interval_get_rfc5225_id_id_p(6)) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 8) &&
 	        !tmp->outer_ip_flag &&
 	        !tmp->innermost_ip_flag &&
 	        !tmp->at_least_one_df_changed &&
@@ -1700,21 +1707,19 @@ static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_FO_SO_pkt(const struct rohc
 /**
  * @brief Define according to computed shift parameter if msn_lsb() is possible
  *
- * @param wlsb           The W-LSB object
- * @param value          The value to encode using the LSB algorithm
+ * @param msn_range      The W-LSB range of the MSN to encode
  * @param reorder_ratio  The reordering ratio
  * @param k              The number of bits for encoding
  * @return               true if msn_lsb is possible or not
  */
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint32_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_range *const msn_range,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 {
 	/* compute p according to reorder ratio  */
 	const int32_t p_computed = rohc_interval_get_rfc5225_msn_p(k, reorder_ratio);
 
-	return wlsb_is_kp_possible_32bits(wlsb, value, k, p_computed);
+	return wlsb_range_is_kp_possible(msn_range, k, p_computed);
 }
 
 
@@ -2083,6 +2088,7 @@ static int rohc_comp_rfc5225_ip_esp_code_CO_pkt(const struct rohc_comp_ctxt *con
                                                 const size_t rohc_pkt_max_len,
                                                 const rohc_packet_t packet_type)
 {
+	struct rohc_comp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	uint8_t crc_computed;
@@ -2096,16 +2102,18 @@ static int rohc_comp_rfc5225_ip_esp_code_CO_pkt(const struct rohc_comp_ctxt *con
 	   packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
+			crc_calc_cached(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_3,
+			                uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-3 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_calc_cached(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_7,
+			                uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -3285,7 +3293,7 @@ static int rohc_comp_rfc5225_ip_esp_build_co_common_pkt(const struct rohc_comp_c
 		size_t sdvl_sn_lsb_len;
 
 		if(!sdvl_sn_lsb_encode(rohc_remain_data, rohc_remain_len, &sdvl_sn_lsb_len,
-		                       &rfc5225_ctxt->msn_wlsb, co_common->reorder_ratio,
+		                       &tmp->msn_range, co_common->reorder_ratio,
 		                       tmp->new_msn))
 		{
 			rohc_comp_warn(context, "ROHC buffer too small for the co_common "
@@ -3344,7 +3352,7 @@ error:
  * @param sdvl_bytes         IN/OUT: The SDVL-encoded bytes
  * @param sdvl_bytes_max_nr  The maximum available free bytes for SDVL
  * @param sdvl_bytes_nr      OUT: The number of SDVL bytes written
- * @param sn_wlsb            The W-LSB object for the SN
+ * @param sn_range           The W-LSB range of the SN to encode
  * @param reorder_ratio      The reorder ratio
  * @param sn                 The SN value to encode
  * @return                   true if SDVL encoding is successful,
@@ -3353,12 +3361,12 @@ error:
 static bool sdvl_sn_lsb_encode(uint8_t *const sdvl_bytes,
                                const size_t sdvl_bytes_max_nr,
                                size_t *const sdvl_bytes_nr,
-                               const struct c_wlsb *const sn_wlsb,
+                               const struct c_wlsb_range *const sn_range,
                                const rohc_reordering_offset_t reorder_ratio,
                                const uint32_t sn)
 {
 	/* encode the value according to the number of available bits */
-	if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_wlsb, sn, reorder_ratio,
+	if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_range, reorder_ratio,
 	                                         ROHC_SDVL_MAX_BITS_IN_1_BYTE))
 	{
 		*sdvl_bytes_nr = 1;
@@ -3371,7 +3379,7 @@ static bool sdvl_sn_lsb_encode(uint8_t *const sdvl_bytes,
 		/* bit pattern 0 */
 		sdvl_bytes[0] = sn & 0x7f;
 	}
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_wlsb, sn, reorder_ratio,
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_range, reorder_ratio,
 	                                              ROHC_SDVL_MAX_BITS_IN_2_BYTES))
 	{
 		*sdvl_bytes_nr = 2;
@@ -3385,7 +3393,7 @@ static bool sdvl_sn_lsb_encode(uint8_t *const sdvl_bytes,
 		sdvl_bytes[0] = ((0x02 << 6) | ((sn >> 8) & 0x3f)) & 0xff;
 		sdvl_bytes[1] = sn & 0xff;
 	}
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_wlsb, sn, reorder_ratio,
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_range, reorder_ratio,
 	                                              ROHC_SDVL_MAX_BITS_IN_3_BYTES))
 	{
 		*sdvl_bytes_nr = 3;
@@ -3400,7 +3408,7 @@ static bool sdvl_sn_lsb_encode(uint8_t *const sdvl_bytes,
 		sdvl_bytes[1] = (sn >> 8) & 0xff;
 		sdvl_bytes[2] = sn & 0xff;
 	}
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_wlsb, sn, reorder_ratio,
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(sn_range, reorder_ratio,
 	                                              ROHC_SDVL_MAX_BITS_IN_4_BYTES_RFC5225))
 	{
 		*sdvl_bytes_nr = 4;
@@ -62,6 +62,10 @@ struct comp_rfc5225_tmp_variables
 	rohc_ip_id_behavior_t innermost_ip_id_behavior;
 	/** The new innermost IP-ID / SN delta (with bits swapped if necessary) */
 	uint16_t innermost_ip_id_offset;
+	/** The W-LSB range of the new innermost IP-ID / SN delta */
+	struct c_wlsb_range innermost_ip_id_offset_range;
+	/** The W-LSB range of the new MSN */
+	struct c_wlsb_range msn_range;
 
 	/** The new innermost TTL/HL value */
 	uint8_t innermost_ttl_hopl;
@@ -180,6 +184,9 @@ struct rohc_comp_rfc5225_ip_udp_ctxt
 	bool udp_checksum_used;
 	/** The number of 'UDP checksum used' transmissions since last change */
 	uint8_t udp_checksum_used_trans_nr;
+
+	/** The CRC of the last uncompressed headers */
+	struct rohc_crc_cache crc_cache;
 };
 
 
@@ -392,8 +399,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_decide_FO_SO_pkt(const struct rohc
                                                                const bool crc7_at_least)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint16_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_range *const msn_range,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -429,6 +435,7 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_arena *const arena = &context->compressor->arena;
 	struct rohc_comp_rfc5225_ip_udp_ctxt *rfc5225_ctxt;
 	size_t ip_hdr_pos;
 	bool is_ok;
@@ -437,7 +444,7 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
 	assert(uncomp_pkt_hdrs->udp != NULL);
 
 	/* create the ROHCv2 IP/UDP part of the profile context */
-	rfc5225_ctxt = calloc(1, sizeof(struct rohc_comp_rfc5225_ip_udp_ctxt));
+	rfc5225_ctxt = rohc_arena_calloc(arena, sizeof(struct rohc_comp_rfc5225_ip_udp_ctxt));
 	if(rfc5225_ctxt == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -487,7 +494,7 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
 	rfc5225_ctxt->ip_contexts_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
 	/* MSN */
-	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr, arena);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -497,7 +504,7 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
 
 	/* innermost IP-ID offset */
 	is_ok = wlsb_new(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                 comp->oa_repetitions_nr);
+	                 comp->oa_repetitions_nr, arena);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -520,7 +527,7 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
 free_wlsb_msn:
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
 free_context:
-	free(rfc5225_ctxt);
+	rohc_arena_free(rfc5225_ctxt);
 error:
 	return false;
 }
@@ -540,7 +547,7 @@ static void rohc_comp_rfc5225_ip_udp_destroy(struct rohc_comp_ctxt *const contex
 
 	wlsb_free(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
-	free(rfc5225_ctxt);
+	rohc_arena_free(rfc5225_ctxt);
 }
 
 
@@ -959,6 +966,9 @@ static void rohc_comp_rfc5225_ip_udp_detect_changes(const struct rohc_comp_ctxt
 		}
 		rohc_comp_debug(context, "new IP-ID offset = 0x%x / %u",
 		                tmp->innermost_ip_id_offset, tmp->innermost_ip_id_offset);
+		wlsb_get_range_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+		                      tmp->innermost_ip_id_offset,
+		                      &tmp->innermost_ip_id_offset_range);
 
 		tmp->innermost_ip_id_offset_just_changed =
 			!!(rfc5225_ctxt->innermost_ip_id_offset != tmp->innermost_ip_id_offset);
@@ -1145,6 +1155,9 @@ static void rohc_comp_rfc5225_ip_udp_detect_changes(const struct rohc_comp_ctxt
 		                oa_repetitions_nr - rfc5225_ctxt->udp_checksum_used_trans_nr);
 		tmp->udp_checksum_used_changed = true;
 	}
+
+	/* walk the MSN window once for all the packet types */
+	wlsb_get_range_16bits(&rfc5225_ctxt->msn_wlsb, tmp->new_msn, &tmp->msn_range);
 }
 
 
@@ -1647,8 +1660,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_decide_FO_SO_pkt(const struct rohc
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn, reorder_ratio, 4) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 4) &&
 	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                                !tmp->innermost_ip_id_offset_changed,
@@ -1671,8 +1683,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_decide_FO_SO_pkt(const struct rohc
 	 *  - the TOS/TC fields of all IP headers shall not be changing
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn, reorder_ratio, 6) &&
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 6) &&
 	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                                !tmp->innermost_ip_id_offset_changed,
@@ -1695,12 +1706,10 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_decide_FO_SO_pkt(const struct rohc
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn, reorder_ratio, 6) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 6) &&
 	        rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   tmp->innermost_ip_id_offset, 4,
-	                                   rohc_interval_get_rfc5225_id_id_p(4)) &&
+	        wlsb_range_is_kp_possible(&tmp->innermost_ip_id_offset_range, 4,
+	                                  rohc_interval_get_rfc5225_id_id_p(4)) &&
 	        !tmp->outer_ip_flag &&
 	        !tmp->innermost_ip_flag &&
 	        !tmp->at_least_one_df_changed &&
@@ -1718,11 +1727,9 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_decide_FO_SO_pkt(const struct rohc
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   tmp->innermost_ip_id_offset, 6,
-	                                   rohc_interval_get_rfc5225_id_id_p(6)) &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn, reorder_ratio, 8) &&
+	        wlsb_range_is_kp_possible(&tmp->innermost_ip_id_offset_range, 6,
+	                                  rohc_interval_get_rfc5225_id_id_p(6)) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 8) &&
 	        !tmp->outer_ip_flag &&
 	        !tmp->innermost_ip_flag &&
 	        !tmp->at_least_one_df_changed &&
@@ -1736,9 +1743,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_decide_FO_SO_pkt(const struct rohc
 	 *  - the DF fields of all outer IP headers shall not be changing
 	 *  - the behavior of the outer IP-IDs shall not be changing
 	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              tmp->new_msn,
-	                                              reorder_ratio, 8) &&
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&tmp->msn_range, reorder_ratio, 8) &&
 	        !tmp->outer_df_changed &&
 	        !tmp->outer_ip_id_behavior_changed)
 	{
@@ -1761,21 +1766,19 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_decide_FO_SO_pkt(const struct rohc
 /**
  * @brief Define according to computed shift parameter if msn_lsb() is possible
  *
- * @param wlsb           The W-LSB object
- * @param value          The value to encode using the LSB algorithm
+ * @param msn_range      The W-LSB range of the MSN to encode
  * @param reorder_ratio  The reordering ratio
  * @param k              The number of bits for encoding
  * @return               true if msn_lsb is possible or not
  */
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint16_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_range *const msn_range,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 {
 	/* compute p according to reorder ratio  */
 	const int32_t p_computed = rohc_interval_get_rfc5225_msn_p(k, reorder_ratio);
 
-	return wlsb_is_kp_possible_16bits(wlsb, value, k, p_computed);
+	return wlsb_range_is_kp_possible(msn_range, k, p_computed);
 }
 
 
@@ -2144,6 +2147,7 @@ static int rohc_comp_rfc5225_ip_udp_code_CO_pkt(const struct rohc_comp_ctxt *con
                                                 const size_t rohc_pkt_max_len,
                                                 const rohc_packet_t packet_type)
 {
+	struct rohc_comp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	uint8_t crc_computed;
@@ -2157,16 +2161,18 @@ static int rohc_comp_rfc5225_ip_udp_code_CO_pkt(const struct rohc_comp_ctxt *con
 	   packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
+			crc_calc_cached(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_3,
+			                uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-3 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_calc_cached(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_7,
+			                uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
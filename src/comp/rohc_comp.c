@@ -59,7 +59,6 @@
 #include "c_tcp_opts_list.h"
 #include "feedback_parse.h"
 #include "hashtable.h"
-#include "hashtable_cr.h"
 
 #include "config.h" /* for PACKAGE_(NAME|URL|VERSION) */
 
@@ -125,11 +124,22 @@ static const struct rohc_comp_profile *const
 
 
 
+/*
+ * Prototypes of private functions related to ROHC compression
+ */
+
+static rohc_status_t rohc_comp_compress_pkt(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_packet,
+                                            struct rohc_buf *const payload)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
 /*
  * Prototypes of private functions related to ROHC compression profiles
  */
 
-static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
+static rohc_profile_t rohc_comp_get_profile(struct rohc_comp *const comp,
                                             const struct rohc_buf *const packet,
                                             struct rohc_fingerprint *const fingerprint,
                                             struct rohc_pkt_hdrs *const pkt_hdrs)
@@ -144,7 +154,7 @@ static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
                                             size_t *const all_ipv6_exts_len)
 	__attribute__((nonnull(1, 2, 4, 5, 6, 7), warn_unused_result));
 
-static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const comp,
+static rohc_profile_t rohc_comp_get_profile_l4(struct rohc_comp *const comp,
                                                const struct rohc_buf *const packet,
                                                const rohc_profile_t l3_profile,
                                                const size_t all_ipv6_exts_len,
@@ -162,11 +172,35 @@ static bool rohc_comp_is_tcp_hdr_supported(const struct rohc_comp *const comp,
                                            size_t *const tcp_hdr_full_len)
 	__attribute__((nonnull(1, 2, 4, 5), warn_unused_result));
 
-static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
+static bool rohc_comp_is_rtp_hdr_supported(struct rohc_comp *const comp,
                                            const uint8_t *const packet,
                                            const size_t packet_len,
+                                           const struct rohc_fingerprint *const fingerprint,
                                            struct rohc_pkt_hdrs *const pkt_hdrs)
-	__attribute__((nonnull(1, 2, 4), warn_unused_result));
+	__attribute__((nonnull(1, 2, 4, 5), warn_unused_result));
+
+static void rohc_comp_rtp_class_build_key(struct rohc_comp_rtp_class_key *const key,
+                                          const struct rohc_fingerprint *const fingerprint)
+	__attribute__((nonnull(1, 2)));
+static struct rohc_comp_rtp_class *
+	rohc_comp_rtp_class_get_set(const struct rohc_comp *const comp,
+	                            const struct rohc_comp_rtp_class_key *const key)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static struct rohc_comp_rtp_class *
+	rohc_comp_rtp_class_find(struct rohc_comp *const comp,
+	                         const struct rohc_comp_rtp_class_key *const key,
+	                         bool *const is_new)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool rohc_comp_rtp_class_heuristic(const struct rohc_comp *const comp,
+                                          struct rohc_comp_rtp_class *const class,
+                                          const bool is_new,
+                                          const struct rtphdr *const rtp)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static void rohc_comp_rtp_class_forget(struct rohc_comp *const comp,
+                                       const struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void rohc_comp_rtp_class_flush(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
 
 static bool rohc_comp_profile_enabled_nocheck(const struct rohc_comp *const comp,
                                               const rohc_profile_t profile)
@@ -179,6 +213,8 @@ static bool rohc_comp_profile_enabled_nocheck(const struct rohc_comp *const comp
 
 static bool c_create_contexts(struct rohc_comp *const comp)
 	__attribute__((warn_unused_result, nonnull(1)));
+static void c_chain_free_contexts(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
 static void c_destroy_contexts(struct rohc_comp *const comp)
 	__attribute__((nonnull(1)));
 
@@ -212,6 +248,25 @@ static struct rohc_comp_ctxt *
 static struct rohc_comp_ctxt *
 	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static void rohc_comp_build_fingerprint_key(struct rohc_fingerprint_key *const key,
+                                            const struct rohc_fingerprint *const fingerprint)
+	__attribute__((nonnull(1, 2)));
+static size_t rohc_comp_flow_cache_idx(const struct rohc_fingerprint *const fingerprint)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static struct rohc_comp_ctxt *
+	rohc_comp_find_ctxt_by_fingerprint(struct rohc_comp *const comp,
+	                                   const struct rohc_fingerprint *const fingerprint)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_destroy_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+
+static void c_lru_append(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void c_lru_remove(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
 
 static rohc_ctxt_affinity_t
 	rohc_comp_get_ctxt_affinity(const struct rohc_comp_ctxt *const ctxt,
@@ -242,12 +297,23 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
                                          const size_t size)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
-                                         const uint8_t *const feedback,
-                                         const size_t feedback_len,
-                                         rohc_cid_t *const cid,
-                                         size_t *const cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static bool rohc_comp_batch_feedback(struct rohc_comp *const comp,
+                                     const uint8_t *const packet,
+                                     const size_t size,
+                                     const size_t pos,
+                                     struct rohc_comp_ctxt ***const last_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+
+static bool rohc_comp_flush_feedback_batch(struct rohc_comp *const comp,
+                                           struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool rohc_comp_feedback_get_ack_mode(const struct rohc_comp *const comp,
+                                            const struct rohc_comp_ctxt *const context,
+                                            const uint8_t *const packet,
+                                            const size_t size,
+                                            rohc_mode_t *const mode)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
 
 static bool rohc_comp_feedback_parse_opt_sn(const struct rohc_comp_ctxt *const context,
                                             const uint8_t *const feedback_data,
@@ -314,6 +380,7 @@ static bool rohc_comp_feedback_check_opts(const struct rohc_comp_ctxt *const con
  * @see rohc_comp_free
  * @see rohc_compress4
  * @see rohc_comp_set_traces_cb2
+ * @see rohc_comp_set_traces_min_level
  * @see rohc_comp_enable_profiles
  * @see rohc_comp_enable_profile
  * @see rohc_comp_disable_profiles
@@ -370,10 +437,16 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 
 	comp->medium.cid_type = cid_type;
 	comp->medium.max_cid = max_cid;
+	comp->first_cid = 0; /* all CIDs may be used by default */
+	comp->last_cid = max_cid;
 	comp->mrru = 0; /* no segmentation by default */
 	comp->rru = NULL; /* no segmentation by default */
 	comp->random_cb = rand_cb;
 	comp->random_cb_ctxt = rand_priv;
+	rohc_arena_init(&comp->arena, 0); /* no slab allocator by default */
+
+	/* give all traces to the trace callback by default */
+	comp->trace_min_level = ROHC_TRACE_DEBUG;
 
 	/* all compression profiles are disabled by default */
 	for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
@@ -391,6 +464,8 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 	comp->total_compressed_size = 0;
 	comp->total_uncompressed_size = 0;
 	comp->last_context = NULL;
+	comp->detailed_stats_seq = 0;
+	memset(&comp->detailed_stats, 0, sizeof(struct rohc_comp_stats));
 
 	/* set the default number of repetitions for Optimistic Approach */
 	is_fine = rohc_comp_set_optimistic_approach(comp, oa_repetitions_nr);
@@ -428,9 +503,7 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 	{
-		const unsigned int max_ctxts = max_cid + 1;
-		const size_t items_nr = 1 << (32 - __builtin_clz(max_ctxts - 1));
-		const size_t hashtable_size = items_nr << 5;
+		const size_t max_ctxts = max_cid + 1;
 		size_t i;
 
 		/* create hash table for finding contexts by their fingerprint */
@@ -440,7 +513,9 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 				comp->random_cb(comp, comp->random_cb_ctxt) & 0xff;
 		}
 		if(!hashtable_new(&comp->contexts_by_fingerprint,
-		                  sizeof(struct rohc_fingerprint), hashtable_size))
+		                  ROHC_FINGERPRINT_KEY_MAX_LEN, true,
+		                  &(comp->contexts[0].fingerprint_key),
+		                  sizeof(struct rohc_comp_ctxt), max_ctxts))
 		{
 			goto destroy_contexts;
 		}
@@ -452,16 +527,35 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 			comp->contexts_cr.key[i] =
 				comp->random_cb(comp, comp->random_cb_ctxt) & 0xff;
 		}
-		if(!hashtable_cr_new(&comp->contexts_cr,
-		                     sizeof(struct rohc_fingerprint_base),
-		                     sizeof(struct rohc_fingerprint), hashtable_size))
+		if(!hashtable_new(&comp->contexts_cr,
+		                  sizeof(struct rohc_fingerprint_base), false,
+		                  &(comp->contexts[0].fingerprint.base),
+		                  sizeof(struct rohc_comp_ctxt), max_ctxts))
 		{
 			goto free_hashtable;
 		}
+
+		/* create the cache of RTP classifications with twice as many entries
+		 * as contexts, so that UDP flows seldom compete for one set */
+		comp->rtp_class_sets_nr = 1;
+		while((comp->rtp_class_sets_nr * ROHC_COMP_RTP_CLASS_WAYS_NR) <
+		      (2 * max_ctxts))
+		{
+			comp->rtp_class_sets_nr *= 2;
+		}
+		comp->rtp_classes =
+			calloc(comp->rtp_class_sets_nr * ROHC_COMP_RTP_CLASS_WAYS_NR,
+			       sizeof(struct rohc_comp_rtp_class));
+		if(comp->rtp_classes == NULL)
+		{
+			goto free_hashtable_cr;
+		}
 	}
 
 	return comp;
 
+free_hashtable_cr:
+	hashtable_free(&comp->contexts_cr);
 free_hashtable:
 	hashtable_free(&comp->contexts_by_fingerprint);
 destroy_contexts:
@@ -504,9 +598,11 @@ void rohc_comp_free(struct rohc_comp *const comp)
 		           "free ROHC compressor");
 
 		/* free memory used by contexts */
-		hashtable_cr_free(&comp->contexts_cr);
+		hashtable_free(&comp->contexts_cr);
 		hashtable_free(&comp->contexts_by_fingerprint);
 		c_destroy_contexts(comp);
+		rohc_arena_free_all(&comp->arena);
+		zfree(comp->rtp_classes);
 
 		/* free RRU buffer */
 		if(comp->rru != NULL)
@@ -593,6 +689,63 @@ error:
 }
 
 
+/**
+ * @brief Set the minimal level of the traces emitted by the compressor
+ *
+ * Traces with a level lower than the given one are discarded by the ROHC
+ * library before the trace callback is called, so that their message is not
+ * even formatted. This permits to keep warnings and errors in production
+ * without paying the cost of the many debug traces emitted for every packet.
+ *
+ * By default, all the traces are given to the trace callback, ie. the
+ * minimal level is \ref ROHC_TRACE_DEBUG.
+ *
+ * @warning The minimal level can not be modified after library
+ *          initialization
+ *
+ * @param comp       The ROHC compressor
+ * @param min_level  The minimal level of the traces given to the callback
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_traces_cb2
+ */
+bool rohc_comp_set_traces_min_level(struct rohc_comp *const comp,
+                                    const rohc_trace_level_t min_level)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* check the trace level */
+	if(min_level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unknown trace level %d", min_level);
+		goto error;
+	}
+
+	/* refuse to change the trace level if compressor is in use: the contexts
+	 * already created keep a copy of the trace settings */
+	if(comp->num_packets > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the minimal trace level after initialization");
+		goto error;
+	}
+
+	comp->trace_min_level = min_level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get the best compression profile for the given network packet
  *
@@ -607,7 +760,7 @@ error:
  * @return                  The ID of the best compression profile to compress
  *                          the packet
  */
-static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
+static rohc_profile_t rohc_comp_get_profile(struct rohc_comp *const comp,
                                             const struct rohc_buf *const packet,
                                             struct rohc_fingerprint *const fingerprint,
                                             struct rohc_pkt_hdrs *const pkt_hdrs)
@@ -727,7 +880,7 @@ unsupported_net_pkt:
  * @return                  The ID of the best compression profile to compress
  *                          the packet
  */
-static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const comp,
+static rohc_profile_t rohc_comp_get_profile_l4(struct rohc_comp *const comp,
                                                const struct rohc_buf *const packet,
                                                const rohc_profile_t l3_profile,
                                                const size_t all_ipv6_exts_len,
@@ -849,7 +1002,8 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
 		}
 
 		/* check if the IP/UDP packet is a RTP packet */
-		if(!rohc_comp_is_rtp_hdr_supported(comp, remain_data, remain_len, pkt_hdrs))
+		if(!rohc_comp_is_rtp_hdr_supported(comp, remain_data, remain_len,
+		                                   fingerprint, pkt_hdrs))
 		{
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			           "unsupported RTP header");
@@ -1247,10 +1401,16 @@ unsupported_tcp_hdr:
 /**
  * @brief Is the given RTP header supported?
  *
+ * The UDP payload is classified as RTP by the user callback if one is set,
+ * or by the built-in heuristic otherwise. The classification of every UDP
+ * flow is cached if the \ref ROHC_COMP_FEATURE_RTP_CLASS_CACHE feature is
+ * enabled or if the built-in heuristic is used.
+ *
  * @param comp              The ROHC compressor to compress the packet with
  * @param packet            The uncompressed packet to search the best compression
  *                          profile for
  * @param packet_len        The length (in bytes) of the uncompressed packet
+ * @param fingerprint       The fingerprint of the packet, with its IP headers
  * @param[out] pkt_hdrs     The information collected about the packet headers,
  *                          may be used later during the detection of changes
  *                          with the compression context, thus avoiding another
@@ -1258,9 +1418,10 @@ unsupported_tcp_hdr:
  * @return                  The ID of the best compression profile to compress
  *                          the packet
  */
-static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
+static bool rohc_comp_is_rtp_hdr_supported(struct rohc_comp *const comp,
                                            const uint8_t *const packet,
                                            const size_t packet_len,
+                                           const struct rohc_fingerprint *const fingerprint,
                                            struct rohc_pkt_hdrs *const pkt_hdrs)
 {
 	const uint8_t *remain_data = packet;
@@ -1268,9 +1429,12 @@ static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
 	const uint8_t *udp_payload;
 	unsigned int udp_payload_size;
 	const struct rtphdr *rtp;
+	struct rohc_comp_rtp_class_key key;
+	struct rohc_comp_rtp_class *class = NULL;
+	bool is_new;
 	bool is_rtp = false;
 
-	if(comp->rtp_callback == NULL)
+	if(comp->rtp_callback == NULL && comp->rtp_heuristic_port_max == 0)
 	{
 		goto unsupported_rtp_hdr;
 	}
@@ -1296,6 +1460,48 @@ static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
 		goto unsupported_rtp_hdr;
 	}
 
+	/* without cache, ask the user callback for every packet */
+	if(comp->rtp_callback != NULL &&
+	   (comp->features & ROHC_COMP_FEATURE_RTP_CLASS_CACHE) == 0)
+	{
+		goto ask_callback;
+	}
+
+	/* search for the classification of the UDP flow */
+	rohc_comp_rtp_class_build_key(&key, fingerprint);
+	key.src_port = pkt_hdrs->udp->source;
+	key.dst_port = pkt_hdrs->udp->dest;
+	class = rohc_comp_rtp_class_find(comp, &key, &is_new);
+
+	/* classify the UDP flow with the built-in heuristic if no callback */
+	if(comp->rtp_callback == NULL)
+	{
+		is_rtp = rohc_comp_rtp_class_heuristic(comp, class, is_new, rtp);
+		if(is_rtp)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "built-in heuristic said the IP/UDP packet is one "
+			           "IP/UDP/RTP packet");
+		}
+		goto unsupported_rtp_hdr;
+	}
+
+	/* the verdict of the user callback is still valid, unless the SSRC or the
+	 * version of one RTP flow changed */
+	if(!is_new &&
+	   (!class->is_rtp ||
+	    (class->rtp_ssrc == rtp->ssrc && class->rtp_version == rtp->version)))
+	{
+		is_rtp = class->is_rtp;
+		if(is_rtp)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "user said the IP/UDP flow is one IP/UDP/RTP flow");
+		}
+		goto unsupported_rtp_hdr;
+	}
+
+ask_callback:
 	/* check if the IP/UDP packet is a RTP packet with the user callback
 	   dedicated to RTP stream detection: if the RTP callback returns true,
 	   consider that the packet matches the RTP profile */
@@ -1309,11 +1515,237 @@ static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
 		           "user said the IP/UDP packet is one IP/UDP/RTP packet");
 	}
 
+	/* remember the verdict for the next packets of the UDP flow */
+	if(class != NULL)
+	{
+		class->is_rtp = is_rtp;
+		class->rtp_ssrc = rtp->ssrc;
+		class->rtp_version = rtp->version;
+	}
+
 unsupported_rtp_hdr:
 	return is_rtp;
 }
 
 
+/**
+ * @brief Build the key of the UDP flow of the given fingerprint
+ *
+ * The UDP ports are not set, as the packet fingerprint does not hold them
+ * yet when the RTP header is classified.
+ *
+ * @param[out] key     The key of the UDP flow
+ * @param fingerprint  The fingerprint of the packet or context
+ */
+static void rohc_comp_rtp_class_build_key(struct rohc_comp_rtp_class_key *const key,
+                                          const struct rohc_fingerprint *const fingerprint)
+{
+	const struct rohc_fingerprint_ip *const ip =
+		&(fingerprint->base.ip_hdrs[fingerprint->base.ip_hdrs_nr - 1]);
+
+	assert(fingerprint->base.ip_hdrs_nr > 0);
+
+	memcpy(&key->saddr, &ip->saddr, sizeof(struct ipv6_addr));
+	memcpy(&key->daddr, &ip->daddr, sizeof(struct ipv6_addr));
+	key->src_port = 0;
+	key->dst_port = 0;
+	key->ip_version = ip->version;
+}
+
+
+/**
+ * @brief Get the set of RTP classifications for the given UDP flow
+ *
+ * The index of the set is a cheap hash of the innermost IP addresses and of
+ * the UDP ports. Like for the flow cache, the entries of the set are always
+ * checked against the full key.
+ *
+ * @param comp  The ROHC compressor
+ * @param key   The key of the UDP flow
+ * @return      The first entry of the set
+ */
+static struct rohc_comp_rtp_class *
+	rohc_comp_rtp_class_get_set(const struct rohc_comp *const comp,
+	                            const struct rohc_comp_rtp_class_key *const key)
+{
+	uint32_t hash;
+
+	hash = key->saddr.u32[0] ^ key->saddr.u32[1] ^ key->saddr.u32[2] ^ key->saddr.u32[3];
+	hash ^= key->daddr.u32[0] ^ key->daddr.u32[1] ^ key->daddr.u32[2] ^ key->daddr.u32[3];
+	hash ^= (((uint32_t) key->src_port) << 16) | key->dst_port;
+	hash *= 0x9e3779b1U;
+	hash ^= hash >> 16;
+
+	return &(comp->rtp_classes[(hash & (comp->rtp_class_sets_nr - 1)) *
+	                           ROHC_COMP_RTP_CLASS_WAYS_NR]);
+}
+
+
+/**
+ * @brief Find the RTP classification of the given UDP flow
+ *
+ * If the UDP flow is not classified yet, the least recently used entry of
+ * its set is given to the UDP flow.
+ *
+ * @param comp         The ROHC compressor
+ * @param key          The key of the UDP flow
+ * @param[out] is_new  Whether the UDP flow was classified before or not
+ * @return             The classification of the UDP flow
+ */
+static struct rohc_comp_rtp_class *
+	rohc_comp_rtp_class_find(struct rohc_comp *const comp,
+	                         const struct rohc_comp_rtp_class_key *const key,
+	                         bool *const is_new)
+{
+	struct rohc_comp_rtp_class *const set = rohc_comp_rtp_class_get_set(comp, key);
+	struct rohc_comp_rtp_class *victim = &(set[0]);
+	size_t i;
+
+	for(i = 0; i < ROHC_COMP_RTP_CLASS_WAYS_NR; i++)
+	{
+		if(memcmp(&set[i].key, key, sizeof(struct rohc_comp_rtp_class_key)) == 0)
+		{
+			set[i].last_used = comp->num_packets;
+			*is_new = false;
+			return &(set[i]);
+		}
+		if(set[i].last_used < victim->last_used ||
+		   (set[i].key.ip_version == 0 && victim->key.ip_version != 0))
+		{
+			victim = &(set[i]);
+		}
+	}
+
+	memcpy(&victim->key, key, sizeof(struct rohc_comp_rtp_class_key));
+	victim->is_rtp = false;
+	victim->seq_nr = 0;
+	victim->last_used = comp->num_packets;
+	*is_new = true;
+
+	return victim;
+}
+
+
+/**
+ * @brief Classify one UDP flow with the built-in heuristic
+ *
+ * The UDP flow is classified as RTP once \ref ROHC_COMP_RTP_CLASS_MIN_SEQUENTIAL
+ * packets in sequence were seen, as RFC 3550 recommends for the validation
+ * of new RTP sources. Packets are in sequence if they use one UDP port of
+ * the configured range, the RTP version 2, the same SSRC, a payload type
+ * that cannot be mistaken for RTCP, and increasing SNs. Once the UDP flow is
+ * classified as RTP, it is validated again only if the SSRC or the RTP
+ * version changes.
+ *
+ * @param comp    The ROHC compressor
+ * @param class   The classification of the UDP flow
+ * @param is_new  Whether the UDP flow was classified before or not
+ * @param rtp     The RTP header of the packet
+ * @return        true if the UDP flow transports RTP, false otherwise
+ */
+static bool rohc_comp_rtp_class_heuristic(const struct rohc_comp *const comp,
+                                          struct rohc_comp_rtp_class *const class,
+                                          const bool is_new,
+                                          const struct rtphdr *const rtp)
+{
+	const uint16_t src_port = rohc_ntoh16(class->key.src_port);
+	const uint16_t dst_port = rohc_ntoh16(class->key.dst_port);
+	const uint16_t sn = rohc_ntoh16(rtp->sn);
+	const uint16_t sn_delta = sn - class->rtp_sn;
+
+	if(!is_new && class->is_rtp &&
+	   class->rtp_ssrc == rtp->ssrc && class->rtp_version == rtp->version)
+	{
+		/* RTP flow is still valid */
+	}
+	else if(rtp->version != 2 || (rtp->pt >= 72 && rtp->pt <= 76) ||
+	        ((src_port < comp->rtp_heuristic_port_min ||
+	          src_port > comp->rtp_heuristic_port_max) &&
+	         (dst_port < comp->rtp_heuristic_port_min ||
+	          dst_port > comp->rtp_heuristic_port_max)))
+	{
+		/* not RTP: bad version, RTCP payload type, or port out of range */
+		class->is_rtp = false;
+		class->seq_nr = 0;
+	}
+	else if(!is_new && !class->is_rtp && class->seq_nr > 0 &&
+	        class->rtp_ssrc == rtp->ssrc &&
+	        sn_delta > 0 && sn_delta <= ROHC_COMP_RTP_CLASS_MAX_DROPOUT)
+	{
+		/* one more packet in sequence */
+		class->seq_nr++;
+		class->is_rtp = (class->seq_nr >= ROHC_COMP_RTP_CLASS_MIN_SEQUENTIAL);
+	}
+	else
+	{
+		/* first packet of the sequence */
+		class->is_rtp = false;
+		class->seq_nr = 1;
+	}
+	class->rtp_ssrc = rtp->ssrc;
+	class->rtp_version = rtp->version;
+	class->rtp_sn = sn;
+
+	return class->is_rtp;
+}
+
+
+/**
+ * @brief Forget the RTP classification of the UDP flow of the given context
+ *
+ * The classification is forgotten only if the context was created for it,
+ * ie. only if the context uses one RTP profile and the UDP flow was
+ * classified as RTP, or if the context uses one UDP profile and the UDP flow
+ * was classified as not RTP.
+ *
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context being destroyed
+ */
+static void rohc_comp_rtp_class_forget(struct rohc_comp *const comp,
+                                       const struct rohc_comp_ctxt *const ctxt)
+{
+	const rohc_profile_t profile_id = ctxt->profile->id;
+	const bool is_rtp_ctxt = (profile_id == ROHCv1_PROFILE_IP_UDP_RTP ||
+	                          profile_id == ROHCv2_PROFILE_IP_UDP_RTP);
+	struct rohc_comp_rtp_class_key key;
+	struct rohc_comp_rtp_class *set;
+	size_t i;
+
+	if(!is_rtp_ctxt &&
+	   profile_id != ROHCv1_PROFILE_IP_UDP &&
+	   profile_id != ROHCv2_PROFILE_IP_UDP)
+	{
+		return;
+	}
+
+	rohc_comp_rtp_class_build_key(&key, &ctxt->fingerprint);
+	key.src_port = rohc_hton16(ctxt->fingerprint.src_port);
+	key.dst_port = rohc_hton16(ctxt->fingerprint.dst_port);
+	set = rohc_comp_rtp_class_get_set(comp, &key);
+
+	for(i = 0; i < ROHC_COMP_RTP_CLASS_WAYS_NR; i++)
+	{
+		if(memcmp(&set[i].key, &key, sizeof(struct rohc_comp_rtp_class_key)) == 0 &&
+		   set[i].is_rtp == is_rtp_ctxt)
+		{
+			memset(&set[i], 0, sizeof(struct rohc_comp_rtp_class));
+		}
+	}
+}
+
+
+/**
+ * @brief Forget the RTP classifications of all UDP flows
+ *
+ * @param comp  The ROHC compressor
+ */
+static void rohc_comp_rtp_class_flush(struct rohc_comp *const comp)
+{
+	memset(comp->rtp_classes, 0, comp->rtp_class_sets_nr *
+	       ROHC_COMP_RTP_CLASS_WAYS_NR * sizeof(struct rohc_comp_rtp_class));
+}
+
+
 /**
  * @brief Compress the given uncompressed packet into a ROHC packet
  *
@@ -1384,94 +1816,298 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
                              const struct rohc_buf uncomp_packet,
                              struct rohc_buf *const rohc_packet)
 {
-	struct rohc_comp_ctxt *c;
-	rohc_packet_t packet_type;
-	int rohc_hdr_size;
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		return ROHC_STATUS_ERROR;
+	}
 
-	const struct rohc_comp_profile *profile;
-	rohc_profile_t profile_id;
+	return rohc_comp_compress_pkt(comp, uncomp_packet, rohc_packet, NULL);
+}
 
-	struct rohc_fingerprint fingerprint;
-	struct rohc_pkt_hdrs pkt_hdrs;
 
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+/**
+ * @brief Compress a burst of uncompressed packets into ROHC packets
+ *
+ * Compress the \e pkts_nr uncompressed packets of the \e uncomp_packets array
+ * into the \e pkts_nr ROHC packets of the \e rohc_packets array. The status
+ * of the compression of every packet is stored in the \e statuses array.
+ *
+ * The result is the same as calling \ref rohc_compress4 once for every
+ * packet of the burst, in the order of the burst: the compression of one
+ * packet may create or update the context used by the next packets, and
+ * the failure to compress one packet does not stop the compression of the
+ * next packets of the burst. The arguments common to all the packets are
+ * however checked once per burst, and the headers of the next packet are
+ * prefetched while the current packet is compressed.
+ *
+ * If ROHC segmentation is required for one packet of the burst, its status
+ * is \ref ROHC_STATUS_SEGMENT as with \ref rohc_compress4, but the segments
+ * cannot be retrieved anymore once the next packet of the burst requires
+ * segmentation too. Use \ref rohc_compress4 if ROHC segmentation is enabled.
+ *
+ * @param comp                The ROHC compressor
+ * @param uncomp_packets      The uncompressed packets to compress
+ * @param[out] rohc_packets   The resulting compressed ROHC packets, every
+ *                            buffer shall be empty before the call
+ * @param[out] statuses       The status of the compression of every packet,
+ *                            see \ref rohc_compress4 for possible values
+ * @param pkts_nr             The number of packets in the burst
+ * @return                    The number of packets that were successfully
+ *                            compressed, ie. with status \ref ROHC_STATUS_OK
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+size_t rohc_compress_burst(struct rohc_comp *const comp,
+                           const struct rohc_buf *const uncomp_packets,
+                           struct rohc_buf *const rohc_packets,
+                           rohc_status_t *const statuses,
+                           const size_t pkts_nr)
+{
+	size_t ok_pkts_nr = 0;
+	size_t i;
 
-	/* check inputs validity */
+	/* check inputs validity once for the whole burst */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(uncomp_packet))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is malformed");
-		goto error;
-	}
-	if(rohc_buf_is_empty(uncomp_packet))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is empty");
-		goto error;
-	}
-	if(rohc_packet == NULL)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is NULL");
-		goto error;
-	}
-	if(rohc_buf_is_malformed(*rohc_packet))
+	if(statuses == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
+		             "given statuses is NULL");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*rohc_packet))
+	if(pkts_nr > 0 && (uncomp_packets == NULL || rohc_packets == NULL))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is not empty");
+		             "given uncomp_packets or rohc_packets is NULL");
 		goto error;
 	}
 
-	/* print uncompressed bytes */
-	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	for(i = 0; i < pkts_nr; i++)
 	{
-		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
-		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
-		                 "uncompressed data, max 100 bytes", uncomp_packet);
-	}
+		/* prefetch the first headers of the next packet and the beginning of
+		 * its output buffer while the current packet is compressed */
+		if((i + 1) < pkts_nr)
+		{
+			const struct rohc_buf *const next_uncomp = &(uncomp_packets[i + 1]);
+			const struct rohc_buf *const next_rohc = &(rohc_packets[i + 1]);
 
-	/* what ROHC profile fits the uncompressed packet best? */
-	profile_id = rohc_comp_get_profile(comp, &uncomp_packet, &fingerprint, &pkt_hdrs);
-	if(profile_id == ROHC_PROFILE_MAX)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to find a matching profile among the enabled profiles "
-		             "for the uncompressed packet");
-		goto error;
+			if(next_uncomp->data != NULL)
+			{
+				__builtin_prefetch(rohc_buf_data(*next_uncomp), 0, 3);
+				__builtin_prefetch(rohc_buf_data(*next_uncomp) + 64, 0, 3);
+			}
+			if(next_rohc->data != NULL)
+			{
+				__builtin_prefetch(rohc_buf_data(*next_rohc), 1, 3);
+			}
+		}
+
+		statuses[i] = rohc_comp_compress_pkt(comp, uncomp_packets[i],
+		                                     &(rohc_packets[i]), NULL);
+		if(statuses[i] == ROHC_STATUS_OK)
+		{
+			ok_pkts_nr++;
+		}
 	}
 
-	/* find the profile identified by the given profile ID */
+	return ok_pkts_nr;
+
+error:
+	if(statuses != NULL)
 	{
-		const uint8_t profile_major = (profile_id >> 8) & 0xff;
-		const uint8_t profile_minor = profile_id & 0xff;
-		profile = rohc_comp_profiles[profile_major][profile_minor];
-		if(profile == NULL)
+		for(i = 0; i < pkts_nr; i++)
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "profile '%s' (0x%04x) is not implemented yet",
-			             rohc_get_profile_descr(profile_id), profile_id);
-			goto error;
+			statuses[i] = ROHC_STATUS_ERROR;
 		}
 	}
+	return 0;
+}
 
-	/* find the best profile context for the packet */
-	c = rohc_comp_find_ctxt(comp, profile, &uncomp_packet, &fingerprint, &pkt_hdrs);
-	if(c == NULL)
-	{
+
+/**
+ * @brief Compress the headers of the given packet, do not copy its payload
+ *
+ * Compress the headers of the given uncompressed packet into a ROHC header,
+ * but do not copy the payload of the packet behind the ROHC header as
+ * \ref rohc_compress4 does. The ROHC packet is made of two parts instead:
+ *   \li the ROHC header written in the \e rohc_hdr buffer,
+ *   \li the payload of the uncompressed packet, referenced by \e payload
+ *       without any copy.
+ *
+ * The two parts may be given as is to scatter-gather APIs such as writev(2),
+ * sendmsg(2) or the DMA descriptors of a network interface, so that payloads
+ * are never copied. The \e payload buffer points into the \e uncomp_packet
+ * buffer, so the latter shall not be released nor modified before the ROHC
+ * packet is sent.
+ *
+ * The \e rohc_hdr buffer only needs to be large enough for the ROHC header.
+ * ROHC segmentation is never used since the payload is not copied, so
+ * \ref ROHC_STATUS_SEGMENT is never returned.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_hdr     The resulting ROHC header, the buffer shall be
+ *                          empty before the call
+ * @param[out] payload      The payload that follows the ROHC header, it
+ *                          references the payload of \e uncomp_packet
+ * @return                  Possible return values:
+ *                          \li \ref ROHC_STATUS_OK if a ROHC header and its
+ *                              payload are returned
+ *                          \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                              output buffer is too small for the ROHC
+ *                              header
+ *                          \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress_zero_copy(struct rohc_comp *const comp,
+                                      const struct rohc_buf uncomp_packet,
+                                      struct rohc_buf *const rohc_hdr,
+                                      struct rohc_buf *const payload)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		return ROHC_STATUS_ERROR;
+	}
+	if(payload == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given payload is NULL");
+		return ROHC_STATUS_ERROR;
+	}
+
+	return rohc_comp_compress_pkt(comp, uncomp_packet, rohc_hdr, payload);
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet into a ROHC packet
+ *
+ * The ROHC compressor shall be valid, see \ref rohc_compress4 for details
+ * about the other parameters.
+ *
+ * If \e payload is not NULL, only the ROHC header is written in
+ * \e rohc_packet and \e payload references the payload of the uncompressed
+ * packet, see \ref rohc_compress_zero_copy.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet, or only its
+ *                          header if \e payload is not NULL
+ * @param[out] payload      NULL to copy the payload in \e rohc_packet,
+ *                          otherwise the payload of the ROHC packet that
+ *                          references the payload of \e uncomp_packet
+ * @return                  The status of the compression, see
+ *                          \ref rohc_compress4 for possible values
+ */
+static rohc_status_t rohc_comp_compress_pkt(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_packet,
+                                            struct rohc_buf *const payload)
+{
+	struct rohc_comp_ctxt *c;
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	size_t rohc_pkt_len;
+
+	const struct rohc_comp_profile *profile;
+	rohc_profile_t profile_id;
+
+	struct rohc_fingerprint fingerprint;
+	struct rohc_pkt_hdrs pkt_hdrs;
+
+	const bool do_stats = ((comp->features & ROHC_COMP_FEATURE_STATS) != 0);
+	uint64_t start_ticks = 0;
+
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+
+	/* check inputs validity */
+	if(rohc_buf_is_malformed(uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is empty");
+		goto error;
+	}
+	if(rohc_packet == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is not empty");
+		goto error;
+	}
+
+	/* start measuring the time spent to compress the packet */
+	if(do_stats)
+	{
+		start_ticks = rohc_stats_get_ticks();
+	}
+
+	/* print uncompressed bytes */
+	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
+		                 comp->trace_min_level,
+		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
+		                 "uncompressed data, max 100 bytes", uncomp_packet);
+	}
+
+	/* what ROHC profile fits the uncompressed packet best? */
+	profile_id = rohc_comp_get_profile(comp, &uncomp_packet, &fingerprint, &pkt_hdrs);
+	if(profile_id == ROHC_PROFILE_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to find a matching profile among the enabled profiles "
+		             "for the uncompressed packet");
+		goto error_update_stats;
+	}
+
+	/* find the profile identified by the given profile ID */
+	{
+		const uint8_t profile_major = (profile_id >> 8) & 0xff;
+		const uint8_t profile_minor = profile_id & 0xff;
+		profile = rohc_comp_profiles[profile_major][profile_minor];
+		if(profile == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "profile '%s' (0x%04x) is not implemented yet",
+			             rohc_get_profile_descr(profile_id), profile_id);
+			goto error_update_stats;
+		}
+	}
+
+	/* find the best profile context for the packet */
+	c = rohc_comp_find_ctxt(comp, profile, &uncomp_packet, &fingerprint, &pkt_hdrs);
+	if(c == NULL)
+	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "failed to find a matching context or to create a new "
 		             "context");
-		goto error;
+		goto error_update_stats;
 	}
 
 	/* decide the next state to go */
@@ -1481,7 +2117,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	rohc_packet->len = 0;
 
 	/* use profile to compress packet */
-	rohc_comp_debug(c, "compress the packet #%d", comp->num_packets + 1);
+	rohc_comp_debug(c, "compress the packet #%" PRIu64, comp->num_packets + 1);
 	rohc_hdr_size =
 		c->profile->encode(c, &pkt_hdrs, rohc_buf_data(*rohc_packet),
 		                   rohc_buf_avail_len(*rohc_packet),
@@ -1514,8 +2150,26 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	/* the payload starts after the header, skip it */
 	rohc_buf_pull(rohc_packet, rohc_hdr_size);
 
+	if(payload != NULL)
+	{
+		/* do not copy the payload, reference it in the uncompressed packet */
+		*payload = uncomp_packet;
+		rohc_buf_pull(payload, pkt_hdrs.all_hdrs_len);
+		assert(payload->len == pkt_hdrs.payload_len);
+
+		/* unhide the ROHC header */
+		rohc_buf_push(rohc_packet, rohc_hdr_size);
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "ROHC size = %zu bytes (header = %d, payload = %u), payload "
+		           "not copied", rohc_packet->len + payload->len, rohc_hdr_size,
+		           pkt_hdrs.payload_len);
+		rohc_pkt_len = rohc_packet->len + payload->len;
+
+		/* report to user that compression was successful */
+		status = ROHC_STATUS_OK;
+	}
 	/* is packet too large for output buffer? */
-	if(pkt_hdrs.payload_len > rohc_buf_avail_len(*rohc_packet))
+	else if(pkt_hdrs.payload_len > rohc_buf_avail_len(*rohc_packet))
 	{
 		const size_t max_rohc_buf_len =
 			rohc_buf_avail_len(*rohc_packet) + rohc_hdr_size;
@@ -1585,6 +2239,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 		/* reset the length of the ROHC packet: it shall be 0 for users */
 		rohc_packet->len = 0;
+		rohc_pkt_len = 0;
 
 		/* report to users that segmentation is possible */
 		status = ROHC_STATUS_SEGMENT;
@@ -1604,6 +2259,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		           "ROHC size = %zd bytes (header = %d, payload = %u), output "
 		           "buffer size = %zu", rohc_packet->len, rohc_hdr_size,
 		           pkt_hdrs.payload_len, rohc_buf_avail_len(*rohc_packet));
+		rohc_pkt_len = rohc_packet->len;
 
 		/* report to user that compression was successful */
 		status = ROHC_STATUS_OK;
@@ -1614,22 +2270,40 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	 *  - context statistics (global + last packet + last 16 packets) */
 	comp->num_packets++;
 	comp->total_uncompressed_size += uncomp_packet.len;
-	comp->total_compressed_size += rohc_packet->len;
+	comp->total_compressed_size += rohc_pkt_len;
 	comp->last_context = c;
 
 	c->packet_type = packet_type;
 
 	c->total_uncompressed_size += uncomp_packet.len;
-	c->total_compressed_size += rohc_packet->len;
+	c->total_compressed_size += rohc_pkt_len;
 	c->header_uncompressed_size += pkt_hdrs.all_hdrs_len;
 	c->header_compressed_size += rohc_hdr_size;
 	c->num_sent_packets++;
 
 	c->total_last_uncompressed_size = uncomp_packet.len;
-	c->total_last_compressed_size = rohc_packet->len;
+	c->total_last_compressed_size = rohc_pkt_len;
 	c->header_last_uncompressed_size = pkt_hdrs.all_hdrs_len;
 	c->header_last_compressed_size = rohc_hdr_size;
 
+	/* update the detailed statistics if asked by user */
+	if(do_stats)
+	{
+		struct rohc_comp_stats *const stats = &comp->detailed_stats;
+		const uint64_t latency = rohc_stats_get_ticks() - start_ticks;
+		const uint8_t profile_major = (profile_id >> 8) & 0xff;
+		const uint8_t profile_minor = profile_id & 0xff;
+
+		rohc_stats_write_begin(&comp->detailed_stats_seq);
+		rohc_stats_add(&stats->packets_nr, 1);
+		rohc_stats_add(&stats->uncomp_bytes_nr, uncomp_packet.len);
+		rohc_stats_add(&stats->comp_bytes_nr, rohc_pkt_len);
+		rohc_stats_add(&stats->profiles_nr[profile_major][profile_minor], 1);
+		rohc_stats_add(&stats->pkt_types_nr[packet_type], 1);
+		rohc_stats_add(&stats->latency_hist[rohc_stats_get_latency_bucket(latency)], 1);
+		rohc_stats_write_end(&comp->detailed_stats_seq);
+	}
+
 	/* compression is successful */
 	return status;
 
@@ -1637,23 +2311,18 @@ error_free_new_context:
 	/* free context if it was just created */
 	if(c->num_sent_packets <= 1)
 	{
-		if(c->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
-		{
-			comp->uncompressed_ctxt = NULL;
-		}
-		else
-		{
-			hashtable_del(&comp->contexts_by_fingerprint, &c->fingerprint);
-			/* TODO: replace TCP by CR capacity */
-			if(c->profile->id == ROHCv1_PROFILE_IP_TCP)
-			{
-				hashtable_cr_del(&comp->contexts_cr, &c->fingerprint);
-			}
-		}
-		c->profile->destroy(c);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		c_destroy_context(comp, c);
+	}
+error_update_stats:
+	if(do_stats)
+	{
+		struct rohc_comp_stats *const stats = &comp->detailed_stats;
+		const uint64_t latency = rohc_stats_get_ticks() - start_ticks;
+
+		rohc_stats_write_begin(&comp->detailed_stats_seq);
+		rohc_stats_add(&stats->failures_nr, 1);
+		rohc_stats_add(&stats->latency_hist[rohc_stats_get_latency_bucket(latency)], 1);
+		rohc_stats_write_end(&comp->detailed_stats_seq);
 	}
 error:
 	return ROHC_STATUS_ERROR;
@@ -2343,7 +3012,67 @@ bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
 	comp->rtp_callback = callback;
 	comp->rtp_private = rtp_private;
 
+	/* verdicts of the previous callback are not valid anymore */
+	rohc_comp_rtp_class_flush(comp);
+
+	return true;
+}
+
+
+/**
+ * @brief Enable or disable the built-in heuristic for RTP detection
+ *
+ * The built-in heuristic classifies UDP flows as RTP without any help from
+ * the application. It is used only if no RTP detection callback is set with
+ * \ref rohc_comp_set_rtp_detection_cb.
+ *
+ * One UDP flow is classified as RTP once 2 packets in sequence were seen:
+ * packets with the UDP source or destination port in the given range, the
+ * RTP version 2, the same SSRC, a payload type that cannot be mistaken for
+ * RTCP, and increasing SNs. The first packets of one RTP flow are thus
+ * compressed with the IP/UDP profile. The RTP flow is validated again only
+ * if its SSRC or its RTP version changes.
+ *
+ * The built-in heuristic is disabled by default. Use 0 for both ports to
+ * disable it again.
+ *
+ * @param comp      The ROHC compressor
+ * @param port_min  The lowest UDP port of RTP flows
+ * @param port_max  The highest UDP port of RTP flows
+ * @return          true if the heuristic was successfully set,
+ *                  false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_rtp_detection_cb
+ */
+bool rohc_comp_set_rtp_heuristic(struct rohc_comp *const comp,
+                                 const uint16_t port_min,
+                                 const uint16_t port_max)
+{
+	/* sanity checks on parameters */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(port_min > port_max)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid UDP port range [%u ; %u] for RTP detection",
+		             port_min, port_max);
+		goto error;
+	}
+
+	comp->rtp_heuristic_port_min = port_min;
+	comp->rtp_heuristic_port_max = port_max;
+
+	/* verdicts of the previous heuristic are not valid anymore */
+	rohc_comp_rtp_class_flush(comp);
+
 	return true;
+
+error:
+	return false;
 }
 
 
@@ -2868,6 +3597,81 @@ error:
 }
 
 
+/**
+ * @brief Set the number of context objects preallocated per slab
+ *
+ * Enable the slab allocator of the compressor for the profile-specific parts
+ * of the compression contexts and for their W-LSB windows. The slab
+ * allocator keeps one slab per object size. Every slab preallocates the
+ * given number of objects with one single allocation the first time an
+ * object of its size is needed, and never grows. Objects released by
+ * destroyed contexts are kept in the slab for the next contexts, so creating
+ * and destroying contexts for short-lived flows does not fragment the heap
+ * nor call the system allocator. The memory of the slabs is released when
+ * the compressor is destroyed.
+ *
+ * Once all the objects of one slab are in use, the creation of a new context
+ * that needs one more object of that size fails. One context uses at most 4
+ * objects (the generic and RTP parts of an RTP context, and their W-LSB
+ * stores), so (MAX_CID + 1) * 4 objects per slab are enough for all the
+ * contexts the compressor may create. Fewer objects per slab bound the
+ * memory further at the cost of fewer contexts of one given kind.
+ *
+ * The slab allocator is disabled by default. Set \e objs_per_slab to 0 to
+ * disable it again: new objects are then allocated with malloc().
+ *
+ * The slab allocator cannot be changed once one of its slabs was allocated,
+ * so the function shall be called before the first packet is compressed.
+ *
+ * @param comp           The ROHC compressor
+ * @param objs_per_slab  The number of objects preallocated per slab,
+ *                       in range [0, 65536]
+ * @return               true if the setting was successfully changed,
+ *                       false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_decomp_set_arena
+ */
+bool rohc_comp_set_arena(struct rohc_comp *const comp,
+                         const size_t objs_per_slab)
+{
+	/* compressor must be valid */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* number of objects per slab must be in range [0, ROHC_ARENA_SLAB_OBJS_MAX] */
+	if(objs_per_slab > ROHC_ARENA_SLAB_OBJS_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unexpected number of objects per slab %zu: must be in "
+		             "range [0, %u]", objs_per_slab, ROHC_ARENA_SLAB_OBJS_MAX);
+		goto error;
+	}
+
+	/* the slabs cannot be resized once allocated */
+	if(comp->arena.slabs_nr > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "slab allocator cannot be changed once slabs exist");
+		goto error;
+	}
+
+	comp->arena.objs_per_slab = objs_per_slab;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "slab allocator %s (%zu objects per slab)",
+	          objs_per_slab > 0 ? "enabled" : "disabled", objs_per_slab);
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get the maximal CID value the compressor uses
  *
@@ -2952,7 +3756,10 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 	const rohc_comp_features_t all_features =
 		ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
 		ROHC_COMP_FEATURE_DUMP_PACKETS |
-		ROHC_COMP_FEATURE_TIME_BASED_REFRESHES;
+		ROHC_COMP_FEATURE_TIME_BASED_REFRESHES |
+		ROHC_COMP_FEATURE_FAST_CTXT_HASH |
+		ROHC_COMP_FEATURE_STATS |
+		ROHC_COMP_FEATURE_RTP_CLASS_CACHE;
 
 	/* compressor must be valid */
 	if(comp == NULL)
@@ -2970,6 +3777,24 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* select the hash function for finding contexts by their fingerprint */
+	if(!hashtable_set_hash(&comp->contexts_by_fingerprint,
+	                       (features & ROHC_COMP_FEATURE_FAST_CTXT_HASH) != 0 ?
+	                       HASHTABLE_HASH_FAST : HASHTABLE_HASH_SIPHASH))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to change the hash function of the table of "
+		             "contexts: no memory available");
+		goto error;
+	}
+
+	/* forget the cached verdicts of the RTP detection callback if the cache
+	 * is enabled or disabled */
+	if(((comp->features ^ features) & ROHC_COMP_FEATURE_RTP_CLASS_CACHE) != 0)
+	{
+		rohc_comp_rtp_class_flush(comp);
+	}
+
 	/* record new feature set */
 	comp->features = features;
 
@@ -3168,52 +3993,446 @@ error:
 
 
 /**
- * @brief Get some information about the last compressed packet
- *
- * Get some information about the last compressed packet.
- *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
- *
- * See the \ref rohc_comp_last_packet_info2_t structure for details about
- * fields that are supported in the above versions.
+ * @brief Deliver a batch of feedback packets to the compressor
+ *
+ * The feedback packets of the batch may contain several feedback items
+ * each. The feedback items are grouped by context before they are taken
+ * into account:
+ *  \li the newest ACK of every context supersedes the older ACKs, since it
+ *      acknowledges all the packets that the older ACKs acknowledged; only
+ *      ACKs without options (except CRC and SN) that request the same mode
+ *      are grouped, other ACKs are all taken into account,
+ *  \li only the strongest NACK of every context is taken into account: the
+ *      newest STATIC-NACK if any, the newest NACK otherwise.
+ *
+ * The ACK and the NACK of every context are taken into account in the order
+ * they were received. Items with reserved acknowledgement types are taken
+ * into account immediately, as \ref rohc_comp_deliver_feedback2 does.
+ *
+ * On high-rate links, the reverse channel may deliver many ACKs for every
+ * context between two calls: grouping them avoids updating the compression
+ * context for every one of them.
  *
- * @param comp          The ROHC compressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param comp          The ROHC compressor
+ * @param feedbacks     The feedback packets
+ * @param feedbacks_nr  The number of feedback packets
+ * @return              true if all the feedback items were successfully
+ *                      taken into account,
+ *                      false if one feedback item could not be taken into
+ *                      account
  *
  * @ingroup rohc_comp
  *
- * @see rohc_comp_last_packet_info2_t
+ * @see rohc_comp_deliver_feedback2
  */
-bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
-                                     rohc_comp_last_packet_info2_t *const info)
+bool rohc_comp_deliver_feedbacks(struct rohc_comp *const comp,
+                                 const struct rohc_buf *const feedbacks,
+                                 const size_t feedbacks_nr)
 {
+	struct rohc_comp_ctxt *first_ctxt = NULL;
+	struct rohc_comp_ctxt **last_ctxt = &first_ctxt;
+	struct rohc_comp_ctxt *context;
+	size_t items_nr = 0;
+	size_t nr_failures = 0;
+	size_t i;
+
+	/* sanity checks */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-
-	if(comp->last_context == NULL)
+	if(feedbacks == NULL && feedbacks_nr > 0)
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "last context found in compressor is not valid");
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: no feedback packet given");
 		goto error;
 	}
 
-	if(info == NULL)
+	/* group the feedback items by context */
+	for(i = 0; i < feedbacks_nr; i++)
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "structure for last packet information is not valid");
-		goto error;
-	}
+		struct rohc_buf remain_data = feedbacks[i];
 
-	/* check compatibility version */
-	if(info->version_major == 0)
-	{
-		/* base fields for major version 0 */
+		if(rohc_buf_is_malformed(remain_data))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback: feedback #%zu is malformed",
+			             i + 1);
+			nr_failures++;
+			continue;
+		}
+
+		while(remain_data.len > 0 &&
+		      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+		{
+			size_t feedback_hdr_len;
+			size_t feedback_data_len;
+
+			if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+			                           &feedback_data_len) ||
+			   (feedback_hdr_len + feedback_data_len) > remain_data.len)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to parse a feedback item of feedback #%zu",
+				             i + 1);
+				nr_failures++;
+				break;
+			}
+			rohc_buf_pull(&remain_data, feedback_hdr_len);
+
+			if(!rohc_comp_batch_feedback(comp, rohc_buf_data(remain_data),
+			                             feedback_data_len, items_nr, &last_ctxt))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to deliver feedback item #%zu", items_nr + 1);
+				nr_failures++;
+			}
+			items_nr++;
+
+			rohc_buf_pull(&remain_data, feedback_data_len);
+		}
+	}
+
+	/* take the ACK and the NACK kept for every context into account, in the
+	 * order they were received */
+	for(context = first_ctxt; context != NULL; context = context->feedback_batch.next)
+	{
+		if(!rohc_comp_flush_feedback_batch(comp, context))
+		{
+			nr_failures++;
+		}
+		context->feedback_batch.is_pending = false;
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "%zu feedback item(s) delivered in %zu feedback packet(s)",
+	           items_nr, feedbacks_nr);
+
+	return (nr_failures == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Keep one feedback item for its context in the current batch
+ *
+ * The item replaces the ACK or the NACK already kept for the context if it
+ * is newer or stronger. An ACK replaces the ACK already kept only if both
+ * carry no option but CRC and SN, and request the same mode: otherwise, the
+ * items kept for the context are taken into account before the new ACK is
+ * kept. Items that cannot be grouped are taken into account immediately.
+ *
+ * @param comp                The ROHC compressor
+ * @param packet              The feedback data
+ * @param size                The length of the feedback data
+ * @param pos                 The position of the feedback item in the batch
+ * @param[in,out] last_ctxt   The end of the list of contexts of the batch
+ * @return                    true if the item was kept or taken into account,
+ *                            false if the item is malformed or for an
+ *                            unknown context, or if the items kept for
+ *                            the context failed to be taken into account
+ */
+static bool rohc_comp_batch_feedback(struct rohc_comp *const comp,
+                                     const uint8_t *const packet,
+                                     const size_t size,
+                                     const size_t pos,
+                                     struct rohc_comp_ctxt ***const last_ctxt)
+{
+	struct rohc_comp_feedback_batch *batch;
+	struct rohc_comp_ctxt *context;
+	enum rohc_feedback_ack_type ack_type;
+	bool is_flush_ok = true;
+	rohc_cid_t cid;
+	size_t cid_len;
+
+	/* find the context of the feedback item */
+	if(!rohc_comp_feedback_parse_cid(comp, packet, size, &cid, &cid_len))
+	{
+		goto error;
+	}
+	context = c_get_context(comp, cid);
+	if(context == NULL || cid_len >= size)
+	{
+		/* let the usual delivery report the error */
+		return __rohc_comp_deliver_feedback(comp, packet, size);
+	}
+	batch = &context->feedback_batch;
+
+	/* FEEDBACK-1 is always an ACK, FEEDBACK-2 starts with the ACK type */
+	if((size - cid_len) == 1)
+	{
+		ack_type = ROHC_FEEDBACK_ACK;
+	}
+	else
+	{
+		ack_type = (packet[cid_len] >> 6) & 0x03;
+	}
+
+	if(ack_type == ROHC_FEEDBACK_ACK)
+	{
+		if(batch->ack != NULL)
+		{
+			rohc_mode_t old_mode;
+			rohc_mode_t new_mode;
+
+			/* ACKs with options or mode requests shall not be lost */
+			if(rohc_comp_feedback_get_ack_mode(comp, context, batch->ack,
+			                                   batch->ack_len, &old_mode) &&
+			   rohc_comp_feedback_get_ack_mode(comp, context, packet, size,
+			                                   &new_mode) &&
+			   old_mode == new_mode)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "CID %u: ACK superseded by a newer ACK", cid);
+			}
+			else
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "CID %u: ACK cannot be grouped with the previous ACK, "
+				           "take the previous feedback items into account", cid);
+				is_flush_ok = rohc_comp_flush_feedback_batch(comp, context);
+			}
+		}
+		batch->ack = packet;
+		batch->ack_len = size;
+		batch->ack_pos = pos;
+	}
+	else if(ack_type == ROHC_FEEDBACK_NACK ||
+	        ack_type == ROHC_FEEDBACK_STATIC_NACK)
+	{
+		if(batch->nack == NULL || ack_type >= batch->nack_type)
+		{
+			if(batch->nack != NULL)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "CID %u: NACK superseded by a newer or stronger NACK",
+				           cid);
+			}
+			batch->nack = packet;
+			batch->nack_len = size;
+			batch->nack_pos = pos;
+			batch->nack_type = ack_type;
+		}
+		else
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "CID %u: NACK superseded by a stronger NACK", cid);
+		}
+	}
+	else
+	{
+		return __rohc_comp_deliver_feedback(comp, packet, size);
+	}
+
+	/* add the context to the list of contexts of the batch */
+	if(!batch->is_pending)
+	{
+		batch->next = NULL;
+		batch->is_pending = true;
+		**last_ctxt = context;
+		*last_ctxt = &batch->next;
+	}
+
+	return is_flush_ok;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Take the feedback items kept for one context into account
+ *
+ * The ACK and the NACK kept for the context are taken into account in the
+ * order they were received, then they are forgotten. The context stays in
+ * the list of contexts of the batch.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context
+ * @return         true if the kept items were successfully taken into account,
+ *                 false if one of them could not be taken into account
+ */
+static bool rohc_comp_flush_feedback_batch(struct rohc_comp *const comp,
+                                           struct rohc_comp_ctxt *const context)
+{
+	struct rohc_comp_feedback_batch *const batch = &context->feedback_batch;
+	bool is_success = true;
+
+	if(batch->nack != NULL && (batch->ack == NULL || batch->nack_pos < batch->ack_pos))
+	{
+		if(!__rohc_comp_deliver_feedback(comp, batch->nack, batch->nack_len))
+		{
+			is_success = false;
+		}
+		batch->nack = NULL;
+	}
+	if(batch->ack != NULL &&
+	   !__rohc_comp_deliver_feedback(comp, batch->ack, batch->ack_len))
+	{
+		is_success = false;
+	}
+	if(batch->nack != NULL &&
+	   !__rohc_comp_deliver_feedback(comp, batch->nack, batch->nack_len))
+	{
+		is_success = false;
+	}
+	batch->ack = NULL;
+	batch->nack = NULL;
+
+	return is_success;
+}
+
+
+/**
+ * @brief Get the mode requested by an ACK that may be grouped with others
+ *
+ * An ACK may be superseded by a newer ACK only if it carries no information
+ * but the acknowledged SN: FEEDBACK-1, or FEEDBACK-2 with no option but the
+ * CRC and SN options. The REJECT, SN-NOT-VALID, CLOCK, JITTER, LOSS... options
+ * shall reach the profile.
+ *
+ * Only the FEEDBACK-2 of the RFC3095 profiles carries a mode, and the
+ * compressor changes its mode only if a CRC option protects the FEEDBACK-2
+ * (RFC3095, §5.6.1): the mode of the other ACKs is \ref ROHC_UNKNOWN_MODE.
+ *
+ * @param comp        The ROHC compressor
+ * @param context     The compression context
+ * @param packet      The feedback data with the CID bits
+ * @param size        The length of the feedback data
+ * @param[out] mode   The mode requested by the ACK
+ * @return            true if the ACK may be grouped with other ACKs,
+ *                    false if it shall be taken into account
+ */
+static bool rohc_comp_feedback_get_ack_mode(const struct rohc_comp *const comp,
+                                            const struct rohc_comp_ctxt *const context,
+                                            const uint8_t *const packet,
+                                            const size_t size,
+                                            rohc_mode_t *const mode)
+{
+	rohc_mode_t requested_mode = ROHC_UNKNOWN_MODE;
+	bool has_crc_opt = false;
+	const uint8_t *remain_data;
+	size_t remain_len;
+	size_t base_len;
+	rohc_cid_t cid;
+	size_t cid_len;
+
+	*mode = ROHC_UNKNOWN_MODE;
+
+	/* skip the CID bits */
+	if(!rohc_comp_feedback_parse_cid(comp, packet, size, &cid, &cid_len) ||
+	   cid_len >= size)
+	{
+		goto not_plain;
+	}
+	remain_data = packet + cid_len;
+	remain_len = size - cid_len;
+
+	/* FEEDBACK-1 only carries SN bits */
+	if(remain_len == 1)
+	{
+		goto plain;
+	}
+
+	/* FEEDBACK-2 base header: with mode for the RFC3095 profiles, with CRC
+	 * for the TCP and ROHCv2 profiles */
+	if(rohc_profile_is_rohcv1(context->profile->id) &&
+	   context->profile->id != ROHC_PROFILE_TCP)
+	{
+		base_len = sizeof(struct rohc_feedback_2_rfc3095);
+		requested_mode = (remain_data[0] >> 4) & 0x03;
+	}
+	else
+	{
+		base_len = sizeof(struct rohc_feedback_2_rfc6846);
+	}
+	if(remain_len < base_len)
+	{
+		goto not_plain;
+	}
+	remain_data += base_len;
+	remain_len -= base_len;
+
+	/* FEEDBACK-2 options */
+	while(remain_len > 0)
+	{
+		const uint8_t opt_type = (remain_data[0] >> 4) & 0x0f;
+		const size_t opt_len = (remain_data[0] & 0x0f) + 1;
+
+		if((opt_type != ROHC_FEEDBACK_OPT_CRC && opt_type != ROHC_FEEDBACK_OPT_SN) ||
+		   opt_len > remain_len)
+		{
+			goto not_plain;
+		}
+		if(opt_type == ROHC_FEEDBACK_OPT_CRC)
+		{
+			has_crc_opt = true;
+		}
+		remain_data += opt_len;
+		remain_len -= opt_len;
+	}
+	if(has_crc_opt)
+	{
+		*mode = requested_mode;
+	}
+
+plain:
+	return true;
+
+not_plain:
+	return false;
+}
+
+
+/**
+ * @brief Get some information about the last compressed packet
+ *
+ * Get some information about the last compressed packet.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_last_packet_info2_t structure for details about
+ * fields that are supported in the above versions.
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_last_packet_info2_t
+ */
+bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
+                                     rohc_comp_last_packet_info2_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(comp->last_context == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "last context found in compressor is not valid");
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for last packet information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		/* base fields for major version 0 */
 		info->context_id = comp->last_context->cid;
 		info->is_context_init = (comp->last_context->num_sent_packets == 1);
 		info->context_mode = comp->last_context->mode;
@@ -3319,6 +4538,88 @@ error:
 }
 
 
+/**
+ * @brief Get the detailed statistics of the compressor
+ *
+ * Get a snapshot of the detailed statistics of the compressor. The statistics
+ * are collected only if the \ref ROHC_COMP_FEATURE_STATS feature is enabled
+ * with \ref rohc_comp_set_features.
+ *
+ * The function does not take any lock: it may be called by any thread, even
+ * while another thread is compressing packets with the same compressor. The
+ * snapshot is consistent, ie. it does not contain any partial update.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_stats_t structure for details about fields that
+ * are supported in the above versions.
+ *
+ * @param comp           The ROHC compressor to get statistics from
+ * @param[in,out] stats  The structure where statistics will be stored
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_stats_t
+ * @see ROHC_COMP_FEATURE_STATS
+ */
+bool rohc_comp_get_stats(const struct rohc_comp *const comp,
+                         rohc_comp_stats_t *const stats)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		/* new fields added by minor versions */
+		if(stats->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "statistics", stats->version_minor);
+			goto error;
+		}
+
+		/* base fields for major version 0: the counters of the internal
+		 * statistics are in the same order as in the structure of the API,
+		 * so take a consistent snapshot of all of them at once */
+		assert((sizeof(rohc_comp_stats_t) -
+		        offsetof(rohc_comp_stats_t, packets_nr)) ==
+		       sizeof(struct rohc_comp_stats));
+		stats->unused = 0;
+		rohc_stats_read(&comp->detailed_stats_seq,
+		                ((uint8_t *) stats) + offsetof(rohc_comp_stats_t, packets_nr),
+		                (const uint64_t *) &comp->detailed_stats,
+		                sizeof(struct rohc_comp_stats) / sizeof(uint64_t));
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "statistics", stats->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Give a description for the given ROHC compression context state
  *
@@ -3378,77 +4679,37 @@ static struct rohc_comp_ctxt *
 	const struct rohc_comp_ctxt *base_ctxt;
 	struct rohc_comp_ctxt *c;
 	rohc_cid_t cid_to_use;
-
-	cid_to_use = 0;
+	bool is_ctxt_recycled = false;
 
 	/* if all the contexts in the array are used:
-	 *   => recycle the oldest context to make room
+	 *   => recycle the least recently used context to make room
 	 * if at least one context in the array is not used:
-	 *   => pick the first unused context
+	 *   => pick the first context in the list of unused contexts
 	 */
-	if(comp->num_contexts_used > comp->medium.max_cid)
+	if(comp->ctxts_free == NULL)
 	{
-		/* all the contexts in the array were used, recycle the oldest context
-		 * to make some room */
-
-		uint64_t oldest;
-		rohc_cid_t i;
-
-		/* find the oldest context */
-		oldest = 0xffffffff;
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].latest_used < oldest)
-			{
-				oldest = comp->contexts[i].latest_used;
-				cid_to_use = i;
-			}
-		}
-		c = &comp->contexts[cid_to_use];
+		/* all the contexts in the array were used, recycle the least recently
+		 * used context (the head of the LRU list) to make some room */
+		c = comp->ctxts_lru_first;
+		assert(c != NULL);
+		assert(comp->num_contexts_used > (comp->last_cid - comp->first_cid));
 
 		/* destroy the oldest context before replacing it with a new one */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "recycle oldest context (CID %u with profile 0x%04x)",
-		           cid_to_use, c->profile->id);
-		if(c->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
-		{
-			comp->uncompressed_ctxt = NULL;
-		}
-		else
-		{
-			hashtable_del(&comp->contexts_by_fingerprint, &c->fingerprint);
-			/* TODO: replace TCP by CR capacity */
-			if(c->profile->id == ROHCv1_PROFILE_IP_TCP)
-			{
-				hashtable_cr_del(&comp->contexts_cr, &c->fingerprint);
-			}
-		}
-		c->profile->destroy(&comp->contexts[cid_to_use]);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		           c->cid, c->profile->id);
+		c_destroy_context(comp, c);
+		is_ctxt_recycled = true;
 	}
-	else
-	{
-		/* there was at least one unused context in the array, pick the first
-		 * unused context in the context array */
-
-		rohc_cid_t i;
 
-		/* find the first unused context */
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].used == 0)
-			{
-				cid_to_use = i;
-				break;
-			}
-		}
-		c = &comp->contexts[cid_to_use];
-
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "take the first unused context (CID %u)", cid_to_use);
-	}
+	/* pick the first unused context */
+	c = comp->ctxts_free;
+	assert(c != NULL);
+	assert(c->used == 0);
+	comp->ctxts_free = c->lru_next;
+	cid_to_use = c - comp->contexts;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "take the first unused context (CID %u)", cid_to_use);
 
 	/* search for a possible base context if Context Replication is possible */
 	base_ctxt = rohc_comp_search_base_ctxt(comp, profile, fingerprint, pkt_hdrs);
@@ -3471,6 +4732,7 @@ static struct rohc_comp_ctxt *
 	}
 
 	memcpy(&c->fingerprint, fingerprint, sizeof(struct rohc_fingerprint));
+	rohc_comp_build_fingerprint_key(&c->fingerprint_key, fingerprint);
 
 	c->state_oa_repeat_nr = 0;
 	c->go_back_fo_count = 0;
@@ -3502,38 +4764,63 @@ static struct rohc_comp_ctxt *
 	{
 		if(!profile->clone(c, base_ctxt))
 		{
-			return NULL;
+			goto error;
 		}
 	}
 	else
 	{
 		if(!profile->create(c, pkt_hdrs))
 		{
-			return NULL;
+			goto error;
 		}
 	}
 
-	/* if creation is successful, mark the context as used */
-	c->used = 1;
-	c->latest_used = pkt_time.sec;
-	assert(comp->num_contexts_used <= comp->medium.max_cid);
-	comp->num_contexts_used++;
-
 	/* insert the context in the hash table of contexts to efficiently find it
 	 * again through its fingerprint */
 	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
 	{
 		comp->uncompressed_ctxt = c;
 	}
-	else
+	else if(!hashtable_add(&comp->contexts_by_fingerprint, c->cid))
 	{
-		hashtable_add(&comp->contexts_by_fingerprint, &(c->fingerprint), c);
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to add context with CID %u in the table of "
+		             "contexts: no memory available", c->cid);
+		profile->destroy(c);
+		goto error;
+	}
+
+	/* if creation is successful, mark the context as used and record it as
+	 * the most recently used context */
+	c->used = 1;
+	c->latest_used = pkt_time;
+	assert(comp->num_contexts_used <= (comp->last_cid - comp->first_cid));
+	comp->num_contexts_used++;
+	c_lru_append(comp, c);
+
+	/* update the detailed statistics if asked by user */
+	if((comp->features & ROHC_COMP_FEATURE_STATS) != 0)
+	{
+		rohc_stats_write_begin(&comp->detailed_stats_seq);
+		rohc_stats_add(&comp->detailed_stats.ctxt_creations_nr, 1);
+		rohc_stats_add(&comp->detailed_stats.ctxt_evictions_nr, is_ctxt_recycled);
+		rohc_stats_add(&comp->detailed_stats.ctxt_replications_nr, base_ctxt != NULL);
+		rohc_stats_write_end(&comp->detailed_stats_seq);
 	}
 
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "context (CID %u) created at %" PRIu64 " seconds (num_used = %u)",
-	           c->cid, c->latest_used, comp->num_contexts_used);
+	           "context (CID %u) created at %" PRIu64 ".%09" PRIu64 " seconds "
+	           "(num_used = %u)", c->cid, c->latest_used.sec,
+	           c->latest_used.nsec, comp->num_contexts_used);
 	return c;
+
+error:
+	/* give the context back to the list of unused contexts (the base context
+	 * copied for Context Replication may have marked it as used) */
+	c->used = 0;
+	c->lru_next = comp->ctxts_free;
+	comp->ctxts_free = c;
+	return NULL;
 }
 
 
@@ -3560,17 +4847,19 @@ static const struct rohc_comp_ctxt *
 	if(profile->id == ROHCv1_PROFILE_IP_TCP)
 	{
 		size_t best_ctxt_affinity = ROHC_AFFINITY_NONE;
-		const struct rohc_comp_ctxt *candidate;
+		struct hashtable_iter iter;
+		uint32_t candidate_cid;
 
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "search a base context for Context Replication");
 
 		/* search for a base context that we may clone the new context from */
-		for(candidate = hashtable_cr_get_first(&comp->contexts_cr, fingerprint);
-		    candidate != NULL;
-		    candidate = hashtable_cr_get_next(&comp->contexts_cr, fingerprint,
-		                                      candidate))
+		for(candidate_cid = hashtable_get_first(&comp->contexts_cr, fingerprint, &iter);
+		    candidate_cid != HASHTABLE_NO_IDX;
+		    candidate_cid = hashtable_get_next(&comp->contexts_cr, fingerprint, &iter))
 		{
+			const struct rohc_comp_ctxt *const candidate =
+				&(comp->contexts[candidate_cid]);
 			rohc_ctxt_affinity_t ctxt_affinity;
 
 			/* context partially matches the fingerprint of the packet */
@@ -3747,7 +5036,7 @@ static struct rohc_comp_ctxt *
 	else /* non-Uncompressed profiles */
 	{
 		/* search for an existing context matching the packet fingerprint */
-		context = hashtable_get(&comp->contexts_by_fingerprint, pkt_fingerprint);
+		context = rohc_comp_find_ctxt_by_fingerprint(comp, pkt_fingerprint);
 
 		/* hmmm, looks like we could re-use that context ; if Context Replication
 		 * is in action, check that the base context didn't change too much */
@@ -3789,12 +5078,7 @@ static struct rohc_comp_ctxt *
 				           base_ctxt->cid);
 
 				/* destroy that half-opened context */
-				hashtable_del(&comp->contexts_by_fingerprint, &context->fingerprint);
-				hashtable_cr_del(&comp->contexts_cr, &context->fingerprint);
-				profile->destroy(context);
-				context->used = 0;
-				assert(comp->num_contexts_used > 0);
-				comp->num_contexts_used--;
+				c_destroy_context(comp, context);
 
 				/* no context found */
 				context = NULL;
@@ -3804,13 +5088,20 @@ static struct rohc_comp_ctxt *
 
 	if(context != NULL)
 	{
-		/* matching context found, update use timestamp */
+		/* matching context found, update use timestamp and move the context
+		 * at the tail of the LRU list */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "re-using context CID %u", context->cid);
-		context->latest_used = packet->time.sec;
+		context->latest_used = packet->time;
+		if(comp->ctxts_lru_last != context)
+		{
+			c_lru_remove(comp, context);
+			c_lru_append(comp, context);
+		}
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "context (CID %u) used at %" PRIu64 " seconds",
-		           context->cid, context->latest_used);
+		           "context (CID %u) used at %" PRIu64 ".%09" PRIu64 " seconds",
+		           context->cid, context->latest_used.sec,
+		           context->latest_used.nsec);
 	}
 	else /* context not found, create a new one */
 	{
@@ -3860,6 +5151,215 @@ not_found:
 }
 
 
+/**
+ * @brief Build the compact key of the given fingerprint
+ *
+ * @param[out] key      The compact key of the fingerprint
+ * @param fingerprint   The fingerprint of the packet or context
+ */
+static void rohc_comp_build_fingerprint_key(struct rohc_fingerprint_key *const key,
+                                            const struct rohc_fingerprint *const fingerprint)
+{
+	uint8_t *data = key->data + 1;
+	size_t i;
+
+	assert(fingerprint->base.ip_hdrs_nr <= ROHC_MAX_IP_HDRS);
+
+	data[0] = (fingerprint->base.profile_id >> 8) & 0xff;
+	data[1] = fingerprint->base.profile_id & 0xff;
+	data[2] = fingerprint->base.ip_hdrs_nr;
+	data += 3;
+
+	for(i = 0; i < fingerprint->base.ip_hdrs_nr; i++)
+	{
+		const struct rohc_fingerprint_ip *const ip = &(fingerprint->base.ip_hdrs[i]);
+		const size_t addr_len =
+			(ip->version == IPV4 ? sizeof(uint32_t) : sizeof(struct ipv6_addr));
+		const uint32_t ip_fields =
+			(((uint32_t) ip->version) << 28) | (((uint32_t) ip->next_proto) << 20) |
+			ip->flow_label;
+
+		memcpy(data, &ip_fields, sizeof(uint32_t));
+		data += sizeof(uint32_t);
+		memcpy(data, ip->saddr.u8, addr_len);
+		data += addr_len;
+		memcpy(data, ip->daddr.u8, addr_len);
+		data += addr_len;
+	}
+
+	memcpy(data, &fingerprint->esp_spi, sizeof(uint32_t));
+	data += sizeof(uint32_t);
+	memcpy(data, &fingerprint->rtp_ssrc, sizeof(uint32_t));
+	data += sizeof(uint32_t);
+
+	key->data[0] = data - key->data;
+}
+
+
+/**
+ * @brief Get the index in the flow cache for the given fingerprint
+ *
+ * The index is a cheap hash of the innermost IP addresses and protocol, and
+ * of the ports (or SPI) and profile of the fingerprint. It does not need to
+ * be secure: the entries of the flow cache are always checked against the
+ * full fingerprint, and the flow cache is only a shortcut in front of the
+ * hash table of contexts.
+ *
+ * @param fingerprint  The fingerprint of the packet or context
+ * @return             The index in the flow cache
+ */
+static size_t rohc_comp_flow_cache_idx(const struct rohc_fingerprint *const fingerprint)
+{
+	const uint8_t ip_hdrs_nr = fingerprint->base.ip_hdrs_nr;
+	const struct rohc_fingerprint_ip *const ip =
+		&(fingerprint->base.ip_hdrs[ip_hdrs_nr > 0 ? (ip_hdrs_nr - 1) : 0]);
+	uint32_t hash;
+
+	hash = ip->saddr.u32[0] ^ ip->saddr.u32[1] ^ ip->saddr.u32[2] ^ ip->saddr.u32[3];
+	hash ^= ip->daddr.u32[0] ^ ip->daddr.u32[1] ^ ip->daddr.u32[2] ^ ip->daddr.u32[3];
+	hash ^= fingerprint->esp_spi ^ (ip->next_proto << 8) ^ fingerprint->base.profile_id;
+	hash *= 0x9e3779b1U;
+
+	return (hash >> 24) & (ROHC_COMP_FLOW_CACHE_SIZE - 1);
+}
+
+
+/**
+ * @brief Find the compression context that matches the given fingerprint
+ *
+ * The flow cache is looked up first, so that the packets of one flow do not
+ * pay for the keyed hash of the fingerprint every time. The hash table of
+ * contexts is looked up on cache miss, and the flow cache is updated with
+ * the context found there. Both are searched with the compact key of the
+ * fingerprint.
+ *
+ * @param comp         The ROHC compressor
+ * @param fingerprint  The fingerprint of the packet
+ * @return             The context if found, NULL if not found
+ */
+static struct rohc_comp_ctxt *
+	rohc_comp_find_ctxt_by_fingerprint(struct rohc_comp *const comp,
+	                                   const struct rohc_fingerprint *const fingerprint)
+{
+	const size_t flow_cache_idx = rohc_comp_flow_cache_idx(fingerprint);
+	struct rohc_comp_ctxt *context = comp->flow_cache[flow_cache_idx];
+	struct rohc_fingerprint_key key;
+
+	rohc_comp_build_fingerprint_key(&key, fingerprint);
+	if(context == NULL ||
+	   memcmp(context->fingerprint_key.data, key.data, key.data[0]) != 0)
+	{
+		const uint32_t cid = hashtable_get(&comp->contexts_by_fingerprint, &key);
+		if(cid == HASHTABLE_NO_IDX)
+		{
+			context = NULL;
+		}
+		else
+		{
+			context = &(comp->contexts[cid]);
+			comp->flow_cache[flow_cache_idx] = context;
+		}
+	}
+
+	return context;
+}
+
+
+/**
+ * @brief Destroy one compression context and give it back to the list of
+ *        unused contexts
+ *
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to destroy
+ */
+static void c_destroy_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+{
+	assert(ctxt->used);
+
+	if(ctxt->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		comp->uncompressed_ctxt = NULL;
+	}
+	else
+	{
+		const size_t flow_cache_idx = rohc_comp_flow_cache_idx(&ctxt->fingerprint);
+		if(comp->flow_cache[flow_cache_idx] == ctxt)
+		{
+			comp->flow_cache[flow_cache_idx] = NULL;
+		}
+		hashtable_del(&comp->contexts_by_fingerprint, ctxt->cid);
+		rohc_comp_rtp_class_forget(comp, ctxt);
+		/* TODO: replace TCP by CR capacity */
+		if(ctxt->profile->id == ROHCv1_PROFILE_IP_TCP)
+		{
+			hashtable_del(&comp->contexts_cr, ctxt->cid);
+		}
+	}
+	ctxt->profile->destroy(ctxt);
+	ctxt->used = 0;
+	assert(comp->num_contexts_used > 0);
+	comp->num_contexts_used--;
+
+	c_lru_remove(comp, ctxt);
+	ctxt->lru_next = comp->ctxts_free;
+	comp->ctxts_free = ctxt;
+}
+
+
+/**
+ * @brief Append the given context at the tail of the LRU list
+ *
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context that was just used
+ */
+static void c_lru_append(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+{
+	ctxt->lru_prev = comp->ctxts_lru_last;
+	ctxt->lru_next = NULL;
+	if(comp->ctxts_lru_last == NULL)
+	{
+		comp->ctxts_lru_first = ctxt;
+	}
+	else
+	{
+		comp->ctxts_lru_last->lru_next = ctxt;
+	}
+	comp->ctxts_lru_last = ctxt;
+}
+
+
+/**
+ * @brief Remove the given context from the LRU list
+ *
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to remove
+ */
+static void c_lru_remove(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+{
+	if(ctxt->lru_prev == NULL)
+	{
+		comp->ctxts_lru_first = ctxt->lru_next;
+	}
+	else
+	{
+		ctxt->lru_prev->lru_next = ctxt->lru_next;
+	}
+	if(ctxt->lru_next == NULL)
+	{
+		comp->ctxts_lru_last = ctxt->lru_prev;
+	}
+	else
+	{
+		ctxt->lru_next->lru_prev = ctxt->lru_prev;
+	}
+	ctxt->lru_prev = NULL;
+	ctxt->lru_next = NULL;
+}
+
+
 /**
  * @brief Create the array of compression contexts
  *
@@ -3885,6 +5385,81 @@ static bool c_create_contexts(struct rohc_comp *const comp)
 		goto error;
 	}
 
+	/* all contexts are unused */
+	c_chain_free_contexts(comp);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Chain all the contexts the compressor may use as unused contexts
+ *
+ * The contexts are chained in CID order so that the lowest CIDs are used
+ * first. All the contexts shall be unused.
+ *
+ * @param comp The ROHC compressor
+ */
+static void c_chain_free_contexts(struct rohc_comp *const comp)
+{
+	rohc_cid_t i;
+
+	assert(comp->num_contexts_used == 0);
+
+	for(i = comp->first_cid; i < comp->last_cid; i++)
+	{
+		comp->contexts[i].lru_next = &comp->contexts[i + 1];
+	}
+	comp->contexts[comp->last_cid].lru_next = NULL;
+	comp->ctxts_free = &comp->contexts[comp->first_cid];
+	comp->ctxts_lru_first = NULL;
+	comp->ctxts_lru_last = NULL;
+}
+
+
+/**
+ * @brief Restrict the CIDs the compressor may use
+ *
+ * Several compressors may then share the CID space of one single channel
+ * without conflicts, each of them using its own range of CIDs.
+ *
+ * The range shall be set before the first context is created.
+ *
+ * @param comp       The ROHC compressor
+ * @param first_cid  The first CID the compressor may use
+ * @param last_cid   The last CID the compressor may use, in range
+ *                   [first_cid, MAX_CID]
+ * @return           true if the range was set,
+ *                   false if the range is invalid or if contexts exist
+ */
+bool rohc_comp_set_cid_range(struct rohc_comp *const comp,
+                             const rohc_cid_t first_cid,
+                             const rohc_cid_t last_cid)
+{
+	if(first_cid > last_cid || last_cid > comp->medium.max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid CID range [%u, %u] for MAX_CID %u", first_cid,
+		             last_cid, comp->medium.max_cid);
+		goto error;
+	}
+	if(comp->num_contexts_used > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "CID range cannot be changed once contexts exist");
+		goto error;
+	}
+
+	comp->first_cid = first_cid;
+	comp->last_cid = last_cid;
+	c_chain_free_contexts(comp);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "compressor restricted to CIDs [%u, %u]", first_cid, last_cid);
+
 	return true;
 
 error:
@@ -3971,15 +5546,18 @@ void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_debug(context, "CR: context CID %u is considered as "
 				                "established", context->cid);
-				hashtable_cr_add(&context->compressor->contexts_cr,
-				                 &context->fingerprint, context);
+				if(!hashtable_add(&context->compressor->contexts_cr, context->cid))
+				{
+					rohc_comp_warn(context, "CR: failed to record context CID %u "
+					               "as base context: no memory available",
+					               context->cid);
+				}
 			}
 			else
 			{
 				rohc_comp_debug(context, "CR: context CID %u is not considered as "
 				                "established", context->cid);
-				hashtable_cr_del(&context->compressor->contexts_cr,
-				                 &context->fingerprint);
+				hashtable_del(&context->compressor->contexts_cr, context->cid);
 			}
 		}
 	}
@@ -4020,15 +5598,18 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_debug(context, "CR: context CID %u is considered as "
 				                "established", context->cid);
-				hashtable_cr_add(&context->compressor->contexts_cr,
-				                 &context->fingerprint, context);
+				if(!hashtable_add(&context->compressor->contexts_cr, context->cid))
+				{
+					rohc_comp_warn(context, "CR: failed to record context CID %u "
+					               "as base context: no memory available",
+					               context->cid);
+				}
 			}
 			else
 			{
 				rohc_comp_debug(context, "CR: context CID %u is not considered as "
 				                "established", context->cid);
-				hashtable_cr_del(&context->compressor->contexts_cr,
-				                 &context->fingerprint);
+				hashtable_del(&context->compressor->contexts_cr, context->cid);
 			}
 		}
 	}
@@ -4201,11 +5782,11 @@ bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
  * @return              true if feedback CID was successfully parsed,
  *                      false if feedback CID is malformed
  */
-static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
-                                         const uint8_t *const feedback,
-                                         const size_t feedback_len,
-                                         rohc_cid_t *const cid,
-                                         size_t *const cid_len)
+bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
+                                  const uint8_t *const feedback,
+                                  const size_t feedback_len,
+                                  rohc_cid_t *const cid,
+                                  size_t *const cid_len)
 {
 	/* decode CID */
 	if(comp->medium.cid_type == ROHC_LARGE_CID)
@@ -60,6 +60,7 @@ extern "C"
  */
 
 struct rohc_comp;
+struct rohc_comp_shards;
 
 
 /*
@@ -212,6 +213,81 @@ typedef struct
 } __attribute__((packed)) rohc_comp_general_info_t;
 
 
+/**
+ * @brief The detailed statistics of the compressor
+ *
+ * The structure is used by the \ref rohc_comp_get_stats function to store a
+ * snapshot of the detailed statistics of the compressor. The statistics are
+ * collected only if the \ref ROHC_COMP_FEATURE_STATS feature is enabled.
+ *
+ * The latency histogram counts the time spent to compress every packet. The
+ * durations are measured in ticks of the cheapest counter available: the
+ * Time Stamp Counter on x86, the virtual counter of the generic timer on
+ * ARM64, the cycle counter of the kernel in kernel space, and nanoseconds
+ * everywhere else. See \ref rohc_stats_get_bucket_min for the range of
+ * durations counted by every bucket of the histogram.
+ *
+ * Versioning works as follow:
+ *  - The \e version_major field defines the compatibility level. If the major
+ *    number given by user does not match the one expected by the library,
+ *    an error is returned.
+ *  - The \e version_minor field defines the extension level. If the minor
+ *    number given by user does not match the one expected by the library,
+ *    only the fields supported in that minor version will be filled by
+ *    \ref rohc_comp_get_stats.
+ *
+ * Notes for developers:
+ *  - Increase the major version if a field is removed.
+ *  - Increase the major version if a field is added at the beginning or in
+ *    the middle of the structure.
+ *  - Increase the minor version if a field is added at the very end of the
+ *    structure.
+ *  - The version_major and version_minor fields must be located at the very
+ *    beginning of the structure.
+ *  - The structure must be packed.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    packets_nr, uncomp_bytes_nr, comp_bytes_nr, failures_nr,
+ *    ctxt_creations_nr, ctxt_evictions_nr, ctxt_replications_nr,
+ *    profiles_nr, pkt_types_nr, and latency_hist.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_stats
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** Unused bytes, keep the counters aligned on 64 bits */
+	uint32_t unused;
+	/** The number of packets successfully compressed */
+	uint64_t packets_nr;
+	/** The number of uncompressed bytes of the compressed packets */
+	uint64_t uncomp_bytes_nr;
+	/** The number of compressed bytes produced by the compressor */
+	uint64_t comp_bytes_nr;
+	/** The number of packets that failed to be compressed */
+	uint64_t failures_nr;
+	/** The number of contexts created */
+	uint64_t ctxt_creations_nr;
+	/** The number of contexts recycled to make room for new ones */
+	uint64_t ctxt_evictions_nr;
+	/** The number of contexts created by Context Replication (CR) */
+	uint64_t ctxt_replications_nr;
+	/** The number of packets compressed with every profile, indexed by the
+	 *  major and minor numbers of the profile ID */
+	uint64_t profiles_nr[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The number of ROHC packets of every type */
+	uint64_t pkt_types_nr[ROHC_PACKET_MAX];
+	/** The histogram of the time spent to compress packets */
+	uint64_t latency_hist[ROHC_STATS_LATENCY_BUCKETS_NR];
+} __attribute__((packed)) rohc_comp_stats_t;
+
+
 /**
  * @brief The different features of the ROHC compressor
  *
@@ -235,6 +311,16 @@ typedef enum
 	ROHC_COMP_FEATURE_DUMP_PACKETS    = (1 << 3),
 	/** Allow periodic refreshes based on inter-packet time */
 	ROHC_COMP_FEATURE_TIME_BASED_REFRESHES = (1 << 4),
+	/** Find contexts with a faster hash function than SipHash (beware: do not
+	 *  enable it if hostile traffic may flood the table of contexts) */
+	ROHC_COMP_FEATURE_FAST_CTXT_HASH = (1 << 5),
+	/** Collect the detailed statistics returned by \ref rohc_comp_get_stats
+	 *  (beware: small performance impact) */
+	ROHC_COMP_FEATURE_STATS = (1 << 6),
+	/** Remember the verdict of the RTP detection callback for every UDP flow
+	 *  (beware: the callback is then called again only if the SSRC or the RTP
+	 *  version of one RTP flow changes) */
+	ROHC_COMP_FEATURE_RTP_CLASS_CACHE = (1 << 7),
 
 } rohc_comp_features_t;
 
@@ -247,6 +333,10 @@ typedef enum
  * function returns true, the RTP profile is used to compress the packet.
  * Otherwise the UDP profile is used.
  *
+ * If the \ref ROHC_COMP_FEATURE_RTP_CLASS_CACHE feature is enabled, the
+ * function is called only for the first packet of every UDP flow, and again
+ * if the SSRC or the RTP version of one RTP flow changes.
+ *
  * The user-defined function is set by calling the function
  * \ref rohc_comp_set_rtp_detection_cb
  *
@@ -308,11 +398,28 @@ bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
                                           void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_traces_min_level(struct rohc_comp *const comp,
+                                                const rohc_trace_level_t min_level)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_compress4(struct rohc_comp *const comp,
                                          const struct rohc_buf uncomp_packet,
                                          struct rohc_buf *const rohc_packet)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_compress_burst(struct rohc_comp *const comp,
+                                       const struct rohc_buf *const uncomp_packets,
+                                       struct rohc_buf *const rohc_packets,
+                                       rohc_status_t *const statuses,
+                                       const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_zero_copy(struct rohc_comp *const comp,
+                                                  const struct rohc_buf uncomp_packet,
+                                                  struct rohc_buf *const rohc_hdr,
+                                                  struct rohc_buf *const payload)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_comp_pad(struct rohc_comp *const comp,
                                         struct rohc_buf *const rohc_packet,
                                         const size_t min_pkt_len)
@@ -355,6 +462,10 @@ bool ROHC_EXPORT rohc_comp_get_mrru(const struct rohc_comp *const comp,
                                     size_t *const mrru)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_arena(struct rohc_comp *const comp,
+                                     const size_t objs_per_slab)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_get_max_cid(const struct rohc_comp *const comp,
                                        size_t *const max_cid)
 	__attribute__((warn_unused_result));
@@ -368,6 +479,11 @@ bool ROHC_EXPORT rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
                                                 void *const rtp_private)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_rtp_heuristic(struct rohc_comp *const comp,
+                                             const uint16_t port_min,
+                                             const uint16_t port_max)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_features(struct rohc_comp *const comp,
                                         const rohc_comp_features_t features)
 	__attribute__((warn_unused_result));
@@ -376,6 +492,11 @@ bool ROHC_EXPORT rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
                                              const struct rohc_buf feedback)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_deliver_feedbacks(struct rohc_comp *const comp,
+                                             const struct rohc_buf *const feedbacks,
+                                             const size_t feedbacks_nr)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions that configure robustness to packet
@@ -423,10 +544,53 @@ bool ROHC_EXPORT rohc_comp_get_last_packet_info2(const struct rohc_comp *const c
                                                  rohc_comp_last_packet_info2_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_stats(const struct rohc_comp *const comp,
+                                     rohc_comp_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
 const char * ROHC_EXPORT rohc_comp_get_state_descr(const rohc_comp_state_t state)
 	__attribute__((warn_unused_result, const));
 
 
+/*
+ * Prototypes of public functions related to multi-core compression
+ */
+
+struct rohc_comp_shards * ROHC_EXPORT rohc_comp_shards_new(const rohc_cid_type_t cid_type,
+                                                           const rohc_cid_t max_cid,
+                                                           const size_t shards_nr,
+                                                           const size_t queue_len,
+                                                           const rohc_comp_random_cb_t rand_cb,
+                                                           void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_shards_free(struct rohc_comp_shards *const shards);
+
+struct rohc_comp * ROHC_EXPORT rohc_comp_shards_get_comp(const struct rohc_comp_shards *const shards,
+                                                         const size_t shard)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_shards_enqueue(struct rohc_comp_shards *const shards,
+                                          const struct rohc_buf uncomp_packet,
+                                          const struct rohc_buf rohc_packet,
+                                          void *const pkt_priv)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_comp_shards_run(struct rohc_comp_shards *const shards,
+                                        const size_t shard,
+                                        const size_t max_pkts_nr);
+
+bool ROHC_EXPORT rohc_comp_shards_dequeue(struct rohc_comp_shards *const shards,
+                                          struct rohc_buf *const rohc_packet,
+                                          rohc_status_t *const status,
+                                          void **const pkt_priv)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_shards_deliver_feedback(struct rohc_comp_shards *const shards,
+                                                   const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
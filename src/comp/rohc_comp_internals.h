@@ -36,6 +36,8 @@
 #include "protocols/uncomp_pkt_hdrs.h"
 #include "feedback.h"
 #include "hashtable.h"
+#include "rohc_arena.h"
+#include "rohc_stats_internal.h"
 
 #include <stdbool.h>
 
@@ -82,6 +84,7 @@
 		if(((context)->compressor->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0) { \
 			rohc_dump_buf((context)->compressor->trace_callback, \
 			              (context)->compressor->trace_callback_priv, \
+			              (context)->compressor->trace_min_level, \
 			              ROHC_TRACE_COMP, ROHC_TRACE_DEBUG, \
 			              descr, buf, buf_len); \
 		} \
@@ -96,11 +99,120 @@
 struct rohc_comp_ctxt;
 
 
+/** The number of entries of the cache of recently found contexts */
+#define ROHC_COMP_FLOW_CACHE_SIZE  128U
+
+/** The number of entries in one set of the RTP classification cache */
+#define ROHC_COMP_RTP_CLASS_WAYS_NR  4U
+
+/** The number of packets in sequence that the built-in heuristic requires
+ *  before it classifies one UDP flow as RTP (MIN_SEQUENTIAL in RFC 3550) */
+#define ROHC_COMP_RTP_CLASS_MIN_SEQUENTIAL  2U
+
+/** The largest SN jump that the built-in heuristic accepts between two
+ *  packets in sequence */
+#define ROHC_COMP_RTP_CLASS_MAX_DROPOUT  100U
+
+
 /*
  * Definitions of ROHC compression structures
  */
 
 
+/**
+ * @brief The key of one UDP flow in the RTP classification cache
+ *
+ * The RTP detection callback only sees the innermost IP header, the UDP
+ * header and the UDP payload, so the innermost IP addresses and the UDP ports
+ * are enough to identify the flow.
+ */
+struct rohc_comp_rtp_class_key
+{
+	struct ipv6_addr saddr;  /**< The innermost source address */
+	struct ipv6_addr daddr;  /**< The innermost destination address */
+	uint16_t src_port;       /**< The UDP source port */
+	uint16_t dst_port;       /**< The UDP destination port */
+	uint8_t ip_version;      /**< The innermost IP version, 0 if entry is unused */
+} __attribute__((packed));
+
+
+/**
+ * @brief The feedback items kept for one context while one batch of feedback
+ *        is delivered
+ *
+ * Only the newest ACK and the strongest NACK of the context are kept, they
+ * point to the feedback data given by the application.
+ */
+struct rohc_comp_feedback_batch
+{
+	/** The next context with feedback items in the batch, NULL if last */
+	struct rohc_comp_ctxt *next;
+	/** The newest ACK (data after the feedback header), NULL if none */
+	const uint8_t *ack;
+	/** The length of the newest ACK */
+	size_t ack_len;
+	/** The position of the newest ACK in the batch */
+	size_t ack_pos;
+	/** The strongest NACK (data after the feedback header), NULL if none */
+	const uint8_t *nack;
+	/** The length of the strongest NACK */
+	size_t nack_len;
+	/** The position of the strongest NACK in the batch */
+	size_t nack_pos;
+	/** The type of the strongest NACK: NACK or STATIC-NACK */
+	enum rohc_feedback_ack_type nack_type;
+	/** Whether the context is in the list of contexts of the batch */
+	bool is_pending;
+};
+
+
+/**
+ * @brief The RTP classification of one UDP flow
+ */
+struct rohc_comp_rtp_class
+{
+	/** The UDP flow */
+	struct rohc_comp_rtp_class_key key;
+	/** Whether the UDP flow transports RTP or not */
+	bool is_rtp;
+	/** The number of packets in sequence (built-in heuristic only) */
+	uint8_t seq_nr;
+	/** The RTP version of the last packet */
+	uint8_t rtp_version;
+	/** The RTP SN of the last packet */
+	uint16_t rtp_sn;
+	/** The RTP SSRC of the last packet */
+	uint32_t rtp_ssrc;
+	/** The last time the entry was used (in number of packets) */
+	uint64_t last_used;
+};
+
+
+/**
+ * @brief The detailed statistics of the ROHC compressor
+ *
+ * The fields are the counters of \ref rohc_comp_stats_t in the same order.
+ * All of them shall be 64-bit counters so that the statistics may be copied
+ * as an array of counters.
+ */
+struct rohc_comp_stats
+{
+	uint64_t packets_nr;           /**< The number of compressed packets */
+	uint64_t uncomp_bytes_nr;      /**< The number of uncompressed bytes */
+	uint64_t comp_bytes_nr;        /**< The number of compressed bytes */
+	uint64_t failures_nr;          /**< The number of compression failures */
+	uint64_t ctxt_creations_nr;    /**< The number of created contexts */
+	uint64_t ctxt_evictions_nr;    /**< The number of recycled contexts */
+	uint64_t ctxt_replications_nr; /**< The number of replicated contexts */
+	/** The number of packets per profile */
+	uint64_t profiles_nr[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The number of packets per packet type */
+	uint64_t pkt_types_nr[ROHC_PACKET_MAX];
+	/** The histogram of compression durations */
+	uint64_t latency_hist[ROHC_STATS_LATENCY_BUCKETS_NR];
+};
+
+
 /**
  * @brief The ROHC compressor
  */
@@ -116,9 +228,27 @@ struct rohc_comp
 	struct rohc_comp_ctxt *contexts;
 	/** The number of compression contexts in use in the array */
 	uint16_t num_contexts_used;
+	/** The first CID the compressor may use */
+	rohc_cid_t first_cid;
+	/** The last CID the compressor may use */
+	rohc_cid_t last_cid;
+	/** The list of unused contexts, linked through their \e lru_next field */
+	struct rohc_comp_ctxt *ctxts_free;
+	/** The least recently used context (head of the LRU list) */
+	struct rohc_comp_ctxt *ctxts_lru_first;
+	/** The most recently used context (tail of the LRU list) */
+	struct rohc_comp_ctxt *ctxts_lru_last;
+	/** The contexts in use, found by their fingerprint */
 	struct hashtable contexts_by_fingerprint;
+	/** The direct-mapped cache of the contexts recently found through their
+	 *  fingerprint, indexed by a cheap hash of the innermost 5-tuple */
+	struct rohc_comp_ctxt *flow_cache[ROHC_COMP_FLOW_CACHE_SIZE];
+	/** The contexts established enough to be base contexts for Context
+	 *  Replication, found by their base fingerprint */
 	struct hashtable contexts_cr;
 	struct rohc_comp_ctxt *uncompressed_ctxt;
+	/** The slab allocator for the profile-specific parts of the contexts */
+	struct rohc_arena arena;
 
 	/** Which profiles are enabled and with one are not? */
 	bool enabled_profiles[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
@@ -143,16 +273,30 @@ struct rohc_comp
 	rohc_rtp_detection_callback_t rtp_callback;
 	/** Pointer to an external memory area provided/used by the callback user */
 	void *rtp_private;
+	/** The lowest UDP port of the built-in RTP heuristic */
+	uint16_t rtp_heuristic_port_min;
+	/** The highest UDP port of the built-in RTP heuristic, 0 if disabled */
+	uint16_t rtp_heuristic_port_max;
+	/** The RTP classifications of UDP flows, grouped in sets of
+	 *  \ref ROHC_COMP_RTP_CLASS_WAYS_NR entries */
+	struct rohc_comp_rtp_class *rtp_classes;
+	/** The number of sets of RTP classifications (power of 2) */
+	size_t rtp_class_sets_nr;
 
 
 	/* some statistics about the compression process: */
 
 	/** The number of sent packets */
-	int num_packets;
+	uint64_t num_packets;
 	/** The size of all the received uncompressed IP packets */
-	int total_uncompressed_size;
+	uint64_t total_uncompressed_size;
 	/** The size of all the sent compressed ROHC packets */
-	int total_compressed_size;
+	uint64_t total_compressed_size;
+
+	/** The sequence counter that protects the detailed statistics */
+	uint32_t detailed_stats_seq;
+	/** The detailed statistics, collected if ROHC_COMP_FEATURE_STATS is set */
+	struct rohc_comp_stats detailed_stats;
 
 	/** The last context used by the compressor */
 	struct rohc_comp_ctxt *last_context;
@@ -192,6 +336,8 @@ struct rohc_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimal level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 };
 
 
@@ -277,18 +423,21 @@ struct rohc_comp_profile
  */
 struct rohc_comp_ctxt
 {
-	struct rohc_comp_ctxt *prev;
-	struct rohc_comp_ctxt *next;
-	struct rohc_comp_ctxt *prev_cr;
-	struct rohc_comp_ctxt *next_cr;
-
 	/** The fingerprint of the context */
 	struct rohc_fingerprint fingerprint;
+	/** The compact key of the fingerprint, to find the context */
+	struct rohc_fingerprint_key fingerprint_key;
 
 	/** Whether the context is in use or not */
 	int used;
-	/** The time when the context was last used (in seconds) */
-	uint64_t latest_used;
+	/** The time when the context was last used */
+	struct rohc_ts latest_used;
+
+	/** The previous context in the LRU list (NULL if least recently used) */
+	struct rohc_comp_ctxt *lru_prev;
+	/** The next context in the LRU list (NULL if most recently used) or
+	 *  the next context in the list of unused contexts */
+	struct rohc_comp_ctxt *lru_next;
 
 	/** The context unique ID (CID) */
 	rohc_cid_t cid;
@@ -344,13 +493,13 @@ struct rohc_comp_ctxt
 	struct rohc_ts go_back_ir_time;
 
 	/** The cumulated size of the uncompressed packets */
-	int total_uncompressed_size;
+	uint64_t total_uncompressed_size;
 	/** The cumulated size of the compressed packets */
-	int total_compressed_size;
+	uint64_t total_compressed_size;
 	/** The cumulated size of the uncompressed headers */
-	int header_uncompressed_size;
+	uint64_t header_uncompressed_size;
 	/** The cumulated size of the compressed headers */
-	int header_compressed_size;
+	uint64_t header_compressed_size;
 
 	/** The total size of the last uncompressed packet */
 	int total_last_uncompressed_size;
@@ -363,6 +512,9 @@ struct rohc_comp_ctxt
 
 	/** The number of sent packets */
 	int num_sent_packets;
+
+	/** The feedback items kept for the context during one batch of feedback */
+	struct rohc_comp_feedback_batch feedback_batch;
 };
 
 
@@ -377,6 +529,18 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+bool rohc_comp_set_cid_range(struct rohc_comp *const comp,
+                             const rohc_cid_t first_cid,
+                             const rohc_cid_t last_cid)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
+                                  const uint8_t *const feedback,
+                                  const size_t feedback_len,
+                                  rohc_cid_t *const cid,
+                                  size_t *const cid_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+
 bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
                                    const uint8_t *const packet,
                                    const size_t packet_len,
@@ -49,21 +49,31 @@
 #include "config.h"
 
 
+/** The maximal number of W-LSB objects in the W-LSB store of one RFC3095
+ *  context (see \ref rohc_comp_rfc3095_get_wlsb_fields for their order) */
+#define RFC3095_WLSB_FIELDS_MAX  (2U + ROHC_MAX_IP_HDRS)
+
 
 /*
  * Prototypes of main private functions
  */
 
-static bool ip_header_info_new(struct ip_header_info *const header_info,
+static void ip_header_info_new(struct ip_header_info *const header_info,
                                const struct rohc_pkt_ip_hdr *const ip,
                                const size_t oa_repetitions_nr,
                                const int profile_id,
                                rohc_trace_callback2_t trace_cb,
-                               void *const trace_cb_priv)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+                               void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_min_level)
+	__attribute__((nonnull(1, 2)));
 static void ip_header_info_free(struct ip_header_info *const header_info)
 	__attribute__((nonnull(1)));
 
+static size_t rohc_comp_rfc3095_get_wlsb_fields(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt,
+                                                struct c_wlsb *fields[RFC3095_WLSB_FIELDS_MAX],
+                                                size_t *const shared_fields_nr)
+	__attribute__((nonnull(1, 2, 3)));
+
 static void c_init_tmp_variables(struct rfc3095_tmp_state *const tmp_vars)
 	__attribute__((nonnull(1)));
 
@@ -418,23 +428,25 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 /**
  * @brief Initialize the IP header info stored in the context
  *
+ * The W-LSB window for the IP-ID of an IPv4 header is created afterwards with
+ * the W-LSB store of the context.
+ *
  * @param header_info        The IP header info to initialize
  * @param ip                 The IP header
  * @param oa_repetitions_nr  The number of repetitions for Optimistic Approach
  * @param profile_id         The ID of the associated compression profile
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
- * @return                   true if successful, false otherwise
+ * @param trace_min_level    The minimal level of the traces to emit
  */
-static bool ip_header_info_new(struct ip_header_info *const header_info,
+static void ip_header_info_new(struct ip_header_info *const header_info,
                                const struct rohc_pkt_ip_hdr *const ip,
                                const size_t oa_repetitions_nr,
                                const int profile_id,
                                rohc_trace_callback2_t trace_cb,
-                               void *const trace_cb_priv)
+                               void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_min_level)
 {
-	bool is_ok;
-
 	/* store the IP version in the header info */
 	header_info->version = ip->version;
 	header_info->static_chain_end = false;
@@ -447,16 +459,6 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 	{
 		memcpy(&header_info->info.v4.old_ip, ip->ipv4, sizeof(struct ipv4_hdr));
 
-		/* init the parameters to encode the IP-ID with W-LSB encoding */
-		is_ok = wlsb_new(&header_info->info.v4.ip_id_window, oa_repetitions_nr);
-		if(!is_ok)
-		{
-			__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_ERROR,
-			             ROHC_TRACE_COMP, profile_id,
-			             "no memory to allocate W-LSB encoding for IP-ID");
-			goto error;
-		}
-
 		/* init the thresholds the counters must reach before launching
 		 * an action */
 		header_info->tos_count = 0;
@@ -472,29 +474,23 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 
 		/* init the compression context for IPv6 extension header list */
 		rohc_comp_list_ipv6_new(&header_info->info.v6.ext_comp, oa_repetitions_nr,
-		                        profile_id, trace_cb, trace_cb_priv);
+		                        profile_id, trace_cb, trace_cb_priv,
+		                        trace_min_level);
 	}
-
-	return true;
-
-error:
-	return false;
 }
 
 
 /**
  * @brief Reset the given IP header info
  *
+ * The W-LSB window for the IP-ID of an IPv4 header is destroyed with the
+ * W-LSB store of the context.
+ *
  * @param header_info  The IP header info to reset
  */
 static void ip_header_info_free(struct ip_header_info *const header_info)
 {
-	if(header_info->version == IPV4)
-	{
-		/* IPv4: destroy the W-LSB context for the IP-ID offset */
-		wlsb_free(&header_info->info.v4.ip_id_window);
-	}
-	else
+	if(header_info->version == IPV6)
 	{
 		/* IPv6: destroy the list of IPv6 extension headers */
 		rohc_comp_list_ipv6_free(&header_info->info.v6.ext_comp);
@@ -502,6 +498,50 @@ static void ip_header_info_free(struct ip_header_info *const header_info)
 }
 
 
+/**
+ * @brief Get the W-LSB objects of the W-LSB store of one RFC3095 context
+ *
+ * The W-LSB objects that are updated with every packet come first, so that
+ * they share the SN ring of the W-LSB store: SN, then the IP-ID of every
+ * IPv4 header. The W-LSB object for the non-acknowledged MSN is not updated
+ * with every packet, so it follows with its own SN column.
+ *
+ * @param rfc3095_ctxt           The generic part of the compression context
+ * @param[out] fields            The W-LSB objects of the context
+ * @param[out] shared_fields_nr  The number of W-LSB objects that share the
+ *                               SN ring
+ * @return                       The number of W-LSB objects of the context
+ */
+static size_t rohc_comp_rfc3095_get_wlsb_fields(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt,
+                                                struct c_wlsb *fields[RFC3095_WLSB_FIELDS_MAX],
+                                                size_t *const shared_fields_nr)
+{
+	size_t fields_nr = 0;
+	size_t ip_hdr_pos;
+
+	/* W-LSB objects updated with every packet */
+	fields[fields_nr] = &rfc3095_ctxt->sn_window;
+	fields_nr++;
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		struct ip_header_info *const ip_ctxt = &(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
+
+		if(ip_ctxt->version == IPV4)
+		{
+			fields[fields_nr] = &ip_ctxt->info.v4.ip_id_window;
+			fields_nr++;
+		}
+	}
+	*shared_fields_nr = fields_nr;
+
+	/* W-LSB object not updated with every packet */
+	fields[fields_nr] = &rfc3095_ctxt->msn_non_acked;
+	fields_nr++;
+
+	return fields_nr;
+}
+
+
 /**
  * @brief Initialize all temporary variables stored in the context.
  *
@@ -586,7 +626,11 @@ static void c_init_tmp_variables(struct rfc3095_tmp_state *const tmp_vars)
 bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
+	struct rohc_arena *const arena = &context->compressor->arena;
+	struct c_wlsb *wlsb_fields[RFC3095_WLSB_FIELDS_MAX];
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
+	size_t wlsb_shared_fields_nr;
+	size_t wlsb_fields_nr;
 	size_t ip_hdr_pos;
 	bool is_ok;
 
@@ -595,7 +639,7 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "new generic context required for a new stream");
 
 	/* allocate memory for the generic part of the context */
-	rfc3095_ctxt = calloc(1, sizeof(struct rohc_comp_rfc3095_ctxt));
+	rfc3095_ctxt = rohc_arena_calloc(arena, sizeof(struct rohc_comp_rfc3095_ctxt));
 	if(rfc3095_ctxt == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -604,22 +648,6 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	}
 	context->specific = rfc3095_ctxt;
 
-	/* init the parameters to encode the SN with W-LSB encoding */
-	is_ok = wlsb_new(&rfc3095_ctxt->sn_window, context->compressor->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "no memory to allocate W-LSB encoding for SN");
-		goto free_generic_context;
-	}
-	is_ok = wlsb_new(&rfc3095_ctxt->msn_non_acked, context->compressor->oa_repetitions_nr);
-	if(!is_ok)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "no memory to allocate W-LSB encoding for non-acknowledged MSN");
-		goto free_sn_window;
-	}
-
 	/* init the info related to the IP headers */
 	for(ip_hdr_pos = 0; ip_hdr_pos < uncomp_pkt_hdrs->ip_hdrs_nr; ip_hdr_pos++)
 	{
@@ -629,17 +657,28 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 
 		rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "init context for IP header #%zu", ip_hdr_pos + 1);
-		if(!ip_header_info_new(ip_ctxt, pkt_ip_hdr,
-		                       context->compressor->oa_repetitions_nr,
-		                       context->profile->id,
-		                       context->compressor->trace_callback,
-		                       context->compressor->trace_callback_priv))
-		{
-			goto free_header_info;
-		}
+		ip_header_info_new(ip_ctxt, pkt_ip_hdr,
+		                   context->compressor->oa_repetitions_nr,
+		                   context->profile->id,
+		                   context->compressor->trace_callback,
+		                   context->compressor->trace_callback_priv,
+		                   context->compressor->trace_min_level);
 	}
 	rfc3095_ctxt->ip_hdr_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
+	/* windows of the W-LSB objects for SN, IP-IDs and non-acknowledged MSN */
+	wlsb_fields_nr = rohc_comp_rfc3095_get_wlsb_fields(rfc3095_ctxt, wlsb_fields,
+	                                                   &wlsb_shared_fields_nr);
+	is_ok = wlsb_store_new(&rfc3095_ctxt->wlsb_store, wlsb_fields, wlsb_fields_nr,
+	                       wlsb_shared_fields_nr,
+	                       context->compressor->oa_repetitions_nr, arena);
+	if(!is_ok)
+	{
+		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		           "no memory to allocate W-LSB encoding for SN, IP-ID and MSN");
+		goto free_header_info;
+	}
+
 	/* RFC 3843, §3.1 Static Chain Termination:
 	 *   [...] the static chain is terminated if the "Next Header / Protocol"
 	 *   field of a static IP header part indicates anything but IP (IPinIP or
@@ -677,18 +716,9 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 free_header_info:
 	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
 	{
-		struct ip_header_info *const ip_ctxt = &(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
-
-		if(ip_ctxt->version == IPV4 || ip_ctxt->version == IPV6)
-		{
-			ip_header_info_free(ip_ctxt);
-		}
+		ip_header_info_free(&rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
 	}
-	wlsb_free(&rfc3095_ctxt->msn_non_acked);
-free_sn_window:
-	wlsb_free(&rfc3095_ctxt->sn_window);
-free_generic_context:
-	free(rfc3095_ctxt);
+	rohc_arena_free(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -712,11 +742,10 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	{
 		ip_header_info_free(&rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
 	}
-	wlsb_free(&rfc3095_ctxt->msn_non_acked);
-	wlsb_free(&rfc3095_ctxt->sn_window);
+	wlsb_store_free(&rfc3095_ctxt->wlsb_store);
 
-	zfree(rfc3095_ctxt->specific);
-	free(rfc3095_ctxt);
+	rohc_arena_free(rfc3095_ctxt->specific);
+	rohc_arena_free(rfc3095_ctxt);
 }
 
 
@@ -751,18 +780,11 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
                              rohc_packet_t *const packet_type)
 {
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	struct rfc3095_tmp_state *changes;
+	struct rfc3095_tmp_state *const changes = &rfc3095_ctxt->tmp;
 	int size;
 
 	*packet_type = ROHC_PACKET_UNKNOWN;
 
-	changes = malloc(sizeof(struct rfc3095_tmp_state));
-	if(changes == NULL)
-	{
-		rohc_comp_warn(context, "failed to allocate memory for temporary state");
-		goto error;
-	}
-
 	/* detect changes between new uncompressed packet and context */
 	rohc_comp_rfc3095_detect_changes(context, uncomp_pkt_hdrs, changes);
 
@@ -924,19 +946,15 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 	                   rohc_pkt, rohc_pkt_max_len, *packet_type);
 	if(size < 0)
 	{
-		goto free_tmp_state;
+		goto error;
 	}
 
 	/* update the context with the new headers */
 	update_context(context, uncomp_pkt_hdrs, changes, *packet_type);
 
-	free(changes);
-
 	/* return the length of the ROHC packet */
 	return size;
 
-free_tmp_state:
-	free(changes);
 error:
 	return -1;
 }
@@ -1168,8 +1186,24 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	size_t ip_hdr_pos;
 
-	/* always ack MSN to detect cases for improved ACK(O) transitions */
-	if(!sn_not_valid)
+	/* always ack MSN to detect cases for improved ACK(O) transitions ; RFC 3095,
+	 * §4.5.2: ack SN and IP-ID W-LSB values only in R-mode since U/O-mode uses
+	 * a sliding window with a limited maximum width */
+	if(!sn_not_valid && context->mode == ROHC_R_MODE)
+	{
+		struct c_wlsb *wlsb_fields[RFC3095_WLSB_FIELDS_MAX];
+		size_t wlsb_shared_fields_nr;
+		size_t acked_nr;
+
+		/* ack SN, the IP-ID of every IPv4 header and MSN at once */
+		rohc_comp_rfc3095_get_wlsb_fields(rfc3095_ctxt, wlsb_fields,
+		                                  &wlsb_shared_fields_nr);
+		acked_nr = wlsb_store_ack(&rfc3095_ctxt->wlsb_store, wlsb_fields,
+		                          sn_bits, sn_bits_nr);
+		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
+		                "from the SN, IP-ID and MSN W-LSB objects", acked_nr);
+	}
+	else if(!sn_not_valid)
 	{
 		const size_t acked_nr =
 			wlsb_ack(&rfc3095_ctxt->msn_non_acked, sn_bits, sn_bits_nr);
@@ -1258,32 +1292,6 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 		 * field and whether it is one IR packet ; if yes, transit upward */
 		rohc_comp_debug(context, "ACK(R) received, but not fully supported, so "
 		                "do not transit to SO state more quickly");
-
-		/* RFC 3095, §4.5.2: ack W-LSB values only in R-mode since U/O-mode uses
-		 * a sliding window with a limited maximum width */
-		/* acknowledge IP-ID and SN only if SN is considered as valid */
-		if(!sn_not_valid)
-		{
-			size_t acked_nr;
-
-			/* ack IP-ID only if IPv4 */
-			for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
-			{
-				struct ip_header_info *const ip_ctxt = &(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
-
-				if(ip_ctxt->version == IPV4)
-				{
-					acked_nr = wlsb_ack(&ip_ctxt->info.v4.ip_id_window, sn_bits, sn_bits_nr);
-					rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu "
-					                "values from IP-ID W-LSB for IP header #%zu",
-					                acked_nr, ip_hdr_pos + 1);
-				}
-			}
-			/* always ack SN */
-			acked_nr = wlsb_ack(&rfc3095_ctxt->sn_window, sn_bits, sn_bits_nr);
-			rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-			                "from SN W-LSB", acked_nr);
-		}
 	}
 
 	/* RFC 3095, §5.8.2.1:
@@ -1361,57 +1369,52 @@ static void rohc_comp_rfc3095_detect_changes(const struct rohc_comp_ctxt *const
 	rohc_comp_debug(context, "new SN = %u / 0x%x", changes->new_sn, changes->new_sn);
 	if(context->profile->id == ROHC_PROFILE_RTP)
 	{
+		/* shift parameter p depends on k for RTP SN */
+		struct c_wlsb_range sn_range;
+
+		wlsb_get_range_16bits(&rfc3095_ctxt->sn_window, changes->new_sn, &sn_range);
 		changes->sn_4bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           4, rohc_interval_compute_p_rtp_sn(4));
+			wlsb_range_is_kp_possible(&sn_range, 4, rohc_interval_compute_p_rtp_sn(4));
 		changes->sn_7bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           7, rohc_interval_compute_p_rtp_sn(7));
+			wlsb_range_is_kp_possible(&sn_range, 7, rohc_interval_compute_p_rtp_sn(7));
 		changes->sn_12bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           12, rohc_interval_compute_p_rtp_sn(12));
+			wlsb_range_is_kp_possible(&sn_range, 12, rohc_interval_compute_p_rtp_sn(12));
 
 		changes->sn_6bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           6, rohc_interval_compute_p_rtp_sn(6));
+			wlsb_range_is_kp_possible(&sn_range, 6, rohc_interval_compute_p_rtp_sn(6));
 		changes->sn_9bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           9, rohc_interval_compute_p_rtp_sn(9));
+			wlsb_range_is_kp_possible(&sn_range, 9, rohc_interval_compute_p_rtp_sn(9));
 		changes->sn_14bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           14, rohc_interval_compute_p_rtp_sn(14));
+			wlsb_range_is_kp_possible(&sn_range, 14, rohc_interval_compute_p_rtp_sn(14));
 	}
 	else if(context->profile->id == ROHC_PROFILE_ESP)
 	{
+		/* shift parameter p depends on k for ESP SN */
+		struct c_wlsb_range sn_range;
+
 		changes->sn_4bits_possible =
 			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
 			                           4, rohc_interval_compute_p_esp_sn(4));
 
+		wlsb_get_range_32bits(&rfc3095_ctxt->sn_window, changes->new_sn, &sn_range);
 		changes->sn_5bits_possible =
-			wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           5, rohc_interval_compute_p_esp_sn(5));
+			wlsb_range_is_kp_possible(&sn_range, 5, rohc_interval_compute_p_esp_sn(5));
 		changes->sn_8bits_possible =
-			wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           8, rohc_interval_compute_p_esp_sn(8));
+			wlsb_range_is_kp_possible(&sn_range, 8, rohc_interval_compute_p_esp_sn(8));
 		changes->sn_13bits_possible =
-			wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           13, rohc_interval_compute_p_esp_sn(13));
+			wlsb_range_is_kp_possible(&sn_range, 13, rohc_interval_compute_p_esp_sn(13));
 	}
 	else
 	{
-		changes->sn_4bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           4, ROHC_LSB_SHIFT_SN);
+		struct c_wlsb_range sn_range;
+		size_t sn_min_k;
 
-		changes->sn_5bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           5, ROHC_LSB_SHIFT_SN);
-		changes->sn_8bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           8, ROHC_LSB_SHIFT_SN);
-		changes->sn_13bits_possible =
-			wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, changes->new_sn,
-			                           13, ROHC_LSB_SHIFT_SN);
+		wlsb_get_range_16bits(&rfc3095_ctxt->sn_window, changes->new_sn, &sn_range);
+		sn_min_k = wlsb_range_get_min_k(&sn_range, ROHC_LSB_SHIFT_SN);
+		changes->sn_4bits_possible = !!(sn_min_k <= 4);
+		changes->sn_5bits_possible = !!(sn_min_k <= 5);
+		changes->sn_8bits_possible = !!(sn_min_k <= 8);
+		changes->sn_13bits_possible = !!(sn_min_k <= 13);
 	}
 	if(changes->sn_4bits_possible)
 	{
@@ -1513,31 +1516,19 @@ static void rohc_comp_rfc3095_detect_changes(const struct rohc_comp_ctxt *const
 			}
 			else
 			{
+				struct c_wlsb_range ip_id_range;
+				size_t ip_id_min_k;
+
 				/* send only required bits in FO or SO states */
-				ip_hdr_changes->ip_id_changed =
-					!wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                            ip_hdr_changes->ip_id_delta,
-					                            0, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_3bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           3, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_5bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           5, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_6bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           6, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_8bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           8, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_11bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           11, ROHC_LSB_SHIFT_IP_ID);
+				wlsb_get_range_16bits(&ip_ctxt->info.v4.ip_id_window,
+				                      ip_hdr_changes->ip_id_delta, &ip_id_range);
+				ip_id_min_k = wlsb_range_get_min_k(&ip_id_range, ROHC_LSB_SHIFT_IP_ID);
+				ip_hdr_changes->ip_id_changed = !!(ip_id_min_k > 0);
+				ip_hdr_changes->ip_id_3bits_possible = !!(ip_id_min_k <= 3);
+				ip_hdr_changes->ip_id_5bits_possible = !!(ip_id_min_k <= 5);
+				ip_hdr_changes->ip_id_6bits_possible = !!(ip_id_min_k <= 6);
+				ip_hdr_changes->ip_id_8bits_possible = !!(ip_id_min_k <= 8);
+				ip_hdr_changes->ip_id_11bits_possible = !!(ip_id_min_k <= 11);
 			}
 			rohc_comp_debug(context, "  %s bits are required to encode new IP-ID delta",
 			                ip_hdr_changes->ip_id_changed ? "some" : "no");
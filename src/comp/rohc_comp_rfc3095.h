@@ -299,6 +299,9 @@ struct rohc_comp_rfc3095_ctxt
 	/** The W-LSB for non-acknowledged MSN */
 	struct c_wlsb msn_non_acked;
 
+	/** The W-LSB store for the windows of SN, IP-IDs and non-acknowledged MSN */
+	struct c_wlsb_store wlsb_store;
+
 	/** The number of IP headers */
 	size_t ip_hdr_nr;
 	/** Information about the IP headers */
@@ -313,6 +316,10 @@ struct rohc_comp_rfc3095_ctxt
 	/** The cache for the CRC-7 value on CRC-STATIC fields */
 	uint8_t crc_static_7_cached;
 
+	/** The temporary state used while encoding one packet, kept in the context
+	 *  to avoid one memory allocation per packet */
+	struct rfc3095_tmp_state tmp;
+
 	/* below are some information and handlers to manage the next header
 	 * (if any) located just after the IP headers (1 or 2 IP headers) */
 
@@ -0,0 +1,725 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_comp_shards.c
+ * @brief  Sharded ROHC compressor for multi-core systems
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The CID space of one channel is split among several compressors (the
+ * shards), so that the shards may compress packets in parallel, each one on
+ * its own thread, without any lock. Every packet is dispatched to one shard
+ * according to a hash of its flow, so all the packets of one flow are
+ * compressed by the same shard in the order they were given.
+ *
+ * The dispatcher records every packet in one slot of a reorder window, then
+ * hands the slot to the shard through a lock-free single-producer,
+ * single-consumer ring. The compressed packets are given back in the order
+ * the packets were dispatched once their shard compressed them.
+ */
+
+#include "rohc_comp.h"
+#include "rohc_comp_internals.h"
+#include "rohc_spsc_ring.h"
+#include "feedback_parse.h"
+#include "protocols/ipv4.h"
+#include "protocols/ipv6.h"
+#include "protocols/ip_numbers.h"
+
+#include <string.h>
+#include <assert.h>
+
+
+/** The maximum length of one feedback item: 2-byte header + data */
+#define ROHC_COMP_SHARDS_FEEDBACK_MAX_LEN  (2U + 255U)
+
+
+/** One packet dispatched to the shards, in the reorder window */
+struct rohc_comp_shards_slot
+{
+	/** The uncompressed packet */
+	struct rohc_buf uncomp_packet;
+	/** The compressed packet */
+	struct rohc_buf rohc_packet;
+	/** The private data given by the user with the packet */
+	void *pkt_priv;
+	/** The status of the compression of the packet */
+	rohc_status_t status;
+	/** Whether the packet was compressed by its shard or not */
+	bool is_done;
+};
+
+
+/** One feedback item waiting for its shard */
+struct rohc_comp_shards_feedback
+{
+	size_t len;                                       /**< The item length */
+	uint8_t data[ROHC_COMP_SHARDS_FEEDBACK_MAX_LEN];  /**< The item */
+};
+
+
+/** One shard: one compressor and the packets it shall compress */
+struct rohc_comp_shard
+{
+	/** The compressor of the shard */
+	struct rohc_comp *comp;
+	/** The first CID used by the compressor of the shard */
+	rohc_cid_t first_cid;
+	/** The last CID used by the compressor of the shard */
+	rohc_cid_t last_cid;
+	/** The reorder slots of the packets to compress */
+	struct rohc_spsc_ring pkts;
+	/** The feedback items to deliver, indexes in \e feedbacks */
+	struct rohc_spsc_ring feedbacks_ring;
+	/** The buffers for the feedback items */
+	struct rohc_comp_shards_feedback *feedbacks;
+	/** The number of feedback items given to the shard so far */
+	size_t feedbacks_in;
+};
+
+
+/** The sharded ROHC compressor */
+struct rohc_comp_shards
+{
+	/** The shards */
+	struct rohc_comp_shard *shards;
+	/** The number of shards */
+	size_t shards_nr;
+
+	/** The reorder window of the packets dispatched to the shards */
+	struct rohc_comp_shards_slot *slots;
+	/** The number of slots in the reorder window minus one (power of 2) */
+	size_t slots_mask;
+	/** The number of packets dispatched so far, written by the dispatcher */
+	size_t pkts_in;
+	/** The number of packets given back so far, written by the collector */
+	size_t pkts_out;
+};
+
+
+static size_t rohc_comp_shards_get_shard(const struct rohc_comp_shards *const shards,
+                                         const struct rohc_buf packet)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+
+/**
+ * @brief Create a new sharded ROHC compressor
+ *
+ * Create \e shards_nr compressors that share the CIDs [0, \e max_cid] of one
+ * single channel: every compressor uses its own range of CIDs. The
+ * compressors are created as with \ref rohc_comp_new2 and shall be
+ * configured with \ref rohc_comp_shards_get_comp before the first packet is
+ * given to \ref rohc_comp_shards_enqueue.
+ *
+ * The sharded compressor may then be used by several threads without any
+ * lock:
+ *  \li one single thread gives the packets to compress with
+ *      \ref rohc_comp_shards_enqueue,
+ *  \li one thread per shard compresses the packets of the shard with
+ *      \ref rohc_comp_shards_run,
+ *  \li one single thread gets the compressed packets back in order with
+ *      \ref rohc_comp_shards_dequeue,
+ *  \li one single thread gives the received feedback with
+ *      \ref rohc_comp_shards_deliver_feedback.
+ * The same thread may play several of these roles.
+ *
+ * ROHC segmentation is not supported: the MRRU of the compressors shall
+ * stay 0.
+ *
+ * @param cid_type   The type of Context IDs (CID) of the channel
+ * @param max_cid    The maximum value for CIDs on the channel
+ * @param shards_nr  The number of shards, in range [1, \e max_cid + 1]
+ * @param queue_len  The maximum number of packets that may be dispatched
+ *                   but not given back yet, rounded up to the next power
+ *                   of 2; also the number of feedback items that may wait
+ *                   for every shard
+ * @param rand_cb    The random callback for all the compressors
+ * @param rand_priv  Private data that will be given to the callback
+ * @return           The created sharded compressor if successful,
+ *                   NULL if creation failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_free
+ * @see rohc_comp_shards_get_comp
+ * @see rohc_comp_shards_enqueue
+ * @see rohc_comp_shards_run
+ * @see rohc_comp_shards_dequeue
+ * @see rohc_comp_shards_deliver_feedback
+ */
+struct rohc_comp_shards * rohc_comp_shards_new(const rohc_cid_type_t cid_type,
+                                               const rohc_cid_t max_cid,
+                                               const size_t shards_nr,
+                                               const size_t queue_len,
+                                               const rohc_comp_random_cb_t rand_cb,
+                                               void *const rand_priv)
+{
+	struct rohc_comp_shards *shards;
+	size_t slots_nr = 1;
+
+	if(shards_nr == 0 || shards_nr > (((size_t) max_cid) + 1))
+	{
+		goto error;
+	}
+	if(queue_len == 0 || queue_len > UINT32_MAX)
+	{
+		goto error;
+	}
+
+	shards = calloc(1, sizeof(struct rohc_comp_shards));
+	if(shards == NULL)
+	{
+		goto error;
+	}
+
+	/* the reorder window */
+	while(slots_nr < queue_len)
+	{
+		slots_nr <<= 1;
+	}
+	shards->slots = calloc(slots_nr, sizeof(struct rohc_comp_shards_slot));
+	if(shards->slots == NULL)
+	{
+		goto free_shards;
+	}
+	shards->slots_mask = slots_nr - 1;
+	shards->pkts_in = 0;
+	shards->pkts_out = 0;
+
+	/* the shards, with a part of the CID space each */
+	shards->shards = calloc(shards_nr, sizeof(struct rohc_comp_shard));
+	if(shards->shards == NULL)
+	{
+		goto free_slots;
+	}
+	for(shards->shards_nr = 0; shards->shards_nr < shards_nr; shards->shards_nr++)
+	{
+		struct rohc_comp_shard *const shard = &(shards->shards[shards->shards_nr]);
+		const size_t cids_nr = ((size_t) max_cid) + 1;
+
+		shard->first_cid = shards->shards_nr * cids_nr / shards_nr;
+		shard->last_cid = (shards->shards_nr + 1) * cids_nr / shards_nr - 1;
+
+		shard->comp = rohc_comp_new2(cid_type, max_cid, rand_cb, rand_priv);
+		if(shard->comp == NULL)
+		{
+			goto free_shard;
+		}
+		if(!rohc_comp_set_cid_range(shard->comp, shard->first_cid,
+		                            shard->last_cid))
+		{
+			goto free_comp;
+		}
+
+		/* every shard may receive all the packets of the reorder window */
+		if(!rohc_spsc_ring_new(&shard->pkts, slots_nr))
+		{
+			goto free_comp;
+		}
+		if(!rohc_spsc_ring_new(&shard->feedbacks_ring, queue_len))
+		{
+			goto free_pkts_ring;
+		}
+		shard->feedbacks =
+			calloc(rohc_spsc_ring_get_size(&shard->feedbacks_ring),
+			       sizeof(struct rohc_comp_shards_feedback));
+		if(shard->feedbacks == NULL)
+		{
+			goto free_feedbacks_ring;
+		}
+		shard->feedbacks_in = 0;
+		continue;
+
+free_feedbacks_ring:
+		rohc_spsc_ring_free(&shard->feedbacks_ring);
+free_pkts_ring:
+		rohc_spsc_ring_free(&shard->pkts);
+free_comp:
+		rohc_comp_free(shard->comp);
+free_shard:
+		rohc_comp_shards_free(shards);
+		goto error;
+	}
+
+	return shards;
+
+free_slots:
+	free(shards->slots);
+free_shards:
+	free(shards);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given sharded ROHC compressor
+ *
+ * All the compressors of the shards are destroyed. The packets that were
+ * dispatched but not given back yet are lost. No thread shall use the
+ * sharded compressor anymore.
+ *
+ * @param shards  The sharded compressor to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_new
+ */
+void rohc_comp_shards_free(struct rohc_comp_shards *const shards)
+{
+	if(shards != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < shards->shards_nr; i++)
+		{
+			struct rohc_comp_shard *const shard = &(shards->shards[i]);
+
+			free(shard->feedbacks);
+			rohc_spsc_ring_free(&shard->feedbacks_ring);
+			rohc_spsc_ring_free(&shard->pkts);
+			rohc_comp_free(shard->comp);
+		}
+		free(shards->shards);
+		free(shards->slots);
+		free(shards);
+	}
+}
+
+
+/**
+ * @brief Get the compressor of one shard
+ *
+ * The compressor of every shard shall be configured the same way, eg.
+ * profiles or RTP detection, before the first packet is given to
+ * \ref rohc_comp_shards_enqueue. Once packets were given, the compressor
+ * belongs to the thread that runs \ref rohc_comp_shards_run for the shard.
+ *
+ * @param shards  The sharded compressor
+ * @param shard   The index of the shard
+ * @return        The compressor of the shard,
+ *                NULL if the shard does not exist
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_new
+ */
+struct rohc_comp * rohc_comp_shards_get_comp(const struct rohc_comp_shards *const shards,
+                                             const size_t shard)
+{
+	if(shards == NULL || shard >= shards->shards_nr)
+	{
+		return NULL;
+	}
+	return shards->shards[shard].comp;
+}
+
+
+/**
+ * @brief Give one packet to compress to the sharded compressor
+ *
+ * The packet is dispatched to the shard in charge of its flow, it will be
+ * compressed the next time \ref rohc_comp_shards_run is called for that
+ * shard. The compressed packet is then given back by
+ * \ref rohc_comp_shards_dequeue.
+ *
+ * The memory of both packets shall not be used by the caller until the
+ * compressed packet is given back.
+ *
+ * Shall be called by one single thread.
+ *
+ * @param shards         The sharded compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param rohc_packet    The buffer for the compressed packet, it shall be
+ *                       empty
+ * @param pkt_priv       Private data given back with the compressed packet,
+ *                       may be NULL
+ * @return               true if the packet was dispatched,
+ *                       false if too many packets were not given back yet
+ *                       or if parameters are invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_run
+ * @see rohc_comp_shards_dequeue
+ */
+bool rohc_comp_shards_enqueue(struct rohc_comp_shards *const shards,
+                              const struct rohc_buf uncomp_packet,
+                              const struct rohc_buf rohc_packet,
+                              void *const pkt_priv)
+{
+	struct rohc_comp_shards_slot *slot;
+	size_t pkts_out;
+	size_t slot_idx;
+	size_t shard;
+
+	if(shards == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(uncomp_packet) ||
+	   rohc_buf_is_malformed(rohc_packet) ||
+	   !rohc_buf_is_empty(rohc_packet))
+	{
+		goto error;
+	}
+
+	/* is there one free slot in the reorder window? */
+	pkts_out = __atomic_load_n(&shards->pkts_out, __ATOMIC_ACQUIRE);
+	if((shards->pkts_in - pkts_out) > shards->slots_mask)
+	{
+		goto error;
+	}
+
+	/* record the packet in the reorder window */
+	slot_idx = shards->pkts_in & shards->slots_mask;
+	slot = &(shards->slots[slot_idx]);
+	slot->uncomp_packet = uncomp_packet;
+	slot->rohc_packet = rohc_packet;
+	slot->pkt_priv = pkt_priv;
+	slot->status = ROHC_STATUS_ERROR;
+	slot->is_done = false;
+
+	/* give the packet to the shard in charge of its flow: its ring cannot be
+	 * full since it is as large as the reorder window */
+	shard = rohc_comp_shards_get_shard(shards, uncomp_packet);
+	if(!rohc_spsc_ring_push(&shards->shards[shard].pkts, slot_idx))
+	{
+		assert(0);
+		goto error;
+	}
+	shards->pkts_in++;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress the packets dispatched to one shard
+ *
+ * The feedback items delivered to the shard are given to its compressor
+ * first, then the packets dispatched to the shard are compressed in the
+ * order they were dispatched.
+ *
+ * Shall be called by one single thread per shard.
+ *
+ * @param shards       The sharded compressor
+ * @param shard        The index of the shard
+ * @param max_pkts_nr  The maximum number of packets to compress
+ * @return             The number of packets compressed by the call, 0 if
+ *                     no packet is waiting or if parameters are invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_enqueue
+ * @see rohc_comp_shards_deliver_feedback
+ */
+size_t rohc_comp_shards_run(struct rohc_comp_shards *const shards,
+                            const size_t shard,
+                            const size_t max_pkts_nr)
+{
+	const struct rohc_ts time = { .sec = 0, .nsec = 0 };
+	struct rohc_comp_shard *cur_shard;
+	size_t pkts_nr = 0;
+	uint32_t idx;
+
+	if(shards == NULL || shard >= shards->shards_nr)
+	{
+		goto error;
+	}
+	cur_shard = &(shards->shards[shard]);
+
+	/* deliver the feedback items before compressing the next packets */
+	while(rohc_spsc_ring_peek(&cur_shard->feedbacks_ring, &idx))
+	{
+		const struct rohc_comp_shards_feedback *const feedback =
+			&(cur_shard->feedbacks[idx]);
+		const struct rohc_buf feedback_buf =
+			rohc_buf_init_full((uint8_t *) feedback->data, feedback->len, time);
+
+		if(!rohc_comp_deliver_feedback2(cur_shard->comp, feedback_buf))
+		{
+			rohc_warning(cur_shard->comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback item to shard #%zu", shard);
+		}
+		rohc_spsc_ring_pop(&cur_shard->feedbacks_ring);
+	}
+
+	/* compress the packets */
+	while(pkts_nr < max_pkts_nr &&
+	      rohc_spsc_ring_peek(&cur_shard->pkts, &idx))
+	{
+		struct rohc_comp_shards_slot *const slot = &(shards->slots[idx]);
+
+		slot->status = rohc_compress4(cur_shard->comp, slot->uncomp_packet,
+		                              &slot->rohc_packet);
+		__atomic_store_n(&slot->is_done, true, __ATOMIC_RELEASE);
+		rohc_spsc_ring_pop(&cur_shard->pkts);
+		pkts_nr++;
+	}
+
+	return pkts_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Get back the next compressed packet
+ *
+ * The packets are given back in the order they were given to
+ * \ref rohc_comp_shards_enqueue, whatever the shards that compressed them.
+ *
+ * Shall be called by one single thread.
+ *
+ * @param shards             The sharded compressor
+ * @param[out] rohc_packet   The compressed packet
+ * @param[out] status        The status of the compression, see
+ *                           \ref rohc_compress4 for possible values
+ * @param[out] pkt_priv      The private data given with the packet, may be
+ *                           NULL if not needed
+ * @return                   true if one packet is given back,
+ *                           false if the next packet is not compressed yet
+ *                           or if parameters are invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_enqueue
+ */
+bool rohc_comp_shards_dequeue(struct rohc_comp_shards *const shards,
+                              struct rohc_buf *const rohc_packet,
+                              rohc_status_t *const status,
+                              void **const pkt_priv)
+{
+	struct rohc_comp_shards_slot *slot;
+	const size_t pkts_out = (shards != NULL ? shards->pkts_out : 0);
+
+	if(shards == NULL || rohc_packet == NULL || status == NULL)
+	{
+		goto error;
+	}
+
+	/* is the oldest packet of the reorder window compressed? */
+	slot = &(shards->slots[pkts_out & shards->slots_mask]);
+	if(!__atomic_load_n(&slot->is_done, __ATOMIC_ACQUIRE))
+	{
+		goto error;
+	}
+
+	*rohc_packet = slot->rohc_packet;
+	*status = slot->status;
+	if(pkt_priv != NULL)
+	{
+		*pkt_priv = slot->pkt_priv;
+	}
+
+	/* free the slot for the dispatcher */
+	slot->is_done = false;
+	__atomic_store_n(&shards->pkts_out, pkts_out + 1, __ATOMIC_RELEASE);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver feedback received for the sharded compressor
+ *
+ * The feedback data may contain several feedback items. Every item is
+ * routed to the shard that owns the CID of the item, and given to the
+ * compressor of that shard the next time \ref rohc_comp_shards_run is
+ * called for the shard.
+ *
+ * Shall be called by one single thread.
+ *
+ * @param shards    The sharded compressor
+ * @param feedback  The feedback data
+ * @return          true if all the feedback items were routed,
+ *                  false if one item is malformed, or if its shard has too
+ *                  many feedback items waiting
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_deliver_feedback2
+ * @see rohc_comp_shards_run
+ */
+bool rohc_comp_shards_deliver_feedback(struct rohc_comp_shards *const shards,
+                                       const struct rohc_buf feedback)
+{
+	struct rohc_buf remain_data = feedback;
+	size_t nr_failures = 0;
+
+	if(shards == NULL || rohc_buf_is_malformed(remain_data))
+	{
+		goto error;
+	}
+
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		const struct rohc_comp *const comp0 = shards->shards[0].comp;
+		struct rohc_comp_shard *shard;
+		struct rohc_comp_shards_feedback *item;
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+		size_t feedback_len;
+		rohc_cid_t cid;
+		size_t cid_len;
+		size_t i;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len))
+		{
+			goto error;
+		}
+		feedback_len = feedback_hdr_len + feedback_data_len;
+		if(feedback_len > remain_data.len ||
+		   feedback_len > ROHC_COMP_SHARDS_FEEDBACK_MAX_LEN)
+		{
+			goto error;
+		}
+
+		/* find the shard that owns the CID of the feedback item */
+		if(!rohc_comp_feedback_parse_cid(comp0,
+		                                 rohc_buf_data_at(remain_data, feedback_hdr_len),
+		                                 feedback_data_len, &cid, &cid_len))
+		{
+			goto error;
+		}
+		for(i = 0; i < shards->shards_nr && cid > shards->shards[i].last_cid; i++)
+		{
+		}
+		if(i == shards->shards_nr)
+		{
+			rohc_warning(comp0, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "feedback for unknown CID %u", cid);
+			nr_failures++;
+			rohc_buf_pull(&remain_data, feedback_len);
+			continue;
+		}
+		shard = &(shards->shards[i]);
+
+		/* queue the feedback item for the shard */
+		if(rohc_spsc_ring_is_full(&shard->feedbacks_ring))
+		{
+			rohc_warning(comp0, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "too many feedback items waiting for shard #%zu, "
+			             "feedback for CID %u dropped", i, cid);
+			nr_failures++;
+			rohc_buf_pull(&remain_data, feedback_len);
+			continue;
+		}
+		item = &(shard->feedbacks[shard->feedbacks_in &
+		                          (rohc_spsc_ring_get_size(&shard->feedbacks_ring) - 1)]);
+		memcpy(item->data, rohc_buf_data(remain_data), feedback_len);
+		item->len = feedback_len;
+		if(!rohc_spsc_ring_push(&shard->feedbacks_ring, item - shard->feedbacks))
+		{
+			assert(0);
+			goto error;
+		}
+		shard->feedbacks_in++;
+
+		rohc_buf_pull(&remain_data, feedback_len);
+	}
+
+	return (nr_failures == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the shard in charge of the flow of the given packet
+ *
+ * The shard is chosen according to a hash of the addresses of the outer IP
+ * header, of the protocol it transports, and of the ports if the protocol
+ * is UDP, UDP-Lite or TCP. All the packets of one flow are thus given to
+ * the same shard. Packets that are not IP packets are given to the first
+ * shard.
+ *
+ * @param shards  The sharded compressor
+ * @param packet  The uncompressed packet
+ * @return        The index of the shard
+ */
+static size_t rohc_comp_shards_get_shard(const struct rohc_comp_shards *const shards,
+                                         const struct rohc_buf packet)
+{
+	const uint8_t *const data = rohc_buf_data(packet);
+	const uint8_t *addrs;
+	size_t addrs_len;
+	uint8_t proto;
+	size_t l4_offset;
+	bool with_ports;
+	uint32_t hash = 2166136261U; /* FNV-1a offset basis */
+	size_t i;
+
+	if(packet.len >= sizeof(struct ipv4_hdr) && (data[0] >> 4) == 4)
+	{
+		const struct ipv4_hdr *const ipv4 = (const struct ipv4_hdr *) data;
+
+		addrs = (const uint8_t *) &(ipv4->saddr);
+		addrs_len = 2 * sizeof(uint32_t);
+		proto = ipv4->protocol;
+		l4_offset = ipv4->ihl * 4U;
+		with_ports = !ipv4_is_fragment(ipv4);
+	}
+	else if(packet.len >= sizeof(struct ipv6_hdr) && (data[0] >> 4) == 6)
+	{
+		const struct ipv6_hdr *const ipv6 = (const struct ipv6_hdr *) data;
+
+		addrs = (const uint8_t *) &(ipv6->saddr);
+		addrs_len = 2 * sizeof(struct ipv6_addr);
+		proto = ipv6->nh;
+		l4_offset = sizeof(struct ipv6_hdr);
+		with_ports = true;
+	}
+	else
+	{
+		return 0;
+	}
+
+	/* hash the addresses and the protocol */
+	for(i = 0; i < addrs_len; i++)
+	{
+		hash = (hash ^ addrs[i]) * 16777619U; /* FNV-1a prime */
+	}
+	hash = (hash ^ proto) * 16777619U;
+
+	/* hash the ports of the flow if any */
+	if(with_ports &&
+	   (proto == ROHC_IPPROTO_UDP || proto == ROHC_IPPROTO_UDPLITE ||
+	    proto == ROHC_IPPROTO_TCP) &&
+	   packet.len >= (l4_offset + 4))
+	{
+		for(i = l4_offset; i < (l4_offset + 4); i++)
+		{
+			hash = (hash ^ data[i]) * 16777619U;
+		}
+	}
+
+	/* map the 32-bit hash onto the shards */
+	return (size_t) ((((uint64_t) hash) * shards->shards_nr) >> 32);
+}
@@ -74,6 +74,8 @@ struct list_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimal level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 	/** The profile ID the compression list was created for */
 	int profile_id;
 };
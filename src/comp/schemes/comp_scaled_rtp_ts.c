@@ -44,16 +44,22 @@
  * @param ts_sc              The ts_sc_comp object to create
  * @param wlsb_window_width  The width of the W-LSB sliding window to use
  *                           for TS_STRIDE (must be > 0)
+ * @param arena              The arena to allocate the W-LSB windows from
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
  *                           callback, may be NULL
+ * @param trace_min_level    The minimal level of the traces to emit
  * @return                   true if creation is successful, false otherwise
  */
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
+                 struct rohc_arena *const arena,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_min_level)
 {
+	struct c_wlsb *const wlsb_fields[2] =
+		{ &ts_sc->ts_unscaled_wlsb, &ts_sc->ts_scaled_wlsb };
 	bool is_ok;
 
 	assert(wlsb_window_width > 0);
@@ -71,29 +77,22 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 
 	ts_sc->trace_callback = trace_cb;
 	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_min_level = trace_min_level;
 
-	/* W-LSB context for TS_SCALED */
-	is_ok = wlsb_new(&ts_sc->ts_scaled_wlsb, wlsb_window_width);
+	/* W-LSB contexts for unscaled TS and TS_SCALED in one single store: the
+	 * unscaled TS is updated with every packet, TS_SCALED in SEND_SCALED
+	 * state only */
+	is_ok = wlsb_store_new(&ts_sc->wlsb_store, wlsb_fields, 2, 1,
+	                       wlsb_window_width, arena);
 	if(!is_ok)
 	{
 		rohc_error(ts_sc, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "cannot create a W-LSB window for TS_SCALED");
+		           "cannot create W-LSB windows for unscaled TS and TS_SCALED");
 		goto error;
 	}
 
-	/* W-LSB context for unscaled TS */
-	is_ok = wlsb_new(&ts_sc->ts_unscaled_wlsb, wlsb_window_width);
-	if(!is_ok)
-	{
-		rohc_error(ts_sc, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "cannot create a W-LSB window for unscaled TS");
-		goto free_ts_scaled_wlsb;
-	}
-
 	return true;
 
-free_ts_scaled_wlsb:
-	wlsb_free(&ts_sc->ts_scaled_wlsb);
 error:
 	return false;
 }
@@ -106,8 +105,7 @@ error:
  */
 void c_destroy_sc(struct ts_sc_comp *const ts_sc)
 {
-	wlsb_free(&ts_sc->ts_unscaled_wlsb);
-	wlsb_free(&ts_sc->ts_scaled_wlsb);
+	wlsb_store_free(&ts_sc->wlsb_store);
 }
 
 
@@ -379,95 +377,99 @@ void ts_detect_changes(const struct ts_sc_comp *const ts_sc,
 size_t nb_bits_unscaled(const struct c_wlsb *const ts_unscaled_wlsb,
                         const uint32_t new_ts_unscaled)
 {
+	struct c_wlsb_range ts_range;
 	size_t nr_ts_bits;
 
-	if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                              0, rohc_interval_compute_p_rtp_ts(0)))
+	/* walk the W-LSB window once, then check every candidate k */
+	wlsb_get_range_32bits(ts_unscaled_wlsb, new_ts_unscaled, &ts_range);
+
+	if(wlsb_range_is_kp_possible(&ts_range, 0,
+	                             rohc_interval_compute_p_rtp_ts(0)))
 	{
 		nr_ts_bits = 0;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   5, rohc_interval_compute_p_rtp_ts(5)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 5,
+	                                  rohc_interval_compute_p_rtp_ts(5)))
 	{
 		nr_ts_bits = 5;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   6, rohc_interval_compute_p_rtp_ts(6)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 6,
+	                                  rohc_interval_compute_p_rtp_ts(6)))
 	{
 		nr_ts_bits = 6;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   7, rohc_interval_compute_p_rtp_ts(7)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 7,
+	                                  rohc_interval_compute_p_rtp_ts(7)))
 	{
 		nr_ts_bits = 7;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   8, rohc_interval_compute_p_rtp_ts(8)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 8,
+	                                  rohc_interval_compute_p_rtp_ts(8)))
 	{
 		nr_ts_bits = 8;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   9, rohc_interval_compute_p_rtp_ts(9)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 9,
+	                                  rohc_interval_compute_p_rtp_ts(9)))
 	{
 		nr_ts_bits = 9;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   12, rohc_interval_compute_p_rtp_ts(12)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 12,
+	                                  rohc_interval_compute_p_rtp_ts(12)))
 	{
 		nr_ts_bits = 12;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   13, rohc_interval_compute_p_rtp_ts(13)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 13,
+	                                  rohc_interval_compute_p_rtp_ts(13)))
 	{
 		nr_ts_bits = 13;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   14, rohc_interval_compute_p_rtp_ts(14)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 14,
+	                                  rohc_interval_compute_p_rtp_ts(14)))
 	{
 		nr_ts_bits = 14;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   16, rohc_interval_compute_p_rtp_ts(16)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 16,
+	                                  rohc_interval_compute_p_rtp_ts(16)))
 	{
 		nr_ts_bits = 16;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   17, rohc_interval_compute_p_rtp_ts(17)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 17,
+	                                  rohc_interval_compute_p_rtp_ts(17)))
 	{
 		nr_ts_bits = 17;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   19, rohc_interval_compute_p_rtp_ts(19)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 19,
+	                                  rohc_interval_compute_p_rtp_ts(19)))
 	{
 		nr_ts_bits = 19;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   20, rohc_interval_compute_p_rtp_ts(20)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 20,
+	                                  rohc_interval_compute_p_rtp_ts(20)))
 	{
 		nr_ts_bits = 20;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   21, rohc_interval_compute_p_rtp_ts(21)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 21,
+	                                  rohc_interval_compute_p_rtp_ts(21)))
 	{
 		nr_ts_bits = 21;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   25, rohc_interval_compute_p_rtp_ts(25)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 25,
+	                                  rohc_interval_compute_p_rtp_ts(25)))
 	{
 		nr_ts_bits = 25;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   26, rohc_interval_compute_p_rtp_ts(26)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 26,
+	                                  rohc_interval_compute_p_rtp_ts(26)))
 	{
 		nr_ts_bits = 26;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   27, rohc_interval_compute_p_rtp_ts(27)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 27,
+	                                  rohc_interval_compute_p_rtp_ts(27)))
 	{
 		nr_ts_bits = 27;
 	}
-	else if(wlsb_is_kp_possible_32bits(ts_unscaled_wlsb, new_ts_unscaled,
-	                                   29, rohc_interval_compute_p_rtp_ts(29)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 29,
+	                                  rohc_interval_compute_p_rtp_ts(29)))
 	{
 		nr_ts_bits = 29;
 	}
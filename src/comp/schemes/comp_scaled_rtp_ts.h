@@ -88,6 +88,9 @@ struct ts_sc_comp
 	/** The W-LSB object used to encode the TS value */
 	struct c_wlsb ts_unscaled_wlsb;
 
+	/** The W-LSB store for the windows of the unscaled TS and TS_SCALED */
+	struct c_wlsb_store wlsb_store;
+
 	/** Whether old SN/TS values are initialized or not */
 	bool are_old_val_init;
 	/// The number of packets sent in state INIT_STRIDE
@@ -97,6 +100,8 @@ struct ts_sc_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimal level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 };
 
 
@@ -107,8 +112,10 @@ struct ts_sc_comp
 
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
+                 struct rohc_arena *const arena,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_min_level)
 	__attribute__((warn_unused_result, nonnull(1)));
 void c_destroy_sc(struct ts_sc_comp *const ts_sc)
 	__attribute__((nonnull(1)));
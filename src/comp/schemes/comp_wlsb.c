@@ -39,6 +39,19 @@
 static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 	__attribute__((warn_unused_result, const));
 
+static void wlsb_get_range(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           const uint8_t bits_nr,
+                           struct c_wlsb_range *const range)
+	__attribute__((nonnull(1, 4)));
+
+static size_t wlsb_store_get_mem_size(const struct c_wlsb_store *const store)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static void wlsb_store_bind(const struct c_wlsb_store *const store,
+                            struct c_wlsb *const fields[])
+	__attribute__((nonnull(1, 2)));
+
 
 /*
  * Public functions
@@ -50,20 +63,24 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
  *
  * @param[in,out] wlsb The W-LSB encoding object to create
  * @param window_width The number of entries in the window (power of 2)
+ * @param arena        The arena to allocate the window from, may be NULL
  * @return             true if the W-LSB encoding object was created,
  *                     false if it was not
  */
 bool wlsb_new(struct c_wlsb *const wlsb,
-              const size_t window_width)
+              const size_t window_width,
+              struct rohc_arena *const arena)
 {
 	assert(window_width > 0);
 	assert(window_width <= ROHC_WLSB_WIDTH_MAX);
 
-	wlsb->window = malloc(sizeof(struct c_window) * window_width);
-	if(wlsb->window == NULL)
+	/* one single memory block for the SN and value columns */
+	wlsb->sns = rohc_arena_malloc(arena, sizeof(uint32_t) * 2 * window_width);
+	if(wlsb->sns == NULL)
 	{
 		goto error;
 	}
+	wlsb->values = wlsb->sns + window_width;
 
 	wlsb->next = 0;
 	wlsb->count = 0;
@@ -82,24 +99,29 @@ error:
  *
  * @param[in,out] dst  The W-LSB encoding object to create
  * @param src          The W-LSB encoding object to copy
+ * @param arena        The arena to allocate the window from, may be NULL
  * @return             true if the W-LSB encoding object was created,
  *                     false if it was not
  */
 bool wlsb_copy(struct c_wlsb *const dst,
-               const struct c_wlsb *const src)
+               const struct c_wlsb *const src,
+               struct rohc_arena *const arena)
 {
-	const size_t window_mem_size = sizeof(struct c_window) * dst->window_width;
+	const size_t column_mem_size = sizeof(uint32_t) * src->window_width;
 
 	dst->next = src->next;
 	dst->count = src->count;
 	dst->window_width = src->window_width;
 
-	dst->window = malloc(window_mem_size);
-	if(dst->window == NULL)
+	/* one single memory block for the SN and value columns */
+	dst->sns = rohc_arena_malloc(arena, column_mem_size * 2);
+	if(dst->sns == NULL)
 	{
 		goto error;
 	}
-	memcpy(dst->window, src->window, window_mem_size);
+	dst->values = dst->sns + dst->window_width;
+	memcpy(dst->sns, src->sns, column_mem_size);
+	memcpy(dst->values, src->values, column_mem_size);
 
 	return true;
 
@@ -111,11 +133,123 @@ error:
 /**
  * @brief Destroy a Window-based LSB (W-LSB) encoding object
  *
+ * The W-LSB objects of one W-LSB store shall not be destroyed with this
+ * function, see \ref wlsb_store_free instead.
+ *
  * @param wlsb  The W-LSB object to destroy
  */
 void wlsb_free(struct c_wlsb *const wlsb)
 {
-	free(wlsb->window);
+	rohc_arena_free(wlsb->sns);
+}
+
+
+/**
+ * @brief Create a new multi-field W-LSB store
+ *
+ * The W-LSB objects of all the fields are created at once with one single
+ * memory allocation.
+ *
+ * @param[out] store        The W-LSB store to create
+ * @param fields            The W-LSB objects of the fields to create, the
+ *                          fields that share the SN ring first
+ * @param fields_nr         The number of fields
+ * @param shared_fields_nr  The number of fields that are updated with every
+ *                          packet, so that they may share one SN ring
+ * @param window_width      The number of entries in the windows
+ * @param arena             The arena to allocate the windows from, may be NULL
+ * @return                  true if the W-LSB store was created,
+ *                          false if it was not
+ */
+bool wlsb_store_new(struct c_wlsb_store *const store,
+                    struct c_wlsb *const fields[],
+                    const size_t fields_nr,
+                    const size_t shared_fields_nr,
+                    const size_t window_width,
+                    struct rohc_arena *const arena)
+{
+	size_t i;
+
+	assert(fields_nr > 0);
+	assert(fields_nr <= UINT8_MAX);
+	assert(shared_fields_nr > 0);
+	assert(shared_fields_nr <= fields_nr);
+	assert(window_width > 0);
+	assert(window_width <= ROHC_WLSB_WIDTH_MAX);
+
+	store->fields_nr = fields_nr;
+	store->shared_fields_nr = shared_fields_nr;
+	store->window_width = window_width;
+
+	store->mem = rohc_arena_malloc(arena, wlsb_store_get_mem_size(store));
+	if(store->mem == NULL)
+	{
+		goto error;
+	}
+
+	wlsb_store_bind(store, fields);
+	for(i = 0; i < fields_nr; i++)
+	{
+		fields[i]->next = 0;
+		fields[i]->count = 0;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Create a new multi-field W-LSB store from another
+ *
+ * The W-LSB objects of the fields shall be copied from the ones of the source
+ * store beforehand, only their windows are created by this function.
+ *
+ * @param[out] dst   The W-LSB store to create
+ * @param dst_fields The W-LSB objects of the fields, in the same order as
+ *                   for \ref wlsb_store_new
+ * @param src        The W-LSB store to copy
+ * @param arena      The arena to allocate the windows from, may be NULL
+ * @return           true if the W-LSB store was created,
+ *                   false if it was not
+ */
+bool wlsb_store_copy(struct c_wlsb_store *const dst,
+                     struct c_wlsb *const dst_fields[],
+                     const struct c_wlsb_store *const src,
+                     struct rohc_arena *const arena)
+{
+	const size_t mem_size = wlsb_store_get_mem_size(src);
+
+	dst->fields_nr = src->fields_nr;
+	dst->shared_fields_nr = src->shared_fields_nr;
+	dst->window_width = src->window_width;
+
+	dst->mem = rohc_arena_malloc(arena, mem_size);
+	if(dst->mem == NULL)
+	{
+		goto error;
+	}
+	memcpy(dst->mem, src->mem, mem_size);
+
+	wlsb_store_bind(dst, dst_fields);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy a multi-field W-LSB store and the W-LSB objects of its fields
+ *
+ * @param store  The W-LSB store to destroy
+ */
+void wlsb_store_free(struct c_wlsb_store *const store)
+{
+	rohc_arena_free(store->mem);
 }
 
 
@@ -135,16 +269,16 @@ void c_add_wlsb(struct c_wlsb *const wlsb,
 		uint8_t i;
 		for(i = 0; i < wlsb->window_width; i++)
 		{
-			wlsb->window[i].sn = sn;
-			wlsb->window[i].value = value;
-			wlsb->next = 1;
+			wlsb->sns[i] = sn;
+			wlsb->values[i] = value;
 		}
+		wlsb->next = 1 % wlsb->window_width;
 		wlsb->count = wlsb->window_width;
 	}
 	else
 	{
-		wlsb->window[wlsb->next].sn = sn;
-		wlsb->window[wlsb->next].value = value;
+		wlsb->sns[wlsb->next] = sn;
+		wlsb->values[wlsb->next] = value;
 		wlsb->next = (wlsb->next + 1) % wlsb->window_width;
 	}
 }
@@ -191,8 +325,7 @@ bool wlsb_is_kp_possible_8bits(const struct c_wlsb *const wlsb,
 		 * to recreate it thanks to ANY value in the window */
 		for(i = 0; i < wlsb->window_width; i++)
 		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint8_t v_ref = entry->value;
+			const uint8_t v_ref = wlsb->values[i];
 
 			/* compute the minimal and maximal values of the interval:
 			 *   min = v_ref - p
@@ -267,8 +400,7 @@ bool wlsb_is_kp_possible_16bits(const struct c_wlsb *const wlsb,
 		 * to recreate it thanks to ANY value in the window */
 		for(i = 0; i < wlsb->window_width; i++)
 		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint16_t v_ref = entry->value;
+			const uint16_t v_ref = wlsb->values[i];
 
 			/* compute the minimal and maximal values of the interval:
 			 *   min = v_ref - p
@@ -345,8 +477,7 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
 		 * to recreate it thanks to ANY value in the window */
 		for(i = 0; i < wlsb->window_width; i++)
 		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint32_t v_ref = entry->value;
+			const uint32_t v_ref = wlsb->values[i];
 
 			/* compute the minimal and maximal values of the interval:
 			 *   min = v_ref - p
@@ -380,6 +511,146 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
 }
 
 
+/**
+ * @brief Compute the offsets between one value and a W-LSB window
+ *
+ * The function is dedicated to 8-bit fields.
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param[out] range  The offsets between the value and the window
+ */
+void wlsb_get_range_8bits(const struct c_wlsb *const wlsb,
+                          const uint8_t value,
+                          struct c_wlsb_range *const range)
+{
+	wlsb_get_range(wlsb, value, 8, range);
+}
+
+
+/**
+ * @brief Compute the offsets between one value and a W-LSB window
+ *
+ * The function is dedicated to 16-bit fields.
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param[out] range  The offsets between the value and the window
+ */
+void wlsb_get_range_16bits(const struct c_wlsb *const wlsb,
+                           const uint16_t value,
+                           struct c_wlsb_range *const range)
+{
+	wlsb_get_range(wlsb, value, 16, range);
+}
+
+
+/**
+ * @brief Compute the offsets between one value and a W-LSB window
+ *
+ * The function is dedicated to 32-bit fields.
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param[out] range  The offsets between the value and the window
+ */
+void wlsb_get_range_32bits(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           struct c_wlsb_range *const range)
+{
+	wlsb_get_range(wlsb, value, 32, range);
+}
+
+
+/**
+ * @brief Find out whether the given number of bits is enough to encode value
+ *
+ * Same result as the wlsb_is_kp_possible_*bits() functions, but without
+ * walking the window again.
+ *
+ * The shift parameter p shall be in range [-1, 2^(N-1) - 2] for a N-bit
+ * field if k is smaller than N.
+ *
+ * @param range  The offsets between the value to encode and the window
+ * @param k      The number of bits for encoding
+ * @param p      The shift parameter p
+ * @return       true if the number of bits is enough for encoding or not
+ */
+bool wlsb_range_is_kp_possible(const struct c_wlsb_range *const range,
+                               const size_t k,
+                               const int32_t p)
+{
+	const int64_t bias = (1LL << (range->bits_nr - 1)) - 1;
+	bool enc_possible;
+
+	assert(k <= range->bits_nr);
+
+	if(k == range->bits_nr)
+	{
+		enc_possible = true;
+	}
+	/* use all bits if the window contains no value */
+	else if(range->is_empty)
+	{
+		enc_possible = false;
+	}
+	else
+	{
+		/* the value may be recreated from ANY value v_ref in the window if
+		 * the offsets value - v_ref are all in range [-p, 2^k - 1 - p] */
+		const int64_t interval_width = (1LL << k) - 1;
+
+		assert(p >= -1);
+		assert(p <= (bias - 1));
+
+		enc_possible = !!((((int64_t) range->min) - bias + p) >= 0 &&
+		                  (((int64_t) range->max) - bias + p) <= interval_width);
+	}
+
+	return enc_possible;
+}
+
+
+/**
+ * @brief Get the minimal number of bits required to encode value
+ *
+ * The shift parameter p shall be in range [-1, 2^(N-1) - 2] for a N-bit
+ * field.
+ *
+ * @param range  The offsets between the value to encode and the window
+ * @param p      The shift parameter p
+ * @return       The minimal number of bits k for which
+ *               \ref wlsb_range_is_kp_possible is true
+ */
+size_t wlsb_range_get_min_k(const struct c_wlsb_range *const range,
+                            const int32_t p)
+{
+	const int64_t bias = (1LL << (range->bits_nr - 1)) - 1;
+	int64_t max_offset;
+	size_t k;
+
+	assert(p >= -1);
+	assert(p <= (bias - 1));
+
+	/* use all bits if the window contains no value or if one value of the
+	 * window is too far ahead the value to encode */
+	if(range->is_empty || (((int64_t) range->min) - bias + p) < 0)
+	{
+		return range->bits_nr;
+	}
+
+	/* k bits are enough if the largest offset is not larger than 2^k - 1 */
+	max_offset = ((int64_t) range->max) - bias + p;
+	k = 0;
+	while(k < range->bits_nr && max_offset > ((1LL << k) - 1))
+	{
+		k++;
+	}
+
+	return k;
+}
+
+
 /**
  * @brief Acknowledge based on the Sequence Number (SN)
  *
@@ -398,8 +669,8 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 	size_t entry = wlsb->next;
 	uint32_t sn_mask;
 	bool do_remove = false;
-	uint32_t sn = wlsb->window[entry].sn;
-	uint32_t value = wlsb->window[entry].value;
+	uint32_t sn = 0;
+	uint32_t value = 0;
 	uint8_t i;
 	size_t acked_nr = 0;
 
@@ -419,16 +690,16 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
 		if(do_remove)
 		{
-			wlsb->window[entry].sn = sn;
-			wlsb->window[entry].value = value;
+			wlsb->sns[entry] = sn;
+			wlsb->values[entry] = value;
 			acked_nr++;
 		}
-		else if((wlsb->window[entry].sn & sn_mask) == sn_bits)
+		else if((wlsb->sns[entry] & sn_mask) == sn_bits)
 		{
 			/* remove all the older window entries */
 			do_remove = true;
-			sn = wlsb->window[entry].sn;
-			value = wlsb->window[entry].value;
+			sn = wlsb->sns[entry];
+			value = wlsb->values[entry];
 		}
 	}
 
@@ -436,6 +707,80 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 }
 
 
+/**
+ * @brief Acknowledge all the fields of one W-LSB store based on the SN
+ *
+ * Removes all window entries older (and including) than the one that matches
+ * the given SN bits. The fields that share the SN ring are all pruned with
+ * one single search in the SN ring.
+ *
+ * @param store       The W-LSB store
+ * @param fields      The W-LSB objects of the fields, in the same order as
+ *                    for \ref wlsb_store_new
+ * @param sn_bits     The LSB of the SN to acknowledge
+ * @param sn_bits_nr  The number of LSB of the SN to acknowledge
+ * @return            The number of acked window entries for all the fields
+ */
+size_t wlsb_store_ack(const struct c_wlsb_store *const store,
+                      struct c_wlsb *const fields[],
+                      const uint32_t sn_bits,
+                      const size_t sn_bits_nr)
+{
+	uint32_t *const sns = fields[0]->sns;
+	const uint8_t count = fields[0]->count;
+	size_t entry = fields[0]->next;
+	uint32_t sn_mask;
+	size_t acked_nr = 0;
+	size_t field;
+	uint8_t i;
+
+	if(sn_bits_nr < 32)
+	{
+		sn_mask = (1U << sn_bits_nr) - 1;
+	}
+	else
+	{
+		sn_mask = 0xffffffffUL;
+	}
+
+	/* search for the entry of the shared SN ring that matches the given SN LSB
+	 * starting from the newest one */
+	for(i = 0; i < count; i++)
+	{
+		entry = wlsb_get_next_older(entry, store->window_width - 1);
+		if((sns[entry] & sn_mask) == sn_bits)
+		{
+			break;
+		}
+	}
+
+	/* remove all the older entries of all the fields that share the SN ring */
+	if(i < count)
+	{
+		const size_t acked_entry = entry;
+
+		for(i++; i < count; i++)
+		{
+			entry = wlsb_get_next_older(entry, store->window_width - 1);
+			sns[entry] = sns[acked_entry];
+			for(field = 0; field < store->shared_fields_nr; field++)
+			{
+				fields[field]->values[entry] = fields[field]->values[acked_entry];
+			}
+			acked_nr += store->shared_fields_nr;
+		}
+	}
+
+	/* the other fields have their own SN column */
+	for(field = store->shared_fields_nr; field < store->fields_nr; field++)
+	{
+		acked_nr += wlsb_ack(fields[field], sn_bits, sn_bits_nr);
+	}
+
+	return acked_nr;
+}
+
+
 /**
  * @brief Whether the given SN is present in the given WLSB window
  *
@@ -453,11 +798,11 @@ bool wlsb_is_sn_present(struct c_wlsb *const wlsb, const uint32_t sn)
 	for(i = 0; i < wlsb->count; i++)
 	{
 		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
-		if(sn == wlsb->window[entry].sn)
+		if(sn == wlsb->sns[entry])
 		{
 			return true;
 		}
-		else if(sn > wlsb->window[entry].sn)
+		else if(sn > wlsb->sns[entry])
 		{
 			return false;
 		}
@@ -472,6 +817,102 @@ bool wlsb_is_sn_present(struct c_wlsb *const wlsb, const uint32_t sn)
  */
 
 
+/**
+ * @brief Compute the offsets between one value and a W-LSB window
+ *
+ * The offsets value - v_ref are computed modulo 2^N for a N-bit field, then
+ * stored with a bias of 2^(N-1) - 1 in order to handle the offsets in range
+ * [-2^(N-1) + 1, 2^(N-1)] as unsigned values.
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param bits_nr     The length (in bits) of the field
+ * @param[out] range  The offsets between the value and the window
+ */
+static void wlsb_get_range(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           const uint8_t bits_nr,
+                           struct c_wlsb_range *const range)
+{
+	const uint32_t mask = (bits_nr == 32 ? 0xffffffffU : ((1U << bits_nr) - 1));
+	const uint32_t bias = (1U << (bits_nr - 1)) - 1;
+	const uint32_t *const values = wlsb->values;
+	uint32_t min = mask;
+	uint32_t max = 0;
+	size_t i;
+
+	assert(bits_nr == 8 || bits_nr == 16 || bits_nr == 32);
+
+	range->bits_nr = bits_nr;
+	range->is_empty = !!(wlsb->count == 0);
+
+	/* branch-free min/max over the contiguous column of values, so that the
+	 * compiler may vectorize the loop */
+	if(!range->is_empty)
+	{
+		for(i = 0; i < wlsb->window_width; i++)
+		{
+			const uint32_t offset = (value - values[i] + bias) & mask;
+
+			min = (offset < min ? offset : min);
+			max = (offset > max ? offset : max);
+		}
+	}
+
+	range->min = min;
+	range->max = max;
+}
+
+
+/**
+ * @brief Get the size of the memory block of one W-LSB store
+ *
+ * The memory block contains the shared SN ring, one SN column for every
+ * field that does not share the SN ring, then one value column per field.
+ *
+ * @param store  The W-LSB store
+ * @return       The size (in bytes) of the memory block
+ */
+static size_t wlsb_store_get_mem_size(const struct c_wlsb_store *const store)
+{
+	const size_t own_sns_nr = store->fields_nr - store->shared_fields_nr;
+	const size_t columns_nr = 1 + own_sns_nr + store->fields_nr;
+
+	return (sizeof(uint32_t) * columns_nr * store->window_width);
+}
+
+
+/**
+ * @brief Bind the W-LSB objects of the fields to the memory block of a store
+ *
+ * @param store   The W-LSB store
+ * @param fields  The W-LSB objects of the fields, in the same order as for
+ *                \ref wlsb_store_new
+ */
+static void wlsb_store_bind(const struct c_wlsb_store *const store,
+                            struct c_wlsb *const fields[])
+{
+	const size_t own_sns_nr = store->fields_nr - store->shared_fields_nr;
+	uint32_t *const values = store->mem + (1 + own_sns_nr) * store->window_width;
+	size_t i;
+
+	for(i = 0; i < store->fields_nr; i++)
+	{
+		if(i < store->shared_fields_nr)
+		{
+			fields[i]->sns = store->mem;
+		}
+		else
+		{
+			const size_t own_sns_pos = 1 + i - store->shared_fields_nr;
+			fields[i]->sns = store->mem + own_sns_pos * store->window_width;
+		}
+		fields[i]->values = values + i * store->window_width;
+		fields[i]->window_width = store->window_width;
+	}
+}
+
+
 /**
  * @brief Get the next older entry
  *
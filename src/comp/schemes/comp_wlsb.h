@@ -28,6 +28,7 @@
 #define ROHC_COMP_SCHEMES_WLSB_H
 
 #include "interval.h" /* for rohc_lsb_shift_t */
+#include "rohc_arena.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -39,36 +40,20 @@
  * Public structures and types
  */
 
-/**
- * @brief One W-LSB window entry
- */
-struct c_window
-{
-	uint32_t sn;     /**< The Sequence Number (SN) associated with the entry
-	                      (used to acknowledge the entry) */
-	uint32_t value;  /**< The value stored in the window entry */
-};
-
-/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
-#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
-     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
-      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
-_Static_assert((offsetof(struct c_window, sn) % 8) == 0,
-               "sn in c_window should be aligned on 8 bytes");
-_Static_assert((offsetof(struct c_window, value) % 4) == 0,
-               "value in c_window should be aligned on 4 bytes");
-_Static_assert((sizeof(struct c_window) % 8) == 0,
-               "c_window length should be multiple of 8 bytes");
-#endif
-
-
 /**
  * @brief One W-LSB encoding object
+ *
+ * The window is stored as two columns: the Sequence Numbers (SN) used to
+ * acknowledge the entries and the values themselves. The values are thus
+ * contiguous in memory for the min/max computations.
  */
 struct c_wlsb
 {
-	/** The window in which previous values of the encoded value are stored */
-	struct c_window *window;
+	/** The SN associated with every entry of the window, the column may be
+	 *  shared with other fields of one W-LSB store */
+	uint32_t *sns;
+	/** The values stored in the window */
+	uint32_t *values;
 
 	/** The width of the window */
 	uint8_t window_width; /* TODO: R-mode needs a non-fixed window width */
@@ -85,27 +70,104 @@ struct c_wlsb
 #if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
      (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
       (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
-_Static_assert((offsetof(struct c_wlsb, window) % 8) == 0,
-               "window in c_wlsb should be aligned on 8 bytes");
+_Static_assert((offsetof(struct c_wlsb, sns) % 8) == 0,
+               "sns in c_wlsb should be aligned on 8 bytes");
+_Static_assert((offsetof(struct c_wlsb, values) % 8) == 0,
+               "values in c_wlsb should be aligned on 8 bytes");
 _Static_assert((sizeof(struct c_wlsb) % 8) == 0,
                "c_wlsb length should be multiple of 8 bytes");
 #endif
 
 
+/**
+ * @brief One multi-field W-LSB store
+ *
+ * The windows of several fields of one context are allocated at once in one
+ * single memory block. The first fields of the store are updated with every
+ * packet, so they share one single SN ring that one acknowledgement pass
+ * prunes for all of them at once. The other fields are updated with some
+ * packets only, so each of them keeps its own SN column.
+ *
+ * The W-LSB objects of the fields are stored in the context, the store does
+ * not keep track of them: they are given to every function of the store,
+ * always in the same order.
+ */
+struct c_wlsb_store
+{
+	/** The memory block for the SN and value columns of all the fields */
+	uint32_t *mem;
+	/** The number of fields in the store */
+	uint8_t fields_nr;
+	/** The number of fields that share the SN ring */
+	uint8_t shared_fields_nr;
+	/** The width of the windows */
+	uint8_t window_width;
+};
+
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert((sizeof(struct c_wlsb_store) % 8) == 0,
+               "c_wlsb_store length should be multiple of 8 bytes");
+#endif
+
+
+
+/**
+ * @brief The offsets between one value and all the values of a W-LSB window
+ *
+ * The offsets are computed with one single pass over the window, then they
+ * tell whether k bits are enough to encode the value for any k and any shift
+ * parameter p without walking the window again.
+ *
+ * The offsets value - v_ref are stored with a bias of 2^(N-1) - 1 for a
+ * N-bit field, so that the smallest and largest offsets are unsigned values.
+ */
+struct c_wlsb_range
+{
+	uint32_t min;      /**< The smallest biased offset in the window */
+	uint32_t max;      /**< The largest biased offset in the window */
+	uint8_t bits_nr;   /**< The length (in bits) of the encoded field */
+	bool is_empty;     /**< Whether the window contained no value */
+};
+
 
 /*
  * Public function prototypes:
  */
 
 bool wlsb_new(struct c_wlsb *const wlsb,
-              const size_t window_width)
+              const size_t window_width,
+              struct rohc_arena *const arena)
 	__attribute__((warn_unused_result, nonnull(1)));
 bool wlsb_copy(struct c_wlsb *const dst,
-               const struct c_wlsb *const src)
+               const struct c_wlsb *const src,
+               struct rohc_arena *const arena)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 void wlsb_free(struct c_wlsb *const wlsb)
 	__attribute__((nonnull(1)));
 
+bool wlsb_store_new(struct c_wlsb_store *const store,
+                    struct c_wlsb *const fields[],
+                    const size_t fields_nr,
+                    const size_t shared_fields_nr,
+                    const size_t window_width,
+                    struct rohc_arena *const arena)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool wlsb_store_copy(struct c_wlsb_store *const dst,
+                     struct c_wlsb *const dst_fields[],
+                     const struct c_wlsb_store *const src,
+                     struct rohc_arena *const arena)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+void wlsb_store_free(struct c_wlsb_store *const store)
+	__attribute__((nonnull(1)));
+size_t wlsb_store_ack(const struct c_wlsb_store *const store,
+                      struct c_wlsb *const fields[],
+                      const uint32_t sn_bits,
+                      const size_t sn_bits_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
                 const uint32_t value)
@@ -129,6 +191,30 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
                                 const int32_t p)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+void wlsb_get_range_8bits(const struct c_wlsb *const wlsb,
+                          const uint8_t value,
+                          struct c_wlsb_range *const range)
+	__attribute__((nonnull(1, 3)));
+
+void wlsb_get_range_16bits(const struct c_wlsb *const wlsb,
+                           const uint16_t value,
+                           struct c_wlsb_range *const range)
+	__attribute__((nonnull(1, 3)));
+
+void wlsb_get_range_32bits(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           struct c_wlsb_range *const range)
+	__attribute__((nonnull(1, 3)));
+
+bool wlsb_range_is_kp_possible(const struct c_wlsb_range *const range,
+                               const size_t k,
+                               const int32_t p)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+size_t wlsb_range_get_min_k(const struct c_wlsb_range *const range,
+                            const int32_t p)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
 size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const uint32_t sn_bits,
                 const size_t sn_bits_nr)
@@ -168,7 +168,7 @@ static bool run_test_variable_length_32_enc(const bool be_verbose)
 	};
 
 	/* create the W-LSB context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, NULL);
 	if(!is_ok)
 	{
 		trace(be_verbose, "failed to create W-LSB context\n");
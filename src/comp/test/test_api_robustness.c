@@ -121,6 +121,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == true);
 	}
 
+	/* rohc_comp_set_traces_min_level() */
+	CHECK(rohc_comp_set_traces_min_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_comp_profile_enabled() */
 	CHECK(rohc_comp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_GENERAL) == false);
@@ -262,6 +268,13 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_rtp_detection_cb(comp, fct, NULL) == true);
 	}
 
+	/* rohc_comp_set_rtp_heuristic() */
+	CHECK(rohc_comp_set_rtp_heuristic(NULL, 1024, 65535) == false);
+	CHECK(rohc_comp_set_rtp_heuristic(comp, 5000, 4999) == false);
+	CHECK(rohc_comp_set_rtp_heuristic(comp, 1024, 65535) == true);
+	CHECK(rohc_comp_set_rtp_heuristic(comp, 5000, 5000) == true);
+	CHECK(rohc_comp_set_rtp_heuristic(comp, 0, 0) == true);
+
 	/* rohc_comp_set_mrru() */
 	CHECK(rohc_comp_set_mrru(NULL, 10) == false);
 	CHECK(rohc_comp_set_mrru(comp, 65535 + 1) == false);
@@ -284,6 +297,13 @@ int main(int argc, char *argv[])
 	/* disable MRRU for next tests */
 	CHECK(rohc_comp_set_mrru(comp, 0) == true);
 
+	/* rohc_comp_set_arena() */
+	CHECK(rohc_comp_set_arena(NULL, 16) == false);
+	CHECK(rohc_comp_set_arena(comp, 65536 + 1) == false);
+	CHECK(rohc_comp_set_arena(comp, 0) == true);
+	CHECK(rohc_comp_set_arena(comp, 65536) == true);
+	CHECK(rohc_comp_set_arena(comp, 16) == true);
+
 	/* rohc_comp_get_max_cid() */
 	{
 		size_t max_cid;
@@ -353,6 +373,21 @@ int main(int argc, char *argv[])
 		pkt2.offset = 0;
 		pkt2.len = 0;
 		CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+
+		/* rohc_compress_zero_copy() */
+		{
+			struct rohc_buf payload;
+			pkt2.max_len = 100;
+			pkt2.offset = 0;
+			pkt2.len = 0;
+			CHECK(rohc_compress_zero_copy(NULL, pkt, &pkt2, &payload) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_zero_copy(comp, pkt, NULL, &payload) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_zero_copy(comp, pkt, &pkt2, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_zero_copy(comp, pkt, &pkt2, &payload) == ROHC_STATUS_OK);
+			CHECK(pkt2.len > 0);
+			CHECK(payload.len > 0);
+			CHECK((rohc_buf_data(payload) + payload.len) == (rohc_buf_data(pkt) + pkt.len));
+		}
 	}
 
 	/* rohc_comp_get_last_packet_info2() */
@@ -385,6 +420,32 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_general_info(comp, &info) == true);
 	}
 
+	/* rohc_comp_get_stats() */
+	{
+		rohc_comp_stats_t stats;
+		memset(&stats, 0, sizeof(rohc_comp_stats_t));
+		CHECK(rohc_comp_get_stats(NULL, &stats) == false);
+		CHECK(rohc_comp_get_stats(comp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_comp_get_stats(comp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_comp_get_stats(comp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_comp_get_stats(comp, &stats) == true);
+		CHECK(stats.packets_nr == 0); /* statistics are disabled by default */
+	}
+
+	/* rohc_stats_get_bucket_min() */
+	CHECK(rohc_stats_get_bucket_min(0) == 0);
+	CHECK(rohc_stats_get_bucket_min(3) == 3);
+	CHECK(rohc_stats_get_bucket_min(4) == 4);
+	CHECK(rohc_stats_get_bucket_min(7) == 7);
+	CHECK(rohc_stats_get_bucket_min(8) == 8);
+	CHECK(rohc_stats_get_bucket_min(9) == 10);
+	CHECK(rohc_stats_get_bucket_min(ROHC_STATS_LATENCY_BUCKETS_NR - 1) == (7ULL << 61));
+	CHECK(rohc_stats_get_bucket_min(ROHC_STATS_LATENCY_BUCKETS_NR) == UINT64_MAX);
+
 	/* rohc_comp_get_state_descr() */
 	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_IR), "IR") == 0);
 	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_FO), "FO") == 0);
@@ -400,6 +461,11 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_DUMP_PACKETS) == true);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_FAST_CTXT_HASH) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_FAST_CTXT_HASH |
+	                                   ROHC_COMP_FEATURE_DUMP_PACKETS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_STATS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_RTP_CLASS_CACHE) == true);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
 
 	/* rohc_comp_deliver_feedback2() */
@@ -417,10 +483,29 @@ int main(int argc, char *argv[])
 		pkt.len = 5; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
 	}
 
+	/* rohc_comp_deliver_feedbacks() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+		struct rohc_buf pkts[2] = {
+			rohc_buf_init_full(buf, 5, ts),
+			rohc_buf_init_full(buf, 5, ts)
+		};
+
+		CHECK(rohc_comp_deliver_feedbacks(NULL, pkts, 2) == false);
+		CHECK(rohc_comp_deliver_feedbacks(comp, NULL, 2) == false);
+		CHECK(rohc_comp_deliver_feedbacks(comp, NULL, 0) == true);
+		CHECK(rohc_comp_deliver_feedbacks(comp, pkts, 0) == true);
+		pkts[1].len = 3; CHECK(rohc_comp_deliver_feedbacks(comp, pkts, 2) == false);
+		pkts[1].len = 0; CHECK(rohc_comp_deliver_feedbacks(comp, pkts, 2) == true);
+		pkts[1].len = 5; CHECK(rohc_comp_deliver_feedbacks(comp, pkts, 2) == true);
+	}
+
 	/* several functions with some packets already compressed */
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
+		CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_WARNING) == false);
 
 		CHECK(rohc_comp_set_optimistic_approach(comp, 16) == false);
 
@@ -431,6 +516,97 @@ int main(int argc, char *argv[])
 	rohc_comp_free(NULL);
 	rohc_comp_free(comp);
 
+	/* rohc_comp_shards_new() */
+	CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, 3, 0, 8, random_cb, NULL) == NULL);
+	CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, 3, 5, 8, random_cb, NULL) == NULL);
+	CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, 3, 2, 0, random_cb, NULL) == NULL);
+	CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1, 2, 8,
+	                           random_cb, NULL) == NULL);
+	CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, 3, 2, 8, NULL, NULL) == NULL);
+	{
+		struct rohc_comp_shards *const shards =
+			rohc_comp_shards_new(ROHC_SMALL_CID, 3, 4, 3, random_cb, NULL);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf1[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt1 = rohc_buf_init_full(buf1, sizeof(buf1), ts);
+		uint8_t buf2[4][100];
+		struct rohc_buf pkt2 = rohc_buf_init_empty(buf2[0], 100);
+		uint8_t fb[] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+		struct rohc_buf feedback = rohc_buf_init_full(fb, 5, ts);
+		rohc_status_t status;
+		void *pkt_priv;
+		size_t i;
+
+		CHECK(shards != NULL);
+
+		/* rohc_comp_shards_get_comp() */
+		CHECK(rohc_comp_shards_get_comp(NULL, 0) == NULL);
+		CHECK(rohc_comp_shards_get_comp(shards, 4) == NULL);
+		for(i = 0; i < 4; i++)
+		{
+			struct rohc_comp *const shard_comp = rohc_comp_shards_get_comp(shards, i);
+			CHECK(shard_comp != NULL);
+			CHECK(rohc_comp_enable_profile(shard_comp, ROHC_PROFILE_IP) == true);
+		}
+
+		/* rohc_comp_shards_enqueue() */
+		CHECK(rohc_comp_shards_enqueue(NULL, pkt1, pkt2, NULL) == false);
+		pkt2.len = 1;
+		CHECK(rohc_comp_shards_enqueue(shards, pkt1, pkt2, NULL) == false);
+		for(i = 0; i < 4; i++)
+		{
+			pkt2.data = buf2[i];
+			pkt2.len = 0;
+			CHECK(rohc_comp_shards_enqueue(shards, pkt1, pkt2, buf2[i]) == true);
+		}
+		CHECK(rohc_comp_shards_enqueue(shards, pkt1, pkt2, NULL) == false);
+
+		/* rohc_comp_shards_dequeue() before any compression */
+		CHECK(rohc_comp_shards_dequeue(shards, &pkt2, &status, &pkt_priv) == false);
+
+		/* rohc_comp_shards_run() */
+		CHECK(rohc_comp_shards_run(NULL, 0, 10) == 0);
+		CHECK(rohc_comp_shards_run(shards, 4, 10) == 0);
+		for(i = 0; i < 4; i++)
+		{
+			(void) rohc_comp_shards_run(shards, i, 10);
+		}
+
+		/* rohc_comp_shards_dequeue() */
+		CHECK(rohc_comp_shards_dequeue(NULL, &pkt2, &status, &pkt_priv) == false);
+		CHECK(rohc_comp_shards_dequeue(shards, NULL, &status, &pkt_priv) == false);
+		CHECK(rohc_comp_shards_dequeue(shards, &pkt2, NULL, &pkt_priv) == false);
+		for(i = 0; i < 4; i++)
+		{
+			CHECK(rohc_comp_shards_dequeue(shards, &pkt2, &status, &pkt_priv) == true);
+			CHECK(status == ROHC_STATUS_OK);
+			CHECK(pkt_priv == buf2[i]);
+			CHECK(rohc_buf_data(pkt2) == buf2[i]);
+			CHECK(pkt2.len > 0);
+		}
+		CHECK(rohc_comp_shards_dequeue(shards, &pkt2, &status, NULL) == false);
+
+		/* rohc_comp_shards_deliver_feedback() */
+		CHECK(rohc_comp_shards_deliver_feedback(NULL, feedback) == false);
+		feedback.len = 0;
+		CHECK(rohc_comp_shards_deliver_feedback(shards, feedback) == true);
+		feedback.len = 2;
+		CHECK(rohc_comp_shards_deliver_feedback(shards, feedback) == false);
+		feedback.len = 5;
+		CHECK(rohc_comp_shards_deliver_feedback(shards, feedback) == true);
+		CHECK(rohc_comp_shards_run(shards, 0, 10) == 0);
+
+		/* rohc_comp_shards_free() */
+		rohc_comp_shards_free(NULL);
+		rohc_comp_shards_free(shards);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
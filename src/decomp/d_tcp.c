@@ -61,17 +61,15 @@
  */
 
 static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
-                                  struct d_tcp_context **const persist_ctxt,
-                                  struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                  struct d_tcp_context **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
                                    const struct rohc_tcp_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_tcp_destroy(struct d_tcp_context *const tcp_context)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -463,17 +461,16 @@ static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
  *
  * @param context            The main decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if creation succeeded, false in case of problem
  */
 static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
-                                  struct d_tcp_context **const persist_ctxt,
-                                  struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                                  struct d_tcp_context **const persist_ctxt)
 {
 	struct d_tcp_context *tcp_context;
 
 	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct d_tcp_context));
+	*persist_ctxt = rohc_arena_calloc(&context->decompressor->arena,
+	                                  sizeof(struct d_tcp_context));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -511,30 +508,8 @@ static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
 	 * reply */
 	rohc_lsb_init(&tcp_context->opt_ts_rep_lsb_ctxt, 32);
 
-	/* volatile part of the decompression context */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_tcp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_tcp_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto free_extr_bits;
-	}
-
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(tcp_context);
 quit:
 	return false;
 }
@@ -547,17 +522,11 @@ quit:
  * framework to work.
  *
  * @param tcp_context  The persistent decompression context for the TCP profile
- * @param volat_ctxt   The volatile decompression context
  */
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_tcp_destroy(struct d_tcp_context *const tcp_context)
 {
 	/* free the TCP decompression context itself */
-	free(tcp_context);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_arena_free(tcp_context);
 }
 
 
@@ -4265,8 +4234,10 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->uncomp.type != ROHC_CRC_TYPE_NONE)
 	{
+		struct d_tcp_context *const tcp_context = context->persist_ctxt;
 		const bool crc_ok =
-			rohc_decomp_check_uncomp_crc(context, uncomp_hdrs, &extr_crc->uncomp);
+			rohc_decomp_check_uncomp_crc(context, &tcp_context->crc_cache,
+			                             uncomp_hdrs, &extr_crc->uncomp);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -4277,6 +4248,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+				                 decomp->trace_min_level,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				                 "uncompressed headers", *uncomp_hdrs);
 			}
@@ -4288,6 +4260,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 decomp->trace_min_level,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
 		                 "IP/TCP headers", *uncomp_hdrs);
 	}
@@ -4574,6 +4547,8 @@ const struct rohc_decomp_profile d_tcp_profile =
 {
 	.id              = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_tcp_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_tcp_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_tcp_create_from_pkt,
 	.free_context    = (rohc_decomp_free_context_t) d_tcp_destroy,
 	.detect_pkt_type = tcp_detect_packet_type,
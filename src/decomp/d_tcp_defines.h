@@ -38,6 +38,7 @@
 #include "schemes/decomp_wlsb.h"
 #include "schemes/tcp_ts.h"
 #include "schemes/tcp_sack.h"
+#include "crc.h"
 
 #include <stdint.h>
 
@@ -198,6 +199,8 @@ struct d_tcp_context
 	/* TCP SACK option */
 	struct d_tcp_opt_sack opt_sack_blocks;  /**< The TCP SACK blocks */
 
+	/** The CRC of the last uncompressed headers */
+	struct rohc_crc_cache crc_cache;
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -64,6 +64,9 @@ struct rohc_decomp_rfc5225_ip_udp_ctxt
 	uint16_t udp_dport;
 	/** Whether the UDP checksum is used or not */
 	bool udp_checksum_used;
+
+	/** The CRC of the last uncompressed headers */
+	struct rohc_crc_cache crc_cache;
 };
 
 
@@ -172,13 +175,11 @@ struct rohc_rfc5225_decoded
  */
 
 static bool decomp_rfc5225_ip_udp_new_context(const struct rohc_decomp_ctxt *const context,
-                                              void **const persist_ctxt,
-                                              struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                              void **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void decomp_rfc5225_ip_udp_free_context(struct rohc_decomp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void decomp_rfc5225_ip_udp_free_context(struct rohc_decomp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t decomp_rfc5225_ip_udp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                                            const uint8_t *const rohc_packet,
@@ -401,25 +402,24 @@ static uint32_t decomp_rfc5225_ip_udp_get_sn(const struct rohc_decomp_ctxt *cons
  */
 
 /**
- * @brief Create the ROHCv2 IP/UDP volatile and persistent parts of the context
+ * @brief Create the ROHCv2 IP/UDP persistent part of the context
  *
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the ROHCv2 IP/UDP context was successfully
  *                           created, false if a problem occurred
  */
 static bool decomp_rfc5225_ip_udp_new_context(const struct rohc_decomp_ctxt *const context,
-                                              void **const persist_ctxt,
-                                              struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                                              void **const persist_ctxt)
 {
 	struct rohc_decomp_rfc5225_ip_udp_ctxt *rfc5225_ctxt;
 
 	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc5225_ip_udp_ctxt));
+	*persist_ctxt = rohc_arena_calloc(&context->decompressor->arena,
+	                                  sizeof(struct rohc_decomp_rfc5225_ip_udp_ctxt));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -436,30 +436,8 @@ static bool decomp_rfc5225_ip_udp_new_context(const struct rohc_decomp_ctxt *con
 	/* by default, no reordering accepted on the channel */
 	rfc5225_ctxt->reorder_ratio = ROHC_REORDERING_NONE;
 
-	/* volatile part */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_rfc5225_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/UDP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_rfc5225_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/UDP decompression context");
-		goto free_extr_bits;
-	}
-
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(rfc5225_ctxt);
 error:
 	return false;
 }
@@ -473,17 +451,11 @@ error:
  * framework to work.
  *
  * @param rfc5225_ctxt  The persistent decompression context for the IP/UDP profile
- * @param volat_ctxt    The volatile part of the decompression context
  */
-static void decomp_rfc5225_ip_udp_free_context(struct rohc_decomp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void decomp_rfc5225_ip_udp_free_context(struct rohc_decomp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt)
 {
 	/* free the ROHCv2 IP/UDP decompression context itself */
-	free(rfc5225_ctxt);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_arena_free(rfc5225_ctxt);
 }
 
 
@@ -645,6 +617,9 @@ static void decomp_rfc5225_ip_udp_reset_extr_bits(const struct rohc_decomp_ctxt
 	bits->reorder_ratio_nr = 0;
 	bits->outer_ip_flag_nr = 0;
 	bits->ctrl_crc.type = ROHC_CRC_TYPE_NONE;
+	bits->udp_sport_nr = 0;
+	bits->udp_dport_nr = 0;
+	bits->udp_checksum_nr = 0;
 
 	/* if context handled at least one packet, init the list of IP headers */
 	if(ctxt->num_recv_packets >= 1)
@@ -2300,7 +2275,7 @@ static rohc_status_t decomp_rfc5225_ip_udp_decode_bits(const struct rohc_decomp_
 			 * https://www.rfc-editor.org/errata_search.php?rfc=5225&eid=2703 */
 			if(rfc5225_ctxt->ip_contexts[ip_hdr_pos].version == IPV4)
 			{
-				ip_id_behaviors[ip_id_behaviors_nr] = bits->ip[ip_hdr_pos].id_behavior;
+				ip_id_behaviors[ip_id_behaviors_nr] = decoded->ip[ip_hdr_pos].id_behavior;
 				rohc_decomp_debug(ctxt, "IP-ID behavior #%zu of IPv4 header #%zu "
 				                  "= 0x%02x", ip_id_behaviors_nr + 1, ip_hdr_pos + 1,
 				                  ip_id_behaviors[ip_id_behaviors_nr]);
@@ -2759,8 +2734,10 @@ static rohc_status_t decomp_rfc5225_ip_udp_build_hdrs(const struct rohc_decomp *
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->uncomp.type != ROHC_CRC_TYPE_NONE)
 	{
+		struct rohc_decomp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt = context->persist_ctxt;
 		const bool crc_ok =
-			rohc_decomp_check_uncomp_crc(context, uncomp_hdrs, &extr_crc->uncomp);
+			rohc_decomp_check_uncomp_crc(context, &rfc5225_ctxt->crc_cache,
+			                             uncomp_hdrs, &extr_crc->uncomp);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -2771,6 +2748,7 @@ static rohc_status_t decomp_rfc5225_ip_udp_build_hdrs(const struct rohc_decomp *
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+				                 decomp->trace_min_level,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				                 "uncompressed headers", *uncomp_hdrs);
 			}
@@ -2781,6 +2759,7 @@ static rohc_status_t decomp_rfc5225_ip_udp_build_hdrs(const struct rohc_decomp *
 	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 decomp->trace_min_level,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
 		                 "IP headers", *uncomp_hdrs);
 	}
@@ -3162,6 +3141,8 @@ static void decomp_rfc5225_ip_udp_update_ctxt(struct rohc_decomp_ctxt *const con
 	rfc5225_ctxt->ip_contexts_nr = decoded->ip_nr;
 
 	/* update context for the UDP header */
+	rfc5225_ctxt->udp_sport = decoded->udp_sport;
+	rfc5225_ctxt->udp_dport = decoded->udp_dport;
 	rfc5225_ctxt->udp_checksum_used = decoded->udp_checksum_used;
 }
 
@@ -3220,6 +3201,8 @@ const struct rohc_decomp_profile rohc_decomp_rfc5225_ip_udp_profile =
 {
 	.id              = ROHCv2_PROFILE_IP_UDP, /* profile ID (RFC5225, ROHCv2 IP/UDP) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_rfc5225_bits),
+	.decoded_values_size = sizeof(struct rohc_rfc5225_decoded),
 	.new_context     = decomp_rfc5225_ip_udp_new_context,
 	.free_context    = (rohc_decomp_free_context_t) decomp_rfc5225_ip_udp_free_context,
 	.detect_pkt_type = decomp_rfc5225_ip_udp_detect_pkt_type,
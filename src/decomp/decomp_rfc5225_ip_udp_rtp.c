@@ -71,6 +71,9 @@ struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt
 	uint8_t rtp_m;       /**< The RTP Marker */
 	uint8_t rtp_pt;      /**< The RTP Payload Type (PT) */
 	uint32_t rtp_ts;     /**< The RTP TimeStamp (TS) */
+
+	/** The CRC of the last uncompressed headers */
+	struct rohc_crc_cache crc_cache;
 };
 
 
@@ -199,13 +202,11 @@ struct rohc_rfc5225_decoded
  */
 
 static bool decomp_rfc5225_ip_udp_rtp_new_context(const struct rohc_decomp_ctxt *const context,
-                                              void **const persist_ctxt,
-                                              struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                              void **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void decomp_rfc5225_ip_udp_rtp_free_context(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void decomp_rfc5225_ip_udp_rtp_free_context(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t decomp_rfc5225_ip_udp_rtp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                                            const uint8_t *const rohc_packet,
@@ -394,25 +395,24 @@ static uint32_t decomp_rfc5225_ip_udp_rtp_get_sn(const struct rohc_decomp_ctxt *
  */
 
 /**
- * @brief Create the ROHCv2 IP/UDP/RTP volatile and persistent parts of the context
+ * @brief Create the ROHCv2 IP/UDP/RTP persistent part of the context
  *
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the ROHCv2 IP/UDP/RTP context was successfully
  *                           created, false if a problem occurred
  */
 static bool decomp_rfc5225_ip_udp_rtp_new_context(const struct rohc_decomp_ctxt *const context,
-                                              void **const persist_ctxt,
-                                              struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                                              void **const persist_ctxt)
 {
 	struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *rfc5225_ctxt;
 
 	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt));
+	*persist_ctxt = rohc_arena_calloc(&context->decompressor->arena,
+	                                  sizeof(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -429,30 +429,8 @@ static bool decomp_rfc5225_ip_udp_rtp_new_context(const struct rohc_decomp_ctxt
 	/* by default, no reordering accepted on the channel */
 	rfc5225_ctxt->reorder_ratio = ROHC_REORDERING_NONE;
 
-	/* volatile part */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_rfc5225_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/UDP/RTP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_rfc5225_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/UDP/RTP decompression context");
-		goto free_extr_bits;
-	}
-
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(rfc5225_ctxt);
 error:
 	return false;
 }
@@ -466,17 +444,11 @@ error:
  * framework to work.
  *
  * @param rfc5225_ctxt  The persistent decompression context for the IP/UDP/RTP profile
- * @param volat_ctxt    The volatile part of the decompression context
  */
-static void decomp_rfc5225_ip_udp_rtp_free_context(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void decomp_rfc5225_ip_udp_rtp_free_context(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt)
 {
 	/* free the ROHCv2 IP/UDP/RTP decompression context itself */
-	free(rfc5225_ctxt);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_arena_free(rfc5225_ctxt);
 }
 
 
@@ -637,6 +609,15 @@ static void decomp_rfc5225_ip_udp_rtp_reset_extr_bits(const struct rohc_decomp_c
 	bits->reorder_ratio_nr = 0;
 	bits->outer_ip_flag_nr = 0;
 	bits->ctrl_crc.type = ROHC_CRC_TYPE_NONE;
+	bits->udp_sport_nr = 0;
+	bits->udp_dport_nr = 0;
+	bits->udp_checksum_nr = 0;
+	bits->rtp_ssrc_nr = 0;
+	bits->rtp_pad_nr = 0;
+	bits->rtp_ext_nr = 0;
+	bits->rtp_m_nr = 0;
+	bits->rtp_pt_nr = 0;
+	bits->rtp_ts_nr = 0;
 
 	/* if context handled at least one packet, init the list of IP headers */
 	if(ctxt->num_recv_packets >= 1)
@@ -1727,7 +1708,7 @@ static rohc_status_t decomp_rfc5225_ip_udp_rtp_decode_bits(const struct rohc_dec
 			 * https://www.rfc-editor.org/errata_search.php?rfc=5225&eid=2703 */
 			if(rfc5225_ctxt->ip_contexts[ip_hdr_pos].version == IPV4)
 			{
-				ip_id_behaviors[ip_id_behaviors_nr] = bits->ip[ip_hdr_pos].id_behavior;
+				ip_id_behaviors[ip_id_behaviors_nr] = decoded->ip[ip_hdr_pos].id_behavior;
 				rohc_decomp_debug(ctxt, "IP-ID behavior #%zu of IPv4 header #%zu "
 				                  "= 0x%02x", ip_id_behaviors_nr + 1, ip_hdr_pos + 1,
 				                  ip_id_behaviors[ip_id_behaviors_nr]);
@@ -2197,8 +2178,10 @@ static rohc_status_t decomp_rfc5225_ip_udp_rtp_build_hdrs(const struct rohc_deco
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->uncomp.type != ROHC_CRC_TYPE_NONE)
 	{
+		struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->persist_ctxt;
 		const bool crc_ok =
-			rohc_decomp_check_uncomp_crc(context, uncomp_hdrs, &extr_crc->uncomp);
+			rohc_decomp_check_uncomp_crc(context, &rfc5225_ctxt->crc_cache,
+			                             uncomp_hdrs, &extr_crc->uncomp);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -2209,6 +2192,7 @@ static rohc_status_t decomp_rfc5225_ip_udp_rtp_build_hdrs(const struct rohc_deco
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+				                 decomp->trace_min_level,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				                 "uncompressed headers", *uncomp_hdrs);
 			}
@@ -2219,6 +2203,7 @@ static rohc_status_t decomp_rfc5225_ip_udp_rtp_build_hdrs(const struct rohc_deco
 	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 decomp->trace_min_level,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
 		                 "IP headers", *uncomp_hdrs);
 	}
@@ -2666,7 +2651,17 @@ static void decomp_rfc5225_ip_udp_rtp_update_ctxt(struct rohc_decomp_ctxt *const
 	rfc5225_ctxt->ip_contexts_nr = decoded->ip_nr;
 
 	/* update context for the UDP header */
+	rfc5225_ctxt->udp_sport = decoded->udp_sport;
+	rfc5225_ctxt->udp_dport = decoded->udp_dport;
 	rfc5225_ctxt->udp_checksum_used = decoded->udp_checksum_used;
+
+	/* update context for the RTP header */
+	rfc5225_ctxt->rtp_ssrc = decoded->rtp_ssrc;
+	rfc5225_ctxt->rtp_pad = decoded->rtp_pad;
+	rfc5225_ctxt->rtp_ext = decoded->rtp_ext;
+	rfc5225_ctxt->rtp_m = decoded->rtp_m;
+	rfc5225_ctxt->rtp_pt = decoded->rtp_pt;
+	rfc5225_ctxt->rtp_ts = decoded->rtp_ts;
 }
 
 
@@ -2724,6 +2719,8 @@ const struct rohc_decomp_profile rohc_decomp_rfc5225_ip_udp_rtp_profile =
 {
 	.id              = ROHCv2_PROFILE_IP_UDP_RTP, /* profile ID (RFC5225, ROHCv2 IP/UDP/RTP) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_rfc5225_bits),
+	.decoded_values_size = sizeof(struct rohc_rfc5225_decoded),
 	.new_context     = decomp_rfc5225_ip_udp_rtp_new_context,
 	.free_context    = (rohc_decomp_free_context_t) decomp_rfc5225_ip_udp_rtp_free_context,
 	.detect_pkt_type = decomp_rfc5225_ip_udp_rtp_detect_pkt_type,
@@ -41,11 +41,14 @@
  * Prototypes of private functions.
  */
 
-static bool f_append_cid(struct d_feedback *const feedback,
-                         const uint16_t cid,
-                         const rohc_cid_type_t cid_type,
-                         size_t *const cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+static size_t f_get_cid_len(const uint16_t cid,
+                            const rohc_cid_type_t cid_type)
+	__attribute__((warn_unused_result, const));
+static bool f_write_cid(const uint16_t cid,
+                        const rohc_cid_type_t cid_type,
+                        const size_t cid_len,
+                        uint8_t *const data)
+	__attribute__((warn_unused_result, nonnull(4)));
 
 
 /**
@@ -297,52 +300,63 @@ error:
 
 
 /**
- * @brief Append the CID to the feedback packet.
+ * @brief Get the length of the CID field of the feedback packet.
  *
- * @param feedback     The feedback packet to which the CID must be appended
- * @param cid          The Context ID (CID) to append
- * @param cid_type     The type of CID used for the feedback
- * @param[out] cid_len The length of the add-CID or large CID field
- * @return             Whether the CID is successfully appended or not
+ * @param cid       The Context ID (CID)
+ * @param cid_type  The type of CID used for the feedback
+ * @return          The length of the add-CID or large CID field
  */
-static bool f_append_cid(struct d_feedback *const feedback,
-                         const uint16_t cid,
-                         const rohc_cid_type_t cid_type,
-                         size_t *const cid_len)
+static size_t f_get_cid_len(const uint16_t cid,
+                            const rohc_cid_type_t cid_type)
 {
-	size_t i;
+	size_t cid_len;
 
 	if(cid_type == ROHC_LARGE_CID)
 	{
 		/* large CIDs are used */
 		assert(cid <= ROHC_LARGE_CID_MAX);
 
-		/* determine the number of bits required for the SDVL-encoded large CID */
-		*cid_len = sdvl_get_encoded_len(cid);
-		assert((*cid_len) == 1 || (*cid_len) == 2); /* ensured by SDVL algorithm */
+		/* determine the number of bytes required for the SDVL-encoded large CID */
+		cid_len = sdvl_get_encoded_len(cid);
+		assert(cid_len == 1 || cid_len == 2); /* ensured by SDVL algorithm */
+	}
+	else
+	{
+		/* small CIDs are used */
+		assert(cid <= ROHC_SMALL_CID_MAX);
 
-		/* check if the feedback packet can contain a SDVL-encoded large CID */
-		if((feedback->size + (*cid_len)) > FEEDBACK_DATA_MAX_LEN)
-		{
-#ifdef ROHC_FEEDBACK_DEBUG
-			printf("feedback packet is too small for large CID\n");
-#endif
-			return false;
-		}
+		/* 1 byte only if CID is non-zero */
+		cid_len = (cid != 0 ? 1 : 0);
+	}
+
+	return cid_len;
+}
+
+
+/**
+ * @brief Write the CID at the beginning of the feedback packet.
+ *
+ * @param cid       The Context ID (CID) to write
+ * @param cid_type  The type of CID used for the feedback
+ * @param cid_len   The length of the add-CID or large CID field
+ * @param data      The feedback packet to write the CID to
+ * @return          Whether the CID is successfully written or not
+ */
+static bool f_write_cid(const uint16_t cid,
+                        const rohc_cid_type_t cid_type,
+                        const size_t cid_len,
+                        uint8_t *const data)
+{
+	if(cid_type == ROHC_LARGE_CID)
+	{
+		size_t encoded_len;
 
 #ifdef ROHC_FEEDBACK_DEBUG
-		printf("add %zu bytes for large CID to feedback\n", *cid_len);
+		printf("add %zu bytes for large CID to feedback\n", cid_len);
 #endif
 
-		/* move feedback data to make space for the SDVL-encoded large CID */
-		assert(feedback->size >= 1);
-		for(i = feedback->size; i > 0; i--)
-		{
-			feedback->data[i - 1 + (*cid_len)] = feedback->data[i - 1];
-		}
-
 		/* SDVL-encode the large CID */
-		if(!sdvl_encode_full(feedback->data, 4U /* TODO */, cid_len, cid))
+		if(!sdvl_encode_full(data, cid_len, &encoded_len, cid))
 		{
 #ifdef ROHC_FEEDBACK_DEBUG
 			printf("failed to SDVL-encoded large CID %u, should never "
@@ -350,41 +364,23 @@ static bool f_append_cid(struct d_feedback *const feedback,
 #endif
 			return false;
 		}
-		feedback->size += (*cid_len);
+		assert(encoded_len == cid_len);
 	}
-	else /* small CID */
+	else if(cid_len > 0)
 	{
-		/* small CIDs are used */
-		assert(cid <= ROHC_SMALL_CID_MAX);
-
-		/* add 1 byte only if CID is non-zero */
-		if(cid != 0)
-		{
 #ifdef ROHC_FEEDBACK_DEBUG
-			printf("add 1 byte for small CID to feedback\n");
+		printf("add 1 byte for small CID to feedback\n");
 #endif
 
-			/* move feedback data to make space for the small CID */
-			assert(feedback->size >= 1);
-			for(i = feedback->size; i > 0; i--)
-			{
-				feedback->data[i] = feedback->data[i - 1];
-			}
-
-			/* write the small CID to the feedback packet */
-			feedback->data[0] = 0xe0;
-			feedback->data[0] = (cid & 0xf) | feedback->data[0];
-			feedback->size++;
-			*cid_len = 1;
-		}
+		/* write the small CID to the feedback packet */
+		data[0] = 0xe0 | (cid & 0xf);
+	}
 #ifdef ROHC_FEEDBACK_DEBUG
-		else
-		{
-			printf("no need to prepend Add-CID byte to feedback\n");
-			*cid_len = 0;
-		}
-#endif
+	else
+	{
+		printf("no need to prepend Add-CID byte to feedback\n");
 	}
+#endif
 
 	return true;
 }
@@ -393,50 +389,96 @@ static bool f_append_cid(struct d_feedback *const feedback,
 /**
  * @brief Wrap the feedback packet and add a CRC option if specified.
  *
+ * The feedback header, the CID, the feedback data and the CRC option are
+ * written directly at the end of the given buffer, then the CRC is computed
+ * there. The feedback is not appended if the buffer is too small for it.
+ *
  * @warning CID may be greater than MAX_CID if the context was not found and
  *          generated a No Context feedback; it must however respect CID type
  *
- * @param feedback          The feedback packet to which the CID must be
- *                          appended
+ * @param feedback          The feedback data to wrap
  * @param cid               The Context ID (CID) to append
  * @param cid_type          The type of CID used for the feedback
  * @param protect_with_crc  Whether the CRC option must be added or not
- * @param final_size        OUT: The final size of the feedback packet
- * @return                  The feedback packet if successful, NULL otherwise
+ * @param feedback_send     The buffer to append the feedback packet to
+ * @param final_size        OUT: The final size of the feedback data
+ * @return                  true if successful, false otherwise
  */
-uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
-                          const uint16_t cid,
-                          const rohc_cid_type_t cid_type,
-                          const rohc_feedback_crc_t protect_with_crc,
-                          size_t *const final_size)
+bool f_wrap_feedback(struct d_feedback *const feedback,
+                     const uint16_t cid,
+                     const rohc_cid_type_t cid_type,
+                     const rohc_feedback_crc_t protect_with_crc,
+                     struct rohc_buf *const feedback_send,
+                     size_t *const final_size)
 {
-	uint8_t *feedback_packet;
-	size_t feedback_cid_len = 0;
+	const size_t feedback_cid_len = f_get_cid_len(cid, cid_type);
+	size_t feedback_opts_len = 0;
+	size_t feedback_hdr_len;
+	uint8_t *feedback_data;
 	size_t crc_pos = 0;
-	uint8_t crc;
 
-	/* append the CID to the feedback packet */
-	if(!f_append_cid(feedback, cid, cid_type, &feedback_cid_len))
+	/* the CRC option is 2-byte long */
+	if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_OPT)
+	{
+		/* options are reserved for FEEDBACK-2 */
+		assert(feedback->type == 2);
+		feedback_opts_len = 2;
+	}
+	else if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC &&
+	        protect_with_crc != ROHC_FEEDBACK_WITH_CRC_BASE)
+	{
+		assert(0);
+		goto error;
+	}
+
+	/* the size of the feedback data determines the length of the header */
+	*final_size = feedback_cid_len + feedback->size + feedback_opts_len;
+	if((*final_size) > FEEDBACK_DATA_MAX_LEN)
 	{
+#ifdef ROHC_FEEDBACK_DEBUG
+		printf("feedback packet is too small for CID and options\n");
+#endif
 		goto error;
 	}
-	assert(feedback_cid_len <= 2);
+	feedback_hdr_len = 1 + ((*final_size) < 8 ? 0 : 1);
+
+	/* do not append the feedback if there is not enough room for it */
+	if((feedback_hdr_len + (*final_size)) > rohc_buf_avail_len(*feedback_send))
+	{
+		goto skip;
+	}
+
+	/* feedback header */
+	if((*final_size) < 8)
+	{
+		rohc_buf_byte_at(*feedback_send, feedback_send->len) = 0xf0 | (*final_size);
+	}
+	else
+	{
+		rohc_buf_byte_at(*feedback_send, feedback_send->len) = 0xf0;
+		rohc_buf_byte_at(*feedback_send, feedback_send->len + 1) = (*final_size);
+	}
+	feedback_data =
+		rohc_buf_data_at(*feedback_send, feedback_send->len + feedback_hdr_len);
+
+	/* CID, then feedback data */
+	if(!f_write_cid(cid, cid_type, feedback_cid_len, feedback_data))
+	{
+		goto error;
+	}
+	memcpy(feedback_data + feedback_cid_len, feedback->data, feedback->size);
 
-	/* add the CRC option if specified */
 	if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_OPT)
 	{
 #ifdef ROHC_FEEDBACK_DEBUG
 		printf("add CRC option to feedback\n");
 #endif
-		if(!f_add_option(feedback, ROHC_FEEDBACK_OPT_CRC, NULL, 0))
-		{
-#ifdef ROHC_FEEDBACK_DEBUG
-			printf("failed to add CRC option to the feedback packet\n");
-#endif
-			goto error;
-		}
-		/* CRC goes in the last byte of the feedback (CRC option is the last one) */
-		crc_pos = feedback->size - 1;
+		/* CRC option with 0x00 as data, the CRC goes in its last byte (CRC
+		 * option is the last one) */
+		crc_pos = feedback_cid_len + feedback->size;
+		feedback_data[crc_pos] = ((ROHC_FEEDBACK_OPT_CRC & 0xf) << 4) | 1;
+		crc_pos++;
+		feedback_data[crc_pos] = 0;
 	}
 	else if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_BASE)
 	{
@@ -445,37 +487,21 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
 		const size_t feedback_base_hdr_len = 2;
 		crc_pos = feedback_type_len + feedback_cid_len + feedback_base_hdr_len - 1;
 	}
-	else if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
-	{
-		assert(0);
-		goto error;
-	}
-
-	/* allocate memory for the feedback packet */
-	feedback_packet = (uint8_t *) malloc(feedback->size);
-	if(feedback_packet == NULL)
-	{
-		goto error;
-	}
-
-	/* duplicate the feedback packet */
-	memcpy(feedback_packet, feedback->data, feedback->size);
 
 	/* compute the CRC and store it in the feedback packet if specified */
 	if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
 	{
-		crc = crc_calculate(ROHC_CRC_TYPE_8, feedback_packet, feedback->size,
-		                    CRC_INIT_8);
-		feedback_packet[crc_pos] = crc;
+		feedback_data[crc_pos] =
+			crc_calculate(ROHC_CRC_TYPE_8, feedback_data, *final_size, CRC_INIT_8);
 	}
 
-	*final_size = feedback->size;
-	feedback->size = 0;
+	feedback_send->len += feedback_hdr_len + (*final_size);
 
-	return feedback_packet;
+skip:
+	feedback->size = 0;
+	return true;
 
 error:
 	feedback->size = 0;
-	return NULL;
+	return false;
 }
-
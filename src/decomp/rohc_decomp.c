@@ -54,6 +54,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <assert.h>
 
 
@@ -131,11 +132,15 @@ struct rohc_decomp_stream
 	                                if not identified) */
 	rohc_mode_t mode;          /**< The context mode (if context found) */
 	bool do_change_mode;       /**< The context mode shall be advertised */
+	/** The mode of the context before it transited to a new mode with the
+	 *  packet, ROHC_UNKNOWN_MODE if the context did not change its mode */
+	rohc_mode_t prev_mode;
 	rohc_decomp_state_t state; /**< The context state (if context found) */
 	uint32_t sn_bits;          /**< The SN LSB bits (if context found) */
 	size_t sn_bits_nr;         /**< The number of SN LSB bits (if context found) */
 	rohc_packet_t packet_type; /**< The type of the decompressed packet */
 	bool crc_failed;           /**< Whether the packet failed the CRC check or not */
+	struct rohc_ts arrival_time; /**< The arrival time of the packet */
 };
 
 
@@ -143,6 +148,11 @@ struct rohc_decomp_stream
  * Prototypes of private functions
  */
 
+static bool rohc_decomp_volat_ctxt_new(struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((nonnull(1), warn_unused_result));
+static void rohc_decomp_volat_ctxt_free(const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((nonnull(1)));
+
 static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
                                         const rohc_cid_t max_cid)
 	__attribute__((nonnull(1), warn_unused_result));
@@ -166,12 +176,34 @@ static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const de
 static void context_free(struct rohc_decomp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+static rohc_status_t rohc_decomp_decompress_pkt(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf rohc_packet,
+                                                struct rohc_buf *const uncomp_packet,
+                                                const bool in_place,
+                                                struct rohc_buf *const rcvd_feedback,
+                                                struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result, nonnull(1)));
+static const struct rohc_decomp_ctxt *
+	rohc_decomp_peek_context(const struct rohc_decomp *const decomp,
+	                         const struct rohc_buf rohc_packet)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_buf rohc_decomp_burst_tail(const struct rohc_buf *const buf)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_decomp_update_detailed_stats(struct rohc_decomp *const decomp,
+                                              const struct rohc_decomp_stream *const stream,
+                                              const rohc_status_t status,
+                                              const struct rohc_buf rohc_packet,
+                                              const struct rohc_buf *const uncomp_packet,
+                                              const uint64_t latency)
+	__attribute__((nonnull(1, 2, 5)));
+
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
+                                     const bool in_place,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
-	__attribute__((nonnull(1, 3, 5), warn_unused_result));
+	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
 static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
                                    const uint8_t *packet,
@@ -201,9 +233,10 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const bool in_place,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
-	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 8, 9)));
 
 static rohc_status_t rohc_decomp_try_decode_pkt(const struct rohc_decomp *const decomp,
                                                 const struct rohc_decomp_ctxt *const context,
@@ -255,6 +288,20 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
                                       const struct rohc_decomp_stream *const stream,
                                       struct rohc_buf *const feedback)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_decomp_feedback_pace(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_stream *const stream,
+                                      const enum rohc_feedback_ack_type ack_type,
+                                      const size_t feedback_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_decomp_feedback_cancel_mode(const struct rohc_decomp *const decomp,
+                                             const struct rohc_decomp_stream *const stream)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_feedback_bucket_conform(struct rohc_feedback_bucket *const bucket,
+                                         const struct rohc_feedback_pacing *const pacing,
+                                         const struct rohc_ts now,
+                                         const enum rohc_feedback_ack_type priority,
+                                         const uint64_t cost)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 /* statistics-related functions */
 static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
@@ -283,6 +330,76 @@ static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const de
 }
 
 
+/**
+ * @brief Create the volatile part of the decompression contexts
+ *
+ * The volatile part lasts one single packet, so the decompressor owns one
+ * single volatile part that is shared by all its contexts. It is sized for
+ * the profile that requires the largest one.
+ *
+ * @param[out] volat_ctxt  The volatile part to create
+ * @return                 true if the volatile part was successfully created,
+ *                         false if a problem occurred
+ */
+static bool rohc_decomp_volat_ctxt_new(struct rohc_decomp_volat_ctxt *const volat_ctxt)
+{
+	size_t extr_bits_max_size = 0;
+	size_t decoded_values_max_size = 0;
+	uint8_t profile_major;
+
+	for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
+	{
+		uint8_t profile_minor;
+
+		for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
+		{
+			const struct rohc_decomp_profile *const profile =
+				rohc_decomp_profiles[profile_major][profile_minor];
+
+			if(profile != NULL)
+			{
+				extr_bits_max_size =
+					rohc_max(extr_bits_max_size, profile->extr_bits_size);
+				decoded_values_max_size =
+					rohc_max(decoded_values_max_size, profile->decoded_values_size);
+			}
+		}
+	}
+
+	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
+	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
+	volat_ctxt->extr_bits = malloc(extr_bits_max_size);
+	if(volat_ctxt->extr_bits == NULL)
+	{
+		goto error;
+	}
+	volat_ctxt->decoded_values = malloc(decoded_values_max_size);
+	if(volat_ctxt->decoded_values == NULL)
+	{
+		goto free_extr_bits;
+	}
+
+	return true;
+
+free_extr_bits:
+	zfree(volat_ctxt->extr_bits);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy the volatile part of the decompression contexts
+ *
+ * @param volat_ctxt  The volatile part to destroy
+ */
+static void rohc_decomp_volat_ctxt_free(const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+{
+	free(volat_ctxt->decoded_values);
+	free(volat_ctxt->extr_bits);
+}
+
+
 /**
  * @brief Create one new decompression context with profile specific data.
  *
@@ -300,7 +417,7 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	assert(cid <= ROHC_LARGE_CID_MAX);
 
 	/* allocate memory for the decompression context */
-	context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
+	context = rohc_arena_malloc(&decomp->arena, sizeof(struct rohc_decomp_ctxt));
 	if(context == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
@@ -329,6 +446,7 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent = 0;
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed = 0;
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
+	context->feedback_bucket.is_init = false;
 
 	/* init the context for packet/context corrections upon CRC failures */
 	/* at the beginning, no attempt to correct CRC failure */
@@ -359,7 +477,7 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 
 	/* create the profile-specific parts of the decompression context (performed
 	 * at the every end so that everything is initialized in context first) */
-	if(!profile->new_context(context, &context->persist_ctxt, &context->volat_ctxt))
+	if(!profile->new_context(context, &context->persist_ctxt))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
 		             "failed to initialize the profile-specific parts of the "
@@ -375,7 +493,7 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	return context;
 
 destroy_context:
-	zfree(context);
+	rohc_arena_free(context);
 error:
 	return NULL;
 }
@@ -396,14 +514,14 @@ static void context_free(struct rohc_decomp_ctxt *const context)
 	           "free context with CID %u", context->cid);
 
 	/* destroy the profile-specific data */
-	context->profile->free_context(context->persist_ctxt, &context->volat_ctxt);
+	context->profile->free_context(context->persist_ctxt);
 
 	/* decompressor got one more context */
 	assert(context->decompressor->num_contexts_used > 0);
 	context->decompressor->num_contexts_used--;
 
 	/* destroy the context itself */
-	free(context);
+	rohc_arena_free(context);
 }
 
 
@@ -457,6 +575,7 @@ static void context_free(struct rohc_decomp_ctxt *const context)
  * @see rohc_decomp_free
  * @see rohc_decompress3
  * @see rohc_decomp_set_traces_cb2
+ * @see rohc_decomp_set_traces_min_level
  * @see rohc_decomp_enable_profiles
  * @see rohc_decomp_enable_profile
  * @see rohc_decomp_disable_profiles
@@ -516,6 +635,7 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	/* no trace callback during decompressor creation */
 	decomp->trace_callback = NULL;
 	decomp->trace_callback_priv = NULL;
+	decomp->trace_min_level = ROHC_TRACE_DEBUG;
 
 	/* default feature set (empty for the moment) */
 	decomp->features = ROHC_DECOMP_FEATURE_NONE;
@@ -538,13 +658,23 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	/* the operational mode the decompressor shall target for all its contexts */
 	decomp->target_mode = mode;
 
+	/* no slab allocator for the decompression contexts by default */
+	rohc_arena_init(&decomp->arena, 0);
+
+	/* the volatile part of the decompression contexts is shared by all the
+	 * contexts since it lasts one single packet */
+	if(!rohc_decomp_volat_ctxt_new(&decomp->volat_ctxt))
+	{
+		goto destroy_decomp;
+	}
+
 	/* initialize the array of decompression contexts to its minimal value */
 	decomp->contexts = NULL;
 	decomp->num_contexts_used = 0;
 	is_fine = rohc_decomp_create_contexts(decomp, decomp->medium.max_cid);
 	if(!is_fine)
 	{
-		goto destroy_decomp;
+		goto free_volat_ctxt;
 	}
 	decomp->last_context = NULL;
 
@@ -566,6 +696,13 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
 	}
 
+	/* no feedback pacing by default */
+	decomp->channel_pacing.rate = 0;
+	decomp->channel_pacing.burst = 0;
+	decomp->ctxt_pacing.rate = 0;
+	decomp->ctxt_pacing.burst = 0;
+	decomp->channel_bucket.is_init = false;
+
 	/* no Reconstructed Reception Unit (RRU) at the moment */
 	decomp->rru_len = 0;
 	/* no segmentation by default */
@@ -577,6 +714,8 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 
 	return decomp;
 
+free_volat_ctxt:
+	rohc_decomp_volat_ctxt_free(&decomp->volat_ctxt);
 destroy_decomp:
 	free(decomp);
 error:
@@ -632,6 +771,7 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 	}
 	zfree(decomp->contexts);
 	assert(decomp->num_contexts_used == 0);
+	rohc_arena_free_all(&decomp->arena);
 
 	/* free RRU buffer */
 	if(decomp->rru != NULL)
@@ -639,6 +779,9 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 		zfree(decomp->rru);
 	}
 
+	/* free the volatile part shared by all the contexts */
+	rohc_decomp_volat_ctxt_free(&decomp->volat_ctxt);
+
 	/* destroy the decompressor itself */
 	free(decomp);
 
@@ -720,14 +863,463 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
                                struct rohc_buf *const rcvd_feedback,
                                struct rohc_buf *const feedback_send)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	struct rohc_decomp_stream stream;
+	/* check decompressor validity */
+	if(decomp == NULL)
+	{
+		return ROHC_STATUS_ERROR;
+	}
+
+	return rohc_decomp_decompress_pkt(decomp, rohc_packet, uncomp_packet, false,
+	                                  rcvd_feedback, feedback_send);
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet in place
+ *
+ * Decompress the given ROHC packet without copying its payload: the
+ * uncompressed headers are written directly in front of the payload of the
+ * ROHC packet, over the ROHC header and the headroom of the buffer. On
+ * success, \e packet is updated to describe the uncompressed packet that
+ * is stored in the same memory as the ROHC packet.
+ *
+ * The ROHC packet shall be given with enough headroom in its buffer, ie.
+ * \e packet->offset shall be greater than 0 and large enough for the
+ * uncompressed headers. \ref ROHC_STATUS_OUTPUT_TOO_SMALL is returned if
+ * the headroom is too small for the uncompressed headers; the ROHC packet
+ * is then left unchanged, but the headroom may have been overwritten.
+ *
+ * The result is otherwise the same as with \ref rohc_decompress3: the
+ * uncompressed packet might be empty if the ROHC packet contained only
+ * feedback data or if the ROHC packet was not a final segment, \e packet
+ * then describes an empty buffer with the same maximum length. ROHC packets
+ * reassembled from several segments cannot be decompressed in place since
+ * their payload is not stored in the given buffer, \ref ROHC_STATUS_ERROR
+ * is returned for them.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[in,out] packet      IN:  The compressed packet to decompress, with
+ *                                 headroom for the uncompressed headers
+ *                            OUT: The resulting uncompressed packet, stored
+ *                                 in the same buffer, in case of success
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel, may be NULL to ignore the
+ *                            received feedback data
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor through the feedback channel, may be
+ *                            NULL to generate no feedback
+ * @return                    The status of the decompression, see
+ *                            \ref rohc_decompress3 for possible values
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_in_place(struct rohc_decomp *const decomp,
+                                       struct rohc_buf *const packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf uncomp_packet;
+	rohc_status_t status = ROHC_STATUS_ERROR;
 
 	/* check inputs validity */
 	if(decomp == NULL)
 	{
 		goto error;
 	}
+	if(packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is malformed");
+		goto error;
+	}
+	if(packet->offset == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet has no headroom for the uncompressed headers");
+		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+		goto error;
+	}
+
+	/* the uncompressed headers are built in the headroom of the ROHC packet,
+	 * then moved in front of the payload once the ROHC header is decoded */
+	uncomp_packet.time = packet->time;
+	uncomp_packet.data = packet->data;
+	uncomp_packet.max_len = packet->offset;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
+
+	status = rohc_decomp_decompress_pkt(decomp, *packet, &uncomp_packet, true,
+	                                    rcvd_feedback, feedback_send);
+	if(status == ROHC_STATUS_OK)
+	{
+		/* the uncompressed packet is stored in the whole buffer of the ROHC
+		 * packet, even if it is empty because the ROHC packet contained only
+		 * feedback data or was not a final segment */
+		uncomp_packet.max_len = packet->max_len;
+		*packet = uncomp_packet;
+	}
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress a burst of ROHC packets into uncompressed packets
+ *
+ * Decompress the \e pkts_nr ROHC packets of the \e rohc_packets array into
+ * the \e pkts_nr uncompressed packets of the \e uncomp_packets array. The
+ * status of the decompression of every packet is stored in the \e statuses
+ * array.
+ *
+ * The result is the same as calling \ref rohc_decompress3 once for every
+ * packet of the burst, in the order of the burst: the decompression of one
+ * packet may create or update the context used by the next packets, and
+ * the failure to decompress one packet does not stop the decompression of
+ * the next packets of the burst. The arguments common to all the packets
+ * are however checked once per burst, and the contexts of the next packets
+ * are prefetched while the current packet is decompressed.
+ *
+ * The feedback received for the same-side associated compressor and the
+ * feedback to be transmitted to the remote compressor are aggregated for
+ * the whole burst: the feedback items of all the packets are appended one
+ * after the other in \e rcvd_feedback and \e feedback_send. Feedback items
+ * that do not fit in the remaining space are dropped, as with
+ * \ref rohc_decompress3.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param rohc_packets         The compressed packets to decompress
+ * @param[out] uncomp_packets  The resulting uncompressed packets, every
+ *                             buffer shall be empty before the call
+ * @param[out] statuses        The status of the decompression of every
+ *                             packet, see \ref rohc_decompress3 for possible
+ *                             values
+ * @param pkts_nr              The number of packets in the burst
+ * @param[out] rcvd_feedback   The feedback received from the remote peer
+ *                             for the same-side associated ROHC compressor
+ *                             in all the packets of the burst, may be NULL
+ *                             to ignore the received feedback data
+ * @param[out] feedback_send   The feedback to be transmitted to the remote
+ *                             compressor for all the packets of the burst,
+ *                             may be NULL to generate no feedback
+ * @return                     The number of packets that were successfully
+ *                             decompressed, ie. with status
+ *                             \ref ROHC_STATUS_OK
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+size_t rohc_decompress_burst(struct rohc_decomp *const decomp,
+                             const struct rohc_buf *const rohc_packets,
+                             struct rohc_buf *const uncomp_packets,
+                             rohc_status_t *const statuses,
+                             const size_t pkts_nr,
+                             struct rohc_buf *const rcvd_feedback,
+                             struct rohc_buf *const feedback_send)
+{
+	size_t ok_pkts_nr = 0;
+	size_t i;
+
+	/* check inputs validity once for the whole burst */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(statuses == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given statuses is NULL");
+		goto error;
+	}
+	if(pkts_nr > 0 && (rohc_packets == NULL || uncomp_packets == NULL))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packets or uncomp_packets is NULL");
+		goto error;
+	}
+	if(rcvd_feedback != NULL)
+	{
+		if(rohc_buf_is_malformed(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is not empty");
+			goto error;
+		}
+	}
+	if(feedback_send != NULL)
+	{
+		if(rohc_buf_is_malformed(*feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is not empty");
+			goto error;
+		}
+	}
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		struct rohc_buf pkt_rcvd_feedback;
+		struct rohc_buf pkt_feedback_send;
+
+		/* prefetch the context of the packet after the next one, then the
+		 * profile-specific part of the context of the next packet: the
+		 * contexts are looked up again just before use since decompressing
+		 * the current packet may create or destroy contexts */
+		if((i + 2) < pkts_nr)
+		{
+			const struct rohc_decomp_ctxt *const ctxt =
+				rohc_decomp_peek_context(decomp, rohc_packets[i + 2]);
+			if(ctxt != NULL)
+			{
+				__builtin_prefetch(ctxt, 1, 3);
+			}
+		}
+		if((i + 1) < pkts_nr)
+		{
+			const struct rohc_decomp_ctxt *const ctxt =
+				rohc_decomp_peek_context(decomp, rohc_packets[i + 1]);
+			if(ctxt != NULL && ctxt->persist_ctxt != NULL)
+			{
+				__builtin_prefetch(ctxt->persist_ctxt, 1, 3);
+			}
+		}
+
+		/* feedback of the current packet is appended to the one of the
+		 * previous packets of the burst */
+		if(rcvd_feedback != NULL)
+		{
+			pkt_rcvd_feedback = rohc_decomp_burst_tail(rcvd_feedback);
+		}
+		if(feedback_send != NULL)
+		{
+			pkt_feedback_send = rohc_decomp_burst_tail(feedback_send);
+		}
+
+		statuses[i] =
+			rohc_decomp_decompress_pkt(decomp, rohc_packets[i], &(uncomp_packets[i]),
+			                           false, rcvd_feedback != NULL ? &pkt_rcvd_feedback : NULL,
+			                           feedback_send != NULL ? &pkt_feedback_send : NULL);
+		if(statuses[i] == ROHC_STATUS_OK)
+		{
+			ok_pkts_nr++;
+		}
+
+		if(rcvd_feedback != NULL)
+		{
+			rcvd_feedback->len += pkt_rcvd_feedback.len;
+		}
+		if(feedback_send != NULL)
+		{
+			feedback_send->len += pkt_feedback_send.len;
+		}
+	}
+
+	return ok_pkts_nr;
+
+error:
+	if(statuses != NULL)
+	{
+		for(i = 0; i < pkts_nr; i++)
+		{
+			statuses[i] = ROHC_STATUS_ERROR;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Get an empty buffer over the free space at the end of a buffer
+ *
+ * Used by \ref rohc_decompress_burst to append the feedback of every packet
+ * of the burst to the feedback of the previous packets.
+ *
+ * @param buf  The buffer that aggregates the data of the burst
+ * @return     The empty buffer that starts just after the data of \e buf
+ */
+static struct rohc_buf rohc_decomp_burst_tail(const struct rohc_buf *const buf)
+{
+	struct rohc_buf tail = *buf;
+
+	tail.offset += buf->len;
+	tail.len = 0;
+
+	return tail;
+}
+
+
+/**
+ * @brief Guess the decompression context of the given ROHC packet
+ *
+ * Parse the CID of the ROHC packet in a lightweight way in order to prefetch
+ * the decompression context before the packet is actually decompressed. The
+ * result is a hint only: the context may be replaced during decompression if
+ * the packet is an IR packet.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet to guess the context for
+ * @return             The decompression context that the packet is likely
+ *                     to use, NULL if not found
+ */
+static const struct rohc_decomp_ctxt *
+	rohc_decomp_peek_context(const struct rohc_decomp *const decomp,
+	                         const struct rohc_buf rohc_packet)
+{
+	rohc_cid_t cid;
+
+	if(!rohc_decomp_peek_cid(decomp, rohc_packet, &cid))
+	{
+		return NULL;
+	}
+
+	return decomp->contexts[cid];
+}
+
+
+/**
+ * @brief Parse the CID of the given ROHC packet
+ *
+ * Skip the padding and the feedback items at the beginning of the ROHC
+ * packet, then parse the Add-CID or the large CID in a lightweight way. The
+ * packet is not checked any further, and it is not decompressed.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet to parse the CID of
+ * @param[out] cid     The CID of the ROHC packet
+ * @return             true if the CID was parsed,
+ *                     false if the packet is malformed, if it contains
+ *                     no compressed packet, or if the CID is greater than
+ *                     MAX_CID
+ */
+bool rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                          const struct rohc_buf rohc_packet,
+                          rohc_cid_t *const cid)
+{
+	struct rohc_buf remain_data = rohc_packet;
+
+	/* do not read the bytes of a malformed buffer */
+	if(rohc_buf_is_malformed(rohc_packet))
+	{
+		goto error;
+	}
+
+	/* skip padding */
+	while(remain_data.len > 0 &&
+	      rohc_decomp_packet_is_padding(rohc_buf_data(remain_data)))
+	{
+		rohc_buf_pull(&remain_data, 1);
+	}
+
+	/* skip feedback items */
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len) ||
+		   (feedback_hdr_len + feedback_data_len) > remain_data.len)
+		{
+			goto error;
+		}
+		rohc_buf_pull(&remain_data, feedback_hdr_len + feedback_data_len);
+	}
+	if(remain_data.len == 0)
+	{
+		goto error;
+	}
+
+	/* parse the Add-CID or the large CID */
+	if(decomp->medium.cid_type == ROHC_SMALL_CID)
+	{
+		*cid = rohc_add_cid_decode(rohc_buf_data(remain_data), remain_data.len);
+		if((*cid) == UINT8_MAX)
+		{
+			*cid = 0;
+		}
+	}
+	else if(remain_data.len >= 2 && (rohc_buf_byte_at(remain_data, 1) & 0x80) == 0)
+	{
+		*cid = rohc_buf_byte_at(remain_data, 1);
+	}
+	else if(remain_data.len >= 3 &&
+	        (rohc_buf_byte_at(remain_data, 1) & 0xc0) == 0x80)
+	{
+		*cid = ((rohc_buf_byte_at(remain_data, 1) & 0x3f) << 8) |
+		       rohc_buf_byte_at(remain_data, 2);
+	}
+	else
+	{
+		goto error;
+	}
+
+	if((*cid) > decomp->medium.max_cid)
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet into one uncompressed packet
+ *
+ * The ROHC decompressor shall be valid, see \ref rohc_decompress3 for
+ * details about the other parameters.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param in_place            Whether the uncompressed headers shall be built
+ *                            in front of the payload of the ROHC packet or
+ *                            not, see \ref rohc_decompress_in_place
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor through the feedback channel
+ * @return                    The status of the decompression, see
+ *                            \ref rohc_decompress3 for possible values
+ */
+static rohc_status_t rohc_decomp_decompress_pkt(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf rohc_packet,
+                                                struct rohc_buf *const uncomp_packet,
+                                                const bool in_place,
+                                                struct rohc_buf *const rcvd_feedback,
+                                                struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_decomp_stream stream;
+	bool do_stats = false;
+	uint64_t start_ticks = 0;
+
+	/* check inputs validity */
 	if(rohc_buf_is_malformed(rohc_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -789,22 +1381,30 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 		}
 	}
 
+	/* start measuring the time spent to decompress the packet */
+	if((decomp->features & ROHC_DECOMP_FEATURE_STATS) != 0)
+	{
+		do_stats = true;
+		start_ticks = rohc_stats_get_ticks();
+	}
+
 	decomp->stats.received++;
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
+	           "decompress the %zu-byte packet #%" PRIu64, rohc_packet.len,
 	           decomp->stats.received);
 
 	/* print compressed bytes */
 	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 decomp->trace_min_level,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
 		                 "compressed data, max 100 bytes", rohc_packet);
 	}
 
 	/* decode ROHC header */
-	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
-	                         &stream);
+	status = d_decode_header(decomp, rohc_packet, uncomp_packet, in_place,
+	                         rcvd_feedback, &stream);
 	assert(status != ROHC_STATUS_SEGMENT);
 
 	/* handle mode transitions if context was found and it is still valid */
@@ -821,6 +1421,7 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 			{
 				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
 				           "transit from U-mode to O-mode as requested by user");
+				stream.prev_mode = stream.context->mode;
 				stream.context->mode = ROHC_O_MODE;
 				/* ACK(O), NACK(O) or STATIC-NACK(O) will transmit the mode
 				 * transition to the remote compressor */
@@ -943,16 +1544,74 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 	}
 
 error:
+	/* update the detailed statistics if asked by user */
+	if(do_stats)
+	{
+		rohc_decomp_update_detailed_stats(decomp, &stream, status, rohc_packet,
+		                                  uncomp_packet,
+		                                  rohc_stats_get_ticks() - start_ticks);
+	}
 	return status;
 }
 
 
+/**
+ * @brief Update the detailed statistics of the decompressor for one packet
+ *
+ * @param decomp         The ROHC decompressor
+ * @param stream         The information about the decompressed stream
+ * @param status         The status of the decompression of the packet
+ * @param rohc_packet    The compressed packet
+ * @param uncomp_packet  The resulting uncompressed packet
+ * @param latency        The time spent to decompress the packet (in ticks)
+ */
+static void rohc_decomp_update_detailed_stats(struct rohc_decomp *const decomp,
+                                              const struct rohc_decomp_stream *const stream,
+                                              const rohc_status_t status,
+                                              const struct rohc_buf rohc_packet,
+                                              const struct rohc_buf *const uncomp_packet,
+                                              const uint64_t latency)
+{
+	struct rohc_decomp_stats *const stats = &decomp->detailed_stats;
+
+	rohc_stats_write_begin(&decomp->detailed_stats_seq);
+	if(status != ROHC_STATUS_OK)
+	{
+		rohc_stats_add(&stats->failures_nr, 1);
+	}
+	else if(uncomp_packet->len > 0)
+	{
+		/* feedback-only packets do not carry any compressed packet */
+		const uint8_t profile_major = (stream->profile_id >> 8) & 0xff;
+		const uint8_t profile_minor = stream->profile_id & 0xff;
+
+		rohc_stats_add(&stats->packets_nr, 1);
+		rohc_stats_add(&stats->comp_bytes_nr, rohc_packet.len);
+		rohc_stats_add(&stats->uncomp_bytes_nr, uncomp_packet->len);
+		if(profile_major <= ROHC_PROFILE_ID_MAJOR_MAX &&
+		   profile_minor <= ROHC_PROFILE_ID_MINOR_MAX)
+		{
+			rohc_stats_add(&stats->profiles_nr[profile_major][profile_minor], 1);
+		}
+		if(stream->packet_type < ROHC_PACKET_MAX)
+		{
+			rohc_stats_add(&stats->pkt_types_nr[stream->packet_type], 1);
+		}
+	}
+	rohc_stats_add(&stats->latency_hist[rohc_stats_get_latency_bucket(latency)], 1);
+	rohc_stats_write_end(&decomp->detailed_stats_seq);
+}
+
+
 /**
  * @brief Decompress the compressed headers.
  *
  * @param decomp              The ROHC decompressor
  * @param rohc_packet         The ROHC packet to decode
  * @param[out] uncomp_packet  The uncompressed packet
+ * @param in_place            Whether the uncompressed headers shall be built
+ *                            in front of the payload of the ROHC packet or
+ *                            not, see \ref rohc_decompress_in_place
  * @param[out] rcvd_feedback  The feedback received from the remote peer for
  *                            the same-side associated ROHC compressor through
  *                            the feedback channel:
@@ -975,6 +1634,7 @@ error:
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
+                                     const bool in_place,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
 {
@@ -1000,10 +1660,12 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	stream->mode = ROHC_UNKNOWN_MODE;
 	stream->state = ROHC_DECOMP_STATE_UNKNOWN;
 	stream->do_change_mode = false;
+	stream->prev_mode = ROHC_UNKNOWN_MODE;
 	stream->sn_bits = 0; /* must be set to 0 until we get some bits */
 	stream->sn_bits_nr = 0;
 	stream->packet_type = ROHC_PACKET_UNKNOWN;
 	stream->crc_failed = false;
+	stream->arrival_time = rohc_packet.time;
 
 	/* empty ROHC packets are not considered as valid */
 	if(remain_rohc_data.len < 1)
@@ -1264,7 +1926,8 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	 * (may change the initial assumption about the packet type) */
 	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
 	                                add_cid_len, large_cid_len, uncomp_packet,
-	                                &stream->packet_type, &stream->do_change_mode);
+	                                in_place, &stream->packet_type,
+	                                &stream->do_change_mode);
 	if(status != ROHC_STATUS_OK)
 	{
 		/* decompression failed, free resources if necessary */
@@ -1283,11 +1946,26 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	 * new one if necessary */
 	if(is_new_context)
 	{
-		if(decomp->contexts[stream->cid] != NULL)
+		const bool is_ctxt_replaced = (decomp->contexts[stream->cid] != NULL);
+
+		if(is_ctxt_replaced)
 		{
 			context_free(decomp->contexts[stream->cid]);
 		}
 		decomp->contexts[stream->cid] = stream->context;
+
+		/* update the detailed statistics if asked by user */
+		if((decomp->features & ROHC_DECOMP_FEATURE_STATS) != 0)
+		{
+			struct rohc_decomp_stats *const stats = &decomp->detailed_stats;
+
+			rohc_stats_write_begin(&decomp->detailed_stats_seq);
+			rohc_stats_add(&stats->ctxt_creations_nr, 1);
+			rohc_stats_add(&stats->ctxt_evictions_nr, is_ctxt_replaced);
+			rohc_stats_add(&stats->ctxt_replications_nr,
+			               stream->packet_type == ROHC_PACKET_IR_CR);
+			rohc_stats_write_end(&decomp->detailed_stats_seq);
+		}
 	}
 
 	/* get the SN of the latest packet successfully decompressed */
@@ -1330,7 +2008,8 @@ error_no_context:
  *  \li C. Decode extracted bits
  *  \li D. Build uncompressed headers (and check for correct decompression
  *         for UO* packets)
- *  \li E. Copy the payload (if any)
+ *  \li E. Copy the payload (if any), or move the uncompressed headers in
+ *         front of the payload for in-place decompression
  *  \li F. Update the compression context
  *
  * Steps C and D may be repeated if packet or context repair is attempted
@@ -1342,6 +2021,9 @@ error_no_context:
  * @param add_cid_len          The length of the optional Add-CID field
  * @param large_cid_len        The length of the optional large CID field
  * @param[out] uncomp_packet   The uncompressed packet
+ * @param in_place             Whether the uncompressed headers shall be built
+ *                             in front of the payload of the ROHC packet or
+ *                             not, see \ref rohc_decompress_in_place
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
  * @param[out] do_change_mode  Whether the profile context wants to change
@@ -1357,13 +2039,14 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const bool in_place,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
 {
 	const struct rohc_decomp_profile *const profile = context->profile;
-	struct rohc_decomp_crc *const extr_crc_bits = &context->volat_ctxt.crc;
-	void *const extr_bits = context->volat_ctxt.extr_bits;
-	void *const decoded_values = context->volat_ctxt.decoded_values;
+	struct rohc_decomp_crc *const extr_crc_bits = &decomp->volat_ctxt.crc;
+	void *const extr_bits = decomp->volat_ctxt.extr_bits;
+	void *const decoded_values = decomp->volat_ctxt.decoded_values;
 
 	/* length of the parsed ROHC header and of the uncompressed headers */
 	size_t rohc_hdr_len;
@@ -1375,6 +2058,8 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 
 	/* Whether to attempt packet correction or not */
 	bool try_decoding_again;
+	/* The length of the uncompressed packet before headers are built */
+	size_t uncomp_packet_len;
 
 	/* helper variables for values returned by functions */
 	bool parsing_ok;
@@ -1430,6 +2115,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
+				              decomp->trace_min_level,
 				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
 				              rohc_buf_data(rohc_packet) - add_cid_len,
 				              rohc_hdr_len + add_cid_len);
@@ -1446,14 +2132,18 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 
 
 	try_decoding_again = false;
+	uncomp_packet_len = uncomp_packet->len;
 	do
 	{
 		rohc_status_t decode_ret;
 
 		if(try_decoding_again)
 		{
+			/* the repair engine already checked the CRC of the hypothesis it
+			 * selected, so headers are built once again, for that hypothesis */
 			rohc_decomp_warn(context, "CID %u: CRC repair: try decoding packet "
 			                 "again with new assumptions", context->cid);
+			uncomp_packet->len = uncomp_packet_len;
 		}
 
 
@@ -1496,10 +2186,18 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			/* uncompressed headers successfully built but CRC is incorrect,
 			 * try decoding with different values (repair) */
 
-			/* attempt a context/packet repair */
+			/* attempt a context/packet repair: the profile evaluates its
+			 * hypotheses without building the headers again */
 			try_decoding_again =
 				profile->attempt_repair(decomp, context, rohc_packet.time,
 				                        &context->crc_corr, extr_bits);
+			if(try_decoding_again &&
+			   (decomp->features & ROHC_DECOMP_FEATURE_STATS) != 0)
+			{
+				rohc_stats_write_begin(&decomp->detailed_stats_seq);
+				rohc_stats_add(&decomp->detailed_stats.crc_repairs_nr, 1);
+				rohc_stats_write_end(&decomp->detailed_stats_seq);
+			}
 
 			/* report CRC failure if attempt is not possible */
 			if(!try_decoding_again)
@@ -1511,6 +2209,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 				{
 					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+					                 decomp->trace_min_level,
 					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 					                 "compressed headers", rohc_packet);
 				}
@@ -1523,6 +2222,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+				                 decomp->trace_min_level,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				                 "compressed headers", rohc_packet);
 			}
@@ -1557,6 +2257,12 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			                 "successful, keep packet", context->cid);
 			context->corrected_crc_failures++;
 			decomp->stats.corrected_crc_failures++;
+			if((decomp->features & ROHC_DECOMP_FEATURE_STATS) != 0)
+			{
+				rohc_stats_write_begin(&decomp->detailed_stats_seq);
+				rohc_stats_add(&decomp->detailed_stats.crc_repairs_ok_nr, 1);
+				rohc_stats_write_end(&decomp->detailed_stats_seq);
+			}
 			switch(context->crc_corr.algo)
 			{
 				case ROHC_DECOMP_CRC_CORR_SN_WRAP:
@@ -1581,7 +2287,6 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		}
 	}
 	uncomp_hdr_len = uncomp_packet->len;
-	rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
 
 
 	/* E. Copy the payload (if any) */
@@ -1595,21 +2300,49 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		status = ROHC_STATUS_ERROR;
 		goto error;
 	}
-	if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+	if(in_place)
 	{
-		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
-		                 "max) for the %zu-byte payload",
-		                 rohc_buf_avail_len(*uncomp_packet), payload_len);
-		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
-		goto error;
+		uint8_t *uncomp_hdrs_data;
+
+		/* the payload of a packet reassembled from ROHC segments is not stored
+		 * in the buffer given by the user */
+		if(rohc_packet.data != uncomp_packet->data)
+		{
+			rohc_decomp_warn(context, "ROHC packet reassembled from segments "
+			                 "cannot be decompressed in place");
+			status = ROHC_STATUS_ERROR;
+			goto error;
+		}
+
+		/* the uncompressed headers were built in the headroom of the ROHC
+		 * packet, move them in front of the payload: they are never larger
+		 * than the headroom, so they always fit in the headroom and the ROHC
+		 * header that is not needed anymore */
+		uncomp_hdrs_data = (uint8_t *) payload_data - uncomp_hdr_len;
+		memmove(uncomp_hdrs_data, rohc_buf_data(*uncomp_packet), uncomp_hdr_len);
+		uncomp_packet->offset = uncomp_hdrs_data - uncomp_packet->data;
+		uncomp_packet->max_len = rohc_packet.max_len;
+		uncomp_packet->len = uncomp_hdr_len + payload_len;
 	}
-	if(payload_len != 0)
+	else
 	{
-		rohc_buf_append(uncomp_packet, payload_data, payload_len);
-		rohc_buf_pull(uncomp_packet, payload_len);
+		rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+		if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+		{
+			rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+			                 "max) for the %zu-byte payload",
+			                 rohc_buf_avail_len(*uncomp_packet), payload_len);
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			goto error;
+		}
+		if(payload_len != 0)
+		{
+			rohc_buf_append(uncomp_packet, payload_data, payload_len);
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
+		/* unhide the uncompressed headers and payload */
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
 	}
-	/* unhide the uncompressed headers and payload */
-	rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
 	rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
 	                  uncomp_packet->len);
 
@@ -1949,11 +2682,10 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 	}
 	else
 	{
+		const size_t feedback_len_before = feedback->len;
 		rohc_feedback_crc_t crc_present;
 		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
 		size_t feedbacksize;
-		size_t feedback_hdr_len;
 
 		/* FEEDBACK-1 or FEEDBACK-2 ? */
 		if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED ||
@@ -1994,44 +2726,36 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 			}
 		}
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, &feedbacksize);
-		if(feedbackp == NULL)
+		/* build the feedback packet directly in the buffer provided by the user */
+		if(!f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
+		                    crc_present, feedback, &feedbacksize))
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			             "failed to wrap the ACK feedback");
 			goto error;
 		}
 
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
+		/* pace the ACK on the feedback channel, retry with next packets if
+		 * the ACK is suppressed */
+		if(feedback->len > feedback_len_before &&
+		   !rohc_decomp_feedback_pace(decomp, infos, ROHC_FEEDBACK_ACK,
+		                              feedback->len - feedback_len_before))
 		{
-			if(feedbacksize < 8)
-			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
-			}
-			else
-			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
-			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
+			feedback->len = feedback_len_before;
+			decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent &= ~((uint32_t) 1);
+			infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent &= ~((uint32_t) 1);
+			rohc_decomp_feedback_cancel_mode(decomp, infos);
 		}
 
-		if(feedback->len > 0)
+		if(feedback->len > feedback_len_before)
 		{
+			const size_t feedback_len = feedback->len - feedback_len_before;
+
 			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			           "decompressor built a %zu-byte positive feedback "
-			           "(header = %zu bytes, data = %zu bytes)", feedback->len,
-			           feedback_hdr_len, feedbacksize);
+			           "(header = %zu bytes, data = %zu bytes)", feedback_len,
+			           feedback_len - feedbacksize, feedbacksize);
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
 	}
 
 skip:
@@ -2287,11 +3011,10 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 	}
 	else
 	{
+		const size_t feedback_len_before = feedback->len;
 		rohc_feedback_crc_t crc_present;
 		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
 		size_t feedbacksize;
-		size_t feedback_hdr_len;
 
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 		           "should send a negative ACK (CID = %u, NACK type = %d, current "
@@ -2313,104 +3036,297 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 		           "FEEDBACK-2 is %d-byte long", sfeedback.size);
 
-		/* use CRC option if mode change requested */
-		if(infos->profile_id == ROHC_PROFILE_TCP ||
-		   rohc_profile_is_rohcv2(infos->profile_id))
-		{
-			crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
-		}
-		else if(infos->do_change_mode)
+		/* use CRC option if mode change requested */
+		if(infos->profile_id == ROHC_PROFILE_TCP ||
+		   rohc_profile_is_rohcv2(infos->profile_id))
+		{
+			crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
+		}
+		else if(infos->do_change_mode)
+		{
+			crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
+		}
+		else
+		{
+			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
+		}
+
+		/* build the feedback packet directly in the buffer provided by the user */
+		if(!f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
+		                    crc_present, feedback, &feedbacksize))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			             "failed to wrap the (STATIC-)NACK feedback");
+			goto error;
+		}
+
+		/* pace the (STATIC-)NACK on the feedback channel */
+		if(feedback->len > feedback_len_before &&
+		   !rohc_decomp_feedback_pace(decomp, infos, ack_type,
+		                              feedback->len - feedback_len_before))
+		{
+			feedback->len = feedback_len_before;
+			if(!do_downward_transition)
+			{
+				decomp->last_pkt_feedbacks[ack_type].sent &= ~((uint32_t) 1);
+				if(infos->context != NULL)
+				{
+					infos->context->last_pkt_feedbacks[ack_type].sent &= ~((uint32_t) 1);
+				}
+			}
+			rohc_decomp_feedback_cancel_mode(decomp, infos);
+		}
+
+		if(feedback->len > feedback_len_before)
+		{
+			const size_t feedback_len = feedback->len - feedback_len_before;
+
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "decompressor built a %zu-byte negative feedback (%zu bytes "
+			           "of header + %zu bytes of data)", feedback_len,
+			           feedback_len - feedbacksize, feedbacksize);
+		}
+	}
+
+	/* upon decompression failure, perform downward transitions if context is
+	 * still available (new contexts are destroyed upon decompression error) */
+	if(!do_downward_transition || infos->context == NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not perform a downward state transition");
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "perform a downward state transition now (CID = %u, NACK "
+		           "type = %d, current mode = %d, target mode = %d, rate-limiting "
+		           "= %zu of 3200 with threshold %zu and %zu of 3200 with "
+		           "threshold %zu)", infos->cid, ack_type, infos->mode,
+		           decomp->target_mode, k_too_quickly, threshold_too_quickly,
+		           k_too_many, decomp->ack_rate_limits.speed.threshold);
+
+		if(infos->state == ROHC_DECOMP_STATE_SC)
+		{
+			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			          "change from state %d to state %d because of error(s)",
+			          infos->state, ROHC_DECOMP_STATE_NC);
+			infos->context->state = ROHC_DECOMP_STATE_NC;
+		}
+		else if(infos->state == ROHC_DECOMP_STATE_FC)
+		{
+			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			          "change from state %d to state %d because of error(s)",
+			          infos->state, ROHC_DECOMP_STATE_SC);
+			infos->context->state = ROHC_DECOMP_STATE_SC;
+		}
+		else
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "stay in state %d because of error(s)", infos->context->state);
+		}
+	}
+
+skip:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Pace one feedback on the feedback channel
+ *
+ * The feedback is sent only if both the token bucket of the feedback channel
+ * and the token bucket of the context hold enough tokens for it. Feedbacks
+ * have different priorities: ACKs cannot use the last half of the buckets and
+ * NACKs cannot use their last quarter, so that the more important feedbacks
+ * are not delayed by bursts of less important ones.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param stream        The information about the decompressed stream
+ * @param ack_type      The type of the feedback
+ * @param feedback_len  The length of the feedback (in bytes)
+ * @return              true if the feedback may be sent,
+ *                      false if the feedback shall be suppressed
+ */
+static bool rohc_decomp_feedback_pace(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_stream *const stream,
+                                      const enum rohc_feedback_ack_type ack_type,
+                                      const size_t feedback_len)
+{
+	const uint64_t cost = ((uint64_t) feedback_len) * 1000000000U;
+	struct rohc_feedback_bucket *ctxt_bucket = NULL;
+	bool is_conform = true;
+
+	/* check the bucket of the feedback channel and the one of the context */
+	if(decomp->channel_pacing.rate > 0 &&
+	   !rohc_feedback_bucket_conform(&decomp->channel_bucket,
+	                                 &decomp->channel_pacing,
+	                                 stream->arrival_time, ack_type, cost))
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream->profile_id,
+		           "not enough tokens on the feedback channel for %zu bytes of "
+		           "feedback", feedback_len);
+		is_conform = false;
+	}
+	if(decomp->ctxt_pacing.rate > 0 && stream->context != NULL)
+	{
+		ctxt_bucket = &stream->context->feedback_bucket;
+		if(!rohc_feedback_bucket_conform(ctxt_bucket, &decomp->ctxt_pacing,
+		                                 stream->arrival_time, ack_type, cost))
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, stream->profile_id,
+			           "not enough tokens for context with CID %u for %zu bytes "
+			           "of feedback", stream->cid, feedback_len);
+			is_conform = false;
+		}
+	}
+
+	/* consume the tokens only if both buckets allow the feedback */
+	if(is_conform)
+	{
+		if(decomp->channel_pacing.rate > 0)
+		{
+			decomp->channel_bucket.tokens -= cost;
+		}
+		if(ctxt_bucket != NULL)
+		{
+			ctxt_bucket->tokens -= cost;
+		}
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream->profile_id,
+		           "feedback of type %d suppressed by pacing", ack_type);
+	}
+
+	/* update the detailed statistics if asked by user */
+	if((decomp->features & ROHC_DECOMP_FEATURE_STATS) != 0)
+	{
+		rohc_stats_write_begin(&decomp->detailed_stats_seq);
+		if(is_conform)
+		{
+			rohc_stats_add(&decomp->detailed_stats.feedbacks_nr[ack_type], 1);
+		}
+		else
+		{
+			rohc_stats_add(&decomp->detailed_stats.feedbacks_paced_nr[ack_type], 1);
+		}
+		rohc_stats_write_end(&decomp->detailed_stats_seq);
+	}
+
+	return is_conform;
+}
+
+
+/**
+ * @brief Cancel the mode transition that a suppressed feedback advertised
+ *
+ * The remote compressor is not told about the new mode of the context if
+ * the feedback that advertises it is suppressed by pacing. The context thus
+ * goes back to its former mode, so that the transition is performed and
+ * advertised again with the next packets.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param stream  The information about the decompressed stream
+ */
+static void rohc_decomp_feedback_cancel_mode(const struct rohc_decomp *const decomp,
+                                             const struct rohc_decomp_stream *const stream)
+{
+	if(stream->prev_mode != ROHC_UNKNOWN_MODE && stream->context != NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream->profile_id,
+		           "mode transition not advertised, context with CID %u goes "
+		           "back to mode %d", stream->cid, stream->prev_mode);
+		stream->context->mode = stream->prev_mode;
+	}
+}
+
+
+/**
+ * @brief Refill one token bucket and check if one feedback conforms to it
+ *
+ * The bucket is full when it is used for the first time. It is then refilled
+ * according to the arrival times of the packets. Arrival times that go back
+ * in time do not refill the bucket.
+ *
+ * @param bucket    The token bucket
+ * @param pacing    The configuration of the bucket
+ * @param now       The arrival time of the current packet
+ * @param priority  The priority of the feedback
+ * @param cost      The tokens required by the feedback
+ * @return          true if the bucket holds enough tokens for the feedback,
+ *                  false otherwise
+ */
+static bool rohc_feedback_bucket_conform(struct rohc_feedback_bucket *const bucket,
+                                         const struct rohc_feedback_pacing *const pacing,
+                                         const struct rohc_ts now,
+                                         const enum rohc_feedback_ack_type priority,
+                                         const uint64_t cost)
+{
+	const uint64_t tokens_max = ((uint64_t) pacing->burst) * 1000000000U;
+	uint64_t reserve;
+
+	/* refill the bucket */
+	if(!bucket->is_init)
+	{
+		bucket->tokens = tokens_max;
+		bucket->last_refill = now;
+		bucket->is_init = true;
+	}
+	else if(now.sec > bucket->last_refill.sec ||
+	        (now.sec == bucket->last_refill.sec &&
+	         now.nsec > bucket->last_refill.nsec))
+	{
+		uint64_t refill;
+
+		/* at least one byte per second is refilled, so the bucket is full
+		 * once as many seconds as bytes in the bucket elapsed */
+		if((now.sec - bucket->last_refill.sec) >= pacing->burst)
 		{
-			crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
+			bucket->tokens = tokens_max;
 		}
 		else
 		{
-			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
-		}
-
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, &feedbacksize);
-		if(feedbackp == NULL)
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the (STATIC-)NACK feedback");
-			goto error;
-		}
+			const uint64_t elapsed =
+				(now.sec - bucket->last_refill.sec) * 1000000000U +
+				now.nsec - bucket->last_refill.nsec;
 
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
-		{
-			if(feedbacksize < 8)
+			if(__builtin_mul_overflow(elapsed, (uint64_t) pacing->rate, &refill) ||
+			   bucket->tokens >= tokens_max ||
+			   refill >= (tokens_max - bucket->tokens))
 			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
+				bucket->tokens = tokens_max;
 			}
 			else
 			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
+				bucket->tokens += refill;
 			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
-		}
-
-		if(feedback->len > 0)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "decompressor built a %zu-byte negative feedback (%zu bytes "
-			           "of header + %zu bytes of data)", feedback->len,
-			           feedback_hdr_len, feedbacksize);
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
+		bucket->last_refill = now;
+	}
+	if(bucket->tokens > tokens_max)
+	{
+		/* the bucket was shrunk since it was last used */
+		bucket->tokens = tokens_max;
 	}
 
-	/* upon decompression failure, perform downward transitions if context is
-	 * still available (new contexts are destroyed upon decompression error) */
-	if(!do_downward_transition || infos->context == NULL)
+	/* keep some tokens for more important feedbacks */
+	if(priority == ROHC_FEEDBACK_ACK)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not perform a downward state transition");
+		reserve = tokens_max / ROHC_FEEDBACK_PACING_ACK_RESERVE;
+	}
+	else if(priority == ROHC_FEEDBACK_NACK)
+	{
+		reserve = tokens_max / ROHC_FEEDBACK_PACING_NACK_RESERVE;
 	}
 	else
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "perform a downward state transition now (CID = %u, NACK "
-		           "type = %d, current mode = %d, target mode = %d, rate-limiting "
-		           "= %zu of 3200 with threshold %zu and %zu of 3200 with "
-		           "threshold %zu)", infos->cid, ack_type, infos->mode,
-		           decomp->target_mode, k_too_quickly, threshold_too_quickly,
-		           k_too_many, decomp->ack_rate_limits.speed.threshold);
-
-		if(infos->state == ROHC_DECOMP_STATE_SC)
-		{
-			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			          "change from state %d to state %d because of error(s)",
-			          infos->state, ROHC_DECOMP_STATE_NC);
-			infos->context->state = ROHC_DECOMP_STATE_NC;
-		}
-		else if(infos->state == ROHC_DECOMP_STATE_FC)
-		{
-			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			          "change from state %d to state %d because of error(s)",
-			          infos->state, ROHC_DECOMP_STATE_SC);
-			infos->context->state = ROHC_DECOMP_STATE_SC;
-		}
-		else
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "stay in state %d because of error(s)", infos->context->state);
-		}
+		reserve = 0;
 	}
 
-skip:
-	return true;
-
-error:
-	return false;
+	return (bucket->tokens >= (cost + reserve));
 }
 
 
@@ -2448,6 +3364,8 @@ static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 	decomp->stats.corrected_crc_failures = 0;
 	decomp->stats.corrected_sn_wraparounds = 0;
 	decomp->stats.corrected_wrong_sn_updates = 0;
+	decomp->detailed_stats_seq = 0;
+	memset(&decomp->detailed_stats, 0, sizeof(struct rohc_decomp_stats));
 }
 
 
@@ -2766,6 +3684,102 @@ error:
 }
 
 
+/**
+ * @brief Get the detailed statistics of the decompressor
+ *
+ * Get a snapshot of the detailed statistics of the decompressor. The
+ * statistics are collected only if the \ref ROHC_DECOMP_FEATURE_STATS
+ * feature is enabled with \ref rohc_decomp_set_features.
+ *
+ * The function does not take any lock: it may be called by any thread, even
+ * while another thread is decompressing packets with the same decompressor.
+ * The snapshot is consistent, ie. it does not contain any partial update.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *
+ * See the \ref rohc_decomp_stats_t structure for details about fields that
+ * are supported in the above versions.
+ *
+ * @param decomp         The ROHC decompressor to get statistics from
+ * @param[in,out] stats  The structure where statistics will be stored
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_stats_t
+ * @see ROHC_DECOMP_FEATURE_STATS
+ */
+bool rohc_decomp_get_stats(const struct rohc_decomp *const decomp,
+                           rohc_decomp_stats_t *const stats)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		size_t counters_len;
+
+		/* new fields added by minor versions */
+		if(stats->version_minor == 0)
+		{
+			counters_len = offsetof(struct rohc_decomp_stats, feedbacks_nr);
+		}
+		else if(stats->version_minor == 1)
+		{
+			counters_len = sizeof(struct rohc_decomp_stats);
+		}
+		else
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "statistics", stats->version_minor);
+			goto error;
+		}
+
+		/* the counters of the internal statistics are in the same order as in
+		 * the structure of the API, so take a consistent snapshot of all the
+		 * counters of the minor version at once */
+		assert((sizeof(rohc_decomp_stats_t) -
+		        offsetof(rohc_decomp_stats_t, packets_nr)) ==
+		       sizeof(struct rohc_decomp_stats));
+		assert((offsetof(rohc_decomp_stats_t, feedbacks_nr) -
+		        offsetof(rohc_decomp_stats_t, packets_nr)) ==
+		       offsetof(struct rohc_decomp_stats, feedbacks_nr));
+		stats->unused = 0;
+		rohc_stats_read(&decomp->detailed_stats_seq,
+		                ((uint8_t *) stats) + offsetof(rohc_decomp_stats_t, packets_nr),
+		                (const uint64_t *) &decomp->detailed_stats,
+		                counters_len / sizeof(uint64_t));
+	}
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "statistics", stats->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get the CID type that the decompressor uses
  *
@@ -3008,6 +4022,82 @@ error:
 }
 
 
+/**
+ * @brief Set the number of context objects preallocated per slab
+ *
+ * Enable the slab allocator of the decompressor for the decompression
+ * contexts and their profile-specific parts. The slab allocator keeps one
+ * slab per object size. Every slab preallocates the given number of objects
+ * with one single allocation the first time an object of its size is
+ * needed, and never grows. Objects released by destroyed contexts are kept
+ * in the slab for the next contexts, so creating and destroying contexts for
+ * short-lived flows does not fragment the heap nor call the system
+ * allocator. The memory of the slabs is released when the decompressor is
+ * destroyed.
+ *
+ * Once all the objects of one slab are in use, the creation of a new context
+ * that needs one more object of that size fails. One context uses at most 3
+ * objects of the same size (the UDP part of an IP/UDP context and its 2 UDP
+ * headers), and a context that replaces another one is created before the
+ * old one is destroyed, so (MAX_CID + 2) * 3 objects per slab are enough for
+ * all the contexts the decompressor may create. Fewer objects per slab bound the
+ * memory further at the cost of fewer contexts of one given kind.
+ *
+ * The slab allocator is disabled by default. Set \e objs_per_slab to 0 to
+ * disable it again: new objects are then allocated with malloc().
+ *
+ * The slab allocator cannot be changed once one of its slabs was allocated,
+ * so the function shall be called before the first packet is decompressed.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param objs_per_slab  The number of objects preallocated per slab,
+ *                       in range [0, 65536]
+ * @return               true if the setting was successfully changed,
+ *                       false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_comp_set_arena
+ */
+bool rohc_decomp_set_arena(struct rohc_decomp *const decomp,
+                           const size_t objs_per_slab)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* number of objects per slab must be in range [0, ROHC_ARENA_SLAB_OBJS_MAX] */
+	if(objs_per_slab > ROHC_ARENA_SLAB_OBJS_MAX)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected number of objects per slab %zu: must be in "
+		             "range [0, %u]", objs_per_slab, ROHC_ARENA_SLAB_OBJS_MAX);
+		goto error;
+	}
+
+	/* the slabs cannot be resized once allocated */
+	if(decomp->arena.slabs_nr > 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "slab allocator cannot be changed once slabs exist");
+		goto error;
+	}
+
+	decomp->arena.objs_per_slab = objs_per_slab;
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "slab allocator %s (%zu objects per slab)",
+	          objs_per_slab > 0 ? "enabled" : "disabled", objs_per_slab);
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Set the number of packets sent during one Round-Trip Time (RTT).
  *
@@ -3325,6 +4415,166 @@ error:
 }
 
 
+/**
+ * @brief Set the pacing of feedbacks
+ *
+ * Pace the feedbacks sent by the decompressor with token buckets, so that
+ * they do not exceed the capacity of a slow feedback channel:
+ *  \li one bucket for the whole feedback channel, refilled with
+ *      \e channel_rate bytes per second up to \e channel_burst bytes ;
+ *  \li one bucket for every context, refilled with \e ctxt_rate bytes per
+ *      second up to \e ctxt_burst bytes.
+ *
+ * A feedback is sent only if both buckets hold enough tokens for all its
+ * bytes, feedback header included. Otherwise the feedback is suppressed:
+ * suppressed ACKs are retried with the next packets, suppressed NACKs and
+ * STATIC-NACKs are sent again upon the next decompression failures.
+ *
+ * Feedbacks are paced according to their priorities: STATIC-NACKs may use
+ * all the tokens of the buckets, NACKs cannot use the last quarter of the
+ * buckets, and ACKs cannot use the last half of the buckets. A burst of ACKs
+ * thus never delays the negative feedbacks that follow it.
+ *
+ * A context that transits to another operational mode goes back to its
+ * former mode if the feedback that advertises the transition is suppressed,
+ * so that the transition is performed and advertised again with the next
+ * packets. The decompressor and the remote compressor thus never disagree
+ * on the mode of one context because of pacing.
+ *
+ * The buckets are refilled according to the arrival times of the ROHC
+ * packets, ie. the \e time field of the \e rohc_packet parameter of
+ * \ref rohc_decompress3. Feedback pacing requires that arrival times are
+ * given.
+ *
+ * The buckets belong to the decompressor, so several decompressors that
+ * share one feedback channel shall split its rate among them: every shard of
+ * \ref rohc_decomp_shards_new has its own buckets, use
+ * \ref rohc_decomp_shards_set_feedback_pacing to pace all the shards.
+ *
+ * Pacing is applied in addition to the rate limits configured with
+ * \ref rohc_decomp_set_rate_limits. The number of feedbacks sent and
+ * suppressed by pacing are available in the detailed statistics if the
+ * \ref ROHC_DECOMP_FEATURE_STATS feature is enabled.
+ *
+ * Pacing is disabled by default. A rate of 0 disables the corresponding
+ * bucket. The rates and the bursts shall not exceed 2^32 - 1. The bursts of
+ * the enabled buckets shall be at least 64 bytes, so that the largest ACK may
+ * be sent.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param channel_rate   The rate of the feedback channel (in bytes per second)
+ * @param channel_burst  The burst of the feedback channel (in bytes)
+ * @param ctxt_rate      The rate of every context (in bytes per second)
+ * @param ctxt_burst     The burst of every context (in bytes)
+ * @return               true if the new values were successfully set,
+ *                       false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_feedback_pacing
+ * @see rohc_decomp_shards_set_feedback_pacing
+ * @see rohc_decomp_set_rate_limits
+ * @see rohc_decompress3
+ */
+bool rohc_decomp_set_feedback_pacing(struct rohc_decomp *const decomp,
+                                     const size_t channel_rate,
+                                     const size_t channel_burst,
+                                     const size_t ctxt_rate,
+                                     const size_t ctxt_burst)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+#if SIZE_MAX > UINT32_MAX
+	/* the tokens of the buckets shall not overflow */
+	if(channel_rate > UINT32_MAX || channel_burst > UINT32_MAX ||
+	   ctxt_rate > UINT32_MAX || ctxt_burst > UINT32_MAX)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "feedback pacing rates and bursts shall not exceed %u",
+		             UINT32_MAX);
+		goto error;
+	}
+#endif
+
+	/* the largest ACK shall fit in the enabled buckets */
+	if((channel_rate > 0 && channel_burst < ROHC_FEEDBACK_PACING_BURST_MIN) ||
+	   (ctxt_rate > 0 && ctxt_burst < ROHC_FEEDBACK_PACING_BURST_MIN))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "feedback pacing bursts shall be at least %u bytes",
+		             ROHC_FEEDBACK_PACING_BURST_MIN);
+		goto error;
+	}
+
+	/* set new pacing, the bucket of the channel is full again */
+	decomp->channel_pacing.rate = channel_rate;
+	decomp->channel_pacing.burst = channel_burst;
+	decomp->ctxt_pacing.rate = ctxt_rate;
+	decomp->ctxt_pacing.burst = ctxt_burst;
+	decomp->channel_bucket.is_init = false;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "feedback pacing is now set to: %zu bytes/s with %zu-byte burst "
+	           "(channel), %zu bytes/s with %zu-byte burst (contexts)",
+	           channel_rate, channel_burst, ctxt_rate, ctxt_burst);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the pacing of feedbacks currently configured
+ *
+ * See \ref rohc_decomp_set_feedback_pacing for details about feedback
+ * pacing.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[out] channel_rate   The rate of the feedback channel (in bytes per
+ *                            second), 0 if disabled
+ * @param[out] channel_burst  The burst of the feedback channel (in bytes)
+ * @param[out] ctxt_rate      The rate of every context (in bytes per second),
+ *                            0 if disabled
+ * @param[out] ctxt_burst     The burst of every context (in bytes)
+ * @return                    true if the pacing was successfully retrieved,
+ *                            false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_feedback_pacing
+ */
+bool rohc_decomp_get_feedback_pacing(const struct rohc_decomp *const decomp,
+                                     size_t *const channel_rate,
+                                     size_t *const channel_burst,
+                                     size_t *const ctxt_rate,
+                                     size_t *const ctxt_burst)
+{
+	if(decomp == NULL ||
+	   channel_rate == NULL || channel_burst == NULL ||
+	   ctxt_rate == NULL || ctxt_burst == NULL)
+	{
+		goto error;
+	}
+
+	*channel_rate = decomp->channel_pacing.rate;
+	*channel_burst = decomp->channel_pacing.burst;
+	*ctxt_rate = decomp->ctxt_pacing.rate;
+	*ctxt_burst = decomp->ctxt_pacing.burst;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Enable/disable features for ROHC decompressor
  *
@@ -3350,7 +4600,8 @@ bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
 {
 	const rohc_decomp_features_t all_features =
 		ROHC_DECOMP_FEATURE_CRC_REPAIR |
-		ROHC_DECOMP_FEATURE_DUMP_PACKETS;
+		ROHC_DECOMP_FEATURE_DUMP_PACKETS |
+		ROHC_DECOMP_FEATURE_STATS;
 
 	/* decompressor must be valid */
 	if(decomp == NULL)
@@ -3768,6 +5019,63 @@ error:
 }
 
 
+/**
+ * @brief Set the minimal level of the traces emitted by the decompressor
+ *
+ * Traces with a level lower than the given one are discarded by the ROHC
+ * library before the trace callback is called, so that their message is not
+ * even formatted. This permits to keep warnings and errors in production
+ * without paying the cost of the many debug traces emitted for every packet.
+ *
+ * By default, all the traces are given to the trace callback, ie. the
+ * minimal level is \ref ROHC_TRACE_DEBUG.
+ *
+ * @warning The minimal level can not be modified after library
+ *          initialization
+ *
+ * @param decomp     The ROHC decompressor
+ * @param min_level  The minimal level of the traces given to the callback
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_traces_cb2
+ */
+bool rohc_decomp_set_traces_min_level(struct rohc_decomp *const decomp,
+                                      const rohc_trace_level_t min_level)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	/* check the trace level */
+	if(min_level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unknown trace level %d", min_level);
+		goto error;
+	}
+
+	/* refuse to change the trace level if decompressor is in use: the contexts
+	 * already created keep a copy of the trace settings */
+	if(decomp->stats.received > 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the minimal trace level after initialization");
+		goto error;
+	}
+
+	decomp->trace_min_level = min_level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /*
  * Private functions
  */
@@ -54,6 +54,7 @@ extern "C"
  */
 
 struct rohc_decomp;
+struct rohc_decomp_shards;
 
 
 
@@ -282,6 +283,95 @@ typedef struct
 } __attribute__((packed)) rohc_decomp_general_info_t;
 
 
+/**
+ * @brief The detailed statistics of the decompressor
+ *
+ * The structure is used by the \ref rohc_decomp_get_stats function to store
+ * a snapshot of the detailed statistics of the decompressor. The statistics
+ * are collected only if the \ref ROHC_DECOMP_FEATURE_STATS feature is
+ * enabled.
+ *
+ * The latency histogram counts the time spent to decompress every packet.
+ * The durations are measured in ticks of the cheapest counter available: the
+ * Time Stamp Counter on x86, the virtual counter of the generic timer on
+ * ARM64, the cycle counter of the kernel in kernel space, and nanoseconds
+ * everywhere else. See \ref rohc_stats_get_bucket_min for the range of
+ * durations counted by every bucket of the histogram.
+ *
+ * Versioning works as follow:
+ *  - The \e version_major field defines the compatibility level. If the major
+ *    number given by user does not match the one expected by the library,
+ *    an error is returned.
+ *  - The \e version_minor field defines the extension level. If the minor
+ *    number given by user does not match the one expected by the library,
+ *    only the fields supported in that minor version will be filled by
+ *    \ref rohc_decomp_get_stats.
+ *
+ * Notes for developers:
+ *  - Increase the major version if a field is removed.
+ *  - Increase the major version if a field is added at the beginning or in
+ *    the middle of the structure.
+ *  - Increase the minor version if a field is added at the very end of the
+ *    structure.
+ *  - The version_major and version_minor fields must be located at the very
+ *    beginning of the structure.
+ *  - The structure must be packed.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    packets_nr, comp_bytes_nr, uncomp_bytes_nr, failures_nr,
+ *    ctxt_creations_nr, ctxt_evictions_nr, ctxt_replications_nr,
+ *    crc_repairs_nr, crc_repairs_ok_nr, profiles_nr, pkt_types_nr, and
+ *    latency_hist.
+ *  - major 0 and minor = 1 contains: all fields from major 0, minor 0 and
+ *    feedbacks_nr and feedbacks_paced_nr.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_stats
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** Unused bytes, keep the counters aligned on 64 bits */
+	uint32_t unused;
+	/** The number of packets successfully decompressed */
+	uint64_t packets_nr;
+	/** The number of compressed bytes of the decompressed packets */
+	uint64_t comp_bytes_nr;
+	/** The number of uncompressed bytes produced by the decompressor */
+	uint64_t uncomp_bytes_nr;
+	/** The number of packets that failed to be decompressed */
+	uint64_t failures_nr;
+	/** The number of contexts created */
+	uint64_t ctxt_creations_nr;
+	/** The number of contexts replaced by new ones */
+	uint64_t ctxt_evictions_nr;
+	/** The number of contexts created by Context Replication (CR) */
+	uint64_t ctxt_replications_nr;
+	/** The number of repairs attempted upon CRC failure */
+	uint64_t crc_repairs_nr;
+	/** The number of successful repairs upon CRC failure */
+	uint64_t crc_repairs_ok_nr;
+	/** The number of packets decompressed with every profile, indexed by the
+	 *  major and minor numbers of the profile ID */
+	uint64_t profiles_nr[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The number of ROHC packets of every type */
+	uint64_t pkt_types_nr[ROHC_PACKET_MAX];
+	/** The histogram of the time spent to decompress packets */
+	uint64_t latency_hist[ROHC_STATS_LATENCY_BUCKETS_NR];
+	/** The number of feedbacks sent, indexed by type: ACK, NACK and
+	 *  STATIC-NACK (since minor 1) */
+	uint64_t feedbacks_nr[3];
+	/** The number of feedbacks suppressed by pacing, indexed by type: ACK,
+	 *  NACK and STATIC-NACK (since minor 1) */
+	uint64_t feedbacks_paced_nr[3];
+} __attribute__((packed)) rohc_decomp_stats_t;
+
+
 /**
  * @brief The different features of the ROHC decompressor
  *
@@ -303,6 +393,9 @@ typedef enum
 	ROHC_DECOMP_FEATURE_COMPAT_1_6_x = (1 << 1),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_DECOMP_FEATURE_DUMP_PACKETS = (1 << 3),
+	/** Collect the detailed statistics returned by \ref rohc_decomp_get_stats
+	 *  (beware: small performance impact) */
+	ROHC_DECOMP_FEATURE_STATS        = (1 << 4),
 
 } rohc_decomp_features_t;
 
@@ -326,6 +419,67 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            struct rohc_buf *const feedback_send)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_decompress_in_place(struct rohc_decomp *const decomp,
+                                                  struct rohc_buf *const packet,
+                                                  struct rohc_buf *const rcvd_feedback,
+                                                  struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decompress_burst(struct rohc_decomp *const decomp,
+                                         const struct rohc_buf *const rohc_packets,
+                                         struct rohc_buf *const uncomp_packets,
+                                         rohc_status_t *const statuses,
+                                         const size_t pkts_nr,
+                                         struct rohc_buf *const rcvd_feedback,
+                                         struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+
+
+/*
+ * Functions related to multi-core decompression:
+ */
+
+struct rohc_decomp_shards * ROHC_EXPORT rohc_decomp_shards_new(const rohc_cid_type_t cid_type,
+                                                               const rohc_cid_t max_cid,
+                                                               const rohc_mode_t mode,
+                                                               const size_t shards_nr,
+                                                               const size_t queue_len)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_decomp_shards_free(struct rohc_decomp_shards *const shards);
+
+struct rohc_decomp * ROHC_EXPORT rohc_decomp_shards_get_decomp(const struct rohc_decomp_shards *const shards,
+                                                               const size_t shard)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_shards_set_feedback_pacing(struct rohc_decomp_shards *const shards,
+                                                        const size_t channel_rate,
+                                                        const size_t channel_burst,
+                                                        const size_t ctxt_rate,
+                                                        const size_t ctxt_burst)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_shards_enqueue(struct rohc_decomp_shards *const shards,
+                                            const struct rohc_buf rohc_packet,
+                                            const struct rohc_buf uncomp_packet,
+                                            const struct rohc_buf *const rcvd_feedback,
+                                            const struct rohc_buf *const feedback_send,
+                                            void *const pkt_priv)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decomp_shards_run(struct rohc_decomp_shards *const shards,
+                                          const size_t shard,
+                                          const size_t max_pkts_nr);
+
+bool ROHC_EXPORT rohc_decomp_shards_dequeue(struct rohc_decomp_shards *const shards,
+                                            struct rohc_buf *const uncomp_packet,
+                                            struct rohc_buf *const rcvd_feedback,
+                                            struct rohc_buf *const feedback_send,
+                                            rohc_status_t *const status,
+                                            void **const pkt_priv)
+	__attribute__((warn_unused_result));
+
 
 
 /*
@@ -348,6 +502,10 @@ bool ROHC_EXPORT rohc_decomp_get_last_packet_info(const struct rohc_decomp *cons
                                                   rohc_decomp_last_packet_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_get_stats(const struct rohc_decomp *const decomp,
+                                       rohc_decomp_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to user parameters
@@ -373,6 +531,10 @@ bool ROHC_EXPORT rohc_decomp_get_mrru(const struct rohc_decomp *const decomp,
                                       size_t *const mrru)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_arena(struct rohc_decomp *const decomp,
+                                       const size_t objs_per_slab)
+	__attribute__((warn_unused_result));
+
 /* pRTT */
 
 bool ROHC_EXPORT rohc_decomp_set_prtt(struct rohc_decomp *const decomp,
@@ -397,6 +559,20 @@ bool ROHC_EXPORT rohc_decomp_get_rate_limits(const struct rohc_decomp *const dec
                                              size_t *const k_2, size_t *const n_2)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_feedback_pacing(struct rohc_decomp *const decomp,
+                                                 const size_t channel_rate,
+                                                 const size_t channel_burst,
+                                                 const size_t ctxt_rate,
+                                                 const size_t ctxt_burst)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_feedback_pacing(const struct rohc_decomp *const decomp,
+                                                 size_t *const channel_rate,
+                                                 size_t *const channel_burst,
+                                                 size_t *const ctxt_rate,
+                                                 size_t *const ctxt_burst)
+	__attribute__((warn_unused_result));
+
 /* decompression library features */
 
 bool ROHC_EXPORT rohc_decomp_set_features(struct rohc_decomp *const decomp,
@@ -438,6 +614,10 @@ bool ROHC_EXPORT rohc_decomp_set_traces_cb2(struct rohc_decomp *const decomp,
                                             void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_traces_min_level(struct rohc_decomp *const decomp,
+                                                  const rohc_trace_level_t min_level)
+	__attribute__((warn_unused_result));
+
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
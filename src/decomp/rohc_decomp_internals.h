@@ -32,6 +32,8 @@
 #include "rohc_traces_internal.h"
 #include "feedback_create.h"
 #include "crc.h"
+#include "rohc_arena.h"
+#include "rohc_stats_internal.h"
 
 
 /*
@@ -57,6 +59,7 @@
 		if(((context)->decompressor->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0) { \
 			rohc_dump_buf((context)->decompressor->trace_callback, \
 			              (context)->decompressor->trace_callback_priv, \
+			              (context)->decompressor->trace_min_level, \
 			              ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG, \
 			              descr, buf, buf_len); \
 		} \
@@ -74,27 +77,58 @@
 struct d_statistics
 {
 	/* The number of received packets */
-	unsigned long received;
+	uint64_t received;
 	/* The number of bad decompressions due to wrong CRC */
-	unsigned long failed_crc;
+	uint64_t failed_crc;
 	/* The number of bad decompressions due to being in the No Context state */
-	unsigned long failed_no_context;
+	uint64_t failed_no_context;
 	/* The number of bad decompressions */
-	unsigned long failed_decomp;
+	uint64_t failed_decomp;
 
 	/** The cumulative size of the compressed packets */
-	unsigned long total_compressed_size;
+	uint64_t total_compressed_size;
 	/** The cumulative size of the uncompressed packets */
-	unsigned long total_uncompressed_size;
+	uint64_t total_uncompressed_size;
 
 	/** The cumulative number of successful corrections upon CRC failure */
-	unsigned long corrected_crc_failures;
+	uint64_t corrected_crc_failures;
 	/** The cumulative number of successful corrections of SN wraparound
 	 *  upon CRC failure */
-	unsigned long corrected_sn_wraparounds;
+	uint64_t corrected_sn_wraparounds;
 	/** The cumulative number of successful corrections of incorrect SN updates
 	 *  upon CRC failure */
-	unsigned long corrected_wrong_sn_updates;
+	uint64_t corrected_wrong_sn_updates;
+};
+
+
+/**
+ * @brief The detailed statistics of the ROHC decompressor
+ *
+ * The fields are the counters of \ref rohc_decomp_stats_t in the same order.
+ * All of them shall be 64-bit counters so that the statistics may be copied
+ * as an array of counters.
+ */
+struct rohc_decomp_stats
+{
+	uint64_t packets_nr;           /**< The number of decompressed packets */
+	uint64_t comp_bytes_nr;        /**< The number of compressed bytes */
+	uint64_t uncomp_bytes_nr;      /**< The number of uncompressed bytes */
+	uint64_t failures_nr;          /**< The number of decompression failures */
+	uint64_t ctxt_creations_nr;    /**< The number of created contexts */
+	uint64_t ctxt_evictions_nr;    /**< The number of replaced contexts */
+	uint64_t ctxt_replications_nr; /**< The number of replicated contexts */
+	uint64_t crc_repairs_nr;       /**< The number of attempted CRC repairs */
+	uint64_t crc_repairs_ok_nr;    /**< The number of successful CRC repairs */
+	/** The number of packets per profile */
+	uint64_t profiles_nr[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The number of packets per packet type */
+	uint64_t pkt_types_nr[ROHC_PACKET_MAX];
+	/** The histogram of decompression durations */
+	uint64_t latency_hist[ROHC_STATS_LATENCY_BUCKETS_NR];
+	/** The number of sent feedbacks per type (ACK, NACK, STATIC-NACK) */
+	uint64_t feedbacks_nr[ROHC_FEEDBACK_RESERVED];
+	/** The number of feedbacks suppressed by pacing per type */
+	uint64_t feedbacks_paced_nr[ROHC_FEEDBACK_RESERVED];
 };
 
 
@@ -124,6 +158,44 @@ struct rohc_ack_rate_limits
 };
 
 
+/**
+ * @brief The user configuration for feedback pacing
+ *
+ * Feedbacks are paced by a token bucket that is refilled with \e rate bytes
+ * every second up to \e burst bytes. Pacing is disabled if \e rate is 0.
+ */
+struct rohc_feedback_pacing
+{
+	size_t rate;   /**< The refill rate of the bucket (in bytes per second) */
+	size_t burst;  /**< The size of the bucket (in bytes) */
+};
+
+
+/** The smallest bucket size for feedback pacing (in bytes), so that the
+ *  largest ACK fits in the half of the bucket that ACKs may use */
+#define ROHC_FEEDBACK_PACING_BURST_MIN  (2U * (2U + FEEDBACK_DATA_MAX_LEN))
+
+/** ACKs shall leave 1/ROHC_FEEDBACK_PACING_ACK_RESERVE of the bucket for
+ *  NACKs and STATIC-NACKs */
+#define ROHC_FEEDBACK_PACING_ACK_RESERVE  2U
+
+/** NACKs shall leave 1/ROHC_FEEDBACK_PACING_NACK_RESERVE of the bucket for
+ *  STATIC-NACKs */
+#define ROHC_FEEDBACK_PACING_NACK_RESERVE  4U
+
+
+/** The token bucket that paces feedbacks on the feedback channel */
+struct rohc_feedback_bucket
+{
+	/** The tokens available in the bucket (in billionths of byte) */
+	uint64_t tokens;
+	/** The arrival time of the packet that last refilled the bucket */
+	struct rohc_ts last_refill;
+	/** Whether the bucket was already used or not */
+	bool is_init;
+};
+
+
 /** The statistics collected about the last needed/sent feedbacks */
 struct rohc_ack_stats
 {
@@ -132,6 +204,47 @@ struct rohc_ack_stats
 };
 
 
+/** The information related to the CRC of a ROHC packet */
+struct rohc_decomp_crc_one
+{
+	rohc_crc_type_t type;  /**< The type of CRC that protects the ROHC header */
+	uint8_t bits;          /**< The CRC bits found in ROHC header */
+};
+
+
+/** The information related to the CRC(s) of a ROHC packet */
+struct rohc_decomp_crc
+{
+	/** The CRC over the compressed header extracted from the ROHC packet */
+	struct rohc_decomp_crc_one comp;
+	/** The CRC over the uncompressed header extracted from the ROHC packet */
+	struct rohc_decomp_crc_one uncomp;
+};
+
+
+/**
+ * @brief The volatile part of the ROHC decompression context
+ *
+ * The volatile part of the ROHC decompression context lasts only one single
+ * packet. Between two ROHC packets, the volatile part of the context is
+ * erased. Since the decompressor decodes one single packet at a time, the
+ * volatile part is owned by the decompressor and shared by all its contexts.
+ */
+struct rohc_decomp_volat_ctxt
+{
+	/** The CRC(s) information extracted from the ROHC packet */
+	struct rohc_decomp_crc crc;
+
+	/** The profile-specific data for bits extracted from the ROHC packet,
+	 * defined by the profiles */
+	void *extr_bits;
+
+	/** The profile-specific data for values decoded from persistent context
+	 * and bits extracted from the ROHC packet, defined by the profiles */
+	void *decoded_values;
+};
+
+
 /**
  * @brief The ROHC decompressor
  */
@@ -155,6 +268,11 @@ struct rohc_decomp
 	uint16_t num_contexts_used;
 	/** The last decompression context used by the decompressor */
 	struct rohc_decomp_ctxt *last_context;
+	/** The volatile data used to decode the current packet, sized for the
+	 *  largest profile and shared by all the decompression contexts */
+	struct rohc_decomp_volat_ctxt volat_ctxt;
+	/** The slab allocator for the decompression contexts */
+	struct rohc_arena arena;
 
 
 	/* feedback-related variables */
@@ -169,6 +287,12 @@ struct rohc_decomp
 	uint32_t last_pkts_errors;
 	/** The information for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The configuration for pacing feedbacks on the whole feedback channel */
+	struct rohc_feedback_pacing channel_pacing;
+	/** The configuration for pacing feedbacks of every context */
+	struct rohc_feedback_pacing ctxt_pacing;
+	/** The token bucket that paces feedbacks on the whole feedback channel */
+	struct rohc_feedback_bucket channel_bucket;
 
 
 	/* segment-related variables */
@@ -184,10 +308,17 @@ struct rohc_decomp
 	/** Some statistics about the decompression processes */
 	struct d_statistics stats;
 
+	/** The sequence counter that protects the detailed statistics */
+	uint32_t detailed_stats_seq;
+	/** The detailed statistics, collected if ROHC_DECOMP_FEATURE_STATS is set */
+	struct rohc_decomp_stats detailed_stats;
+
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimal level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 };
 
 
@@ -221,46 +352,6 @@ struct rohc_decomp_crc_corr_ctxt
 };
 
 
-/** The information related to the CRC of a ROHC packet */
-struct rohc_decomp_crc_one
-{
-	rohc_crc_type_t type;  /**< The type of CRC that protects the ROHC header */
-	uint8_t bits;          /**< The CRC bits found in ROHC header */
-};
-
-
-/** The information related to the CRC(s) of a ROHC packet */
-struct rohc_decomp_crc
-{
-	/** The CRC over the compressed header extracted from the ROHC packet */
-	struct rohc_decomp_crc_one comp;
-	/** The CRC over the uncompressed header extracted from the ROHC packet */
-	struct rohc_decomp_crc_one uncomp;
-};
-
-
-/**
- * @brief The volatile part of the ROHC decompression context
- *
- * The volatile part of the ROHC decompression context lasts only one single
- * packet. Between two ROHC packets, the volatile part of the context is
- * erased.
- */
-struct rohc_decomp_volat_ctxt
-{
-	/** The CRC(s) information extracted from the ROHC packet */
-	struct rohc_decomp_crc crc;
-
-	/** The profile-specific data for bits extracted from the ROHC packet,
-	 * defined by the profiles */
-	void *extr_bits;
-
-	/** The profile-specific data for values decoded from persistent context
-	 * and bits extracted from the ROHC packet, defined by the profiles */
-	void *decoded_values;
-};
-
-
 /**
  * @brief The ROHC decompression context
  */
@@ -276,8 +367,6 @@ struct rohc_decomp_ctxt
 	const struct rohc_decomp_profile *profile;
 	/** The persistent profile-specific data, defined by the profiles */
 	void *persist_ctxt;
-	/** The volatile data, erased between two ROHC packets */
-	struct rohc_decomp_volat_ctxt volat_ctxt;
 
 	/** The operation mode in which the context operates */
 	rohc_mode_t mode;
@@ -288,6 +377,8 @@ struct rohc_decomp_ctxt
 	uint32_t last_pkts_errors;
 	/** The information for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The token bucket that paces the feedbacks of the context */
+	struct rohc_feedback_bucket feedback_bucket;
 
 	/** The context for corrections upon CRC failure */
 	struct rohc_decomp_crc_corr_ctxt crc_corr;
@@ -335,13 +426,10 @@ struct rohc_decomp_ctxt
 
 
 typedef bool (*rohc_decomp_new_context_t)(const struct rohc_decomp_ctxt *const context,
-                                          void **const persist_ctxt,
-                                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                          void **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt,
-                                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt);
 
 typedef rohc_packet_t (*rohc_decomp_detect_pkt_type_t) (const struct rohc_decomp_ctxt *const context,
                                                         const uint8_t *const rohc_packet,
@@ -405,6 +493,11 @@ struct rohc_decomp_profile
 	/** The maximum number of bits of the Master Sequence Number (MSN) */
 	const size_t msn_max_bits;
 
+	/** The size of the profile-specific bits extracted from one ROHC packet */
+	const size_t extr_bits_size;
+	/** The size of the profile-specific values decoded for one ROHC packet */
+	const size_t decoded_values_size;
+
 	/** @brief The handler used to create the profile-specific part of the
 	 *         decompression context */
 	rohc_decomp_new_context_t new_context;
@@ -435,5 +528,15 @@ struct rohc_decomp_profile
 	rohc_decomp_get_sn_t get_sn;
 };
 
+
+/*
+ * Prototypes of library-private functions
+ */
+
+bool rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                          const struct rohc_buf rohc_packet,
+                          rohc_cid_t *const cid)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
 #endif
 
@@ -47,6 +47,24 @@
 #include <assert.h>
 
 
+/** The maximum number of SN LSB wraparounds that CRC repair may correct */
+#define ROHC_DECOMP_REPAIR_SN_WRAPS_MAX  4U
+
+
+/**
+ * @brief One hypothesis evaluated by CRC repair
+ */
+struct rohc_decomp_repair_hyp
+{
+	/** The correction algorithm that the hypothesis stands for */
+	rohc_decomp_crc_corr_t algo;
+	/** The reference to use for SN LSB decoding */
+	rohc_lsb_ref_t lsb_ref_type;
+	/** The offset to add to the reference SN */
+	uint32_t sn_ref_offset;
+};
+
+
 /*
  * Private function prototypes for parsing the static and dynamic parts
  * of the IR and IR-DYN headers
@@ -322,14 +340,19 @@ static bool check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
                              const struct rohc_decomp_crc_one *const crc_pkt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
-                             const struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES],
-                             const size_t arrival_times_nr,
-                             const size_t arrival_times_index,
-                             const size_t k,
-                             const int32_t p)
+static size_t get_sn_wraparounds_nr(const struct rohc_ts cur_arrival_time,
+                                    const struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES],
+                                    const size_t arrival_times_nr,
+                                    const size_t arrival_times_index,
+                                    const size_t k,
+                                    const int32_t p)
 	__attribute__((warn_unused_result, pure));
 
+static void patch_repair_hdrs(const struct rohc_decomp_ctxt *const context,
+                              const struct rohc_decoded_values *const decoded,
+                              struct rohc_decomp_rfc3095_repair *const repair)
+	__attribute__((nonnull(1, 2, 3)));
+
 static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                             struct rohc_extr_bits *const bits)
 	__attribute__((nonnull(1, 2)));
@@ -341,31 +364,32 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
  */
 
 /**
- * @brief Create the RFC3095 volatile and persistent parts of the context
+ * @brief Create the RFC3095 persistent part of the context
  *
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_min_level    The minimal level of the traces to emit
  * @param profile_id         The ID of the associated decompression profile
  * @return                   true if the Uncompressed context was successfully
  *                           created, false if a problem occurred
  */
 bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
                                 struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                                struct rohc_decomp_volat_ctxt *const volat_ctxt,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_min_level,
                                 const int profile_id)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
 	/* allocate memory for the generic context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc3095_ctxt));
+	*persist_ctxt = rohc_arena_calloc(&context->decompressor->arena,
+	                                  sizeof(struct rohc_decomp_rfc3095_ctxt));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -379,7 +403,9 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* create the Offset IP-ID decoding context for inner IP header */
 	ip_id_offset_init(&rfc3095_ctxt->inner_ip_id_offset_ctxt);
 
-	rfc3095_ctxt->outer_ip_changes = calloc(2, sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->outer_ip_changes =
+		rohc_arena_calloc(&context->decompressor->arena,
+		                  2 * sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->outer_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -387,7 +413,9 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 		goto free_context;
 	}
 
-	rfc3095_ctxt->inner_ip_changes = calloc(1, sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->inner_ip_changes =
+		rohc_arena_calloc(&context->decompressor->arena,
+		                  sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->inner_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -398,9 +426,11 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* init the context used to compress the list of IPv6 extension headers
 	 * for the outer and inner IP headers */
 	rohc_decomp_list_ipv6_init(&rfc3095_ctxt->list_decomp1,
-	                           trace_cb, trace_cb_priv, profile_id);
+	                           trace_cb, trace_cb_priv, trace_min_level,
+	                           profile_id);
 	rohc_decomp_list_ipv6_init(&rfc3095_ctxt->list_decomp2,
-	                           trace_cb, trace_cb_priv, profile_id);
+	                           trace_cb, trace_cb_priv, trace_min_level,
+	                           profile_id);
 
 	/* no default next header */
 	rfc3095_ctxt->next_header_proto = 0;
@@ -410,35 +440,14 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_dynamic = ip_compute_crc_dynamic;
 	rfc3095_ctxt->is_crc_static_3_cached_valid = false;
 	rfc3095_ctxt->is_crc_static_7_cached_valid = false;
-
-	/* volatile part of the decompression context */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_inner_ip_changes;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_extr_bits;
-	}
+	rfc3095_ctxt->repair.is_valid = false;
 
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-free_inner_ip_changes:
-	zfree(rfc3095_ctxt->inner_ip_changes);
 free_outer_ip_changes:
-	zfree(rfc3095_ctxt->outer_ip_changes);
+	rohc_arena_zfree(rfc3095_ctxt->outer_ip_changes);
 free_context:
-	zfree(rfc3095_ctxt);
+	rohc_arena_zfree(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -451,24 +460,18 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The generic decompression context
- * @param volat_ctxt    The volatile part of the decompression context
  */
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-
 	/* destroy the information about the IP headers */
-	zfree(rfc3095_ctxt->outer_ip_changes);
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	rohc_arena_zfree(rfc3095_ctxt->outer_ip_changes);
+	rohc_arena_zfree(rfc3095_ctxt->inner_ip_changes);
 
 	/* destroy profile-specific part */
-	zfree(rfc3095_ctxt->specific);
+	rohc_arena_zfree(rfc3095_ctxt->specific);
 
 	/* destroy generic context itself */
-	free(rfc3095_ctxt);
+	rohc_arena_free(rfc3095_ctxt);
 }
 
 
@@ -5185,6 +5188,9 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 	};
 	size_t ip_payload_len = 0;
 
+	/* headers built for a previous packet cannot be used for CRC repair */
+	rfc3095_ctxt->repair.is_valid = false;
+
 	/* build the IP headers */
 	if(decoded->multiple_ip)
 	{
@@ -5333,9 +5339,18 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+				                 decomp->trace_min_level,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				                 "uncompressed headers", *uncomp_hdrs);
 			}
+
+			/* keep the built headers, so that CRC repair may evaluate its
+			 * hypotheses without building them again */
+			rfc3095_ctxt->repair.hdrs = uncomp_pkt_hdrs;
+			rfc3095_ctxt->repair.data = rohc_buf_data(*uncomp_hdrs);
+			rfc3095_ctxt->repair.crc = extr_crc->uncomp;
+			rfc3095_ctxt->repair.is_valid = true;
+
 			goto error_crc;
 		}
 	}
@@ -5644,13 +5659,26 @@ error:
 /**
  * @brief Attempt a packet/context repair upon CRC failure
  *
+ * All the hypotheses that may explain the CRC failure are evaluated in one
+ * pass: several SN LSB wraparounds (as many as the arrival times of the last
+ * packets allow), then the use of ref -1 as reference SN. For every
+ * hypothesis, the bits are decoded again, then the fields that depend on the
+ * SN are patched in the headers built for the CRC failure. The CRC is then
+ * computed from the cached CRC-STATIC part and from the patched CRC-DYNAMIC
+ * fields: headers are not built for any hypothesis.
+ *
+ * Upon success, the bits extracted from the ROHC header are updated for the
+ * first hypothesis that matches the CRC, so that the headers are built once
+ * for that hypothesis.
+ *
  * @param decomp             The ROHC decompressor
  * @param context            The decompression context
  * @param pkt_arrival_time   The arrival time of the ROHC packet that caused
  *                           the CRC failure
  * @param[in,out] crc_corr   The context for corrections upon CRC failures
  * @param[in,out] extr_bits  The bits extracted from the ROHC header
- * @return                   true if repair is possible, false if not
+ * @return                   true if one hypothesis matches the CRC,
+ *                           false if repair is not possible
  */
 bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
                                    const struct rohc_decomp_ctxt *const context,
@@ -5659,10 +5687,16 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
                                    struct rohc_extr_bits *const extr_bits)
 {
 	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	struct rohc_decomp_rfc3095_repair *const repair = &rfc3095_ctxt->repair;
 	const uint32_t sn_ref_0 = rohc_lsb_get_ref(&rfc3095_ctxt->sn_lsb_ctxt,
 	                                           ROHC_LSB_REF_0);
 	const uint32_t sn_ref_minus_1 = rohc_lsb_get_ref(&rfc3095_ctxt->sn_lsb_ctxt,
 	                                                 ROHC_LSB_REF_MINUS_1);
+	struct rohc_decomp_repair_hyp hyps[ROHC_DECOMP_REPAIR_SN_WRAPS_MAX + 1];
+	struct rohc_decoded_values decoded;
+	size_t sn_wraps_nr;
+	size_t hyps_nr = 0;
+	size_t i;
 	int32_t sn_lsb_p;
 	bool verdict = false;
 
@@ -5685,6 +5719,15 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 	/* no correction attempt shall be already running */
 	assert(crc_corr->counter == 0);
 
+	/* the headers built for the CRC failure are required to evaluate the
+	 * hypotheses */
+	if(!repair->is_valid)
+	{
+		rohc_decomp_warn(context, "CID %u: CRC repair: no headers to evaluate "
+		                 "hypotheses with", context->cid);
+		goto skip;
+	}
+
 	/* try to guess the correct SN value in case of failure */
 	rohc_decomp_warn(context, "CID %u: CRC repair: attempt to correct SN",
 	                 context->cid);
@@ -5710,65 +5753,163 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 	 * step c of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
 	 *   If wraparound has occurred, INTERVAL will correspond to at least
 	 *   2^k inter-packet times, where k is the number of SN bits in the
-	 *   current header. */
-	if(is_sn_wraparound(pkt_arrival_time, crc_corr->arrival_times,
-	                    crc_corr->arrival_times_nr, crc_corr->arrival_times_index,
-	                    extr_bits->sn_nr, sn_lsb_p))
+	 *   current header.
+	 *
+	 * step d of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
+	 *   add 2^k to the reference SN and attempts to decompress the
+	 *   packet using the new reference SN
+	 *
+	 * INTERVAL may correspond to several wraparounds: try adding 2^k, then
+	 * 2 * 2^k, and so on. */
+	sn_wraps_nr = get_sn_wraparounds_nr(pkt_arrival_time, crc_corr->arrival_times,
+	                                    crc_corr->arrival_times_nr,
+	                                    crc_corr->arrival_times_index,
+	                                    extr_bits->sn_nr, sn_lsb_p);
+	for(i = 1; i <= sn_wraps_nr; i++)
+	{
+		hyps[hyps_nr].algo = ROHC_DECOMP_CRC_CORR_SN_WRAP;
+		hyps[hyps_nr].lsb_ref_type = ROHC_LSB_REF_0;
+		hyps[hyps_nr].sn_ref_offset = i << extr_bits->sn_nr;
+		hyps_nr++;
+	}
+
+	/* step d of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
+	 *   If the header generated in b. does not pass the CRC test, and the
+	 *   SN (SN curr2) generated when using ref -1 as the reference is
+	 *   different from SN curr1, an additional decompression attempt is
+	 *   performed based on SN curr2 as the decompressed SN.
+	 *
+	 * step e of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
+	 *   If the decompressed header generated in b. does not pass the CRC
+	 *   test and SN curr2 is the same as SN curr1, an additional
+	 *   decompression attempt is not useful and is not attempted. */
+	if(sn_ref_0 != sn_ref_minus_1)
 	{
-		rohc_decomp_warn(context, "CID %u: CRC repair: CRC failure seems to "
-		                 "be caused by a sequence number LSB wraparound",
-		                 context->cid);
-
-		crc_corr->algo = ROHC_DECOMP_CRC_CORR_SN_WRAP;
-
-		/* step d of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
-		 *   add 2^k to the reference SN and attempts to decompress the
-		 *   packet using the new reference SN */
-		extr_bits->sn_ref_offset = (1 << extr_bits->sn_nr);
-		rohc_decomp_warn(context, "CID %u: CRC repair: try adding 2^k = 2^%zu "
-		                 "= %u to reference SN (ref 0 = %u)", context->cid,
-		                 extr_bits->sn_nr, extr_bits->sn_ref_offset, sn_ref_0);
+		hyps[hyps_nr].algo = ROHC_DECOMP_CRC_CORR_SN_UPDATES;
+		hyps[hyps_nr].lsb_ref_type = ROHC_LSB_REF_MINUS_1;
+		hyps[hyps_nr].sn_ref_offset = 0;
+		hyps_nr++;
 	}
-	else if(sn_ref_0 != sn_ref_minus_1)
+
+	if(hyps_nr == 0)
 	{
-		rohc_decomp_warn(context, "CID %u: CRC repair: CRC failure seems to "
-		                 "be caused by an incorrect SN update", context->cid);
+		rohc_decomp_warn(context, "CID %u: CRC repair: repair is not useful",
+		                 context->cid);
+		goto skip;
+	}
 
-		crc_corr->algo = ROHC_DECOMP_CRC_CORR_SN_UPDATES;
+	/* evaluate all the hypotheses, keep the first one that matches the CRC */
+	for(i = 0; !verdict && i < hyps_nr; i++)
+	{
+		extr_bits->lsb_ref_type = hyps[i].lsb_ref_type;
+		extr_bits->sn_ref_offset = hyps[i].sn_ref_offset;
+		if(hyps[i].algo == ROHC_DECOMP_CRC_CORR_SN_WRAP)
+		{
+			rohc_decomp_warn(context, "CID %u: CRC repair: try adding %u to "
+			                 "reference SN (ref 0 = %u)", context->cid,
+			                 extr_bits->sn_ref_offset, sn_ref_0);
+		}
+		else
+		{
+			rohc_decomp_warn(context, "CID %u: CRC repair: try using ref -1 (%u) "
+			                 "as reference SN instead of ref 0 (%u)",
+			                 context->cid, sn_ref_minus_1, sn_ref_0);
+		}
 
-		/* step d of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
-		 *   If the header generated in b. does not pass the CRC test, and the
-		 *   SN (SN curr2) generated when using ref -1 as the reference is
-		 *   different from SN curr1, an additional decompression attempt is
-		 *   performed based on SN curr2 as the decompressed SN. */
-		extr_bits->lsb_ref_type = ROHC_LSB_REF_MINUS_1;
-		rohc_decomp_warn(context, "CID %u: CRC repair: try using ref -1 (%u) "
-		                 "as reference SN instead of ref 0 (%u)",
-		                 context->cid, sn_ref_minus_1, sn_ref_0);
+		if(rfc3095_decomp_decode_bits(context, extr_bits, repair->hdrs.payload_len,
+		                              &decoded) != ROHC_STATUS_OK)
+		{
+			continue;
+		}
+		patch_repair_hdrs(context, &decoded, repair);
+		if(check_uncomp_crc(context, &repair->hdrs, &repair->crc))
+		{
+			rohc_decomp_warn(context, "CID %u: CRC repair: SN %u matches the CRC",
+			                 context->cid, decoded.sn);
+			crc_corr->algo = hyps[i].algo;
+			verdict = true;
+		}
 	}
-	else
+	if(!verdict)
 	{
-		/* step e of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
-		 *   If the decompressed header generated in b. does not pass the CRC
-		 *   test and SN curr2 is the same as SN curr1, an additional
-		 *   decompression attempt is not useful and is not attempted. */
-		rohc_decomp_warn(context, "CID %u: CRC repair: repair is not useful",
-		                 context->cid);
+		rohc_decomp_warn(context, "CID %u: CRC repair: none of the %zu "
+		                 "hypotheses matches the CRC", context->cid, hyps_nr);
+		extr_bits->lsb_ref_type = ROHC_LSB_REF_0;
+		extr_bits->sn_ref_offset = 0;
 		goto skip;
 	}
 
 	/* packet/context correction is going to be attempted, 3 packets with
 	 * correct CRC are required to accept the correction */
 	crc_corr->counter = 3;
-	verdict = true;
 
 skip:
+	repair->is_valid = false;
 	return verdict;
 }
 
 
 /**
- * @brief Is SN wraparound possible?
+ * @brief Patch the fields that depend on the SN in the headers built for
+ *        the packet that failed its CRC
+ *
+ * The IP-ID (and the header checksum) of the IPv4 headers, the RTP SN and TS,
+ * and the ESP SN are updated with the values decoded for one hypothesis of
+ * CRC repair. Other fields do not depend on the SN.
+ *
+ * @param context     The decompression context
+ * @param decoded     The values decoded for the hypothesis
+ * @param[in,out] repair  The headers built for the packet that failed its CRC
+ */
+static void patch_repair_hdrs(const struct rohc_decomp_ctxt *const context,
+                              const struct rohc_decoded_values *const decoded,
+                              struct rohc_decomp_rfc3095_repair *const repair)
+{
+	const struct rohc_decoded_ip_values *const ip_values[2] = {
+		&decoded->outer_ip, &decoded->inner_ip
+	};
+	size_t ip_hdr_pos;
+
+	assert(repair->hdrs.ip_hdrs_nr <= 2);
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < repair->hdrs.ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct rohc_pkt_ip_hdr *const ip_hdr =
+			&repair->hdrs.ip_hdrs[ip_hdr_pos];
+
+		if(ip_hdr->version == IPV4)
+		{
+			uint8_t *const ipv4_data =
+				repair->data + (ip_hdr->data - repair->hdrs.all_hdrs);
+			struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ipv4_data;
+
+			ipv4->id = rohc_hton16(ip_values[ip_hdr_pos]->id);
+			ipv4->check = 0;
+			ipv4->check = ip_fast_csum(ipv4_data, ipv4->ihl);
+		}
+	}
+
+	if(context->profile->id == ROHCv1_PROFILE_IP_UDP_RTP)
+	{
+		struct rtphdr *const rtp = (struct rtphdr *)
+			(repair->data + (((const uint8_t *) repair->hdrs.rtp) -
+			                 repair->hdrs.all_hdrs));
+
+		rtp->sn = rohc_hton16((uint16_t) decoded->sn);
+		rtp->timestamp = rohc_hton32(decoded->ts);
+	}
+	else if(context->profile->id == ROHCv1_PROFILE_IP_ESP)
+	{
+		struct esphdr *const esp = (struct esphdr *)
+			(repair->data + (repair->hdrs.transport - repair->hdrs.all_hdrs));
+
+		esp->sn = rohc_hton32(decoded->sn);
+	}
+}
+
+
+/**
+ * @brief How many SN wraparounds are possible?
  *
  * According to RFC3095, §5.3.2.2.4, step c, SN wraparound is possible if the
  * inter-packet interval of the current packet is at least 2^k times the
@@ -5785,6 +5926,10 @@ skip:
  *
  * A -10% margin is taken to handle problems due to clock precision.
  *
+ * The number of possible SN wraparounds is the number of times the
+ * inter-packet interval of the current packet contains the minimal interval
+ * for one wraparound.
+ *
  * @param cur_arrival_time     The arrival time of the current packet
  * @param arrival_times        The arrival times for the last packets
  * @param arrival_times_nr     The number of arrival times for last packets
@@ -5792,14 +5937,15 @@ skip:
  *                             packet
  * @param k                    The number of bits for SN
  * @param p                    The shift parameter p for SN
- * @return                     Whether SN wraparound is possible or not
+ * @return                     The number of possible SN wraparounds, 0 if
+ *                             no SN wraparound is possible
  */
-static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
-                             const struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES],
-                             const size_t arrival_times_nr,
-                             const size_t arrival_times_index,
-                             const size_t k,
-                             const int32_t p)
+static size_t get_sn_wraparounds_nr(const struct rohc_ts cur_arrival_time,
+                                    const struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES],
+                                    const size_t arrival_times_nr,
+                                    const size_t arrival_times_index,
+                                    const size_t k,
+                                    const int32_t p)
 {
 	const size_t arrival_times_index_last =
 		(arrival_times_index + ROHC_MAX_ARRIVAL_TIMES - 1) % ROHC_MAX_ARRIVAL_TIMES;
@@ -5807,6 +5953,7 @@ static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
 	uint64_t avg_interval; /* in microseconds */
 	uint64_t min_interval; /* in microseconds */
 	uint64_t margin; /* in microseconds */
+	uint64_t wraps_nr;
 
 	/* cannot use correction for SN wraparound if no arrival time was given
 	 * for the current packet, or if too few packets were received yet */
@@ -5847,10 +5994,25 @@ static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
 	min_interval -= margin;
 
 	/* enough time elapsed for SN wraparound? */
-	return (cur_interval >= min_interval);
+	if(cur_interval < min_interval)
+	{
+		goto error;
+	}
+	else if(min_interval == 0)
+	{
+		return 1;
+	}
+
+	/* enough time elapsed for several SN wraparounds? */
+#ifndef __KERNEL__
+	wraps_nr = cur_interval / min_interval;
+#else
+	wraps_nr = div64_u64(cur_interval, min_interval);
+#endif
+	return rohc_min(wraps_nr, ROHC_DECOMP_REPAIR_SN_WRAPS_MAX);
 
 error:
-	return false;
+	return 0;
 }
 
 
@@ -305,6 +305,26 @@ struct rohc_decomp_rfc3095_changes
 };
 
 
+/**
+ * @brief The uncompressed headers built for a packet that failed its CRC
+ *
+ * The headers are valid only while the packet that failed its CRC is being
+ * decoded. CRC repair evaluates its hypotheses by patching the fields that
+ * depend on the SN in these headers, instead of building the headers again.
+ */
+struct rohc_decomp_rfc3095_repair
+{
+	/** Information about the built headers, for CRC computation */
+	struct rohc_pkt_hdrs hdrs;
+	/** The built headers */
+	uint8_t *data;
+	/** The CRC on uncompressed headers extracted from the ROHC packet */
+	struct rohc_decomp_crc_one crc;
+	/** Whether the headers above are valid or not */
+	bool is_valid;
+};
+
+
 /**
  * @brief The generic decompression context for RFC3095-based profiles
  *
@@ -343,6 +363,9 @@ struct rohc_decomp_rfc3095_ctxt
 	/** The cache for the CRC-7 value on CRC-STATIC fields */
 	uint8_t crc_static_7_cached;
 
+	/** The headers built for the last packet that failed its CRC */
+	struct rohc_decomp_rfc3095_repair repair;
+
 	/* below are some information and handlers to manage the next header
 	 * (if any) located just after the IP headers (1 or 2 IP headers) */
 
@@ -432,15 +455,14 @@ struct rohc_decomp_rfc3095_ctxt
 
 bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
                                 struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                                struct rohc_decomp_volat_ctxt *const volat_ctxt,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_min_level,
                                 const int profile_id)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_buf rohc_packet,
@@ -0,0 +1,609 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_decomp_shards.c
+ * @brief  Sharded ROHC decompressor for multi-core systems
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The CID space of one channel is split among several decompressors (the
+ * shards), so that the shards may decompress packets in parallel, each one
+ * on its own thread, without any lock. The CID of every packet is parsed in
+ * a lightweight way, then the packet is given to the shard in charge of
+ * that CID, so all the packets of one context are decompressed by the same
+ * shard in the order they were received.
+ *
+ * The dispatcher records every packet in one slot of a reorder window, then
+ * hands the slot to the shard through a lock-free single-producer,
+ * single-consumer ring. The decompressed packets are given back in the
+ * order the packets were received once their shard decompressed them,
+ * along with the feedback the shard built for them.
+ */
+
+#include "rohc_decomp.h"
+#include "rohc_decomp_internals.h"
+#include "rohc_spsc_ring.h"
+
+#include <string.h>
+#include <assert.h>
+
+
+/** One packet dispatched to the shards, in the reorder window */
+struct rohc_decomp_shards_slot
+{
+	/** The ROHC packet */
+	struct rohc_buf rohc_packet;
+	/** The decompressed packet */
+	struct rohc_buf uncomp_packet;
+	/** The feedback received for the same-side compressor */
+	struct rohc_buf rcvd_feedback;
+	/** The feedback to send to the remote compressor */
+	struct rohc_buf feedback_send;
+	/** Whether the user gave a buffer for the received feedback or not */
+	bool with_rcvd_feedback;
+	/** Whether the user gave a buffer for the feedback to send or not */
+	bool with_feedback_send;
+	/** Whether the packet was decompressed by its shard or not */
+	bool is_done;
+	/** The status of the decompression of the packet */
+	rohc_status_t status;
+	/** The private data given by the user with the packet */
+	void *pkt_priv;
+};
+
+
+/** One shard: one decompressor and the packets it shall decompress */
+struct rohc_decomp_shard
+{
+	/** The decompressor of the shard */
+	struct rohc_decomp *decomp;
+	/** The reorder slots of the packets to decompress */
+	struct rohc_spsc_ring pkts;
+};
+
+
+/** The sharded ROHC decompressor */
+struct rohc_decomp_shards
+{
+	/** The shards */
+	struct rohc_decomp_shard *shards;
+	/** The number of shards */
+	size_t shards_nr;
+	/** The number of CIDs of the channel, ie. MAX_CID + 1 */
+	size_t cids_nr;
+
+	/** The reorder window of the packets dispatched to the shards */
+	struct rohc_decomp_shards_slot *slots;
+	/** The number of slots in the reorder window minus one (power of 2) */
+	size_t slots_mask;
+	/** The number of packets dispatched so far, written by the dispatcher */
+	size_t pkts_in;
+	/** The number of packets given back so far, written by the collector */
+	size_t pkts_out;
+};
+
+
+/**
+ * @brief Create a new sharded ROHC decompressor
+ *
+ * Create \e shards_nr decompressors that share the CIDs [0, \e max_cid] of
+ * one single channel: shard #i is in charge of the CIDs that verify
+ * CID * \e shards_nr / (\e max_cid + 1) = i. The decompressors are created
+ * as with \ref rohc_decomp_new2 and shall be configured with
+ * \ref rohc_decomp_shards_get_decomp before the first packet is given to
+ * \ref rohc_decomp_shards_enqueue.
+ *
+ * The sharded decompressor may then be used by several threads without any
+ * lock:
+ *  \li one single thread gives the received packets with
+ *      \ref rohc_decomp_shards_enqueue,
+ *  \li one thread per shard decompresses the packets of the shard with
+ *      \ref rohc_decomp_shards_run,
+ *  \li one single thread gets the decompressed packets back in order with
+ *      \ref rohc_decomp_shards_dequeue.
+ * The same thread may play several of these roles.
+ *
+ * ROHC segmentation is not supported: the MRRU of the decompressors shall
+ * stay 0.
+ *
+ * Every shard paces its feedbacks with its own token buckets. Use
+ * \ref rohc_decomp_shards_set_feedback_pacing rather than
+ * \ref rohc_decomp_set_feedback_pacing on every shard, so that the rate of
+ * the feedback channel is split among the shards instead of being granted
+ * to every shard.
+ *
+ * @param cid_type   The type of Context IDs (CID) of the channel
+ * @param max_cid    The maximum value for CIDs on the channel
+ * @param mode       The operational mode that the decompressors shall
+ *                   target
+ * @param shards_nr  The number of shards, in range [1, \e max_cid + 1]
+ * @param queue_len  The maximum number of packets that may be dispatched
+ *                   but not given back yet, rounded up to the next power
+ *                   of 2
+ * @return           The created sharded decompressor if successful,
+ *                   NULL if creation failed
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_free
+ * @see rohc_decomp_shards_get_decomp
+ * @see rohc_decomp_shards_set_feedback_pacing
+ * @see rohc_decomp_shards_enqueue
+ * @see rohc_decomp_shards_run
+ * @see rohc_decomp_shards_dequeue
+ */
+struct rohc_decomp_shards * rohc_decomp_shards_new(const rohc_cid_type_t cid_type,
+                                                   const rohc_cid_t max_cid,
+                                                   const rohc_mode_t mode,
+                                                   const size_t shards_nr,
+                                                   const size_t queue_len)
+{
+	struct rohc_decomp_shards *shards;
+	size_t slots_nr = 1;
+
+	if(shards_nr == 0 || shards_nr > (((size_t) max_cid) + 1))
+	{
+		goto error;
+	}
+	if(queue_len == 0 || queue_len > UINT32_MAX)
+	{
+		goto error;
+	}
+
+	shards = calloc(1, sizeof(struct rohc_decomp_shards));
+	if(shards == NULL)
+	{
+		goto error;
+	}
+	shards->cids_nr = ((size_t) max_cid) + 1;
+
+	/* the reorder window */
+	while(slots_nr < queue_len)
+	{
+		slots_nr <<= 1;
+	}
+	shards->slots = calloc(slots_nr, sizeof(struct rohc_decomp_shards_slot));
+	if(shards->slots == NULL)
+	{
+		goto free_shards;
+	}
+	shards->slots_mask = slots_nr - 1;
+	shards->pkts_in = 0;
+	shards->pkts_out = 0;
+
+	/* the shards */
+	shards->shards = calloc(shards_nr, sizeof(struct rohc_decomp_shard));
+	if(shards->shards == NULL)
+	{
+		goto free_slots;
+	}
+	for(shards->shards_nr = 0; shards->shards_nr < shards_nr; shards->shards_nr++)
+	{
+		struct rohc_decomp_shard *const shard = &(shards->shards[shards->shards_nr]);
+
+		shard->decomp = rohc_decomp_new2(cid_type, max_cid, mode);
+		if(shard->decomp == NULL)
+		{
+			goto free_shard;
+		}
+
+		/* every shard may receive all the packets of the reorder window */
+		if(!rohc_spsc_ring_new(&shard->pkts, slots_nr))
+		{
+			goto free_decomp;
+		}
+		continue;
+
+free_decomp:
+		rohc_decomp_free(shard->decomp);
+free_shard:
+		rohc_decomp_shards_free(shards);
+		goto error;
+	}
+
+	return shards;
+
+free_slots:
+	free(shards->slots);
+free_shards:
+	free(shards);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given sharded ROHC decompressor
+ *
+ * All the decompressors of the shards are destroyed. The packets that were
+ * dispatched but not given back yet are lost. No thread shall use the
+ * sharded decompressor anymore.
+ *
+ * @param shards  The sharded decompressor to destroy
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_new
+ */
+void rohc_decomp_shards_free(struct rohc_decomp_shards *const shards)
+{
+	if(shards != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < shards->shards_nr; i++)
+		{
+			rohc_spsc_ring_free(&shards->shards[i].pkts);
+			rohc_decomp_free(shards->shards[i].decomp);
+		}
+		free(shards->shards);
+		free(shards->slots);
+		free(shards);
+	}
+}
+
+
+/**
+ * @brief Get the decompressor of one shard
+ *
+ * The decompressor of every shard shall be configured the same way, eg.
+ * profiles or features, before the first packet is given to
+ * \ref rohc_decomp_shards_enqueue. Once packets were given, the
+ * decompressor belongs to the thread that runs \ref rohc_decomp_shards_run
+ * for the shard.
+ *
+ * @param shards  The sharded decompressor
+ * @param shard   The index of the shard
+ * @return        The decompressor of the shard,
+ *                NULL if the shard does not exist
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_new
+ */
+struct rohc_decomp * rohc_decomp_shards_get_decomp(const struct rohc_decomp_shards *const shards,
+                                                   const size_t shard)
+{
+	if(shards == NULL || shard >= shards->shards_nr)
+	{
+		return NULL;
+	}
+	return shards->shards[shard].decomp;
+}
+
+
+/**
+ * @brief Set the pacing of the feedbacks of all the shards
+ *
+ * The decompressors of the shards build their feedbacks on their own
+ * threads, and each one paces them with its own token buckets. The rate and
+ * the burst of the feedback channel are thus split among the shards, so
+ * that all the shards together never exceed the capacity of the one
+ * feedback channel they share: shard #i gets \e channel_rate / \e shards_nr
+ * bytes per second and \e channel_burst / \e shards_nr bytes of burst, the
+ * remainders of the divisions going to the first shards. The pacing of the
+ * contexts is not split since every context belongs to one single shard.
+ *
+ * A shard that is idle does not give its share of the channel to the other
+ * shards. The burst of the channel shall thus be large enough for every
+ * shard to send the largest ACK, ie. at least 64 bytes per shard.
+ *
+ * See \ref rohc_decomp_set_feedback_pacing for details about feedback
+ * pacing. The function shall be called before the first packet is given to
+ * \ref rohc_decomp_shards_enqueue.
+ *
+ * @param shards         The sharded decompressor
+ * @param channel_rate   The rate of the feedback channel (in bytes per second)
+ * @param channel_burst  The burst of the feedback channel (in bytes)
+ * @param ctxt_rate      The rate of every context (in bytes per second)
+ * @param ctxt_burst     The burst of every context (in bytes)
+ * @return               true if the new values were successfully set,
+ *                       false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_feedback_pacing
+ * @see rohc_decomp_shards_new
+ */
+bool rohc_decomp_shards_set_feedback_pacing(struct rohc_decomp_shards *const shards,
+                                            const size_t channel_rate,
+                                            const size_t channel_burst,
+                                            const size_t ctxt_rate,
+                                            const size_t ctxt_burst)
+{
+	size_t i;
+
+	if(shards == NULL)
+	{
+		goto error;
+	}
+
+	/* every shard shall get at least one byte per second of the channel and
+	 * room for the largest ACK */
+	if(channel_rate > 0 &&
+	   (channel_rate < shards->shards_nr ||
+	    (channel_burst / shards->shards_nr) < ROHC_FEEDBACK_PACING_BURST_MIN))
+	{
+		goto error;
+	}
+
+	for(i = 0; i < shards->shards_nr; i++)
+	{
+		const size_t shard_rate = channel_rate / shards->shards_nr +
+			(i < (channel_rate % shards->shards_nr) ? 1 : 0);
+		const size_t shard_burst = channel_burst / shards->shards_nr +
+			(i < (channel_burst % shards->shards_nr) ? 1 : 0);
+
+		if(!rohc_decomp_set_feedback_pacing(shards->shards[i].decomp, shard_rate,
+		                                    shard_burst, ctxt_rate, ctxt_burst))
+		{
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Give one received ROHC packet to the sharded decompressor
+ *
+ * The CID of the packet is parsed after the padding and the feedback items,
+ * then the packet is dispatched to the shard in charge of that CID. Packets
+ * which CID cannot be parsed are dispatched to the first shard that reports
+ * the error. The packet will be decompressed the next time
+ * \ref rohc_decomp_shards_run is called for that shard, and given back by
+ * \ref rohc_decomp_shards_dequeue.
+ *
+ * The memory of the packet and of the buffers shall not be used by the
+ * caller until the decompressed packet is given back.
+ *
+ * Shall be called by one single thread.
+ *
+ * @param shards         The sharded decompressor
+ * @param rohc_packet    The ROHC packet to decompress
+ * @param uncomp_packet  The buffer for the decompressed packet, it shall be
+ *                       empty
+ * @param rcvd_feedback  The buffer for the feedback received for the
+ *                       same-side compressor, it shall be empty, may be NULL
+ * @param feedback_send  The buffer for the feedback to send to the remote
+ *                       compressor, it shall be empty, may be NULL
+ * @param pkt_priv       Private data given back with the decompressed packet,
+ *                       may be NULL
+ * @return               true if the packet was dispatched,
+ *                       false if too many packets were not given back yet
+ *                       or if parameters are invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ * @see rohc_decomp_shards_run
+ * @see rohc_decomp_shards_dequeue
+ */
+bool rohc_decomp_shards_enqueue(struct rohc_decomp_shards *const shards,
+                                const struct rohc_buf rohc_packet,
+                                const struct rohc_buf uncomp_packet,
+                                const struct rohc_buf *const rcvd_feedback,
+                                const struct rohc_buf *const feedback_send,
+                                void *const pkt_priv)
+{
+	const struct rohc_buf empty_buf = rohc_buf_init_empty(NULL, 0);
+	struct rohc_decomp_shards_slot *slot;
+	size_t pkts_out;
+	size_t slot_idx;
+	size_t shard = 0;
+	rohc_cid_t cid;
+
+	if(shards == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(rohc_packet) ||
+	   rohc_buf_is_malformed(uncomp_packet) ||
+	   !rohc_buf_is_empty(uncomp_packet))
+	{
+		goto error;
+	}
+	if(rcvd_feedback != NULL &&
+	   (rohc_buf_is_malformed(*rcvd_feedback) ||
+	    !rohc_buf_is_empty(*rcvd_feedback)))
+	{
+		goto error;
+	}
+	if(feedback_send != NULL &&
+	   (rohc_buf_is_malformed(*feedback_send) ||
+	    !rohc_buf_is_empty(*feedback_send)))
+	{
+		goto error;
+	}
+
+	/* is there one free slot in the reorder window? */
+	pkts_out = __atomic_load_n(&shards->pkts_out, __ATOMIC_ACQUIRE);
+	if((shards->pkts_in - pkts_out) > shards->slots_mask)
+	{
+		goto error;
+	}
+
+	/* record the packet in the reorder window */
+	slot_idx = shards->pkts_in & shards->slots_mask;
+	slot = &(shards->slots[slot_idx]);
+	slot->rohc_packet = rohc_packet;
+	slot->uncomp_packet = uncomp_packet;
+	slot->with_rcvd_feedback = (rcvd_feedback != NULL);
+	slot->rcvd_feedback = (rcvd_feedback != NULL ? *rcvd_feedback : empty_buf);
+	slot->with_feedback_send = (feedback_send != NULL);
+	slot->feedback_send = (feedback_send != NULL ? *feedback_send : empty_buf);
+	slot->pkt_priv = pkt_priv;
+	slot->status = ROHC_STATUS_ERROR;
+	slot->is_done = false;
+
+	/* give the packet to the shard in charge of its CID: its ring cannot be
+	 * full since it is as large as the reorder window (the CID type and
+	 * MAX_CID of the first shard never change, so reading them here does not
+	 * race with the thread of that shard) */
+	if(rohc_decomp_peek_cid(shards->shards[0].decomp, rohc_packet, &cid))
+	{
+		shard = ((size_t) cid) * shards->shards_nr / shards->cids_nr;
+	}
+	if(!rohc_spsc_ring_push(&shards->shards[shard].pkts, slot_idx))
+	{
+		assert(0);
+		goto error;
+	}
+	shards->pkts_in++;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress the packets dispatched to one shard
+ *
+ * The packets dispatched to the shard are decompressed in the order they
+ * were received.
+ *
+ * Shall be called by one single thread per shard.
+ *
+ * @param shards       The sharded decompressor
+ * @param shard        The index of the shard
+ * @param max_pkts_nr  The maximum number of packets to decompress
+ * @return             The number of packets decompressed by the call, 0 if
+ *                     no packet is waiting or if parameters are invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_enqueue
+ */
+size_t rohc_decomp_shards_run(struct rohc_decomp_shards *const shards,
+                              const size_t shard,
+                              const size_t max_pkts_nr)
+{
+	struct rohc_decomp_shard *cur_shard;
+	size_t pkts_nr = 0;
+	uint32_t idx;
+
+	if(shards == NULL || shard >= shards->shards_nr)
+	{
+		goto error;
+	}
+	cur_shard = &(shards->shards[shard]);
+
+	while(pkts_nr < max_pkts_nr &&
+	      rohc_spsc_ring_peek(&cur_shard->pkts, &idx))
+	{
+		struct rohc_decomp_shards_slot *const slot = &(shards->slots[idx]);
+
+		slot->status =
+			rohc_decompress3(cur_shard->decomp, slot->rohc_packet,
+			                 &slot->uncomp_packet,
+			                 (slot->with_rcvd_feedback ? &slot->rcvd_feedback : NULL),
+			                 (slot->with_feedback_send ? &slot->feedback_send : NULL));
+		__atomic_store_n(&slot->is_done, true, __ATOMIC_RELEASE);
+		rohc_spsc_ring_pop(&cur_shard->pkts);
+		pkts_nr++;
+	}
+
+	return pkts_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Get back the next decompressed packet
+ *
+ * The packets are given back in the order they were given to
+ * \ref rohc_decomp_shards_enqueue, whatever the shards that decompressed
+ * them. The feedback built by the shard for the packet is given back with
+ * the packet, in the buffer given with the packet.
+ *
+ * Shall be called by one single thread.
+ *
+ * @param shards              The sharded decompressor
+ * @param[out] uncomp_packet  The decompressed packet
+ * @param[out] rcvd_feedback  The feedback received for the same-side
+ *                            compressor, an empty buffer if no buffer was
+ *                            given with the packet, may be NULL if not needed
+ * @param[out] feedback_send  The feedback to send to the remote compressor,
+ *                            an empty buffer if no buffer was given with the
+ *                            packet, may be NULL if not needed
+ * @param[out] status         The status of the decompression, see
+ *                            \ref rohc_decompress3 for possible values
+ * @param[out] pkt_priv       The private data given with the packet, may be
+ *                            NULL if not needed
+ * @return                    true if one packet is given back,
+ *                            false if the next packet is not decompressed
+ *                            yet or if parameters are invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_enqueue
+ */
+bool rohc_decomp_shards_dequeue(struct rohc_decomp_shards *const shards,
+                                struct rohc_buf *const uncomp_packet,
+                                struct rohc_buf *const rcvd_feedback,
+                                struct rohc_buf *const feedback_send,
+                                rohc_status_t *const status,
+                                void **const pkt_priv)
+{
+	struct rohc_decomp_shards_slot *slot;
+	const size_t pkts_out = (shards != NULL ? shards->pkts_out : 0);
+
+	if(shards == NULL || uncomp_packet == NULL || status == NULL)
+	{
+		goto error;
+	}
+
+	/* is the oldest packet of the reorder window decompressed? */
+	slot = &(shards->slots[pkts_out & shards->slots_mask]);
+	if(!__atomic_load_n(&slot->is_done, __ATOMIC_ACQUIRE))
+	{
+		goto error;
+	}
+
+	*uncomp_packet = slot->uncomp_packet;
+	*status = slot->status;
+	if(rcvd_feedback != NULL)
+	{
+		*rcvd_feedback = slot->rcvd_feedback;
+	}
+	if(feedback_send != NULL)
+	{
+		*feedback_send = slot->feedback_send;
+	}
+	if(pkt_priv != NULL)
+	{
+		*pkt_priv = slot->pkt_priv;
+	}
+
+	/* free the slot for the dispatcher */
+	slot->is_done = false;
+	__atomic_store_n(&shards->pkts_out, pkts_out + 1, __ATOMIC_RELEASE);
+
+	return true;
+
+error:
+	return false;
+}
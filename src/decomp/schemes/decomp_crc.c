@@ -33,24 +33,23 @@
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
  * @param context      The decompression context
+ * @param crc_cache    The CRC of the last uncompressed headers of the context
  * @param uncomp_hdrs  The uncompressed headers
  * @param crc_pkt      The CRC over uncompressed headers extracted from packet
  * @return             true if the CRC is correct, false otherwise
  */
 bool rohc_decomp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
+                                  struct rohc_crc_cache *const crc_cache,
                                   struct rohc_buf *const uncomp_hdrs,
                                   const struct rohc_decomp_crc_one *const crc_pkt)
 {
 	uint8_t crc_computed;
 
-	/* determine the initial value and the pre-computed table for the CRC */
+	/* check the CRC type */
 	switch(crc_pkt->type)
 	{
 		case ROHC_CRC_TYPE_3:
-			crc_computed = CRC_INIT_3;
-			break;
 		case ROHC_CRC_TYPE_7:
-			crc_computed = CRC_INIT_7;
 			break;
 		case ROHC_CRC_TYPE_8:
 			rohc_decomp_warn(context, "unexpected CRC type %d", crc_pkt->type);
@@ -65,8 +64,8 @@ bool rohc_decomp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
 
 	/* compute the CRC from built uncompressed headers */
 	crc_computed =
-		crc_calculate(crc_pkt->type, rohc_buf_data(*uncomp_hdrs), uncomp_hdrs->len,
-		              crc_computed);
+		crc_calc_cached(crc_cache, crc_pkt->type, rohc_buf_data(*uncomp_hdrs),
+		                uncomp_hdrs->len);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_pkt->type, crc_computed);
 
@@ -61,14 +61,16 @@ static size_t rohc_build_ip6_exts(const struct list_decomp *const decomp,
 /**
  * @brief Init one context for decompressing lists of IPv6 extension headers
  *
- * @param decomp         The context to create
- * @param trace_cb       The function to call for printing traces
- * @param trace_cb_priv  An optional private context, may be NULL
- * @param profile_id     The ID of the associated decompression profile
+ * @param decomp           The context to create
+ * @param trace_cb         The function to call for printing traces
+ * @param trace_cb_priv    An optional private context, may be NULL
+ * @param trace_min_level  The minimal level of the traces to emit
+ * @param profile_id       The ID of the associated decompression profile
  */
 void rohc_decomp_list_ipv6_init(struct list_decomp *const decomp,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_min_level,
                                 const int profile_id)
 {
 	/* specific callbacks for IPv6 extension headers */
@@ -81,6 +83,7 @@ void rohc_decomp_list_ipv6_init(struct list_decomp *const decomp,
 	/* traces */
 	decomp->trace_callback = trace_cb;
 	decomp->trace_callback_priv = trace_cb_priv;
+	decomp->trace_min_level = trace_min_level;
 	decomp->profile_id = profile_id;
 }
 
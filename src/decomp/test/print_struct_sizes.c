@@ -53,6 +53,8 @@ int main(void)
 	printf("\n");
 	printf("sizeof(struct rohc_decomp_ctxt) = %zu\n", sizeof(struct rohc_decomp_ctxt));
 	printf("\tsizeof(struct d_statistics) = %zu\n", sizeof(struct d_statistics));
+	printf("\tsizeof(struct rohc_decomp_volat_ctxt) = %zu\n",
+	       sizeof(struct rohc_decomp_volat_ctxt));
 
 	/* RFC3095 */
 	printf("\n");
@@ -65,6 +67,9 @@ int main(void)
 	printf("\tsizeof(struct list_decomp) = %zu\n", sizeof(struct list_decomp));
 	printf("\t\tsizeof(struct rohc_list) = %zu\n", sizeof(struct rohc_list));
 	printf("\t\tsizeof(struct rohc_list_item) = %zu\n", sizeof(struct rohc_list_item));
+	printf("sizeof(struct rohc_extr_bits) = %zu\n", sizeof(struct rohc_extr_bits));
+	printf("sizeof(struct rohc_decoded_values) = %zu\n",
+	       sizeof(struct rohc_decoded_values));
 
 	/* RFC6846 / TCP */
 	printf("\n");
@@ -111,6 +111,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == true);
 	}
 
+	/* rohc_decomp_set_traces_min_level() */
+	CHECK(rohc_decomp_set_traces_min_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_decomp_profile_enabled() */
 	CHECK(rohc_decomp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_GENERAL) == false);
@@ -218,6 +224,13 @@ int main(int argc, char *argv[])
 		CHECK(mrru == 65535);
 	}
 
+	/* rohc_decomp_set_arena() */
+	CHECK(rohc_decomp_set_arena(NULL, 16) == false);
+	CHECK(rohc_decomp_set_arena(decomp, 65536 + 1) == false);
+	CHECK(rohc_decomp_set_arena(decomp, 0) == true);
+	CHECK(rohc_decomp_set_arena(decomp, 65536) == true);
+	CHECK(rohc_decomp_set_arena(decomp, 16) == true);
+
 	/* rohc_decomp_get_max_cid() */
 	{
 		size_t max_cid;
@@ -280,9 +293,44 @@ int main(int argc, char *argv[])
 		CHECK(n_2 == 102);
 	}
 
+	/* rohc_decomp_set_feedback_pacing() */
+	CHECK(rohc_decomp_set_feedback_pacing(NULL,   1200, 600, 120, 120) == false);
+	CHECK(rohc_decomp_set_feedback_pacing(decomp, 1200,   0, 120, 120) == false);
+	CHECK(rohc_decomp_set_feedback_pacing(decomp, 1200,  63, 120, 120) == false);
+	CHECK(rohc_decomp_set_feedback_pacing(decomp, 1200, 600, 120,  63) == false);
+#if SIZE_MAX > UINT32_MAX
+	CHECK(rohc_decomp_set_feedback_pacing(decomp, 1200, 600, 120, 0x100000000ULL) == false);
+	CHECK(rohc_decomp_set_feedback_pacing(decomp, 0x100000000ULL, 600, 120, 120) == false);
+#endif
+	CHECK(rohc_decomp_set_feedback_pacing(decomp,    0,   0,   0,   0) == true);
+	CHECK(rohc_decomp_set_feedback_pacing(decomp, 1200, 600, 120, 120) == true);
+
+	/* rohc_decomp_get_feedback_pacing() */
+	{
+		size_t channel_rate, channel_burst, ctxt_rate, ctxt_burst;
+		CHECK(rohc_decomp_get_feedback_pacing(NULL, &channel_rate, &channel_burst,
+		                                      &ctxt_rate, &ctxt_burst) == false);
+		CHECK(rohc_decomp_get_feedback_pacing(decomp, NULL, &channel_burst,
+		                                      &ctxt_rate, &ctxt_burst) == false);
+		CHECK(rohc_decomp_get_feedback_pacing(decomp, &channel_rate, NULL,
+		                                      &ctxt_rate, &ctxt_burst) == false);
+		CHECK(rohc_decomp_get_feedback_pacing(decomp, &channel_rate, &channel_burst,
+		                                      NULL, &ctxt_burst) == false);
+		CHECK(rohc_decomp_get_feedback_pacing(decomp, &channel_rate, &channel_burst,
+		                                      &ctxt_rate, NULL) == false);
+		CHECK(rohc_decomp_get_feedback_pacing(decomp, &channel_rate, &channel_burst,
+		                                      &ctxt_rate, &ctxt_burst) == true);
+		CHECK(channel_rate == 1200);
+		CHECK(channel_burst == 600);
+		CHECK(ctxt_rate == 120);
+		CHECK(ctxt_burst == 120);
+	}
+	CHECK(rohc_decomp_set_feedback_pacing(decomp, 0, 0, 0, 0) == true);
+
 	/* rohc_decomp_set_features */
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_COMPAT_1_6_x) == false);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CRC_REPAIR) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_STATS) == true);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
 
 	/* rohc_decompress3() */
@@ -356,6 +404,51 @@ int main(int argc, char *argv[])
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_malformed) == ROHC_STATUS_ERROR);
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_full) == ROHC_STATUS_ERROR);
 		}
+
+		/* rohc_decompress_in_place() */
+		{
+			uint8_t buf_copy[100];
+			struct rohc_buf pkt_copy = rohc_buf_init_empty(buf_copy, 100);
+			uint8_t buf_in_place[100 + sizeof(buf)];
+			struct rohc_buf pkt_in_place = rohc_buf_init_empty(buf_in_place, 100);
+
+			CHECK(rohc_decompress3(decomp, pkt, &pkt_copy, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(pkt_copy.len > 0);
+
+			CHECK(rohc_decompress_in_place(NULL, &pkt_in_place, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_in_place(decomp, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+			pkt_in_place.max_len = 0;
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_ERROR);
+
+			/* no headroom */
+			pkt_in_place.max_len = sizeof(buf);
+			rohc_buf_append(&pkt_in_place, buf, sizeof(buf));
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+			CHECK(pkt_in_place.offset == 0);
+			CHECK(pkt_in_place.len == sizeof(buf));
+
+			/* headroom too small for the uncompressed headers */
+			pkt_in_place.max_len = 10 + sizeof(buf);
+			pkt_in_place.offset = 10;
+			pkt_in_place.len = 0;
+			rohc_buf_append(&pkt_in_place, buf, sizeof(buf));
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+			CHECK(pkt_in_place.offset == 10);
+			CHECK(pkt_in_place.len == sizeof(buf));
+
+			/* enough headroom */
+			pkt_in_place.max_len = 100 + sizeof(buf);
+			pkt_in_place.offset = 100;
+			pkt_in_place.len = 0;
+			rohc_buf_append(&pkt_in_place, buf, sizeof(buf));
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(pkt_in_place.data == buf_in_place);
+			CHECK(pkt_in_place.max_len == (100 + sizeof(buf)));
+			CHECK((pkt_in_place.offset + pkt_in_place.len) == pkt_in_place.max_len);
+			CHECK(pkt_in_place.len == pkt_copy.len);
+			CHECK(memcmp(rohc_buf_data(pkt_in_place), rohc_buf_data(pkt_copy),
+			             pkt_copy.len) == 0);
+		}
 	}
 
 	/* rohc_decomp_get_last_packet_info() */
@@ -392,6 +485,27 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
 	}
 
+	/* rohc_decomp_get_stats() */
+	{
+		rohc_decomp_stats_t stats;
+		memset(&stats, 0, sizeof(rohc_decomp_stats_t));
+		CHECK(rohc_decomp_get_stats(NULL, &stats) == false);
+		CHECK(rohc_decomp_get_stats(decomp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == true);
+		CHECK(stats.packets_nr == 0); /* statistics are disabled by default */
+		stats.version_minor = 1;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == true);
+		CHECK(stats.feedbacks_nr[0] == 0);
+		stats.version_minor = 2;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == false);
+	}
+
 	/* rohc_decomp_get_state_descr() */
 	CHECK(strcmp(rohc_decomp_get_state_descr(ROHC_DECOMP_STATE_NC), "No Context") == 0);
 	CHECK(strcmp(rohc_decomp_get_state_descr(ROHC_DECOMP_STATE_SC), "Static Context") == 0);
@@ -402,12 +516,170 @@ int main(int argc, char *argv[])
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == false);
+		CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_WARNING) == false);
 	}
 
 	/* rohc_decomp_free() */
 	rohc_decomp_free(NULL);
 	rohc_decomp_free(decomp);
 
+	/* rohc_decomp_shards_new() */
+	CHECK(rohc_decomp_shards_new(ROHC_SMALL_CID, 3, ROHC_U_MODE, 0, 8) == NULL);
+	CHECK(rohc_decomp_shards_new(ROHC_SMALL_CID, 3, ROHC_U_MODE, 5, 8) == NULL);
+	CHECK(rohc_decomp_shards_new(ROHC_SMALL_CID, 3, ROHC_U_MODE, 2, 0) == NULL);
+	CHECK(rohc_decomp_shards_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1,
+	                             ROHC_U_MODE, 2, 8) == NULL);
+	CHECK(rohc_decomp_shards_new(ROHC_SMALL_CID, 3, ROHC_R_MODE, 2, 8) == NULL);
+	{
+		struct rohc_decomp_shards *const shards =
+			rohc_decomp_shards_new(ROHC_SMALL_CID, 3, ROHC_O_MODE, 4, 3);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		/* IR packets for CIDs 0 and 3, the second one with one feedback item */
+		uint8_t buf[2][3 + 85] =
+		{
+			{
+				0xfd, 0x04, 0x10,  0x40, 0x01, 0xc0, 0xa8,
+				0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+				0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+				0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+				0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+				0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+				0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+				0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+				0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+				0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+				0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+			},
+			{
+				0xf1, 0x20,
+				0xe3, 0xfd, 0x04, 0x95,  0x40, 0x01, 0xc0, 0xa8,
+				0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+				0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+				0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+				0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+				0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+				0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+				0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+				0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+				0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+				0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+			}
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf[0], 85, ts);
+		uint8_t buf2[4][100];
+		struct rohc_buf pkt2 = rohc_buf_init_empty(buf2[0], 100);
+		uint8_t rcvd_buf[4][10];
+		struct rohc_buf rcvd_feedback = rohc_buf_init_empty(rcvd_buf[0], 10);
+		uint8_t send_buf[4][50];
+		struct rohc_buf feedback_send = rohc_buf_init_empty(send_buf[0], 50);
+		rohc_status_t status;
+		void *pkt_priv;
+		size_t i;
+
+		CHECK(shards != NULL);
+
+		/* rohc_decomp_shards_get_decomp() */
+		CHECK(rohc_decomp_shards_get_decomp(NULL, 0) == NULL);
+		CHECK(rohc_decomp_shards_get_decomp(shards, 4) == NULL);
+		for(i = 0; i < 4; i++)
+		{
+			struct rohc_decomp *const shard_decomp =
+				rohc_decomp_shards_get_decomp(shards, i);
+			CHECK(shard_decomp != NULL);
+			CHECK(rohc_decomp_enable_profile(shard_decomp, ROHC_PROFILE_IP) == true);
+		}
+
+		/* rohc_decomp_shards_set_feedback_pacing() */
+		CHECK(rohc_decomp_shards_set_feedback_pacing(NULL, 1202, 600, 120, 120) == false);
+		CHECK(rohc_decomp_shards_set_feedback_pacing(shards, 3, 600, 120, 120) == false);
+		CHECK(rohc_decomp_shards_set_feedback_pacing(shards, 1202, 255, 120, 120) == false);
+		CHECK(rohc_decomp_shards_set_feedback_pacing(shards, 1202, 600, 120, 63) == false);
+		CHECK(rohc_decomp_shards_set_feedback_pacing(shards, 0, 0, 0, 0) == true);
+		CHECK(rohc_decomp_shards_set_feedback_pacing(shards, 1202, 600, 120, 120) == true);
+		for(i = 0; i < 4; i++)
+		{
+			size_t channel_rate, channel_burst, ctxt_rate, ctxt_burst;
+			CHECK(rohc_decomp_get_feedback_pacing(rohc_decomp_shards_get_decomp(shards, i),
+			                                      &channel_rate, &channel_burst,
+			                                      &ctxt_rate, &ctxt_burst) == true);
+			CHECK(channel_rate == (i < 2 ? 301 : 300));
+			CHECK(channel_burst == 150);
+			CHECK(ctxt_rate == 120);
+			CHECK(ctxt_burst == 120);
+		}
+
+		/* rohc_decomp_shards_enqueue() */
+		CHECK(rohc_decomp_shards_enqueue(NULL, pkt, pkt2, NULL, NULL, NULL) == false);
+		pkt2.len = 1;
+		CHECK(rohc_decomp_shards_enqueue(shards, pkt, pkt2, NULL, NULL, NULL) == false);
+		pkt2.len = 0;
+		rcvd_feedback.len = 1;
+		CHECK(rohc_decomp_shards_enqueue(shards, pkt, pkt2, &rcvd_feedback, NULL, NULL) == false);
+		rcvd_feedback.len = 0;
+		feedback_send.len = 1;
+		CHECK(rohc_decomp_shards_enqueue(shards, pkt, pkt2, NULL, &feedback_send, NULL) == false);
+		feedback_send.len = 0;
+		for(i = 0; i < 4; i++)
+		{
+			pkt.data = buf[i % 2];
+			pkt.max_len = 85 + (i % 2) * 3;
+			pkt.len = pkt.max_len;
+			pkt2.data = buf2[i];
+			rcvd_feedback.data = rcvd_buf[i];
+			feedback_send.data = send_buf[i];
+			CHECK(rohc_decomp_shards_enqueue(shards, pkt, pkt2, &rcvd_feedback,
+			                                 &feedback_send, buf2[i]) == true);
+		}
+		CHECK(rohc_decomp_shards_enqueue(shards, pkt, pkt2, NULL, NULL, NULL) == false);
+
+		/* rohc_decomp_shards_dequeue() before any decompression */
+		CHECK(rohc_decomp_shards_dequeue(shards, &pkt2, NULL, NULL, &status,
+		                                 &pkt_priv) == false);
+
+		/* rohc_decomp_shards_run(): CID 0 for shard #0, CID 3 for shard #3 */
+		CHECK(rohc_decomp_shards_run(NULL, 0, 10) == 0);
+		CHECK(rohc_decomp_shards_run(shards, 4, 10) == 0);
+		CHECK(rohc_decomp_shards_run(shards, 1, 10) == 0);
+		CHECK(rohc_decomp_shards_run(shards, 2, 10) == 0);
+		CHECK(rohc_decomp_shards_run(shards, 3, 1) == 1);
+		CHECK(rohc_decomp_shards_run(shards, 3, 10) == 1);
+		CHECK(rohc_decomp_shards_dequeue(shards, &pkt2, NULL, NULL, &status,
+		                                 &pkt_priv) == false);
+		CHECK(rohc_decomp_shards_run(shards, 0, 10) == 2);
+
+		/* rohc_decomp_shards_dequeue() */
+		CHECK(rohc_decomp_shards_dequeue(NULL, &pkt2, NULL, NULL, &status,
+		                                 &pkt_priv) == false);
+		CHECK(rohc_decomp_shards_dequeue(shards, NULL, NULL, NULL, &status,
+		                                 &pkt_priv) == false);
+		CHECK(rohc_decomp_shards_dequeue(shards, &pkt2, NULL, NULL, NULL,
+		                                 &pkt_priv) == false);
+		for(i = 0; i < 4; i++)
+		{
+			CHECK(rohc_decomp_shards_dequeue(shards, &pkt2, &rcvd_feedback,
+			                                 &feedback_send, &status,
+			                                 &pkt_priv) == true);
+			CHECK(status == ROHC_STATUS_OK);
+			CHECK(pkt_priv == buf2[i]);
+			CHECK(rohc_buf_data(pkt2) == buf2[i]);
+			CHECK(pkt2.len == 84);
+			CHECK(rohc_buf_data(rcvd_feedback) == rcvd_buf[i]);
+			CHECK(rcvd_feedback.len == ((i % 2) * 2));
+			CHECK(rohc_buf_data(feedback_send) == send_buf[i]);
+			if(i < 2)
+			{
+				/* first packet of each context is acknowledged */
+				CHECK(feedback_send.len > 0);
+			}
+		}
+		CHECK(rohc_decomp_shards_dequeue(shards, &pkt2, NULL, NULL, &status,
+		                                 NULL) == false);
+
+		/* rohc_decomp_shards_free() */
+		rohc_decomp_shards_free(NULL);
+		rohc_decomp_shards_free(shards);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
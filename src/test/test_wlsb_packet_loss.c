@@ -205,7 +205,7 @@ static bool run_test8_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, win_size);
+	is_ok = wlsb_new(&wlsb, win_size, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -353,7 +353,7 @@ static bool run_test16_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, win_size);
+	is_ok = wlsb_new(&wlsb, win_size, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -501,7 +501,7 @@ static bool run_test32_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, win_size);
+	is_ok = wlsb_new(&wlsb, win_size, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_wlsb_range.c
+ * @brief   Test the single-pass W-LSB range API against the k probes
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * For many windows and values, including values close to the wraparound
+ * boundaries, check that wlsb_range_is_kp_possible() gives the same result
+ * as the wlsb_is_kp_possible_*bits() functions for every k and several shift
+ * parameters, and that wlsb_range_get_min_k() returns the smallest such k.
+ */
+
+#include "schemes/comp_wlsb.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The width of the W-LSB sliding window */
+#define ROHC_WLSB_WINDOW_WIDTH  4U
+
+/** The number of windows to test for every field length */
+#define TEST_WINDOWS_NR  20000U
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+
+static bool test_range(const bool be_verbose, const uint8_t bits_nr)
+	__attribute__((warn_unused_result));
+static uint32_t gen_value(const uint32_t base, const uint8_t bits_nr)
+	__attribute__((warn_unused_result));
+static uint32_t rand32(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test the W-LSB range API
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const uint8_t bits_nrs[] = { 8, 16, 32 };
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		verbose = true;
+	}
+	else
+	{
+		printf("test the single-pass W-LSB range API\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	srand(5);
+
+	for(i = 0; i < (sizeof(bits_nrs) / sizeof(uint8_t)); i++)
+	{
+		trace(verbose, "run test with %u-bit field\n", bits_nrs[i]);
+		if(!test_range(verbose, bits_nrs[i]))
+		{
+			fprintf(stderr, "test with %u-bit field failed\n", bits_nrs[i]);
+			goto error;
+		}
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run the test for one field length
+ *
+ * @param be_verbose  Whether to print traces or not
+ * @param bits_nr     The length (in bits) of the field
+ * @return            true if test succeeds, false otherwise
+ */
+static bool test_range(const bool be_verbose, const uint8_t bits_nr)
+{
+	const uint32_t max_p = (1U << (bits_nr - 1)) - 2;
+	const int32_t p_params[] = {
+		-1, 0, 1, 3, 7, 63, 126, 16383, 32766, 65535, 0x04000000, max_p
+	};
+	struct c_wlsb wlsb;
+	bool is_success = false;
+	size_t n;
+
+	if(!wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, NULL))
+	{
+		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
+		goto error;
+	}
+
+	for(n = 0; n < TEST_WINDOWS_NR; n++)
+	{
+		const uint32_t base = gen_value(rand32(), bits_nr);
+		const uint32_t value = gen_value(base + (rand() % 64) - 32, bits_nr);
+		struct c_wlsb_range range;
+		size_t i;
+
+		/* empty window first, then windows close to the value or not */
+		wlsb.count = 0;
+		wlsb.next = 0;
+		for(i = 0; n > 0 && i < (n % (ROHC_WLSB_WINDOW_WIDTH + 2)); i++)
+		{
+			uint32_t v_ref;
+			if((rand() % 8) == 0)
+			{
+				v_ref = gen_value(rand32(), bits_nr);
+			}
+			else
+			{
+				v_ref = gen_value(base + (rand() % 256) - 128, bits_nr);
+			}
+			c_add_wlsb(&wlsb, i, v_ref);
+		}
+
+		if(bits_nr == 8)
+		{
+			wlsb_get_range_8bits(&wlsb, value, &range);
+		}
+		else if(bits_nr == 16)
+		{
+			wlsb_get_range_16bits(&wlsb, value, &range);
+		}
+		else
+		{
+			wlsb_get_range_32bits(&wlsb, value, &range);
+		}
+
+		for(i = 0; i < (sizeof(p_params) / sizeof(int32_t)); i++)
+		{
+			const int32_t p = p_params[i];
+			size_t min_k = bits_nr;
+			size_t k;
+
+			if(p > ((int64_t) max_p))
+			{
+				continue;
+			}
+
+			for(k = 0; k <= bits_nr; k++)
+			{
+				bool expected;
+				bool got;
+
+				if(bits_nr == 8)
+				{
+					expected = wlsb_is_kp_possible_8bits(&wlsb, value, k, p);
+				}
+				else if(bits_nr == 16)
+				{
+					expected = wlsb_is_kp_possible_16bits(&wlsb, value, k, p);
+				}
+				else
+				{
+					expected = wlsb_is_kp_possible_32bits(&wlsb, value, k, p);
+				}
+				got = wlsb_range_is_kp_possible(&range, k, p);
+				if(got != expected)
+				{
+					fprintf(stderr, "value 0x%08x, k = %zu, p = %d: range API "
+					        "returned %d while %d was expected\n", value, k, p,
+					        got, expected);
+					goto free_wlsb;
+				}
+				if(expected && k < min_k)
+				{
+					min_k = k;
+				}
+			}
+
+			if(wlsb_range_get_min_k(&range, p) != min_k)
+			{
+				fprintf(stderr, "value 0x%08x, p = %d: minimal k is %zu while %zu "
+				        "was expected\n", value, p, wlsb_range_get_min_k(&range, p),
+				        min_k);
+				goto free_wlsb;
+			}
+		}
+	}
+	trace(be_verbose, "\t%u windows successfully tested\n", TEST_WINDOWS_NR);
+
+	is_success = true;
+
+free_wlsb:
+	wlsb_free(&wlsb);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Truncate the given value to the field length
+ *
+ * @param base     The value to truncate
+ * @param bits_nr  The length (in bits) of the field
+ * @return         The truncated value
+ */
+static uint32_t gen_value(const uint32_t base, const uint8_t bits_nr)
+{
+	return (bits_nr == 32 ? base : (base & ((1U << bits_nr) - 1)));
+}
+
+
+/**
+ * @brief Generate a 32-bit random number
+ *
+ * @return  The random number
+ */
+static uint32_t rand32(void)
+{
+	return ((((uint32_t) rand()) << 16) ^ ((uint32_t) rand()));
+}
+
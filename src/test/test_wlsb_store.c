@@ -0,0 +1,278 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_wlsb_store.c
+ * @brief   Test the multi-field W-LSB store against standalone W-LSB objects
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Feed the same values and the same acknowledgements to the fields of one
+ * W-LSB store and to standalone W-LSB objects, then check that the windows
+ * of the store, of its copy and of the standalone objects are always the
+ * same.
+ */
+
+#include "schemes/comp_wlsb.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The number of fields in the W-LSB store */
+#define TEST_FIELDS_NR  5U
+
+/** The number of fields that share the SN ring of the W-LSB store */
+#define TEST_SHARED_FIELDS_NR  3U
+
+/** The number of packets to test for every window width */
+#define TEST_PACKETS_NR  20000U
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+
+static bool test_store(const bool be_verbose, const size_t window_width)
+	__attribute__((warn_unused_result));
+static bool check_fields(struct c_wlsb *const fields[],
+                         const struct c_wlsb *const refs,
+                         const size_t packet_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/**
+ * @brief Test the multi-field W-LSB store
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const size_t window_widths[] = { 1, 2, 4, 16, ROHC_WLSB_WIDTH_MAX };
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		verbose = true;
+	}
+	else
+	{
+		printf("test the multi-field W-LSB store\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	srand(5);
+
+	for(i = 0; i < (sizeof(window_widths) / sizeof(size_t)); i++)
+	{
+		trace(verbose, "run test with window width %zu\n", window_widths[i]);
+		if(!test_store(verbose, window_widths[i]))
+		{
+			fprintf(stderr, "test with window width %zu failed\n",
+			        window_widths[i]);
+			goto error;
+		}
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run the test for one window width
+ *
+ * @param be_verbose    Whether to print traces or not
+ * @param window_width  The width of the W-LSB windows
+ * @return              true if test succeeds, false otherwise
+ */
+static bool test_store(const bool be_verbose, const size_t window_width)
+{
+	struct c_wlsb_store store;
+	struct c_wlsb_store store_copy;
+	struct c_wlsb wlsbs[TEST_FIELDS_NR];
+	struct c_wlsb wlsbs_copy[TEST_FIELDS_NR];
+	struct c_wlsb *fields[TEST_FIELDS_NR];
+	struct c_wlsb *fields_copy[TEST_FIELDS_NR];
+	struct c_wlsb refs[TEST_FIELDS_NR];
+	bool is_success = false;
+	size_t refs_nr;
+	size_t n;
+	size_t i;
+
+	for(i = 0; i < TEST_FIELDS_NR; i++)
+	{
+		fields[i] = &wlsbs[i];
+		fields_copy[i] = &wlsbs_copy[i];
+	}
+
+	if(!wlsb_store_new(&store, fields, TEST_FIELDS_NR, TEST_SHARED_FIELDS_NR,
+	                   window_width, NULL))
+	{
+		fprintf(stderr, "no memory to allocate W-LSB store\n");
+		goto error;
+	}
+	for(refs_nr = 0; refs_nr < TEST_FIELDS_NR; refs_nr++)
+	{
+		if(!wlsb_new(&refs[refs_nr], window_width, NULL))
+		{
+			fprintf(stderr, "no memory to allocate W-LSB encoding\n");
+			goto free_refs;
+		}
+	}
+
+	for(n = 0; n < TEST_PACKETS_NR; n++)
+	{
+		const uint32_t sn = n & 0xffff;
+		size_t acked_nr = 0;
+		size_t ref_acked_nr = 0;
+
+		/* the shared fields are updated with every packet, the other fields
+		 * with some packets only */
+		for(i = 0; i < TEST_FIELDS_NR; i++)
+		{
+			if(i < TEST_SHARED_FIELDS_NR || (rand() % 3) == 0)
+			{
+				const uint32_t value = rand();
+				c_add_wlsb(fields[i], sn, value);
+				c_add_wlsb(&refs[i], sn, value);
+			}
+		}
+
+		/* acknowledge one of the last packets from time to time, or a packet
+		 * that was never sent */
+		if((rand() % 4) == 0)
+		{
+			const size_t sn_bits_nr = ((rand() % 2) == 0 ? 4 : 16);
+			const uint32_t sn_mask = (1U << sn_bits_nr) - 1;
+			const uint32_t acked_sn = (sn - (rand() % (window_width + 2))) & sn_mask;
+
+			acked_nr = wlsb_store_ack(&store, fields, acked_sn, sn_bits_nr);
+			for(i = 0; i < TEST_FIELDS_NR; i++)
+			{
+				ref_acked_nr += wlsb_ack(&refs[i], acked_sn, sn_bits_nr);
+			}
+			if(acked_nr != ref_acked_nr)
+			{
+				fprintf(stderr, "packet #%zu: store acked %zu values while %zu "
+				        "were expected\n", n, acked_nr, ref_acked_nr);
+				goto free_refs;
+			}
+		}
+
+		if(!check_fields(fields, refs, n))
+		{
+			goto free_refs;
+		}
+
+		/* the copy of the store shall be the same */
+		if((n % 97) == 0)
+		{
+			memcpy(wlsbs_copy, wlsbs, sizeof(struct c_wlsb) * TEST_FIELDS_NR);
+			if(!wlsb_store_copy(&store_copy, fields_copy, &store, NULL))
+			{
+				fprintf(stderr, "no memory to copy W-LSB store\n");
+				goto free_refs;
+			}
+			is_success = check_fields(fields_copy, refs, n);
+			wlsb_store_free(&store_copy);
+			if(!is_success)
+			{
+				goto free_refs;
+			}
+			is_success = false;
+		}
+	}
+	trace(be_verbose, "\t%u packets successfully tested\n", TEST_PACKETS_NR);
+
+	is_success = true;
+
+free_refs:
+	for(i = 0; i < refs_nr; i++)
+	{
+		wlsb_free(&refs[i]);
+	}
+	wlsb_store_free(&store);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Check that the fields of the W-LSB store match the reference objects
+ *
+ * @param fields     The W-LSB objects of the fields of the store
+ * @param refs       The standalone W-LSB objects
+ * @param packet_nr  The number of the current packet
+ * @return           true if the windows are the same, false otherwise
+ */
+static bool check_fields(struct c_wlsb *const fields[],
+                         const struct c_wlsb *const refs,
+                         const size_t packet_nr)
+{
+	size_t i;
+
+	for(i = 0; i < TEST_FIELDS_NR; i++)
+	{
+		size_t entry;
+
+		if(fields[i]->count != refs[i].count || fields[i]->next != refs[i].next)
+		{
+			fprintf(stderr, "packet #%zu: field #%zu: count/next %u/%u while "
+			        "%u/%u were expected\n", packet_nr, i, fields[i]->count,
+			        fields[i]->next, refs[i].count, refs[i].next);
+			return false;
+		}
+		for(entry = 0; entry < refs[i].count; entry++)
+		{
+			if(fields[i]->sns[entry] != refs[i].sns[entry] ||
+			   fields[i]->values[entry] != refs[i].values[entry])
+			{
+				fprintf(stderr, "packet #%zu: field #%zu: entry #%zu is SN %u / "
+				        "value 0x%08x while SN %u / value 0x%08x was expected\n",
+				        packet_nr, i, entry, fields[i]->sns[entry],
+				        fields[i]->values[entry], refs[i].sns[entry],
+				        refs[i].values[entry]);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
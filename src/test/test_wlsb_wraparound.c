@@ -202,7 +202,7 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 	bool is_ok;
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -265,7 +265,7 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 	bool is_ok;
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -329,7 +329,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	bool is_ok;
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -366,7 +366,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	wlsb_free(&wlsb);
 
 	/* create the W-LSB encoding context again */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -404,7 +404,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	wlsb_free(&wlsb);
 
 	/* create the W-LSB encoding context again */
-	is_ok = wlsb_new(&wlsb, 64U);
+	is_ok = wlsb_new(&wlsb, 64U, NULL);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_arena.c
+ * @brief  Check the compression and decompression with the slab allocators
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses more IPv4/UDP and IPv4/UDP/RTP
+ * flows than there are CIDs, so that contexts are continuously destroyed and
+ * created again: at any time, 8 flows out of 37 are active, and one active
+ * flow is replaced by another one every few packets. The decompressor runs
+ * in O-mode and its feedback is delivered to the compressor.
+ *
+ * The test is run without slab allocators, then with the smallest slabs the
+ * documentation of rohc_comp_set_arena() and rohc_decomp_set_arena() gives
+ * for MAX_CID, so that the objects of the slabs are reused by new contexts
+ * and the slabs never run out of objects. All the packets shall be
+ * decompressed correctly, and the ROHC packets shall be the same in both
+ * cases.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of UDP and RTP flows */
+#define FLOWS_NR  37U
+
+/** The largest CID, ie. the number of contexts minus one */
+#define MAX_CID  7U
+
+/** The number of packets between two changes of the active flows */
+#define PKTS_PER_STEP  64U
+
+/** The number of packets to compress, every flow is active twice */
+#define PKTS_NR  (FLOWS_NR * PKTS_PER_STEP * 2U)
+
+/** The number of objects per slab of the compressor */
+#define COMP_OBJS_PER_SLAB  ((MAX_CID + 1U) * 4U)
+
+/** The number of objects per slab of the decompressor */
+#define DECOMP_OBJS_PER_SLAB  ((MAX_CID + 2U) * 3U)
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 12U + 20U)
+
+
+/* prototypes of private functions */
+static bool test_arena(const size_t comp_objs_per_slab,
+                       const size_t decomp_objs_per_slab,
+                       uint64_t *const rohc_hash)
+	__attribute__((warn_unused_result, nonnull(3)));
+
+
+/**
+ * @brief Check the compression and decompression with the slab allocators
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	uint64_t malloc_hash;
+	uint64_t arena_hash;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_arena\n");
+		goto error;
+	}
+
+	if(!test_arena(0, 0, &malloc_hash))
+	{
+		fprintf(stderr, "test failed without slab allocators\n");
+		goto error;
+	}
+	if(!test_arena(COMP_OBJS_PER_SLAB, DECOMP_OBJS_PER_SLAB, &arena_hash))
+	{
+		fprintf(stderr, "test failed with slab allocators\n");
+		goto error;
+	}
+
+	/* same ROHC packets */
+	if(malloc_hash != arena_hash)
+	{
+		fprintf(stderr, "ROHC packets differ whether slab allocators are used "
+		        "or not\n");
+		goto error;
+	}
+
+	/* everything went fine */
+	printf("all tests are successful\n");
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress and decompress all the flows
+ *
+ * @param comp_objs_per_slab    The number of objects per slab of the
+ *                              compressor, 0 to disable its slab allocator
+ * @param decomp_objs_per_slab  The number of objects per slab of the
+ *                              decompressor, 0 to disable its slab allocator
+ * @param rohc_hash             OUT: A hash of all the ROHC packets
+ * @return                      true if the test succeeded, false otherwise
+ */
+static bool test_arena(const size_t comp_objs_per_slab,
+                       const size_t decomp_objs_per_slab,
+                       uint64_t *const rohc_hash)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint16_t flows_sn[FLOWS_NR] = { 0 };
+	size_t i;
+	bool is_success = false;
+
+	printf("test with %zu/%zu objects per slab\n", comp_objs_per_slab,
+	       decomp_objs_per_slab);
+
+	*rohc_hash = 14695981039346656037ULL;
+	srand(42);
+
+	/* create the compressor with the UDP and RTP profiles */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, MAX_CID, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_heuristic(comp, 5000, 5099))
+	{
+		fprintf(stderr, "failed to enable the built-in RTP heuristic\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_arena(comp, comp_objs_per_slab))
+	{
+		fprintf(stderr, "failed to set the slab allocator of the compressor\n");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor in O-mode with the UDP and RTP profiles */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, MAX_CID, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_arena(decomp, decomp_objs_per_slab))
+	{
+		fprintf(stderr, "failed to set the slab allocator of the decompressor\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the packets of the active flows: flows
+	 * [step, step + MAX_CID] are active, one flow is replaced by another one
+	 * at every step */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		const size_t step = i / PKTS_PER_STEP;
+		const size_t flow = (step + (i % (MAX_CID + 1))) % FLOWS_NR;
+		const struct rohc_ts arrival_time = { .sec = i / 50, .nsec = (i % 50) * 20000000 };
+		uint8_t ip_buffer[IP_PKT_LEN];
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, IP_PKT_LEN, arrival_time);
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		uint8_t decomp_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		uint8_t feedback_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+		rohc_status_t status;
+		size_t j;
+
+		/* even flows are RTP flows, odd flows are UDP flows */
+		if((flow % 2) == 0)
+		{
+			const uint16_t port = 5000 + flow * 2;
+			test_build_rtp_packet(ip_buffer, IP_PKT_LEN, port, port, 0,
+			                      flows_sn[flow], 0x1000 + flow);
+		}
+		else
+		{
+			const uint16_t port = 6000 + flow * 2;
+			test_build_udp_packet(ip_buffer, IP_PKT_LEN, port, port, flows_sn[flow]);
+		}
+		flows_sn[flow]++;
+
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%zu\n", i + 1);
+			goto destroy_decomp;
+		}
+		for(j = 0; j < rohc_packet.len; j++)
+		{
+			*rohc_hash ^= rohc_buf_byte_at(rohc_packet, j);
+			*rohc_hash *= 1099511628211ULL;
+		}
+
+		status = rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                          &feedback_send);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress packet #%zu\n", i + 1);
+			goto destroy_decomp;
+		}
+		if(decomp_packet.len != IP_PKT_LEN ||
+		   memcmp(rohc_buf_data(decomp_packet), ip_buffer, IP_PKT_LEN) != 0)
+		{
+			fprintf(stderr, "packet #%zu is not decompressed correctly\n", i + 1);
+			goto destroy_decomp;
+		}
+
+		if(feedback_send.len > 0 &&
+		   !rohc_comp_deliver_feedback2(comp, feedback_send))
+		{
+			fprintf(stderr, "failed to deliver the feedback of packet #%zu\n",
+			        i + 1);
+			goto destroy_decomp;
+		}
+	}
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
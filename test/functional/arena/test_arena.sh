@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# Copyright 2018 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+
+#
+# file:        test_arena.sh
+# description: Check the compression and decompression with the slab
+#              allocators of the compressor and decompressor
+# author:      Didier Barvaux <didier@barvaux.org>
+#
+# Script arguments:
+#    test_arena.sh [verbose]
+# where:
+#   verbose          prints the traces of test application
+#
+
+if [ "${CROSS_COMPILATION}" = "yes" ] && \
+   [ -z "${CROSS_COMPILATION_EMULATOR}" ] ; then
+	exit 77
+fi
+
+SCRIPT="$0"
+VERBOSE="$1"
+if [ "x$MAKELEVEL" != "x" ] ; then
+	BASEDIR="${srcdir}"
+	APP="./test_arena${CROSS_COMPILATION_EXEEXT}"
+else
+	BASEDIR=$( dirname "${SCRIPT}" )
+	APP="${BASEDIR}/test_arena${CROSS_COMPILATION_EXEEXT}"
+fi
+
+CMD="${CROSS_COMPILATION_EMULATOR} ${APP}"
+
+if [ "${VERBOSE}" = "verbose" ] ; then
+	${CMD} || exit $?
+else
+	${CMD} > /dev/null 2>&1 || exit $?
+fi
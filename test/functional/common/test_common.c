@@ -0,0 +1,232 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_common.c
+ * @brief  Helpers shared by the functional tests
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "test_common.h"
+
+/* system includes */
+#include <stdlib.h>
+#include <string.h>
+
+
+static void build_ipv4_hdr(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint8_t protocol,
+                           const uint16_t ip_id)
+	__attribute__((nonnull(1)));
+
+static void build_udp_hdr(uint8_t *const udp,
+                          const uint16_t udp_len,
+                          const uint16_t sport,
+                          const uint16_t dport)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Build one IPv4/UDP packet
+ *
+ * @param pkt      The buffer to build the packet in
+ * @param pkt_len  The length of the packet, at least \ref TEST_UDP_HDRS_LEN
+ * @param sport    The UDP source port
+ * @param dport    The UDP destination port
+ * @param sn       The number of the packet, it gives the IP-ID and the payload
+ */
+void test_build_udp_packet(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint16_t sport,
+                           const uint16_t dport,
+                           const uint16_t sn)
+{
+	build_ipv4_hdr(pkt, pkt_len, 17, sn);
+	build_udp_hdr(pkt + 20, pkt_len - 20, sport, dport);
+
+	/* payload */
+	memset(pkt + TEST_UDP_HDRS_LEN, sn & 0xff, pkt_len - TEST_UDP_HDRS_LEN);
+}
+
+
+/**
+ * @brief Build one IPv4/UDP/RTP packet
+ *
+ * The RTP timestamp is incremented by 160 with every packet, as for a 20 ms
+ * audio codec sampled at 8 kHz.
+ *
+ * @param pkt      The buffer to build the packet in
+ * @param pkt_len  The length of the packet, at least \ref TEST_RTP_HDRS_LEN
+ * @param sport    The UDP source port
+ * @param dport    The UDP destination port
+ * @param pt       The RTP Payload Type
+ * @param sn       The RTP Sequence Number, it gives the IP-ID and the payload
+ * @param ssrc     The RTP SSRC
+ */
+void test_build_rtp_packet(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint16_t sport,
+                           const uint16_t dport,
+                           const uint8_t pt,
+                           const uint16_t sn,
+                           const uint32_t ssrc)
+{
+	const uint32_t ts = sn * 160;
+	uint8_t *const rtp = pkt + TEST_UDP_HDRS_LEN;
+
+	build_ipv4_hdr(pkt, pkt_len, 17, sn);
+	build_udp_hdr(pkt + 20, pkt_len - 20, sport, dport);
+
+	/* RTP header, version 2 */
+	rtp[0] = 0x80;
+	rtp[1] = pt & 0x7f;
+	rtp[2] = (sn >> 8) & 0xff;
+	rtp[3] = sn & 0xff;
+	rtp[4] = (ts >> 24) & 0xff;
+	rtp[5] = (ts >> 16) & 0xff;
+	rtp[6] = (ts >> 8) & 0xff;
+	rtp[7] = ts & 0xff;
+	rtp[8] = (ssrc >> 24) & 0xff;
+	rtp[9] = (ssrc >> 16) & 0xff;
+	rtp[10] = (ssrc >> 8) & 0xff;
+	rtp[11] = ssrc & 0xff;
+
+	/* payload */
+	memset(pkt + TEST_RTP_HDRS_LEN, sn & 0xff, pkt_len - TEST_RTP_HDRS_LEN);
+}
+
+
+/**
+ * @brief Build one IPv4/TCP packet of a bulk transfer from port 40000 to 80
+ *
+ * The TCP sequence number grows with the length of the payload, so that all
+ * the packets of the transfer are in sequence.
+ *
+ * @param pkt      The buffer to build the packet in
+ * @param pkt_len  The length of the packet, at least \ref TEST_TCP_HDRS_LEN
+ * @param num      The number of the packet, it gives the IP-ID, the TCP
+ *                 sequence number and checksum, and the payload
+ */
+void test_build_tcp_packet(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint16_t num)
+{
+	const uint32_t seq = 1000 + num * (pkt_len - TEST_TCP_HDRS_LEN);
+	uint8_t *const tcp = pkt + 20;
+
+	build_ipv4_hdr(pkt, pkt_len, 6, num);
+
+	/* TCP header without options */
+	tcp[0] = 0x9c; tcp[1] = 0x40; /* port 40000 */
+	tcp[2] = 0x00; tcp[3] = 0x50; /* port 80 */
+	tcp[4] = (seq >> 24) & 0xff;
+	tcp[5] = (seq >> 16) & 0xff;
+	tcp[6] = (seq >> 8) & 0xff;
+	tcp[7] = seq & 0xff;
+	tcp[8] = 0x00; tcp[9] = 0x00; tcp[10] = 0x13; tcp[11] = 0x88; /* ACK */
+	tcp[12] = 0x50; /* data offset */
+	tcp[13] = 0x10; /* ACK flag */
+	tcp[14] = 0xff; tcp[15] = 0xff; /* window */
+	tcp[16] = (num >> 8) & 0xff; tcp[17] = num & 0xff; /* checksum */
+	tcp[18] = 0x00; tcp[19] = 0x00; /* urgent pointer */
+
+	/* payload */
+	memset(pkt + TEST_TCP_HDRS_LEN, num & 0xff, pkt_len - TEST_TCP_HDRS_LEN);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+int test_gen_random_num(const struct rohc_comp *const comp,
+                        void *const user_context)
+{
+	return rand();
+}
+
+
+/**
+ * @brief Build one IPv4 header from 192.168.0.1 to 192.168.0.2
+ *
+ * @param pkt       The buffer to build the IPv4 header in
+ * @param pkt_len   The total length of the IPv4 packet
+ * @param protocol  The protocol of the next header
+ * @param ip_id     The IP-ID of the packet
+ */
+static void build_ipv4_hdr(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint8_t protocol,
+                           const uint16_t ip_id)
+{
+	uint32_t checksum = 0;
+	size_t i;
+
+	memset(pkt, 0, 20);
+
+	pkt[0] = 0x45;
+	pkt[2] = (pkt_len >> 8) & 0xff;
+	pkt[3] = pkt_len & 0xff;
+	pkt[4] = (ip_id >> 8) & 0xff;
+	pkt[5] = ip_id & 0xff;
+	pkt[6] = 0x40; /* DF */
+	pkt[8] = 64; /* TTL */
+	pkt[9] = protocol;
+	pkt[12] = 192; pkt[13] = 168; pkt[14] = 0; pkt[15] = 1;
+	pkt[16] = 192; pkt[17] = 168; pkt[18] = 0; pkt[19] = 2;
+	for(i = 0; i < 20; i += 2)
+	{
+		checksum += (pkt[i] << 8) | pkt[i + 1];
+	}
+	while((checksum >> 16) != 0)
+	{
+		checksum = (checksum & 0xffff) + (checksum >> 16);
+	}
+	checksum = ~checksum;
+	pkt[10] = (checksum >> 8) & 0xff;
+	pkt[11] = checksum & 0xff;
+}
+
+
+/**
+ * @brief Build one UDP header without checksum
+ *
+ * @param udp      The buffer to build the UDP header in
+ * @param udp_len  The length of the UDP header and payload
+ * @param sport    The UDP source port
+ * @param dport    The UDP destination port
+ */
+static void build_udp_hdr(uint8_t *const udp,
+                          const uint16_t udp_len,
+                          const uint16_t sport,
+                          const uint16_t dport)
+{
+	udp[0] = (sport >> 8) & 0xff;
+	udp[1] = sport & 0xff;
+	udp[2] = (dport >> 8) & 0xff;
+	udp[3] = dport & 0xff;
+	udp[4] = (udp_len >> 8) & 0xff;
+	udp[5] = udp_len & 0xff;
+	udp[6] = 0x00;
+	udp[7] = 0x00;
+}
+
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_common.h
+ * @brief  Helpers shared by the functional tests
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The functional tests build their IP packets on the fly. All the packets are
+ * IPv4 packets from 192.168.0.1 to 192.168.0.2 with a sequential IP-ID, the
+ * DF flag and a valid IPv4 checksum. Their payload is filled with the least
+ * significant byte of the packet number.
+ */
+
+#ifndef ROHC_TEST_FUNCTIONAL_COMMON__H
+#define ROHC_TEST_FUNCTIONAL_COMMON__H
+
+#include <rohc_comp.h>
+
+#include <stdint.h>
+
+
+/** The length of the IPv4/UDP headers built by the helpers */
+#define TEST_UDP_HDRS_LEN  (20U + 8U)
+
+/** The length of the IPv4/UDP/RTP headers built by the helpers */
+#define TEST_RTP_HDRS_LEN  (20U + 8U + 12U)
+
+/** The length of the IPv4/TCP headers built by the helpers */
+#define TEST_TCP_HDRS_LEN  (20U + 20U)
+
+
+void test_build_udp_packet(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint16_t sport,
+                           const uint16_t dport,
+                           const uint16_t sn)
+	__attribute__((nonnull(1)));
+
+void test_build_rtp_packet(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint16_t sport,
+                           const uint16_t dport,
+                           const uint8_t pt,
+                           const uint16_t sn,
+                           const uint32_t ssrc)
+	__attribute__((nonnull(1)));
+
+void test_build_tcp_packet(uint8_t *const pkt,
+                           const uint16_t pkt_len,
+                           const uint16_t num)
+	__attribute__((nonnull(1)));
+
+int test_gen_random_num(const struct rohc_comp *const comp,
+                        void *const user_context)
+	__attribute__((warn_unused_result));
+
+#endif
+
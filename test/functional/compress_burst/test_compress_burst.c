@@ -0,0 +1,337 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_compress_burst.c
+ * @brief  Check the compression of bursts of packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses several IPv4/UDP and IPv4/UDP/RTP flows twice:
+ *  - one packet at a time with rohc_compress4(),
+ *  - in bursts of packets with rohc_compress_burst().
+ *
+ * In the middle of every burst, one packet is malformed and cannot be
+ * compressed. Once in a while, the output buffer of the next packet is also
+ * too small for its ROHC packet, so it fails to be compressed too. The status
+ * of every packet and the ROHC packets must be the same in both cases, and
+ * the compression of the packets that follow a failing packet in a burst
+ * shall not be affected.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+
+
+/** The number of UDP and RTP flows */
+#define FLOWS_NR  6U
+
+/** The number of bursts to compress */
+#define BURSTS_NR  100U
+
+/** The number of packets in every burst */
+#define BURST_LEN  32U
+
+/** The position of the malformed packet in every burst */
+#define MALFORMED_POS  (BURST_LEN / 2)
+
+/** The output buffer of one burst out of SMALL_OUTPUT_PERIOD is too small */
+#define SMALL_OUTPUT_PERIOD  7U
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 12U + 20U)
+
+/** The length of the truncated IP packet, shorter than its IPv4 header */
+#define MALFORMED_PKT_LEN  10U
+
+
+/** The result of one run of the test */
+struct test_result
+{
+	/** The status of the compression of every packet */
+	rohc_status_t statuses[BURSTS_NR * BURST_LEN];
+	/** The number of packets compressed successfully */
+	size_t ok_nr;
+	/** A hash of all the ROHC packets */
+	uint64_t rohc_hash;
+};
+
+
+/* prototypes of private functions */
+static bool test_compress_burst(const char *const descr,
+                                const bool use_burst,
+                                struct test_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static rohc_status_t expected_status(const size_t burst, const size_t pos)
+	__attribute__((warn_unused_result, const));
+
+
+/**
+ * @brief Check the compression of bursts of packets
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	static struct test_result one_by_one;
+	static struct test_result burst;
+	size_t i;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_compress_burst\n");
+		goto error;
+	}
+
+	if(!test_compress_burst("one packet at a time", false, &one_by_one) ||
+	   !test_compress_burst("bursts of packets", true, &burst))
+	{
+		goto error;
+	}
+
+	/* same status for every packet, same ROHC packets */
+	for(i = 0; i < (BURSTS_NR * BURST_LEN); i++)
+	{
+		if(one_by_one.statuses[i] != burst.statuses[i])
+		{
+			fprintf(stderr, "packet #%zu: status %d one at a time, but %d in "
+			        "burst\n", i + 1, one_by_one.statuses[i], burst.statuses[i]);
+			goto error;
+		}
+	}
+	if(one_by_one.ok_nr != burst.ok_nr)
+	{
+		fprintf(stderr, "%zu packets compressed one at a time, but %zu in "
+		        "bursts\n", one_by_one.ok_nr, burst.ok_nr);
+		goto error;
+	}
+	if(one_by_one.rohc_hash != burst.rohc_hash)
+	{
+		fprintf(stderr, "ROHC packets differ whether packets are compressed one "
+		        "at a time or in bursts\n");
+		goto error;
+	}
+
+	/* everything went fine */
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress all the flows one packet at a time or in bursts
+ *
+ * @param descr      The description of the way of compressing packets
+ * @param use_burst  Whether to compress the packets in bursts
+ * @param result     OUT: The result of the test
+ * @return           true if the test succeeded, false otherwise
+ */
+static bool test_compress_burst(const char *const descr,
+                                const bool use_burst,
+                                struct test_result *const result)
+{
+	struct rohc_comp *comp;
+	uint8_t ip_buffers[BURST_LEN][IP_PKT_LEN];
+	struct rohc_buf ip_packets[BURST_LEN];
+	uint8_t rohc_buffers[BURST_LEN][MAX_ROHC_SIZE];
+	struct rohc_buf rohc_packets[BURST_LEN];
+	uint16_t flows_sn[FLOWS_NR] = { 0 };
+	size_t burst;
+	bool is_success = false;
+
+	printf("test compression: %s\n", descr);
+
+	memset(result, 0, sizeof(struct test_result));
+	result->rohc_hash = 14695981039346656037ULL;
+	srand(42);
+
+	/* create the compressor with the UDP and RTP profiles, but without the
+	 * Uncompressed profile, so that malformed packets cannot be compressed */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_heuristic(comp, 5000, 5099))
+	{
+		fprintf(stderr, "failed to enable the built-in RTP heuristic\n");
+		goto destroy_comp;
+	}
+
+	for(burst = 0; burst < BURSTS_NR; burst++)
+	{
+		const bool small_output = ((burst % SMALL_OUTPUT_PERIOD) == 0);
+		rohc_status_t *const statuses = result->statuses + burst * BURST_LEN;
+		size_t burst_ok_nr = 0;
+		size_t pos;
+
+		/* build the packets of the burst: even flows are RTP flows, odd flows
+		 * are UDP flows */
+		for(pos = 0; pos < BURST_LEN; pos++)
+		{
+			const size_t i = burst * BURST_LEN + pos;
+			const size_t flow = i % FLOWS_NR;
+			const struct rohc_ts arrival_time =
+				{ .sec = i / 50, .nsec = (i % 50) * 20000000 };
+			size_t ip_len = IP_PKT_LEN;
+			size_t rohc_max_len = MAX_ROHC_SIZE;
+
+			if((flow % 2) == 0)
+			{
+				const uint16_t port = 5000 + flow * 2;
+				test_build_rtp_packet(ip_buffers[pos], IP_PKT_LEN, port, port, 0,
+				                      flows_sn[flow], 0x1000 + flow);
+			}
+			else
+			{
+				const uint16_t port = 6000 + flow * 2;
+				test_build_udp_packet(ip_buffers[pos], IP_PKT_LEN, port, port,
+				                      flows_sn[flow]);
+			}
+			if(pos == MALFORMED_POS)
+			{
+				ip_len = MALFORMED_PKT_LEN;
+			}
+			else
+			{
+				flows_sn[flow]++;
+			}
+			if(small_output && pos == (MALFORMED_POS + 1))
+			{
+				rohc_max_len = 2;
+			}
+
+			ip_packets[pos].time = arrival_time;
+			ip_packets[pos].data = ip_buffers[pos];
+			ip_packets[pos].max_len = IP_PKT_LEN;
+			ip_packets[pos].offset = 0;
+			ip_packets[pos].len = ip_len;
+			rohc_packets[pos].time.sec = 0;
+			rohc_packets[pos].time.nsec = 0;
+			rohc_packets[pos].data = rohc_buffers[pos];
+			rohc_packets[pos].max_len = rohc_max_len;
+			rohc_packets[pos].offset = 0;
+			rohc_packets[pos].len = 0;
+		}
+
+		/* compress the burst */
+		if(use_burst)
+		{
+			burst_ok_nr = rohc_compress_burst(comp, ip_packets, rohc_packets,
+			                                  statuses, BURST_LEN);
+		}
+		else
+		{
+			for(pos = 0; pos < BURST_LEN; pos++)
+			{
+				statuses[pos] = rohc_compress4(comp, ip_packets[pos],
+				                               &(rohc_packets[pos]));
+				if(statuses[pos] == ROHC_STATUS_OK)
+				{
+					burst_ok_nr++;
+				}
+			}
+		}
+
+		/* check the status of every packet and hash the ROHC packets */
+		for(pos = 0; pos < BURST_LEN; pos++)
+		{
+			const rohc_status_t expected = expected_status(burst, pos);
+			size_t j;
+
+			if(statuses[pos] != expected)
+			{
+				fprintf(stderr, "burst #%zu: packet #%zu has status %d while %d "
+				        "was expected\n", burst + 1, pos + 1, statuses[pos],
+				        expected);
+				goto destroy_comp;
+			}
+			if(statuses[pos] != ROHC_STATUS_OK)
+			{
+				continue;
+			}
+			for(j = 0; j < rohc_packets[pos].len; j++)
+			{
+				result->rohc_hash ^= rohc_buf_byte_at(rohc_packets[pos], j);
+				result->rohc_hash *= 1099511628211ULL;
+			}
+		}
+		if(burst_ok_nr != (BURST_LEN - 1 - (small_output ? 1 : 0)))
+		{
+			fprintf(stderr, "burst #%zu: %zu packets compressed successfully\n",
+			        burst + 1, burst_ok_nr);
+			goto destroy_comp;
+		}
+		result->ok_nr += burst_ok_nr;
+	}
+
+	printf("\t%zu packets compressed successfully\n", result->ok_nr);
+
+	is_success = true;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Get the status expected for one packet of one burst
+ *
+ * @param burst  The index of the burst
+ * @param pos    The position of the packet in the burst
+ * @return       The expected compression status
+ */
+static rohc_status_t expected_status(const size_t burst, const size_t pos)
+{
+	rohc_status_t expected = ROHC_STATUS_OK;
+
+	/* rohc_compress4() reports too small output buffers as errors when ROHC
+	 * segmentation is disabled */
+	if(pos == MALFORMED_POS ||
+	   (pos == (MALFORMED_POS + 1) && (burst % SMALL_OUTPUT_PERIOD) == 0))
+	{
+		expected = ROHC_STATUS_ERROR;
+	}
+
+	return expected;
+}
@@ -0,0 +1,376 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_decomp_shards.c
+ * @brief  Check that the sharded decompressor gives back the packets in order
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses many IPv4/UDP flows with one compressor, then
+ * decompresses them with a sharded decompressor: every shard runs on its own
+ * thread. The decompressed packets are given back in order and compared
+ * with the original packets. The feedback built by the shards is delivered
+ * to the compressor. The test is run with small and large CIDs.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of shards, and of worker threads */
+#define SHARDS_NR  4U
+
+/** The number of packets to decompress */
+#define PKTS_NR  20000U
+
+/** The number of packets that may wait for decompression */
+#define QUEUE_LEN  64U
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 20U)
+
+
+/** The context of one worker thread */
+struct worker
+{
+	pthread_t thread;                  /**< The worker thread */
+	struct rohc_decomp_shards *shards; /**< The sharded decompressor */
+	size_t shard;                      /**< The shard of the worker */
+	bool stop;                         /**< Whether the worker shall stop */
+};
+
+
+/* prototypes of private functions */
+static bool test_decomp_shards(const rohc_cid_type_t cid_type,
+                               const rohc_cid_t max_cid,
+                               const size_t flows_nr)
+	__attribute__((warn_unused_result));
+static void * worker_run(void *arg)
+	__attribute__((nonnull(1)));
+static bool check_next_packet(struct rohc_decomp_shards *const shards,
+                              struct rohc_comp *const comp,
+                              uint8_t ip_buffers[QUEUE_LEN][IP_PKT_LEN],
+                              const size_t pkt_num)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+
+/**
+ * @brief Check that the sharded decompressor gives back the packets in order
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_decomp_shards\n");
+		goto error;
+	}
+
+	/* 16 contexts with small CIDs, then 500 contexts with large CIDs, some of
+	 * them on 2 bytes */
+	if(!test_decomp_shards(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, 16))
+	{
+		goto error;
+	}
+	if(!test_decomp_shards(ROHC_LARGE_CID, 499, 500))
+	{
+		goto error;
+	}
+
+	/* everything went fine */
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress the packets of several flows with the sharded decompressor
+ *
+ * @param cid_type  The type of CIDs
+ * @param max_cid   The maximum CID
+ * @param flows_nr  The number of flows
+ * @return          true if all packets were decompressed in order,
+ *                  false otherwise
+ */
+static bool test_decomp_shards(const rohc_cid_type_t cid_type,
+                               const rohc_cid_t max_cid,
+                               const size_t flows_nr)
+{
+	static uint8_t ip_buffers[QUEUE_LEN][IP_PKT_LEN];
+	static uint8_t rohc_buffers[QUEUE_LEN][MAX_ROHC_SIZE];
+	static uint8_t uncomp_buffers[QUEUE_LEN][MAX_ROHC_SIZE];
+	static uint8_t feedback_buffers[QUEUE_LEN][MAX_ROHC_SIZE];
+	struct worker workers[SHARDS_NR];
+	struct rohc_decomp_shards *shards;
+	struct rohc_comp *comp;
+	uint16_t *flows_sn;
+	size_t workers_nr = 0;
+	size_t pkts_in;
+	size_t pkts_out = 0;
+	size_t i;
+	bool is_success = false;
+
+	flows_sn = calloc(flows_nr, sizeof(uint16_t));
+	if(flows_sn == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the flows\n");
+		goto error;
+	}
+
+	/* create the compressor with the UDP profile enabled */
+	comp = rohc_comp_new2(cid_type, max_cid, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto free_flows;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* create the sharded decompressor in O-mode, so that it sends feedback */
+	shards = rohc_decomp_shards_new(cid_type, max_cid, ROHC_O_MODE, SHARDS_NR,
+	                                QUEUE_LEN);
+	if(shards == NULL)
+	{
+		fprintf(stderr, "failed to create the sharded ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	for(i = 0; i < SHARDS_NR; i++)
+	{
+		struct rohc_decomp *const decomp = rohc_decomp_shards_get_decomp(shards, i);
+
+		if(decomp == NULL ||
+		   !rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_UDP, -1))
+		{
+			fprintf(stderr, "failed to enable the decompression profiles\n");
+			goto destroy_shards;
+		}
+	}
+
+	/* start one worker thread per shard */
+	for(workers_nr = 0; workers_nr < SHARDS_NR; workers_nr++)
+	{
+		workers[workers_nr].shards = shards;
+		workers[workers_nr].shard = workers_nr;
+		workers[workers_nr].stop = false;
+		if(pthread_create(&workers[workers_nr].thread, NULL, worker_run,
+		                  &workers[workers_nr]) != 0)
+		{
+			fprintf(stderr, "failed to create worker thread #%zu\n", workers_nr);
+			goto stop_workers;
+		}
+	}
+
+	/* compress the packets of all the flows, dispatch them to the shards,
+	 * and check them once decompressed */
+	for(pkts_in = 0; pkts_in < PKTS_NR; pkts_in++)
+	{
+		const size_t flow = (pkts_in * 7) % flows_nr;
+		const size_t slot = pkts_in % QUEUE_LEN;
+		const struct rohc_ts arrival_time = { .sec = pkts_in / 1000, .nsec = 0 };
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffers[slot], IP_PKT_LEN, arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffers[slot], MAX_ROHC_SIZE);
+		const struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(uncomp_buffers[slot], MAX_ROHC_SIZE);
+		const struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffers[slot], MAX_ROHC_SIZE);
+
+		/* wait for the oldest packet if all the buffers are in use */
+		if((pkts_in - pkts_out) == QUEUE_LEN)
+		{
+			if(!check_next_packet(shards, comp, ip_buffers, pkts_out))
+			{
+				goto stop_workers;
+			}
+			pkts_out++;
+		}
+
+		test_build_udp_packet(ip_buffers[slot], IP_PKT_LEN, 0x1300 + flow, 5002,
+		                      flows_sn[flow]);
+		flows_sn[flow]++;
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%zu\n", pkts_in + 1);
+			goto stop_workers;
+		}
+		if(!rohc_decomp_shards_enqueue(shards, rohc_packet, uncomp_packet, NULL,
+		                               &feedback_send, ip_buffers[slot]))
+		{
+			fprintf(stderr, "failed to dispatch packet #%zu\n", pkts_in + 1);
+			goto stop_workers;
+		}
+	}
+	for(; pkts_out < PKTS_NR; pkts_out++)
+	{
+		if(!check_next_packet(shards, comp, ip_buffers, pkts_out))
+		{
+			goto stop_workers;
+		}
+	}
+	printf("%u packets of %zu flows decompressed by %u shards\n",
+	       PKTS_NR, flows_nr, SHARDS_NR);
+
+	/* the contexts shall be spread over all the shards */
+	for(i = 0; i < SHARDS_NR; i++)
+	{
+		rohc_decomp_general_info_t info = { .version_major = 0, .version_minor = 0 };
+
+		if(!rohc_decomp_get_general_info(rohc_decomp_shards_get_decomp(shards, i),
+		                                 &info))
+		{
+			fprintf(stderr, "failed to get information on shard #%zu\n", i);
+			goto stop_workers;
+		}
+		printf("shard #%zu: %zu contexts\n", i, info.contexts_nr);
+		if(info.contexts_nr == 0)
+		{
+			fprintf(stderr, "no context was given to shard #%zu\n", i);
+			goto stop_workers;
+		}
+	}
+
+	is_success = true;
+
+stop_workers:
+	for(i = 0; i < workers_nr; i++)
+	{
+		__atomic_store_n(&workers[i].stop, true, __ATOMIC_RELAXED);
+		pthread_join(workers[i].thread, NULL);
+	}
+destroy_shards:
+	rohc_decomp_shards_free(shards);
+destroy_comp:
+	rohc_comp_free(comp);
+free_flows:
+	free(flows_sn);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Decompress the packets of one shard until asked to stop
+ *
+ * @param arg  The context of the worker thread
+ * @return     Always NULL
+ */
+static void * worker_run(void *arg)
+{
+	struct worker *const worker = arg;
+
+	while(!__atomic_load_n(&worker->stop, __ATOMIC_RELAXED))
+	{
+		if(rohc_decomp_shards_run(worker->shards, worker->shard, 16) == 0)
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Get back the next decompressed packet and check it
+ *
+ * The feedback built by the shard for the packet is delivered to the
+ * compressor.
+ *
+ * @param shards      The sharded decompressor
+ * @param comp        The compressor
+ * @param ip_buffers  The buffers of the uncompressed packets
+ * @param pkt_num     The number of the expected packet
+ * @return            true if the packet is the expected one,
+ *                    false otherwise
+ */
+static bool check_next_packet(struct rohc_decomp_shards *const shards,
+                              struct rohc_comp *const comp,
+                              uint8_t ip_buffers[QUEUE_LEN][IP_PKT_LEN],
+                              const size_t pkt_num)
+{
+	struct rohc_buf decomp_packet;
+	struct rohc_buf feedback_send;
+	rohc_status_t status;
+	void *pkt_priv;
+
+	/* the packets are given back in order once decompressed */
+	while(!rohc_decomp_shards_dequeue(shards, &decomp_packet, NULL,
+	                                  &feedback_send, &status, &pkt_priv))
+	{
+		sched_yield();
+	}
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "failed to decompress packet #%zu\n", pkt_num + 1);
+		goto error;
+	}
+	if(pkt_priv != ip_buffers[pkt_num % QUEUE_LEN])
+	{
+		fprintf(stderr, "packet #%zu given back out of order\n", pkt_num + 1);
+		goto error;
+	}
+	if(decomp_packet.len != IP_PKT_LEN ||
+	   memcmp(rohc_buf_data(decomp_packet), pkt_priv, IP_PKT_LEN) != 0)
+	{
+		fprintf(stderr, "packet #%zu is not decompressed correctly\n",
+		        pkt_num + 1);
+		goto error;
+	}
+
+	/* deliver the feedback of the shard to the compressor */
+	if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+	{
+		fprintf(stderr, "failed to deliver feedback for packet #%zu\n",
+		        pkt_num + 1);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
@@ -0,0 +1,502 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_decompress_burst.c
+ * @brief  Check the decompression of bursts of ROHC packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses several IPv4/UDP/RTP flows, then decompresses
+ * the ROHC packets twice with a decompressor in O-mode:
+ *  - one packet at a time with rohc_decompress3(),
+ *  - in bursts of packets with rohc_decompress_burst().
+ *
+ * Every burst mixes the ROHC packets of the flows with:
+ *  - a feedback-only packet,
+ *  - a ROHC packet with piggybacked feedback,
+ *  - a malformed buffer,
+ *  - a truncated IR packet.
+ *
+ * The status of every packet, the decompressed packets, and the feedback
+ * received and to send must be the same in both cases: the feedback of all
+ * the packets of one burst shall be aggregated in the order of the packets.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of RTP flows */
+#define FLOWS_NR  4U
+
+/** The number of bursts to decompress */
+#define BURSTS_NR  40U
+
+/** The number of packets in every burst */
+#define BURST_LEN  32U
+
+/** The position of the feedback-only packet in every burst */
+#define FEEDBACK_ONLY_POS  3U
+
+/** The position of the malformed buffer in every burst */
+#define MALFORMED_POS  10U
+
+/** The position of the truncated IR packet in every burst */
+#define TRUNCATED_POS  11U
+
+/** The position of the packet with piggybacked feedback in every burst */
+#define PIGGYBACKED_POS  20U
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 12U + 20U)
+
+/** The maximum length of every ROHC packet */
+#define ROHC_PKT_MAX_LEN  256U
+
+/** The maximum length of the feedback of one burst */
+#define FEEDBACK_MAX_LEN  1024U
+
+
+/** The ROHC packets of all the bursts */
+static uint8_t rohc_buffers[BURSTS_NR][BURST_LEN][ROHC_PKT_MAX_LEN];
+static struct rohc_buf rohc_packets[BURSTS_NR][BURST_LEN];
+
+/** The IP packets that the ROHC packets of all the bursts shall give */
+static uint8_t ip_buffers[BURSTS_NR][BURST_LEN][IP_PKT_LEN];
+
+/** A FEEDBACK-2 item for CID 0 with a CRC option */
+static const uint8_t feedback_item[] = { 0xf4, 0x20, 0x00, 0x11, 0xe9 };
+
+
+/** The result of one run of the test */
+struct test_result
+{
+	/** The status of the decompression of every packet */
+	rohc_status_t statuses[BURSTS_NR][BURST_LEN];
+	/** The length of every decompressed packet */
+	size_t uncomp_lens[BURSTS_NR][BURST_LEN];
+	/** The feedback received in every burst */
+	uint8_t rcvd_feedback[BURSTS_NR][FEEDBACK_MAX_LEN];
+	/** The length of the feedback received in every burst */
+	size_t rcvd_feedback_lens[BURSTS_NR];
+	/** The feedback to send for every burst */
+	uint8_t feedback_send[BURSTS_NR][FEEDBACK_MAX_LEN];
+	/** The length of the feedback to send for every burst */
+	size_t feedback_send_lens[BURSTS_NR];
+	/** The number of packets decompressed successfully */
+	size_t ok_nr;
+};
+
+
+/* prototypes of private functions */
+static bool build_rohc_packets(void)
+	__attribute__((warn_unused_result));
+static bool test_decompress_burst(const char *const descr,
+                                  const bool use_burst,
+                                  struct test_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+
+/**
+ * @brief Check the decompression of bursts of ROHC packets
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	static struct test_result one_by_one;
+	static struct test_result burst;
+	size_t rcvd_feedback_len = 0;
+	size_t feedback_send_len = 0;
+	size_t i;
+	size_t j;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_decompress_burst\n");
+		goto error;
+	}
+
+	if(!build_rohc_packets())
+	{
+		goto error;
+	}
+
+	if(!test_decompress_burst("one packet at a time", false, &one_by_one) ||
+	   !test_decompress_burst("bursts of packets", true, &burst))
+	{
+		goto error;
+	}
+
+	/* same status and same decompressed packets */
+	for(i = 0; i < BURSTS_NR; i++)
+	{
+		for(j = 0; j < BURST_LEN; j++)
+		{
+			if(one_by_one.statuses[i][j] != burst.statuses[i][j])
+			{
+				fprintf(stderr, "burst #%zu: packet #%zu has status %d one at a "
+				        "time, but %d in burst\n", i + 1, j + 1,
+				        one_by_one.statuses[i][j], burst.statuses[i][j]);
+				goto error;
+			}
+			if(one_by_one.uncomp_lens[i][j] != burst.uncomp_lens[i][j])
+			{
+				fprintf(stderr, "burst #%zu: packet #%zu is decompressed in %zu "
+				        "bytes one at a time, but %zu bytes in burst\n", i + 1,
+				        j + 1, one_by_one.uncomp_lens[i][j],
+				        burst.uncomp_lens[i][j]);
+				goto error;
+			}
+		}
+	}
+	if(one_by_one.ok_nr != burst.ok_nr)
+	{
+		fprintf(stderr, "%zu packets decompressed one at a time, but %zu in "
+		        "bursts\n", one_by_one.ok_nr, burst.ok_nr);
+		goto error;
+	}
+
+	/* same feedback, aggregated for the whole burst */
+	for(i = 0; i < BURSTS_NR; i++)
+	{
+		if(one_by_one.rcvd_feedback_lens[i] != burst.rcvd_feedback_lens[i] ||
+		   memcmp(one_by_one.rcvd_feedback[i], burst.rcvd_feedback[i],
+		          burst.rcvd_feedback_lens[i]) != 0)
+		{
+			fprintf(stderr, "burst #%zu: received feedback differs\n", i + 1);
+			goto error;
+		}
+		if(one_by_one.feedback_send_lens[i] != burst.feedback_send_lens[i] ||
+		   memcmp(one_by_one.feedback_send[i], burst.feedback_send[i],
+		          burst.feedback_send_lens[i]) != 0)
+		{
+			fprintf(stderr, "burst #%zu: feedback to send differs\n", i + 1);
+			goto error;
+		}
+		rcvd_feedback_len += burst.rcvd_feedback_lens[i];
+		feedback_send_len += burst.feedback_send_lens[i];
+	}
+	printf("%zu bytes of feedback received, %zu bytes of feedback to send\n",
+	       rcvd_feedback_len, feedback_send_len);
+	if(feedback_send_len == 0)
+	{
+		fprintf(stderr, "no feedback to send, the aggregation of feedback to "
+		        "send is not tested\n");
+		goto error;
+	}
+
+	/* everything went fine */
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress the flows and build the ROHC packets of all the bursts
+ *
+ * @return  true if the ROHC packets were built, false otherwise
+ */
+static bool build_rohc_packets(void)
+{
+	struct rohc_comp *comp;
+	uint16_t flows_sn[FLOWS_NR] = { 0 };
+	size_t pkts_nr = 0;
+	size_t burst;
+	bool is_success = false;
+
+	srand(42);
+
+	/* create the compressor with the UDP and RTP profiles */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_heuristic(comp, 5000, 5099))
+	{
+		fprintf(stderr, "failed to enable the built-in RTP heuristic\n");
+		goto destroy_comp;
+	}
+
+	for(burst = 0; burst < BURSTS_NR; burst++)
+	{
+		size_t pos;
+
+		for(pos = 0; pos < BURST_LEN; pos++)
+		{
+			struct rohc_buf *const rohc_packet = &(rohc_packets[burst][pos]);
+			const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+			const struct rohc_buf ip_packet =
+				rohc_buf_init_full(ip_buffers[burst][pos], IP_PKT_LEN, arrival_time);
+			size_t flow;
+			uint16_t port;
+
+			rohc_packet->time = arrival_time;
+			rohc_packet->data = rohc_buffers[burst][pos];
+			rohc_packet->max_len = ROHC_PKT_MAX_LEN;
+			rohc_packet->offset = 0;
+			rohc_packet->len = 0;
+
+			if(pos == FEEDBACK_ONLY_POS)
+			{
+				/* feedback-only packet */
+				memcpy(rohc_buffers[burst][pos], feedback_item, sizeof(feedback_item));
+				rohc_packet->len = sizeof(feedback_item);
+				continue;
+			}
+			else if(pos == MALFORMED_POS)
+			{
+				/* more data than the buffer may hold */
+				rohc_packet->max_len = 4;
+				rohc_packet->len = 8;
+				continue;
+			}
+			else if(pos == TRUNCATED_POS)
+			{
+				/* IR packet for CID 0 with no profile ID */
+				rohc_buffers[burst][pos][0] = 0xfd;
+				rohc_packet->len = 1;
+				continue;
+			}
+			else if(pos == PIGGYBACKED_POS)
+			{
+				/* the feedback is piggybacked in front of the ROHC packet */
+				memcpy(rohc_buffers[burst][pos], feedback_item, sizeof(feedback_item));
+				rohc_packet->offset = sizeof(feedback_item);
+			}
+
+			flow = pkts_nr % FLOWS_NR;
+			port = 5000 + flow * 2;
+			test_build_rtp_packet(ip_buffers[burst][pos], IP_PKT_LEN, port, port, 0,
+			                      flows_sn[flow], 0x1000 + flow);
+			flows_sn[flow]++;
+			pkts_nr++;
+
+			if(rohc_compress4(comp, ip_packet, rohc_packet) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "failed to compress packet #%zu\n", pkts_nr);
+				goto destroy_comp;
+			}
+
+			if(pos == PIGGYBACKED_POS)
+			{
+				rohc_buf_push(rohc_packet, sizeof(feedback_item));
+			}
+		}
+	}
+
+	is_success = true;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Decompress all the bursts one packet at a time or at once
+ *
+ * @param descr      The description of the way of decompressing packets
+ * @param use_burst  Whether to decompress the packets in bursts
+ * @param result     OUT: The result of the test
+ * @return           true if the test succeeded, false otherwise
+ */
+static bool test_decompress_burst(const char *const descr,
+                                  const bool use_burst,
+                                  struct test_result *const result)
+{
+	static uint8_t uncomp_buffers[BURST_LEN][MAX_ROHC_SIZE];
+	struct rohc_buf uncomp_packets[BURST_LEN];
+	struct rohc_decomp *decomp;
+	size_t burst;
+	bool is_success = false;
+
+	printf("test decompression: %s\n", descr);
+
+	memset(result, 0, sizeof(struct test_result));
+
+	/* create the decompressor in O-mode with the UDP and RTP profiles */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto error;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* do not rate-limit the feedback, so that every burst has some */
+	if(!rohc_decomp_set_rate_limits(decomp, 2, 1, 1, 100, 1, 100))
+	{
+		fprintf(stderr, "failed to set the feedback rate limits\n");
+		goto destroy_decomp;
+	}
+
+	for(burst = 0; burst < BURSTS_NR; burst++)
+	{
+		struct rohc_buf rcvd_feedback =
+			rohc_buf_init_empty(result->rcvd_feedback[burst], FEEDBACK_MAX_LEN);
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(result->feedback_send[burst], FEEDBACK_MAX_LEN);
+		rohc_status_t *const statuses = result->statuses[burst];
+		size_t burst_ok_nr = 0;
+		size_t pos;
+
+		for(pos = 0; pos < BURST_LEN; pos++)
+		{
+			uncomp_packets[pos].time.sec = 0;
+			uncomp_packets[pos].time.nsec = 0;
+			uncomp_packets[pos].data = uncomp_buffers[pos];
+			uncomp_packets[pos].max_len = MAX_ROHC_SIZE;
+			uncomp_packets[pos].offset = 0;
+			uncomp_packets[pos].len = 0;
+		}
+
+		if(use_burst)
+		{
+			burst_ok_nr = rohc_decompress_burst(decomp, rohc_packets[burst],
+			                                    uncomp_packets, statuses, BURST_LEN,
+			                                    &rcvd_feedback, &feedback_send);
+		}
+		else
+		{
+			/* aggregate the feedback of all the packets of the burst */
+			for(pos = 0; pos < BURST_LEN; pos++)
+			{
+				struct rohc_buf pkt_rcvd_feedback = rcvd_feedback;
+				struct rohc_buf pkt_feedback_send = feedback_send;
+
+				pkt_rcvd_feedback.offset += rcvd_feedback.len;
+				pkt_rcvd_feedback.len = 0;
+				pkt_feedback_send.offset += feedback_send.len;
+				pkt_feedback_send.len = 0;
+
+				statuses[pos] =
+					rohc_decompress3(decomp, rohc_packets[burst][pos],
+					                 &(uncomp_packets[pos]), &pkt_rcvd_feedback,
+					                 &pkt_feedback_send);
+				if(statuses[pos] == ROHC_STATUS_OK)
+				{
+					burst_ok_nr++;
+				}
+				rcvd_feedback.len += pkt_rcvd_feedback.len;
+				feedback_send.len += pkt_feedback_send.len;
+			}
+		}
+		result->rcvd_feedback_lens[burst] = rcvd_feedback.len;
+		result->feedback_send_lens[burst] = feedback_send.len;
+
+		/* check the status of every packet and the decompressed packets */
+		for(pos = 0; pos < BURST_LEN; pos++)
+		{
+			result->uncomp_lens[burst][pos] = uncomp_packets[pos].len;
+
+			if(pos == MALFORMED_POS)
+			{
+				if(statuses[pos] != ROHC_STATUS_ERROR)
+				{
+					fprintf(stderr, "burst #%zu: malformed buffer has status %d\n",
+					        burst + 1, statuses[pos]);
+					goto destroy_decomp;
+				}
+			}
+			else if(pos == TRUNCATED_POS)
+			{
+				if(statuses[pos] != ROHC_STATUS_MALFORMED)
+				{
+					fprintf(stderr, "burst #%zu: truncated IR packet has status %d\n",
+					        burst + 1, statuses[pos]);
+					goto destroy_decomp;
+				}
+			}
+			else if(statuses[pos] != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "burst #%zu: packet #%zu has status %d\n",
+				        burst + 1, pos + 1, statuses[pos]);
+				goto destroy_decomp;
+			}
+			else if(pos == FEEDBACK_ONLY_POS)
+			{
+				if(!rohc_buf_is_empty(uncomp_packets[pos]))
+				{
+					fprintf(stderr, "burst #%zu: feedback-only packet gave %zu "
+					        "bytes\n", burst + 1, uncomp_packets[pos].len);
+					goto destroy_decomp;
+				}
+			}
+			else if(uncomp_packets[pos].len != IP_PKT_LEN ||
+			        memcmp(rohc_buf_data(uncomp_packets[pos]),
+			               ip_buffers[burst][pos], IP_PKT_LEN) != 0)
+			{
+				fprintf(stderr, "burst #%zu: packet #%zu is not decompressed "
+				        "correctly\n", burst + 1, pos + 1);
+				goto destroy_decomp;
+			}
+		}
+
+		/* the feedback of the feedback-only packet and the piggybacked one */
+		if(rcvd_feedback.len != (2 * sizeof(feedback_item)))
+		{
+			fprintf(stderr, "burst #%zu: %zu bytes of feedback received\n",
+			        burst + 1, rcvd_feedback.len);
+			goto destroy_decomp;
+		}
+		result->ok_nr += burst_ok_nr;
+	}
+
+	printf("\t%zu packets decompressed successfully\n", result->ok_nr);
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return is_success;
+}
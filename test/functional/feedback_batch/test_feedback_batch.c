@@ -0,0 +1,575 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_feedback_batch.c
+ * @brief  Check the delivery of batches of feedback to the compressor
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses several IPv4/UDP/RTP flows with
+ * a decompressor in O-mode that does not rate-limit its feedback. Some ROHC
+ * packets are damaged, so that the decompressor sends NACKs and STATIC-NACKs
+ * in addition to ACKs. The feedback is delivered
+ * back to the compressor after every batch of packets:
+ *  - one feedback packet at a time with rohc_comp_deliver_feedback2(),
+ *  - all the feedback packets at once with rohc_comp_deliver_feedbacks().
+ *
+ * The ROHC packets must be the same in both cases, while the compression
+ * profile shall handle less feedback items in the second case.
+ *
+ * Finally, one batch with an ACK that requests O-mode followed by a newer
+ * FEEDBACK-1 ACK is delivered: the newer ACK shall not supersede the mode
+ * request.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <inttypes.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of RTP flows */
+#define FLOWS_NR  4U
+
+/** The number of packets to compress */
+#define PKTS_NR  2000U
+
+/** The number of packets between two deliveries of feedback */
+#define BATCH_LEN  32U
+
+/** One ROHC packet out of DAMAGE_PERIOD is damaged */
+#define DAMAGE_PERIOD  97U
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 12U + 20U)
+
+
+/** The result of one run of the test */
+struct test_result
+{
+	/** The number of feedback items handled by the compression profiles */
+	size_t handled_nr;
+	/** The number of feedback packets delivered to the compressor */
+	size_t feedbacks_nr;
+	/** The number of packets that failed to be decompressed */
+	size_t failures_nr;
+	/** A hash of all the ROHC packets */
+	uint64_t rohc_hash;
+};
+
+
+/* prototypes of private functions */
+static bool test_feedback_batch(const char *const descr,
+                                const bool use_batch,
+                                struct test_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static bool test_feedback_batch_mode(void)
+	__attribute__((warn_unused_result));
+static uint8_t compute_crc8(const uint8_t *const data, const size_t len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void count_handled_feedbacks(void *const priv_ctxt,
+                                    const rohc_trace_level_t level,
+                                    const rohc_trace_entity_t entity,
+                                    const int profile,
+                                    const char *const format,
+                                    ...)
+	__attribute__((format(printf, 5, 6)));
+
+
+/**
+ * @brief Check the delivery of batches of feedback to the compressor
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct test_result one_by_one;
+	struct test_result batch;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_feedback_batch\n");
+		goto error;
+	}
+
+	if(!test_feedback_batch("one feedback packet at a time", false, &one_by_one) ||
+	   !test_feedback_batch("all feedback packets at once", true, &batch))
+	{
+		goto error;
+	}
+
+	/* same feedback, same ROHC packets */
+	if(one_by_one.failures_nr != batch.failures_nr)
+	{
+		fprintf(stderr, "%zu packets failed to be decompressed with feedback "
+		        "delivered one at a time, but %zu in batches\n",
+		        one_by_one.failures_nr, batch.failures_nr);
+		goto error;
+	}
+	if(one_by_one.feedbacks_nr != batch.feedbacks_nr)
+	{
+		fprintf(stderr, "%zu feedback packets were delivered one at a time, "
+		        "but %zu in batches\n", one_by_one.feedbacks_nr,
+		        batch.feedbacks_nr);
+		goto error;
+	}
+	if(one_by_one.rohc_hash != batch.rohc_hash)
+	{
+		fprintf(stderr, "ROHC packets differ whether feedback is delivered "
+		        "one packet at a time or in batches\n");
+		goto error;
+	}
+
+	/* less feedback items handled by the profiles */
+	if(one_by_one.handled_nr != one_by_one.feedbacks_nr)
+	{
+		fprintf(stderr, "%zu feedback items handled for %zu feedback packets "
+		        "delivered one at a time\n", one_by_one.handled_nr,
+		        one_by_one.feedbacks_nr);
+		goto error;
+	}
+	if(batch.handled_nr >= one_by_one.handled_nr)
+	{
+		fprintf(stderr, "%zu feedback items handled in batches, at least as "
+		        "many as the %zu items handled one at a time\n",
+		        batch.handled_nr, one_by_one.handled_nr);
+		goto error;
+	}
+
+	/* ACKs that request a mode are not superseded */
+	if(!test_feedback_batch_mode())
+	{
+		goto error;
+	}
+
+	/* everything went fine */
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress and decompress all the flows with one way of delivering
+ *        feedback
+ *
+ * @param descr      The description of the way of delivering feedback
+ * @param use_batch  Whether to deliver the feedback of every batch at once
+ * @param result     OUT: The result of the test
+ * @return           true if the test succeeded, false otherwise
+ */
+static bool test_feedback_batch(const char *const descr,
+                                const bool use_batch,
+                                struct test_result *const result)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint8_t feedback_buffers[BATCH_LEN][MAX_ROHC_SIZE];
+	struct rohc_buf feedbacks[BATCH_LEN];
+	size_t feedbacks_nr = 0;
+	uint16_t flows_sn[FLOWS_NR] = { 0 };
+	size_t i;
+	bool is_success = false;
+
+	printf("test feedback delivery: %s\n", descr);
+
+	memset(result, 0, sizeof(struct test_result));
+	result->rohc_hash = 14695981039346656037ULL;
+	srand(42);
+
+	/* create the compressor with the UDP and RTP profiles */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_heuristic(comp, 5000, 5099))
+	{
+		fprintf(stderr, "failed to enable the built-in RTP heuristic\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, count_handled_feedbacks, result))
+	{
+		fprintf(stderr, "failed to set the compression trace callback\n");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor in O-mode with the UDP and RTP profiles */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* do not rate-limit the feedback, as on a high-rate reverse channel */
+	if(!rohc_decomp_set_rate_limits(decomp, 2, 1, 1, 100, 1, 100))
+	{
+		fprintf(stderr, "failed to set the feedback rate limits\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the packets of all the flows */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		const size_t flow = i % FLOWS_NR;
+		const uint16_t port = 5000 + flow * 2;
+		const struct rohc_ts arrival_time = { .sec = i / 50, .nsec = (i % 50) * 20000000 };
+		uint8_t ip_buffer[IP_PKT_LEN];
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, IP_PKT_LEN, arrival_time);
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		uint8_t decomp_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffers[feedbacks_nr], MAX_ROHC_SIZE);
+		rohc_status_t status;
+		bool is_damaged;
+		size_t j;
+
+		test_build_rtp_packet(ip_buffer, IP_PKT_LEN, port, port, 0, flows_sn[flow],
+		                      0x1000 + flow);
+		flows_sn[flow]++;
+
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%zu\n", i + 1);
+			goto destroy_decomp;
+		}
+		for(j = 0; j < rohc_packet.len; j++)
+		{
+			result->rohc_hash ^= rohc_buf_byte_at(rohc_packet, j);
+			result->rohc_hash *= 1099511628211ULL;
+		}
+
+		/* damage the last byte of the ROHC header of some packets */
+		is_damaged = ((i % DAMAGE_PERIOD) == (DAMAGE_PERIOD - 1));
+		if(is_damaged)
+		{
+			rohc_buf_byte_at(rohc_packet, rohc_packet.len - (IP_PKT_LEN - 40) - 1) ^= 0x03;
+		}
+
+		status = rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                          &feedback_send);
+		if(status != ROHC_STATUS_OK)
+		{
+			result->failures_nr++;
+		}
+		else if(!is_damaged &&
+		        (decomp_packet.len != IP_PKT_LEN ||
+		         memcmp(rohc_buf_data(decomp_packet), ip_buffer, IP_PKT_LEN) != 0))
+		{
+			fprintf(stderr, "packet #%zu is not decompressed correctly\n", i + 1);
+			goto destroy_decomp;
+		}
+		if(feedback_send.len > 0)
+		{
+			feedbacks[feedbacks_nr] = feedback_send;
+			feedbacks_nr++;
+		}
+
+		/* deliver the feedback of the batch */
+		if(feedbacks_nr > 0 && ((i + 1) % BATCH_LEN) == 0)
+		{
+			if(use_batch)
+			{
+				if(!rohc_comp_deliver_feedbacks(comp, feedbacks, feedbacks_nr))
+				{
+					fprintf(stderr, "failed to deliver the feedback of the batch\n");
+					goto destroy_decomp;
+				}
+			}
+			else
+			{
+				for(j = 0; j < feedbacks_nr; j++)
+				{
+					if(!rohc_comp_deliver_feedback2(comp, feedbacks[j]))
+					{
+						fprintf(stderr, "failed to deliver feedback #%zu of the "
+						        "batch\n", j + 1);
+						goto destroy_decomp;
+					}
+				}
+			}
+			result->feedbacks_nr += feedbacks_nr;
+			feedbacks_nr = 0;
+		}
+	}
+
+	printf("\t%zu decompression failures, %zu feedback packets delivered, "
+	       "%zu feedback items handled\n", result->failures_nr,
+	       result->feedbacks_nr, result->handled_nr);
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Check that an ACK that requests a mode is not superseded by a newer
+ *        ACK in a batch of feedback
+ *
+ * One RTP flow is compressed and decompressed in U-mode, then one batch with
+ * two feedback packets is delivered to the compressor:
+ *  - one FEEDBACK-2 ACK that requests O-mode, protected by a CRC option,
+ *  - one newer FEEDBACK-1 ACK.
+ * The compression context shall then be in O-mode.
+ *
+ * @return  true if the test succeeded, false otherwise
+ */
+static bool test_feedback_batch_mode(void)
+{
+	const struct rohc_ts zero_time = { .sec = 0, .nsec = 0 };
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	rohc_comp_last_packet_info2_t info;
+	uint8_t mode_ack[1 + 1 + 4];
+	uint8_t newer_ack[1 + 1 + 1];
+	const struct rohc_buf feedbacks[2] = {
+		rohc_buf_init_full(mode_ack, sizeof(mode_ack), zero_time),
+		rohc_buf_init_full(newer_ack, sizeof(newer_ack), zero_time),
+	};
+	uint16_t sn;
+	bool is_success = false;
+
+	printf("test feedback delivery: ACK with mode request in batch\n");
+
+	srand(42);
+
+	/* create the compressor with the UDP and RTP profiles */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_heuristic(comp, 5000, 5099))
+	{
+		fprintf(stderr, "failed to enable the built-in RTP heuristic\n");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor in U-mode with the UDP and RTP profiles */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the flow in U-mode */
+	for(sn = 0; sn < 20; sn++)
+	{
+		const struct rohc_ts arrival_time = { .sec = 0, .nsec = sn * 20000000 };
+		uint8_t ip_buffer[IP_PKT_LEN];
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, IP_PKT_LEN, arrival_time);
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		uint8_t decomp_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		uint8_t feedback_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+
+		test_build_rtp_packet(ip_buffer, IP_PKT_LEN, 5000, 5000, 0, sn, 0x1000);
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%u\n", sn + 1);
+			goto destroy_decomp;
+		}
+		if(rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                    &feedback_send) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress packet #%u\n", sn + 1);
+			goto destroy_decomp;
+		}
+		if(feedback_send.len > 0 && !rohc_comp_deliver_feedback2(comp, feedback_send))
+		{
+			fprintf(stderr, "failed to deliver the feedback of packet #%u\n",
+			        sn + 1);
+			goto destroy_decomp;
+		}
+	}
+	info.version_major = 0;
+	info.version_minor = 0;
+	if(!rohc_comp_get_last_packet_info2(comp, &info))
+	{
+		fprintf(stderr, "failed to get information on the last packet\n");
+		goto destroy_decomp;
+	}
+	/* the first packets of the flow are compressed with the UDP profile before
+	 * the RTP heuristic detects the flow, so the RTP context does not use CID 0
+	 * and its feedback needs an Add-CID octet */
+	if(info.profile_id != ROHC_PROFILE_RTP || info.context_mode != ROHC_U_MODE ||
+	   info.context_id == 0 || info.context_id > 15)
+	{
+		fprintf(stderr, "context with CID %u is in mode %d with profile 0x%04x "
+		        "instead of U-mode with the RTP profile and a CID in range "
+		        "[1, 15]\n", info.context_id, info.context_mode, info.profile_id);
+		goto destroy_decomp;
+	}
+
+	/* FEEDBACK-2 ACK that requests O-mode, with Add-CID and a CRC option */
+	sn--;
+	mode_ack[0] = 0xf0 | (sizeof(mode_ack) - 1);
+	mode_ack[1] = 0xe0 | (info.context_id & 0x0f);
+	mode_ack[2] = (ROHC_O_MODE << 4) | ((sn >> 8) & 0x0f);
+	mode_ack[3] = sn & 0xff;
+	mode_ack[4] = 0x11; /* CRC option */
+	mode_ack[5] = 0x00;
+	mode_ack[5] = compute_crc8(mode_ack + 1, sizeof(mode_ack) - 1);
+
+	/* newer FEEDBACK-1 ACK with Add-CID */
+	newer_ack[0] = 0xf0 | (sizeof(newer_ack) - 1);
+	newer_ack[1] = 0xe0 | (info.context_id & 0x0f);
+	newer_ack[2] = sn & 0xff;
+
+	if(!rohc_comp_deliver_feedbacks(comp, feedbacks, 2))
+	{
+		fprintf(stderr, "failed to deliver the batch of feedback\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_comp_get_last_packet_info2(comp, &info))
+	{
+		fprintf(stderr, "failed to get information on the last packet\n");
+		goto destroy_decomp;
+	}
+	if(info.context_mode != ROHC_O_MODE)
+	{
+		fprintf(stderr, "context is in mode %d instead of O-mode: the mode "
+		        "request was superseded by the newer ACK\n", info.context_mode);
+		goto destroy_decomp;
+	}
+	printf("\tmode request taken into account\n");
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Compute the 8-bit CRC of a feedback packet, as defined in RFC3095
+ *
+ * @param data  The feedback data with the CRC byte set to zero
+ * @param len   The length of the feedback data
+ * @return      The 8-bit CRC
+ */
+static uint8_t compute_crc8(const uint8_t *const data, const size_t len)
+{
+	uint8_t crc = 0xff;
+	size_t i;
+	size_t j;
+
+	/* polynomial 1 + x + x^2 + x^8, bit-reflected */
+	for(i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+		for(j = 0; j < 8; j++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xe0) : (crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Count the feedback items handled by the compression profiles
+ *
+ * @param priv_ctxt  The result of the test
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace
+ * @param profile    The ID of the ROHC compression profile
+ * @param format     The format string of the trace
+ */
+static void count_handled_feedbacks(void *const priv_ctxt,
+                                    const rohc_trace_level_t level,
+                                    const rohc_trace_entity_t entity,
+                                    const int profile,
+                                    const char *const format,
+                                    ...)
+{
+	struct test_result *const result = priv_ctxt;
+
+	if(level == ROHC_TRACE_DEBUG && entity == ROHC_TRACE_COMP &&
+	   strstr(format, "data successfully handled") != NULL)
+	{
+		result->handled_nr++;
+	}
+}
@@ -0,0 +1,604 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_feedback_pacing.c
+ * @brief  Check the pacing of the feedback sent by the decompressor
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses several IPv4/UDP/RTP flows with
+ * a decompressor in O-mode that does not rate-limit its feedback. Some ROHC
+ * packets are damaged, so that the decompressor sends NACKs and STATIC-NACKs
+ * in addition to ACKs. The feedback is delivered back to the compressor. The
+ * flows are run several times:
+ *  - without any feedback pacing,
+ *  - with a narrow feedback channel paced by rohc_decomp_set_feedback_pacing(),
+ *  - with every context paced by rohc_decomp_set_feedback_pacing().
+ *
+ * The paced feedback shall never exceed the bandwidth of the feedback channel.
+ * Some ACKs shall be suppressed, but no NACK nor STATIC-NACK.
+ *
+ * Finally, many IPv4/UDP flows start at the same time with a decompressor
+ * that transits every context from U-mode to O-mode. The narrow feedback
+ * channel suppresses some of the ACKs that advertise the transition: the
+ * contexts of those ACKs shall stay in U-mode, then transit again with the
+ * next packets until all the contexts of both sides are in O-mode.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of RTP flows */
+#define FLOWS_NR  8U
+
+/** The number of packets per second of every flow */
+#define FLOW_PKTS_PER_SEC  50U
+
+/** The duration of the test (in seconds) */
+#define DURATION  10U
+
+/** The number of packets to compress */
+#define PKTS_NR  (FLOWS_NR * FLOW_PKTS_PER_SEC * DURATION)
+
+/** One ROHC packet out of DAMAGE_PERIOD is damaged */
+#define DAMAGE_PERIOD  97U
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 12U + 20U)
+
+/** The bandwidth of the narrow feedback channel (in bytes per second) */
+#define CHANNEL_RATE  40U
+
+/** The burst tolerance of the narrow feedback channel (in bytes) */
+#define CHANNEL_BURST  64U
+
+/** The feedback bandwidth granted to every context (in bytes per second) */
+#define CTXT_RATE  2U
+
+/** The burst tolerance of every context (in bytes) */
+#define CTXT_BURST  64U
+
+/** The number of UDP flows that start at the same time, one per CID */
+#define MODE_FLOWS_NR  (ROHC_SMALL_CID_MAX + 1U)
+
+/** The largest number of rounds of packets before all the contexts of the
+ *  UDP flows are in O-mode */
+#define MODE_ROUNDS_MAX  10U
+
+/** The length of the IP packets of the UDP flows */
+#define MODE_IP_PKT_LEN  (TEST_UDP_HDRS_LEN + 20U)
+
+/** The indexes of the feedback types in the decompression statistics */
+#define STATS_ACK          0U
+#define STATS_NACK         1U
+#define STATS_STATIC_NACK  2U
+
+
+/** The result of one run of the test */
+struct test_result
+{
+	/** The number of feedback bytes sent during every second of the test */
+	size_t bytes_per_sec[DURATION];
+	/** The number of feedback packets sent by the decompressor */
+	size_t feedbacks_nr;
+	/** The detailed statistics of the decompressor at the end of the test */
+	rohc_decomp_stats_t stats;
+};
+
+
+/* prototypes of private functions */
+static bool test_feedback_pacing(const char *const descr,
+                                 const size_t channel_rate,
+                                 const size_t channel_burst,
+                                 const size_t ctxt_rate,
+                                 const size_t ctxt_burst,
+                                 struct test_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 6)));
+static size_t get_max_bytes_per_sec(const struct test_result *const result)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool test_feedback_pacing_mode(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check the pacing of the feedback sent by the decompressor
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct test_result unpaced;
+	struct test_result channel;
+	struct test_result ctxt;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_feedback_pacing\n");
+		goto error;
+	}
+
+	if(!test_feedback_pacing("no pacing", 0, 0, 0, 0, &unpaced) ||
+	   !test_feedback_pacing("narrow feedback channel", CHANNEL_RATE,
+	                         CHANNEL_BURST, 0, 0, &channel) ||
+	   !test_feedback_pacing("per-context pacing", 0, 0, CTXT_RATE,
+	                         CTXT_BURST, &ctxt))
+	{
+		goto error;
+	}
+
+	/* without pacing, the feedback shall not fit in the narrow channel,
+	 * otherwise the test is useless */
+	if(get_max_bytes_per_sec(&unpaced) <= (CHANNEL_RATE + CHANNEL_BURST))
+	{
+		fprintf(stderr, "unpaced feedback never exceeds %u bytes per second\n",
+		        CHANNEL_RATE + CHANNEL_BURST);
+		goto error;
+	}
+	if(unpaced.stats.feedbacks_paced_nr[STATS_ACK] != 0 ||
+	   unpaced.stats.feedbacks_paced_nr[STATS_NACK] != 0 ||
+	   unpaced.stats.feedbacks_paced_nr[STATS_STATIC_NACK] != 0)
+	{
+		fprintf(stderr, "feedback suppressed while pacing is disabled\n");
+		goto error;
+	}
+
+	/* the narrow channel shall never be overloaded */
+	if(get_max_bytes_per_sec(&channel) > (CHANNEL_RATE + CHANNEL_BURST))
+	{
+		fprintf(stderr, "paced feedback exceeds %u bytes per second\n",
+		        CHANNEL_RATE + CHANNEL_BURST);
+		goto error;
+	}
+
+	/* the per-context pacing shall send less feedback than no pacing at all */
+	if(ctxt.feedbacks_nr >= unpaced.feedbacks_nr)
+	{
+		fprintf(stderr, "per-context pacing sent %zu feedback packets, not "
+		        "less than the %zu packets sent without pacing\n",
+		        ctxt.feedbacks_nr, unpaced.feedbacks_nr);
+		goto error;
+	}
+
+	/* ACKs are suppressed first, NACKs and STATIC-NACKs are never suppressed */
+	if(channel.stats.feedbacks_paced_nr[STATS_ACK] == 0 ||
+	   ctxt.stats.feedbacks_paced_nr[STATS_ACK] == 0)
+	{
+		fprintf(stderr, "no ACK suppressed by feedback pacing\n");
+		goto error;
+	}
+	if(channel.stats.feedbacks_paced_nr[STATS_NACK] != 0 ||
+	   channel.stats.feedbacks_paced_nr[STATS_STATIC_NACK] != 0 ||
+	   ctxt.stats.feedbacks_paced_nr[STATS_NACK] != 0 ||
+	   ctxt.stats.feedbacks_paced_nr[STATS_STATIC_NACK] != 0)
+	{
+		fprintf(stderr, "NACK or STATIC-NACK suppressed by feedback pacing\n");
+		goto error;
+	}
+	if((channel.stats.feedbacks_nr[STATS_NACK] +
+	    channel.stats.feedbacks_nr[STATS_STATIC_NACK]) == 0 ||
+	   (ctxt.stats.feedbacks_nr[STATS_NACK] +
+	    ctxt.stats.feedbacks_nr[STATS_STATIC_NACK]) == 0)
+	{
+		fprintf(stderr, "no NACK nor STATIC-NACK sent with feedback pacing\n");
+		goto error;
+	}
+
+	/* suppressed ACKs shall not change the mode of their contexts */
+	if(!test_feedback_pacing_mode())
+	{
+		goto error;
+	}
+
+	/* everything went fine */
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress and decompress all the flows with one feedback pacing
+ *
+ * @param descr          The description of the feedback pacing
+ * @param channel_rate   The bandwidth of the feedback channel, 0 to disable
+ * @param channel_burst  The burst tolerance of the feedback channel
+ * @param ctxt_rate      The feedback bandwidth of every context, 0 to disable
+ * @param ctxt_burst     The burst tolerance of every context
+ * @param result         OUT: The result of the test
+ * @return               true if the test succeeded, false otherwise
+ */
+static bool test_feedback_pacing(const char *const descr,
+                                 const size_t channel_rate,
+                                 const size_t channel_burst,
+                                 const size_t ctxt_rate,
+                                 const size_t ctxt_burst,
+                                 struct test_result *const result)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint16_t flows_sn[FLOWS_NR] = { 0 };
+	size_t feedbacks_nr;
+	size_t i;
+	bool is_success = false;
+
+	printf("test feedback pacing: %s\n", descr);
+
+	memset(result, 0, sizeof(struct test_result));
+	result->stats.version_major = 0;
+	result->stats.version_minor = 1;
+	srand(42);
+
+	/* create the compressor with the UDP and RTP profiles */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_heuristic(comp, 5000, 5099))
+	{
+		fprintf(stderr, "failed to enable the built-in RTP heuristic\n");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor in O-mode with the UDP and RTP profiles */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_STATS))
+	{
+		fprintf(stderr, "failed to enable the decompression statistics\n");
+		goto destroy_decomp;
+	}
+
+	/* do not rate-limit the feedback, pace it instead */
+	if(!rohc_decomp_set_rate_limits(decomp, 2, 1, 1, 100, 1, 100))
+	{
+		fprintf(stderr, "failed to set the feedback rate limits\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_feedback_pacing(decomp, channel_rate, channel_burst,
+	                                    ctxt_rate, ctxt_burst))
+	{
+		fprintf(stderr, "failed to set the feedback pacing\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the packets of all the flows */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		const size_t flow = i % FLOWS_NR;
+		const uint16_t port = 5000 + flow * 2;
+		const size_t pkts_per_sec = FLOWS_NR * FLOW_PKTS_PER_SEC;
+		const struct rohc_ts arrival_time = {
+			.sec = i / pkts_per_sec,
+			.nsec = (i % pkts_per_sec) * (1000000000U / pkts_per_sec)
+		};
+		uint8_t ip_buffer[IP_PKT_LEN];
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, IP_PKT_LEN, arrival_time);
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		uint8_t decomp_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		uint8_t feedback_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+		bool is_damaged;
+
+		test_build_rtp_packet(ip_buffer, IP_PKT_LEN, port, port, 0, flows_sn[flow],
+		                      0x1000 + flow);
+		flows_sn[flow]++;
+
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%zu\n", i + 1);
+			goto destroy_decomp;
+		}
+
+		/* damage the last byte of the ROHC header of some packets */
+		is_damaged = ((i % DAMAGE_PERIOD) == (DAMAGE_PERIOD - 1));
+		if(is_damaged)
+		{
+			rohc_buf_byte_at(rohc_packet, rohc_packet.len - (IP_PKT_LEN - 40) - 1) ^= 0x03;
+		}
+
+		/* the decompressor paces its feedback on the arrival times of packets */
+		rohc_packet.time = arrival_time;
+		if(rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                    &feedback_send) == ROHC_STATUS_OK &&
+		   !is_damaged &&
+		   (decomp_packet.len != IP_PKT_LEN ||
+		    memcmp(rohc_buf_data(decomp_packet), ip_buffer, IP_PKT_LEN) != 0))
+		{
+			fprintf(stderr, "packet #%zu is not decompressed correctly\n", i + 1);
+			goto destroy_decomp;
+		}
+
+		/* deliver the feedback to the compressor */
+		if(feedback_send.len > 0)
+		{
+			result->bytes_per_sec[arrival_time.sec] += feedback_send.len;
+			result->feedbacks_nr++;
+			if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+			{
+				fprintf(stderr, "failed to deliver feedback for packet #%zu\n",
+				        i + 1);
+				goto destroy_decomp;
+			}
+		}
+	}
+
+	/* the statistics shall count the feedback that was sent */
+	if(!rohc_decomp_get_stats(decomp, &result->stats))
+	{
+		fprintf(stderr, "failed to get the decompression statistics\n");
+		goto destroy_decomp;
+	}
+	feedbacks_nr = result->stats.feedbacks_nr[STATS_ACK] +
+	               result->stats.feedbacks_nr[STATS_NACK] +
+	               result->stats.feedbacks_nr[STATS_STATIC_NACK];
+	if(feedbacks_nr != result->feedbacks_nr)
+	{
+		fprintf(stderr, "%zu feedback packets sent, but %zu counted in the "
+		        "statistics\n", result->feedbacks_nr, feedbacks_nr);
+		goto destroy_decomp;
+	}
+
+	printf("\t%zu feedback packets sent, at most %zu bytes per second\n",
+	       result->feedbacks_nr, get_max_bytes_per_sec(result));
+	printf("\tACK: %" PRIu64 " sent, %" PRIu64 " suppressed\n",
+	       result->stats.feedbacks_nr[STATS_ACK],
+	       result->stats.feedbacks_paced_nr[STATS_ACK]);
+	printf("\tNACK: %" PRIu64 " sent, %" PRIu64 " suppressed\n",
+	       result->stats.feedbacks_nr[STATS_NACK],
+	       result->stats.feedbacks_paced_nr[STATS_NACK]);
+	printf("\tSTATIC-NACK: %" PRIu64 " sent, %" PRIu64 " suppressed\n",
+	       result->stats.feedbacks_nr[STATS_STATIC_NACK],
+	       result->stats.feedbacks_paced_nr[STATS_STATIC_NACK]);
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Get the largest number of feedback bytes sent in one second
+ *
+ * @param result  The result of the test
+ * @return        The largest number of feedback bytes sent in one second
+ */
+static size_t get_max_bytes_per_sec(const struct test_result *const result)
+{
+	size_t max_bytes = 0;
+	size_t i;
+
+	for(i = 0; i < DURATION; i++)
+	{
+		if(result->bytes_per_sec[i] > max_bytes)
+		{
+			max_bytes = result->bytes_per_sec[i];
+		}
+	}
+
+	return max_bytes;
+}
+
+
+/**
+ * @brief Check that the mode transitions are not lost by feedback pacing
+ *
+ * @return  true if the test succeeded, false otherwise
+ */
+static bool test_feedback_pacing_mode(void)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	rohc_decomp_stats_t stats = { .version_major = 0, .version_minor = 1 };
+	size_t o_mode_flows_nr = 0;
+	size_t round;
+	bool is_success = false;
+
+	printf("test feedback pacing: mode transitions\n");
+
+	/* create the compressor with the UDP profile */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor in O-mode with the UDP profile */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_STATS))
+	{
+		fprintf(stderr, "failed to enable the decompression statistics\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_feedback_pacing(decomp, CHANNEL_RATE, CHANNEL_BURST, 0, 0))
+	{
+		fprintf(stderr, "failed to set the feedback pacing\n");
+		goto destroy_decomp;
+	}
+
+	/* one packet of every flow per round, all the packets of one round at the
+	 * same time, one round every 2 seconds so that the channel is refilled */
+	for(round = 0; round < MODE_ROUNDS_MAX && o_mode_flows_nr < MODE_FLOWS_NR; round++)
+	{
+		const struct rohc_ts arrival_time = { .sec = round * 2U, .nsec = 0 };
+		size_t flow;
+
+		o_mode_flows_nr = 0;
+		for(flow = 0; flow < MODE_FLOWS_NR; flow++)
+		{
+			const uint16_t port = 6000 + flow * 2;
+			uint8_t ip_buffer[MODE_IP_PKT_LEN];
+			const struct rohc_buf ip_packet =
+				rohc_buf_init_full(ip_buffer, MODE_IP_PKT_LEN, arrival_time);
+			uint8_t rohc_buffer[MAX_ROHC_SIZE];
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+			uint8_t decomp_buffer[MAX_ROHC_SIZE];
+			struct rohc_buf decomp_packet =
+				rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+			uint8_t feedback_buffer[MAX_ROHC_SIZE];
+			struct rohc_buf feedback_send =
+				rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+			rohc_comp_last_packet_info2_t comp_info =
+				{ .version_major = 0, .version_minor = 0 };
+			rohc_decomp_last_packet_info_t decomp_info =
+				{ .version_major = 0, .version_minor = 0 };
+
+			test_build_udp_packet(ip_buffer, MODE_IP_PKT_LEN, port, port, round);
+			if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "failed to compress packet of flow #%zu in round "
+				        "#%zu\n", flow + 1, round + 1);
+				goto destroy_decomp;
+			}
+			rohc_packet.time = arrival_time;
+			if(rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+			                    &feedback_send) != ROHC_STATUS_OK ||
+			   decomp_packet.len != MODE_IP_PKT_LEN ||
+			   memcmp(rohc_buf_data(decomp_packet), ip_buffer, MODE_IP_PKT_LEN) != 0)
+			{
+				fprintf(stderr, "packet of flow #%zu in round #%zu is not "
+				        "decompressed correctly\n", flow + 1, round + 1);
+				goto destroy_decomp;
+			}
+			if(feedback_send.len > 0 &&
+			   !rohc_comp_deliver_feedback2(comp, feedback_send))
+			{
+				fprintf(stderr, "failed to deliver feedback of flow #%zu in round "
+				        "#%zu\n", flow + 1, round + 1);
+				goto destroy_decomp;
+			}
+
+			/* both contexts shall agree on the mode */
+			if(!rohc_comp_get_last_packet_info2(comp, &comp_info) ||
+			   !rohc_decomp_get_last_packet_info(decomp, &decomp_info))
+			{
+				fprintf(stderr, "failed to get the information about the last "
+				        "packet\n");
+				goto destroy_decomp;
+			}
+			if(feedback_send.len == 0 && decomp_info.context_mode != comp_info.context_mode)
+			{
+				fprintf(stderr, "decompression context of flow #%zu in mode %d "
+				        "while no feedback told the compressor, still in mode %d\n",
+				        flow + 1, decomp_info.context_mode, comp_info.context_mode);
+				goto destroy_decomp;
+			}
+			if(decomp_info.context_mode == ROHC_O_MODE &&
+			   comp_info.context_mode == ROHC_O_MODE)
+			{
+				o_mode_flows_nr++;
+			}
+		}
+		printf("\tround #%zu: %zu flows out of %u in O-mode\n", round + 1,
+		       o_mode_flows_nr, MODE_FLOWS_NR);
+	}
+
+	/* some ACKs shall have been suppressed, but no context shall be lost in
+	 * U-mode */
+	if(!rohc_decomp_get_stats(decomp, &stats))
+	{
+		fprintf(stderr, "failed to get the decompression statistics\n");
+		goto destroy_decomp;
+	}
+	if(stats.feedbacks_paced_nr[STATS_ACK] == 0)
+	{
+		fprintf(stderr, "no ACK suppressed by feedback pacing\n");
+		goto destroy_decomp;
+	}
+	if(o_mode_flows_nr != MODE_FLOWS_NR)
+	{
+		fprintf(stderr, "only %zu flows out of %u in O-mode after %u rounds\n",
+		        o_mode_flows_nr, MODE_FLOWS_NR, MODE_ROUNDS_MAX);
+		goto destroy_decomp;
+	}
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
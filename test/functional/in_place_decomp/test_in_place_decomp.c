@@ -0,0 +1,240 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_in_place_decomp.c
+ * @brief  Check the decompression of ROHC packets in place
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses a stream of large IPv4/TCP packets, then
+ * decompresses every ROHC packet in place with rohc_decompress_in_place().
+ * The ROHC packet is stored after some headroom in its buffer. The
+ * decompressed packet shall be identical to the original packet, and it
+ * shall be stored in the buffer of the ROHC packet with its payload left at
+ * the very same place. The test is run with the TCP profile and with the
+ * Uncompressed profile.
+ *
+ * A feedback-only packet is finally decompressed in place: the buffer shall
+ * then be empty but keep its maximum length.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of packets of the test stream */
+#define STREAM_PKTS_NR  500U
+
+/** The length of the TCP payload of every packet of the test stream */
+#define TCP_PAYLOAD_LEN  1400U
+
+/** The length of the headroom in front of the ROHC packets */
+#define HEADROOM_LEN  64U
+
+
+/* prototypes of private functions */
+static bool test_in_place_decomp(const rohc_profile_t profile)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check the decompression of ROHC packets in place
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_in_place_decomp\n");
+		goto error;
+	}
+
+	if(!test_in_place_decomp(ROHCv1_PROFILE_IP_TCP))
+	{
+		fprintf(stderr, "test failed with the TCP profile\n");
+		goto error;
+	}
+	if(!test_in_place_decomp(ROHCv1_PROFILE_UNCOMPRESSED))
+	{
+		fprintf(stderr, "test failed with the Uncompressed profile\n");
+		goto error;
+	}
+
+	/* everything went fine */
+	printf("all tests are successful\n");
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress the test stream, then decompress it in place
+ *
+ * @param profile  The compression/decompression profile to use
+ * @return         true if the test succeeds, false otherwise
+ */
+static bool test_in_place_decomp(const rohc_profile_t profile)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	const uint16_t ip_pkt_len = 20 + 20 + TCP_PAYLOAD_LEN;
+	uint8_t ip_buffer[20 + 20 + TCP_PAYLOAD_LEN];
+	uint8_t rohc_buffer[HEADROOM_LEN + MAX_ROHC_SIZE];
+	uint16_t num;
+	bool is_success = false;
+
+	/* create the ROHC compressor and decompressor */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profile(comp, profile))
+	{
+		fprintf(stderr, "failed to enable the compression profile\n");
+		goto destroy_comp;
+	}
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profile(decomp, profile))
+	{
+		fprintf(stderr, "failed to enable the decompression profile\n");
+		goto destroy_decomp;
+	}
+
+	for(num = 0; num < STREAM_PKTS_NR; num++)
+	{
+		const struct rohc_ts arrival_time = { .sec = num / 100, .nsec = 0 };
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, ip_pkt_len, arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, HEADROOM_LEN + MAX_ROHC_SIZE);
+		uint8_t *rohc_pkt_end;
+		rohc_status_t ret;
+
+		test_build_tcp_packet(ip_buffer, ip_pkt_len, num);
+
+		/* compress the packet after the headroom */
+		rohc_packet.offset = HEADROOM_LEN;
+		ret = rohc_compress4(comp, ip_packet, &rohc_packet);
+		if(ret != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%u\n", num + 1);
+			goto destroy_decomp;
+		}
+		rohc_pkt_end = rohc_buf_data(rohc_packet) + rohc_packet.len;
+
+		/* decompress the packet in place */
+		ret = rohc_decompress_in_place(decomp, &rohc_packet, NULL, NULL);
+		if(ret != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress packet #%u in place\n", num + 1);
+			goto destroy_decomp;
+		}
+
+		/* the uncompressed packet shall be stored in the same buffer, with the
+		 * payload at the same place */
+		if(rohc_packet.data != rohc_buffer ||
+		   (rohc_buf_data(rohc_packet) + rohc_packet.len) != rohc_pkt_end)
+		{
+			fprintf(stderr, "packet #%u: packet was not decompressed in place\n",
+			        num + 1);
+			goto destroy_decomp;
+		}
+
+		/* the uncompressed packet shall match the original packet */
+		if(rohc_packet.len != ip_packet.len ||
+		   memcmp(rohc_buf_data(rohc_packet), rohc_buf_data(ip_packet),
+		          ip_packet.len) != 0)
+		{
+			fprintf(stderr, "packet #%u: %zu-byte decompressed packet does not "
+			        "match the %zu-byte original packet\n", num + 1,
+			        rohc_packet.len, ip_packet.len);
+			goto destroy_decomp;
+		}
+	}
+
+	/* decompress a feedback-only packet in place */
+	{
+		const uint8_t feedback_data[] = { 0xf4, 0x20, 0x00, 0x11, 0xe9 };
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, HEADROOM_LEN + MAX_ROHC_SIZE);
+		uint8_t rcvd_feedback_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rcvd_feedback =
+			rohc_buf_init_empty(rcvd_feedback_buffer, MAX_ROHC_SIZE);
+		rohc_status_t ret;
+
+		rohc_packet.offset = HEADROOM_LEN;
+		rohc_buf_append(&rohc_packet, feedback_data, sizeof(feedback_data));
+		ret = rohc_decompress_in_place(decomp, &rohc_packet, &rcvd_feedback, NULL);
+		if(ret != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress the feedback-only packet in "
+			        "place\n");
+			goto destroy_decomp;
+		}
+		if(!rohc_buf_is_empty(rohc_packet) || rohc_buf_is_empty(rcvd_feedback))
+		{
+			fprintf(stderr, "feedback-only packet was not handled as such\n");
+			goto destroy_decomp;
+		}
+		if(rohc_packet.data != rohc_buffer ||
+		   rohc_packet.max_len != (HEADROOM_LEN + MAX_ROHC_SIZE))
+		{
+			fprintf(stderr, "buffer of the feedback-only packet has %zu bytes "
+			        "instead of %u bytes\n", rohc_packet.max_len,
+			        HEADROOM_LEN + MAX_ROHC_SIZE);
+			goto destroy_decomp;
+		}
+	}
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
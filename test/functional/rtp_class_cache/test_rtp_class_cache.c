@@ -0,0 +1,343 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_rtp_class_cache.c
+ * @brief  Check the cache of RTP classifications and the built-in heuristic
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses several IPv4/UDP flows, half
+ * of them transport RTP. The SSRC of all RTP flows changes in the middle of
+ * the test. The number of calls to the RTP detection callback and the number
+ * of packets compressed with the RTP profile are checked:
+ *  - with the callback but without the cache,
+ *  - with the callback and the cache,
+ *  - with the callback and the cache, but less contexts than flows,
+ *  - with the built-in heuristic.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of flows, the first half of them transport RTP */
+#define FLOWS_NR  8U
+
+/** The number of RTP flows */
+#define RTP_FLOWS_NR  (FLOWS_NR / 2)
+
+/** The number of consecutive packets of every flow */
+#define FLOW_BURST_LEN  50U
+
+/** The number of packets to compress */
+#define PKTS_NR  2000U
+
+/** The number of packets in every flow */
+#define FLOW_PKTS_NR  (PKTS_NR / FLOWS_NR)
+
+/** The first UDP port of RTP flows */
+#define RTP_PORT_MIN  5000U
+
+/** The last UDP port of RTP flows */
+#define RTP_PORT_MAX  5099U
+
+/** The first UDP port of the flows that do not transport RTP */
+#define UDP_PORT_MIN  6000U
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 12U + 20U)
+
+
+/* prototypes of private functions */
+static bool test_rtp_class(const char *const descr,
+                           const size_t max_cid,
+                           const bool use_callback,
+                           const bool use_cache,
+                           const uint64_t expected_calls_nr,
+                           const uint64_t expected_rtp_pkts_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool callback_detect(const unsigned char *const ip,
+                            const unsigned char *const udp,
+                            const unsigned char *const payload,
+                            const unsigned int payload_size,
+                            void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check the cache of RTP classifications and the built-in heuristic
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	const uint64_t rtp_pkts_nr = RTP_FLOWS_NR * FLOW_PKTS_NR;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_rtp_class_cache\n");
+		goto error;
+	}
+
+	/* the callback is called for every packet */
+	if(!test_rtp_class("callback without cache", 15, true, false,
+	                   PKTS_NR, rtp_pkts_nr))
+	{
+		goto error;
+	}
+
+	/* the callback is called for the first packet of every flow, and again
+	 * when the SSRC of RTP flows changes */
+	if(!test_rtp_class("callback with cache", 15, true, true,
+	                   FLOWS_NR + RTP_FLOWS_NR, rtp_pkts_nr))
+	{
+		goto error;
+	}
+
+	/* the callback is called again for every burst, since the context of the
+	 * flow was recycled since its previous burst */
+	if(!test_rtp_class("callback with cache and recycled contexts", 3, true, true,
+	                   PKTS_NR / FLOW_BURST_LEN, rtp_pkts_nr))
+	{
+		goto error;
+	}
+
+	/* the first packet of every RTP flow, and the first packet after the
+	 * SSRC changes, are not classified as RTP by the built-in heuristic */
+	if(!test_rtp_class("built-in heuristic", 15, false, false,
+	                   0, rtp_pkts_nr - 2 * RTP_FLOWS_NR))
+	{
+		goto error;
+	}
+
+	/* everything went fine */
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress and decompress all the flows with one RTP detection setup
+ *
+ * @param descr                 The description of the setup
+ * @param max_cid               The largest CID of compressor and decompressor
+ * @param use_callback          Whether to detect RTP with the callback or with
+ *                              the built-in heuristic
+ * @param use_cache             Whether to cache the verdicts of the callback
+ * @param expected_calls_nr     The expected number of calls to the callback
+ * @param expected_rtp_pkts_nr  The expected number of packets compressed with
+ *                              the RTP profile
+ * @return                      true if the test succeeded, false otherwise
+ */
+static bool test_rtp_class(const char *const descr,
+                           const size_t max_cid,
+                           const bool use_callback,
+                           const bool use_cache,
+                           const uint64_t expected_calls_nr,
+                           const uint64_t expected_rtp_pkts_nr)
+{
+	rohc_comp_stats_t comp_stats = { .version_major = 0, .version_minor = 0 };
+	rohc_comp_features_t features = ROHC_COMP_FEATURE_STATS;
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint16_t flows_sn[FLOWS_NR] = { 0 };
+	uint64_t calls_nr = 0;
+	size_t i;
+	bool is_success = false;
+
+	printf("test RTP detection: %s\n", descr);
+
+	/* create the compressor with the RTP and UDP profiles */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, max_cid, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(use_cache)
+	{
+		features |= ROHC_COMP_FEATURE_RTP_CLASS_CACHE;
+	}
+	if(!rohc_comp_set_features(comp, features))
+	{
+		fprintf(stderr, "failed to enable the compression features\n");
+		goto destroy_comp;
+	}
+	if(use_callback)
+	{
+		if(!rohc_comp_set_rtp_detection_cb(comp, callback_detect, &calls_nr))
+		{
+			fprintf(stderr, "failed to set the RTP detection callback\n");
+			goto destroy_comp;
+		}
+	}
+	else if(!rohc_comp_set_rtp_heuristic(comp, RTP_PORT_MIN, RTP_PORT_MAX))
+	{
+		fprintf(stderr, "failed to enable the built-in RTP heuristic\n");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor with the RTP and UDP profiles */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, max_cid, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the packets of all the flows, the SSRC of all
+	 * RTP flows changes in the middle of the test */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		const size_t flow = (i / FLOW_BURST_LEN) % FLOWS_NR;
+		const uint32_t ssrc = flow + (i < (PKTS_NR / 2) ? 0x1000 : 0x2000);
+		const uint16_t port =
+			(flow < RTP_FLOWS_NR ? RTP_PORT_MIN : UDP_PORT_MIN) + flow * 2;
+		const struct rohc_ts arrival_time = { .sec = i / 50, .nsec = (i % 50) * 20000000 };
+		uint8_t ip_buffer[IP_PKT_LEN];
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, IP_PKT_LEN, arrival_time);
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		uint8_t decomp_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+
+		if(flow < RTP_FLOWS_NR)
+		{
+			test_build_rtp_packet(ip_buffer, IP_PKT_LEN, port, port, 0,
+			                      flows_sn[flow], ssrc);
+		}
+		else
+		{
+			/* 12 zero bytes that are not RTP, then data */
+			test_build_udp_packet(ip_buffer, IP_PKT_LEN, port, port, flows_sn[flow]);
+			memset(ip_buffer + TEST_UDP_HDRS_LEN, 0, 12);
+		}
+		flows_sn[flow]++;
+
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%zu\n", i + 1);
+			goto destroy_decomp;
+		}
+		if(rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                    NULL) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress packet #%zu\n", i + 1);
+			goto destroy_decomp;
+		}
+		if(decomp_packet.len != IP_PKT_LEN ||
+		   memcmp(rohc_buf_data(decomp_packet), ip_buffer, IP_PKT_LEN) != 0)
+		{
+			fprintf(stderr, "packet #%zu is not decompressed correctly\n", i + 1);
+			goto destroy_decomp;
+		}
+	}
+
+	/* check the number of calls to the callback and of RTP packets */
+	if(!rohc_comp_get_stats(comp, &comp_stats))
+	{
+		fprintf(stderr, "failed to get the compression statistics\n");
+		goto destroy_decomp;
+	}
+	printf("\t%" PRIu64 " calls to the RTP detection callback, %" PRIu64
+	       " packets compressed with the RTP profile\n", calls_nr,
+	       comp_stats.profiles_nr[0][ROHC_PROFILE_RTP]);
+	if(calls_nr != expected_calls_nr)
+	{
+		fprintf(stderr, "%" PRIu64 " calls to the RTP detection callback while "
+		        "%" PRIu64 " were expected\n", calls_nr, expected_calls_nr);
+		goto destroy_decomp;
+	}
+	if(comp_stats.profiles_nr[0][ROHC_PROFILE_RTP] != expected_rtp_pkts_nr ||
+	   (comp_stats.profiles_nr[0][ROHC_PROFILE_RTP] +
+	    comp_stats.profiles_nr[0][ROHC_PROFILE_UDP]) != PKTS_NR)
+	{
+		fprintf(stderr, "%" PRIu64 " packets compressed with the RTP profile "
+		        "while %" PRIu64 " were expected\n",
+		        comp_stats.profiles_nr[0][ROHC_PROFILE_RTP], expected_rtp_pkts_nr);
+		goto destroy_decomp;
+	}
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief The RTP detection callback that detects RTP flows by UDP port
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  The number of calls to the callback
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool callback_detect(const unsigned char *const ip,
+                            const unsigned char *const udp,
+                            const unsigned char *const payload,
+                            const unsigned int payload_size,
+                            void *const rtp_private)
+{
+	const uint16_t dst_port = (udp[2] << 8) | udp[3];
+	uint64_t *const calls_nr = rtp_private;
+
+	(*calls_nr)++;
+
+	return (dst_port >= RTP_PORT_MIN && dst_port <= RTP_PORT_MAX);
+}
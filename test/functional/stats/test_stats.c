@@ -0,0 +1,397 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_stats.c
+ * @brief  Check the detailed statistics of the compressor and decompressor
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses several IPv4/UDP flows with
+ * more flows than contexts, so that contexts are recycled. Another thread
+ * reads the statistics of the compressor and of the decompressor at the same
+ * time and checks that every snapshot is consistent. The final statistics
+ * are then compared with the packets that were processed.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The largest CID, use less contexts than flows */
+#define MAX_CID  3U
+
+/** The number of flows */
+#define FLOWS_NR  8U
+
+/** The number of consecutive packets of every flow */
+#define FLOW_BURST_LEN  50U
+
+/** The number of packets to compress */
+#define PKTS_NR  20000U
+
+/** The length of every IP packet */
+#define IP_PKT_LEN  (20U + 8U + 20U)
+
+
+/** The context of the thread that reads the statistics */
+struct reader
+{
+	pthread_t thread;                /**< The reader thread */
+	const struct rohc_comp *comp;    /**< The compressor */
+	const struct rohc_decomp *decomp; /**< The decompressor */
+	size_t snapshots_nr;             /**< The number of snapshots taken */
+	bool is_consistent;              /**< Whether all snapshots were consistent */
+	bool stop;                       /**< Whether the reader shall stop */
+};
+
+
+/* prototypes of private functions */
+static void * reader_run(void *arg)
+	__attribute__((nonnull(1)));
+static bool check_comp_stats(const rohc_comp_stats_t *const stats)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool check_decomp_stats(const rohc_decomp_stats_t *const stats)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/**
+ * @brief Check the detailed statistics of the compressor and decompressor
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	rohc_comp_stats_t comp_stats = { .version_major = 0, .version_minor = 0 };
+	rohc_decomp_stats_t decomp_stats = { .version_major = 0, .version_minor = 0 };
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	struct reader reader;
+	uint16_t flows_sn[FLOWS_NR] = { 0 };
+	uint64_t comp_bytes_nr = 0;
+	size_t i;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_stats\n");
+		goto error;
+	}
+
+	/* create the compressor with the UDP profile and the statistics */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, MAX_CID, test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_features(comp, ROHC_COMP_FEATURE_STATS))
+	{
+		fprintf(stderr, "failed to enable the compression statistics\n");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor with the UDP profile and the statistics */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, MAX_CID, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_STATS))
+	{
+		fprintf(stderr, "failed to enable the decompression statistics\n");
+		goto destroy_decomp;
+	}
+
+	/* read the statistics on another thread while packets are processed */
+	reader.comp = comp;
+	reader.decomp = decomp;
+	reader.snapshots_nr = 0;
+	reader.is_consistent = true;
+	reader.stop = false;
+	if(pthread_create(&reader.thread, NULL, reader_run, &reader) != 0)
+	{
+		fprintf(stderr, "failed to create the reader thread\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the packets of all the flows */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		const size_t flow = (i / FLOW_BURST_LEN) % FLOWS_NR;
+		const struct rohc_ts arrival_time = { .sec = i / 1000, .nsec = 0 };
+		uint8_t ip_buffer[IP_PKT_LEN];
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, IP_PKT_LEN, arrival_time);
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		uint8_t decomp_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		uint8_t feedback_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+
+		test_build_udp_packet(ip_buffer, IP_PKT_LEN, 5000 + flow, 5002,
+		                      flows_sn[flow]);
+		flows_sn[flow]++;
+
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%zu\n", i + 1);
+			goto stop_reader;
+		}
+		comp_bytes_nr += rohc_packet.len;
+
+		if(rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                    &feedback_send) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress packet #%zu\n", i + 1);
+			goto stop_reader;
+		}
+		if(decomp_packet.len != IP_PKT_LEN ||
+		   memcmp(rohc_buf_data(decomp_packet), ip_buffer, IP_PKT_LEN) != 0)
+		{
+			fprintf(stderr, "packet #%zu is not decompressed correctly\n", i + 1);
+			goto stop_reader;
+		}
+		if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+		{
+			fprintf(stderr, "failed to deliver feedback for packet #%zu\n", i + 1);
+			goto stop_reader;
+		}
+	}
+
+	/* every snapshot taken during the processing shall be consistent */
+	__atomic_store_n(&reader.stop, true, __ATOMIC_RELAXED);
+	pthread_join(reader.thread, NULL);
+	printf("%zu snapshots of the statistics taken during processing\n",
+	       reader.snapshots_nr);
+	if(!reader.is_consistent)
+	{
+		fprintf(stderr, "inconsistent snapshot of the statistics\n");
+		goto destroy_decomp;
+	}
+
+	/* check the final statistics of the compressor */
+	if(!rohc_comp_get_stats(comp, &comp_stats) ||
+	   !check_comp_stats(&comp_stats))
+	{
+		fprintf(stderr, "failed to get consistent compression statistics\n");
+		goto destroy_decomp;
+	}
+	printf("compressor: %" PRIu64 " packets, %" PRIu64 " contexts created, "
+	       "%" PRIu64 " contexts recycled, %" PRIu64 " IR packets\n",
+	       comp_stats.packets_nr, comp_stats.ctxt_creations_nr,
+	       comp_stats.ctxt_evictions_nr, comp_stats.pkt_types_nr[ROHC_PACKET_IR]);
+	if(comp_stats.packets_nr != PKTS_NR ||
+	   comp_stats.failures_nr != 0 ||
+	   comp_stats.uncomp_bytes_nr != (PKTS_NR * IP_PKT_LEN) ||
+	   comp_stats.comp_bytes_nr != comp_bytes_nr ||
+	   comp_stats.profiles_nr[0][ROHC_PROFILE_UDP] != PKTS_NR)
+	{
+		fprintf(stderr, "unexpected packet counters for the compressor\n");
+		goto destroy_decomp;
+	}
+	if(comp_stats.ctxt_creations_nr != (PKTS_NR / FLOW_BURST_LEN) ||
+	   comp_stats.ctxt_evictions_nr != (comp_stats.ctxt_creations_nr - (MAX_CID + 1)) ||
+	   comp_stats.ctxt_replications_nr != 0 ||
+	   comp_stats.pkt_types_nr[ROHC_PACKET_IR] < comp_stats.ctxt_creations_nr)
+	{
+		fprintf(stderr, "unexpected context counters for the compressor\n");
+		goto destroy_decomp;
+	}
+
+	/* check the final statistics of the decompressor */
+	if(!rohc_decomp_get_stats(decomp, &decomp_stats) ||
+	   !check_decomp_stats(&decomp_stats))
+	{
+		fprintf(stderr, "failed to get consistent decompression statistics\n");
+		goto destroy_decomp;
+	}
+	printf("decompressor: %" PRIu64 " packets, %" PRIu64 " contexts created, "
+	       "%" PRIu64 " IR packets\n", decomp_stats.packets_nr,
+	       decomp_stats.ctxt_creations_nr,
+	       decomp_stats.pkt_types_nr[ROHC_PACKET_IR]);
+	if(decomp_stats.packets_nr != PKTS_NR ||
+	   decomp_stats.failures_nr != 0 ||
+	   decomp_stats.comp_bytes_nr != comp_bytes_nr ||
+	   decomp_stats.uncomp_bytes_nr != (PKTS_NR * IP_PKT_LEN) ||
+	   decomp_stats.profiles_nr[0][ROHC_PROFILE_UDP] != PKTS_NR ||
+	   decomp_stats.crc_repairs_nr != 0)
+	{
+		fprintf(stderr, "unexpected packet counters for the decompressor\n");
+		goto destroy_decomp;
+	}
+	if(decomp_stats.ctxt_creations_nr != (MAX_CID + 1) ||
+	   decomp_stats.pkt_types_nr[ROHC_PACKET_IR] !=
+	   comp_stats.pkt_types_nr[ROHC_PACKET_IR])
+	{
+		fprintf(stderr, "unexpected context counters for the decompressor\n");
+		goto destroy_decomp;
+	}
+
+	/* everything went fine */
+	status = 0;
+	goto destroy_decomp;
+
+stop_reader:
+	__atomic_store_n(&reader.stop, true, __ATOMIC_RELAXED);
+	pthread_join(reader.thread, NULL);
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Read the statistics until asked to stop
+ *
+ * @param arg  The context of the reader thread
+ * @return     Always NULL
+ */
+static void * reader_run(void *arg)
+{
+	struct reader *const reader = arg;
+
+	while(!__atomic_load_n(&reader->stop, __ATOMIC_RELAXED))
+	{
+		rohc_comp_stats_t comp_stats = { .version_major = 0, .version_minor = 0 };
+		rohc_decomp_stats_t decomp_stats = { .version_major = 0, .version_minor = 0 };
+
+		if(!rohc_comp_get_stats(reader->comp, &comp_stats) ||
+		   !check_comp_stats(&comp_stats) ||
+		   !rohc_decomp_get_stats(reader->decomp, &decomp_stats) ||
+		   !check_decomp_stats(&decomp_stats))
+		{
+			reader->is_consistent = false;
+		}
+		reader->snapshots_nr++;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Check that one snapshot of the compression statistics is consistent
+ *
+ * @param stats  The snapshot of the compression statistics
+ * @return       true if the snapshot is consistent, false otherwise
+ */
+static bool check_comp_stats(const rohc_comp_stats_t *const stats)
+{
+	uint64_t profiles_nr = 0;
+	uint64_t pkt_types_nr = 0;
+	uint64_t latencies_nr = 0;
+	size_t i;
+	size_t j;
+
+	for(i = 0; i <= ROHC_PROFILE_ID_MAJOR_MAX; i++)
+	{
+		for(j = 0; j <= ROHC_PROFILE_ID_MINOR_MAX; j++)
+		{
+			profiles_nr += stats->profiles_nr[i][j];
+		}
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		pkt_types_nr += stats->pkt_types_nr[i];
+	}
+	for(i = 0; i < ROHC_STATS_LATENCY_BUCKETS_NR; i++)
+	{
+		latencies_nr += stats->latency_hist[i];
+	}
+
+	/* every packet is counted once per profile and once per packet type,
+	 * every packet is timed, even if it failed to be compressed */
+	return (profiles_nr == stats->packets_nr &&
+	        pkt_types_nr == stats->packets_nr &&
+	        latencies_nr == (stats->packets_nr + stats->failures_nr));
+}
+
+
+/**
+ * @brief Check that one snapshot of the decompression statistics is consistent
+ *
+ * @param stats  The snapshot of the decompression statistics
+ * @return       true if the snapshot is consistent, false otherwise
+ */
+static bool check_decomp_stats(const rohc_decomp_stats_t *const stats)
+{
+	uint64_t profiles_nr = 0;
+	uint64_t pkt_types_nr = 0;
+	uint64_t latencies_nr = 0;
+	size_t i;
+	size_t j;
+
+	for(i = 0; i <= ROHC_PROFILE_ID_MAJOR_MAX; i++)
+	{
+		for(j = 0; j <= ROHC_PROFILE_ID_MINOR_MAX; j++)
+		{
+			profiles_nr += stats->profiles_nr[i][j];
+		}
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		pkt_types_nr += stats->pkt_types_nr[i];
+	}
+	for(i = 0; i < ROHC_STATS_LATENCY_BUCKETS_NR; i++)
+	{
+		latencies_nr += stats->latency_hist[i];
+	}
+
+	/* every packet is counted once per profile and once per packet type,
+	 * every packet is timed, even if it failed to be decompressed */
+	return (profiles_nr == stats->packets_nr &&
+	        pkt_types_nr == stats->packets_nr &&
+	        latencies_nr == (stats->packets_nr + stats->failures_nr));
+}
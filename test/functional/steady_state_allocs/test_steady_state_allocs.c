@@ -0,0 +1,267 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_steady_state_allocs.c
+ * @brief  Check that the compressor and the decompressor do not allocate
+ *         memory in steady state
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses a long IPv4/UDP/RTP stream with
+ * the RTP profile and counts the calls to the memory allocator. The
+ * decompressor sends one positive feedback for every packet, the feedback is
+ * delivered back to the compressor. Once the contexts are created, no more
+ * memory shall be allocated.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of packets to compress before counting allocations */
+#define WARMUP_PKTS_NR  100U
+
+/** The number of packets to compress while counting allocations */
+#define STREAM_PKTS_NR  10000U
+
+
+#if defined(__GLIBC__)
+
+/* the glibc allocator, used by the counting wrappers below */
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t nmemb, size_t size);
+extern void * __libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+/** The number of calls to the memory allocator */
+static size_t allocs_nr = 0;
+
+void * malloc(size_t size)
+{
+	allocs_nr++;
+	return __libc_malloc(size);
+}
+
+void * calloc(size_t nmemb, size_t size)
+{
+	allocs_nr++;
+	return __libc_calloc(nmemb, size);
+}
+
+void * realloc(void *ptr, size_t size)
+{
+	allocs_nr++;
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+	__libc_free(ptr);
+}
+
+#endif /* __GLIBC__ */
+
+
+/* prototypes of private functions */
+static bool rtp_detect(const unsigned char *const ip,
+                       const unsigned char *const udp,
+                       const unsigned char *const payload,
+                       const unsigned int payload_size,
+                       void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check that no memory is allocated in steady state
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure,
+ *              \li 77 if the test cannot be run on the platform
+ */
+int main(int argc, char *argv[])
+{
+#if defined(__GLIBC__)
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint8_t ip_buffer[100];
+	const uint16_t ip_pkt_len = 20 + 8 + 12 + 20;
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	uint8_t feedback_buffer[MAX_ROHC_SIZE];
+	size_t steady_allocs_nr;
+	size_t steady_feedbacks_nr = 0;
+	uint16_t sn;
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_steady_state_allocs\n");
+		goto error;
+	}
+
+	/* create the ROHC compressor with the RTP profile enabled */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rtp_detect, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor with the RTP profile enabled, it sends one
+	 * positive feedback for every packet */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_rate_limits(decomp, 2, 1, 1, 100, 1, 100))
+	{
+		fprintf(stderr, "failed to set the feedback rate limits\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the stream, start counting allocations after
+	 * warm-up */
+	for(sn = 0; sn < (WARMUP_PKTS_NR + STREAM_PKTS_NR); sn++)
+	{
+		const struct rohc_ts arrival_time = { .sec = sn / 50, .nsec = 0 };
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, ip_pkt_len, arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+		rohc_status_t ret;
+
+		if(sn == WARMUP_PKTS_NR)
+		{
+			allocs_nr = 0;
+			steady_feedbacks_nr = 0;
+		}
+
+		test_build_rtp_packet(ip_buffer, ip_pkt_len, 5000, 5002, 8 /* PCMA */, sn,
+		                      0x01020304);
+		ret = rohc_compress4(comp, ip_packet, &rohc_packet);
+		if(ret != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%u\n", sn + 1);
+			goto destroy_decomp;
+		}
+		ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                       &feedback_send);
+		if(ret != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress packet #%u\n", sn + 1);
+			goto destroy_decomp;
+		}
+		if(feedback_send.len > 0)
+		{
+			steady_feedbacks_nr++;
+			if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+			{
+				fprintf(stderr, "failed to deliver the feedback of packet #%u\n",
+				        sn + 1);
+				goto destroy_decomp;
+			}
+		}
+	}
+	steady_allocs_nr = allocs_nr;
+
+	printf("%zu memory allocations for %u packets and %zu feedbacks in steady "
+	       "state\n", steady_allocs_nr, STREAM_PKTS_NR, steady_feedbacks_nr);
+	if(steady_feedbacks_nr == 0)
+	{
+		fprintf(stderr, "decompressor sent no feedback in steady state\n");
+		goto destroy_decomp;
+	}
+	if(steady_allocs_nr != 0)
+	{
+		fprintf(stderr, "compressor or decompressor allocated memory in steady "
+		        "state\n");
+		goto destroy_decomp;
+	}
+
+	/* everything went fine */
+	status = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return status;
+#else
+	/* allocator calls cannot be counted on this platform, skip test */
+	return 77;
+#endif
+}
+
+
+/**
+ * @brief The RTP detection callback that detects all UDP packets as RTP
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context
+ * @return             Always true
+ */
+static bool rtp_detect(const unsigned char *const ip,
+                       const unsigned char *const udp,
+                       const unsigned char *const payload,
+                       const unsigned int payload_size,
+                       void *const rtp_private)
+{
+	return true;
+}
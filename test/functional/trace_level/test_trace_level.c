@@ -0,0 +1,320 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_trace_level.c
+ * @brief  Check the minimal trace level and measure its per-packet cost
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses an IPv4/UDP/RTP stream with
+ * the RTP profile in several trace configurations:
+ *  - no trace callback,
+ *  - a trace callback with the minimal level set to WARNING,
+ *  - a trace callback with all traces enabled.
+ *
+ * The test fails if one trace below the WARNING level reaches the callback
+ * while the minimal level is set to WARNING. The per-packet cost of every
+ * configuration is printed, so that the cost of the trace filter may be
+ * compared with the cost of no trace callback at all.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <inttypes.h>
+#include <time.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of packets to compress and decompress in every configuration */
+#define STREAM_PKTS_NR  20000U
+
+
+/** The configurations of traces to test */
+struct trace_config
+{
+	const char *descr;             /**< The description of the configuration */
+	bool with_cb;                  /**< Whether a trace callback is set */
+	rohc_trace_level_t min_level;  /**< The minimal level of traces */
+};
+
+
+/** The number of traces received by the callback for every level */
+static size_t traces_nr[ROHC_TRACE_LEVEL_MAX];
+
+
+/* prototypes of private functions */
+static bool run_config(const struct trace_config *const config,
+                       const bool be_verbose)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void count_traces(void *const priv_ctxt,
+                         const rohc_trace_level_t level,
+                         const rohc_trace_entity_t entity,
+                         const int profile,
+                         const char *const format,
+                         ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static bool rtp_detect(const unsigned char *const ip,
+                       const unsigned char *const udp,
+                       const unsigned char *const payload,
+                       const unsigned int payload_size,
+                       void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check the minimal trace level and measure its per-packet cost
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	const struct trace_config configs[] = {
+		{ .descr = "no trace callback", .with_cb = false,
+		  .min_level = ROHC_TRACE_DEBUG },
+		{ .descr = "trace callback, WARNING level", .with_cb = true,
+		  .min_level = ROHC_TRACE_WARNING },
+		{ .descr = "trace callback, DEBUG level", .with_cb = true,
+		  .min_level = ROHC_TRACE_DEBUG },
+	};
+	bool be_verbose = false;
+	int status = 1;
+	size_t i;
+
+	if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		be_verbose = true;
+	}
+	else if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_trace_level [verbose]\n");
+		goto error;
+	}
+
+	for(i = 0; i < (sizeof(configs) / sizeof(struct trace_config)); i++)
+	{
+		if(!run_config(&configs[i], be_verbose))
+		{
+			fprintf(stderr, "test failed with %s\n", configs[i].descr);
+			goto error;
+		}
+	}
+
+	/* everything went fine */
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress and decompress the stream with one trace configuration
+ *
+ * @param config      The trace configuration to test
+ * @param be_verbose  Whether to print the results or not
+ * @return            true if the test succeeds, false otherwise
+ */
+static bool run_config(const struct trace_config *const config,
+                       const bool be_verbose)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint8_t ip_buffer[100];
+	const uint16_t ip_pkt_len = 20 + 8 + 12 + 20;
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	struct timespec start;
+	struct timespec end;
+	uint64_t elapsed_ns;
+	uint16_t sn;
+	int level;
+	bool is_success = false;
+
+	memset(traces_nr, 0, sizeof(traces_nr));
+
+	/* create the ROHC compressor and decompressor with the RTP profile */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      test_gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rtp_detect, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback\n");
+		goto destroy_comp;
+	}
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* configure traces */
+	if(config->with_cb)
+	{
+		if(!rohc_comp_set_traces_cb2(comp, count_traces, NULL) ||
+		   !rohc_decomp_set_traces_cb2(decomp, count_traces, NULL))
+		{
+			fprintf(stderr, "failed to set the trace callbacks\n");
+			goto destroy_decomp;
+		}
+	}
+	if(!rohc_comp_set_traces_min_level(comp, config->min_level) ||
+	   !rohc_decomp_set_traces_min_level(decomp, config->min_level))
+	{
+		fprintf(stderr, "failed to set the minimal trace level\n");
+		goto destroy_decomp;
+	}
+
+	/* compress and decompress the stream */
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(sn = 0; sn < STREAM_PKTS_NR; sn++)
+	{
+		const struct rohc_ts arrival_time = { .sec = sn / 50, .nsec = 0 };
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, ip_pkt_len, arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+
+		test_build_rtp_packet(ip_buffer, ip_pkt_len, 5000, 5002, 8 /* PCMA */, sn,
+		                      0x01020304);
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%u\n", sn + 1);
+			goto destroy_decomp;
+		}
+		if(rohc_decompress3(decomp, rohc_packet, &decomp_packet,
+		                    NULL, NULL) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress packet #%u\n", sn + 1);
+			goto destroy_decomp;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	elapsed_ns = (end.tv_sec - start.tv_sec) * 1000000000ULL +
+	             end.tv_nsec - start.tv_nsec;
+
+	if(be_verbose)
+	{
+		printf("%s: %" PRIu64 " ns per packet (compression and decompression)\n",
+		       config->descr, elapsed_ns / STREAM_PKTS_NR);
+		for(level = ROHC_TRACE_DEBUG; level < ROHC_TRACE_LEVEL_MAX; level++)
+		{
+			printf("\t%zu traces of level %d\n", traces_nr[level], level);
+		}
+	}
+
+	/* no trace below the minimal level shall reach the callback */
+	for(level = ROHC_TRACE_DEBUG; level < (int) config->min_level; level++)
+	{
+		if(traces_nr[level] != 0)
+		{
+			fprintf(stderr, "%zu traces of level %d were received while the "
+			        "minimal level is %d\n", traces_nr[level], level,
+			        config->min_level);
+			goto destroy_decomp;
+		}
+	}
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Count the traces received for every level
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void count_traces(void *const priv_ctxt,
+                         const rohc_trace_level_t level,
+                         const rohc_trace_entity_t entity,
+                         const int profile,
+                         const char *const format,
+                         ...)
+{
+	if(level < ROHC_TRACE_LEVEL_MAX)
+	{
+		traces_nr[level]++;
+	}
+}
+
+
+/**
+ * @brief The RTP detection callback that detects all UDP packets as RTP
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context
+ * @return             Always true
+ */
+static bool rtp_detect(const unsigned char *const ip,
+                       const unsigned char *const udp,
+                       const unsigned char *const payload,
+                       const unsigned int payload_size,
+                       void *const rtp_private)
+{
+	return true;
+}
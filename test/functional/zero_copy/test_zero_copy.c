@@ -0,0 +1,245 @@
+/*
+ * Copyright 2018 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_zero_copy.c
+ * @brief  Check the compression of headers without copy of the payload
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses a stream of large IPv4/TCP packets twice: once
+ * with rohc_compress4() and once with rohc_compress_zero_copy(). The ROHC
+ * header followed by the referenced payload shall be identical to the ROHC
+ * packet built by rohc_compress4(), and the payload shall be referenced in
+ * the uncompressed packet, not copied. The test is run with the TCP profile
+ * and with the Uncompressed profile.
+ */
+
+#include "test.h"
+#include "test_common.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+
+
+/** The number of packets of the test stream */
+#define STREAM_PKTS_NR  500U
+
+/** The length of the TCP payload of every packet of the test stream */
+#define TCP_PAYLOAD_LEN  1400U
+
+/** The length of the ROHC header buffer given to rohc_compress_zero_copy() */
+#define ROHC_HDR_MAX_LEN  128U
+
+
+/* prototypes of private functions */
+static bool test_zero_copy(const rohc_profile_t profile)
+	__attribute__((warn_unused_result));
+static struct rohc_comp * create_comp(const rohc_profile_t profile)
+	__attribute__((warn_unused_result));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check the compression of headers without copy of the payload
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "usage: test_zero_copy\n");
+		goto error;
+	}
+
+	if(!test_zero_copy(ROHCv1_PROFILE_IP_TCP))
+	{
+		fprintf(stderr, "test failed with the TCP profile\n");
+		goto error;
+	}
+	if(!test_zero_copy(ROHCv1_PROFILE_UNCOMPRESSED))
+	{
+		fprintf(stderr, "test failed with the Uncompressed profile\n");
+		goto error;
+	}
+
+	/* everything went fine */
+	printf("all tests are successful\n");
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress the test stream with and without copy of the payloads
+ *
+ * @param profile  The compression profile to use
+ * @return         true if the test succeeds, false otherwise
+ */
+static bool test_zero_copy(const rohc_profile_t profile)
+{
+	struct rohc_comp *comp_copy;
+	struct rohc_comp *comp_zc;
+	const uint16_t ip_pkt_len = 20 + 20 + TCP_PAYLOAD_LEN;
+	uint8_t ip_buffer[20 + 20 + TCP_PAYLOAD_LEN];
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	uint8_t rohc_hdr_buffer[ROHC_HDR_MAX_LEN];
+	uint16_t num;
+	bool is_success = false;
+
+	/* create the two ROHC compressors */
+	comp_copy = create_comp(profile);
+	if(comp_copy == NULL)
+	{
+		goto error;
+	}
+	comp_zc = create_comp(profile);
+	if(comp_zc == NULL)
+	{
+		goto destroy_comp_copy;
+	}
+
+	for(num = 0; num < STREAM_PKTS_NR; num++)
+	{
+		const struct rohc_ts arrival_time = { .sec = num / 100, .nsec = 0 };
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, ip_pkt_len, arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf rohc_hdr =
+			rohc_buf_init_empty(rohc_hdr_buffer, ROHC_HDR_MAX_LEN);
+		struct rohc_buf payload;
+		rohc_status_t ret;
+
+		test_build_tcp_packet(ip_buffer, ip_pkt_len, num);
+
+		/* compress with copy of the payload */
+		ret = rohc_compress4(comp_copy, ip_packet, &rohc_packet);
+		if(ret != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%u with copy\n", num + 1);
+			goto destroy_comp_zc;
+		}
+
+		/* compress without copy of the payload */
+		ret = rohc_compress_zero_copy(comp_zc, ip_packet, &rohc_hdr, &payload);
+		if(ret != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to compress packet #%u without copy\n",
+			        num + 1);
+			goto destroy_comp_zc;
+		}
+
+		/* the payload shall be referenced in the uncompressed packet */
+		if(rohc_buf_data(payload) < ip_buffer ||
+		   (rohc_buf_data(payload) + payload.len) != (ip_buffer + ip_pkt_len))
+		{
+			fprintf(stderr, "packet #%u: payload is not referenced in the "
+			        "uncompressed packet\n", num + 1);
+			goto destroy_comp_zc;
+		}
+
+		/* ROHC header and payload shall match the ROHC packet built with copy */
+		if((rohc_hdr.len + payload.len) != rohc_packet.len ||
+		   memcmp(rohc_buf_data(rohc_hdr), rohc_buf_data(rohc_packet),
+		          rohc_hdr.len) != 0 ||
+		   memcmp(rohc_buf_data(payload),
+		          rohc_buf_data(rohc_packet) + rohc_hdr.len, payload.len) != 0)
+		{
+			fprintf(stderr, "packet #%u: %zu-byte ROHC header and %zu-byte "
+			        "payload do not match the %zu-byte ROHC packet\n", num + 1,
+			        rohc_hdr.len, payload.len, rohc_packet.len);
+			goto destroy_comp_zc;
+		}
+	}
+
+	is_success = true;
+
+destroy_comp_zc:
+	rohc_comp_free(comp_zc);
+destroy_comp_copy:
+	rohc_comp_free(comp_copy);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Create a ROHC compressor with the given profile enabled
+ *
+ * @param profile  The compression profile to enable
+ * @return         The new ROHC compressor, NULL in case of failure
+ */
+static struct rohc_comp * create_comp(const rohc_profile_t profile)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_enable_profile(comp, profile))
+	{
+		fprintf(stderr, "failed to enable the compression profile\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Generate a "random" number
+ *
+ * The same number is always returned, so that both compressors choose the
+ * same initial values for their contexts.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always the same number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	return 42;
+}
@@ -71,7 +71,8 @@ static void usage(void);
 static int test_comp_and_decomp(const char *const filename,
                                 const unsigned int packet_to_damage,
                                 const rohc_packet_t expected_packet,
-                                const bool do_repair);
+                                const bool do_repair,
+                                const bool is_repairable);
 static bool are_packet_types_equal(const rohc_packet_t packet_type1,
                                    const rohc_packet_t packet_type2)
 	__attribute__((warn_unused_result, const));
@@ -112,6 +113,7 @@ int main(int argc, char *argv[])
 	char *packet_type = NULL;
 	rohc_packet_t expected_packet;
 	bool do_repair = false;
+	bool is_repairable = false;
 	int srand_init;
 	int status = 1;
 
@@ -133,6 +135,12 @@ int main(int argc, char *argv[])
 		else if(!strcmp(*argv, "--repair"))
 		{
 			do_repair = true;
+			is_repairable = true;
+		}
+		else if(!strcmp(*argv, "--repair-unmatched"))
+		{
+			do_repair = true;
+			is_repairable = false;
 		}
 		else if(filename == NULL)
 		{
@@ -219,7 +227,7 @@ int main(int argc, char *argv[])
 
 	/* test ROHC compression/decompression with the packets from the file */
 	status = test_comp_and_decomp(filename, packet_to_damage, expected_packet,
-	                              do_repair);
+	                              do_repair, is_repairable);
 
 error:
 	return status;
@@ -245,7 +253,10 @@ static void usage(void)
 	        "\n"
 	        "options:\n"
 	        "  -h           Print this usage and exit\n"
-	        "  --repair     Repair packet/context\n");
+	        "  --repair     Repair packet/context\n"
+	        "  --repair-unmatched\n"
+	        "               Enable packet/context repair, but damage the packet\n"
+	        "               in a way that no repair attempt can explain\n");
 }
 
 
@@ -259,13 +270,16 @@ static void usage(void)
  * @param expected_packet   The type of ROHC packet expected at the end of the
  *                          source capture
  * @param do_repair         Repair the packet/context
+ * @param is_repairable     Whether the damage can be repaired, if not, only
+ *                          the damaged packet shall fail to be decompressed
  * @return                  0 in case of success,
  *                          1 in case of failure
  */
 static int test_comp_and_decomp(const char *const filename,
                                 const unsigned int packet_to_damage,
                                 const rohc_packet_t expected_packet,
-                                const bool do_repair)
+                                const bool do_repair,
+                                const bool is_repairable)
 {
 	struct rohc_ts arrival_time = { .sec = 4242, .nsec = 4242 };
 	char errbuf[PCAP_ERRBUF_SIZE];
@@ -499,7 +513,7 @@ static int test_comp_and_decomp(const char *const filename,
 			        packet_to_damage, expected_packet);
 
 			/* damage the packet */
-			if(do_repair)
+			if(is_repairable)
 			{
 				assert(rohc_packet.len >= 1);
 				pos = 1;
@@ -539,8 +553,8 @@ static int test_comp_and_decomp(const char *const filename,
 		                          NULL, NULL);
 		if(status == ROHC_STATUS_BAD_CRC)
 		{
-			if((!do_repair && counter != packet_to_damage) ||
-			   (do_repair && counter != (packet_to_damage + 1) &&
+			if((!is_repairable && counter != packet_to_damage) ||
+			   (is_repairable && counter != (packet_to_damage + 1) &&
 			    counter != (packet_to_damage + 2)))
 			{
 				/* failure is NOT expected for the non-damaged packets */
@@ -558,8 +572,8 @@ static int test_comp_and_decomp(const char *const filename,
 		else if(status != ROHC_STATUS_OK)
 		{
 			/* non-CRC failure is NOT expected except for damaged IR/IR-DYN packet */
-			if((!do_repair && counter != packet_to_damage) ||
-			   (do_repair && counter != (packet_to_damage + 1) &&
+			if((!is_repairable && counter != packet_to_damage) ||
+			   (is_repairable && counter != (packet_to_damage + 1) &&
 			    counter != (packet_to_damage + 2)))
 			{
 				fprintf(stderr, "\tunexpected non-CRC failure to decompress generated "
@@ -581,8 +595,8 @@ static int test_comp_and_decomp(const char *const filename,
 		}
 		else
 		{
-			if((!do_repair && counter != packet_to_damage) ||
-			   (do_repair && counter != (packet_to_damage + 1) &&
+			if((!is_repairable && counter != packet_to_damage) ||
+			   (is_repairable && counter != (packet_to_damage + 1) &&
 			    counter != (packet_to_damage + 2)))
 			{
 				/* success is expected for the non-damaged packets */
@@ -598,7 +612,7 @@ static int test_comp_and_decomp(const char *const filename,
 	}
 
 	/* everything went fine */
-	if(!do_repair)
+	if(!is_repairable)
 	{
 		fprintf(stderr, "all non-damaged packets were successfully decompressed\n");
 		fprintf(stderr, "all damaged packets failed to be decompressed as expected\n");
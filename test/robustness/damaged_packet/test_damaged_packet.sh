@@ -87,6 +87,8 @@ if [ "${REPAIR}" = "norepair" ] ; then
 	REPAIR=""
 elif [ "${REPAIR}" = "repair" ] ; then
 	REPAIR="--repair"
+elif [ "${REPAIR}" = "repair-unmatched" ] ; then
+	REPAIR="--repair-unmatched"
 else
 	echo "wrong repair argument" >&2
 	exit 1
@@ -0,0 +1,23 @@
+#!/bin/sh
+#
+# Copyright 2018 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+# damage the same packet as test_damaged_packet_5_uo0.sh, but with CRC repair
+# enabled: no repair hypothesis matches the damaged packet, so only the
+# damaged packet shall be lost
+$( dirname "$0" )/test_damaged_packet.sh repair-unmatched test_damaged_packet_5_uo0 $@
+exit $?